@@ -249,6 +249,14 @@ struct HostImageCopyProperties {
     std::vector<TextureLayout> dstCopyLayouts;
 };
 
+/**
+    @headerfile adapter_properties.h <KDGpu/adapter_properties.h>
+ */
+struct ExternalMemoryHostProperties {
+    // Alignment of the pointer and size of host memory imported into a Buffer, 0 when importing is unsupported
+    DeviceSize minImportedHostPointerAlignment{ 0 };
+};
+
 /**
     @headerfile adapter_properties.h <KDGpu/adapter_properties.h>
  */
@@ -275,6 +283,7 @@ struct AdapterProperties {
     RayTracingProperties rayTracingProperties;
     MeshShaderProperties meshShaderProperties;
     HostImageCopyProperties hostImageCopyProperties;
+    ExternalMemoryHostProperties externalMemoryHostProperties;
     PushBindGroupProperties pushBindGroupProperties;
 };
 
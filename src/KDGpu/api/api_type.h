@@ -14,6 +14,7 @@ This file is part of KDGpu.
 namespace KDGpu {
 enum class ApiType : uint8_t {
     Vulkan = 0,
+    Null = 1,
     UserDefined = 255
 };
 }
@@ -12,4 +12,8 @@ This file is part of KDGpu.
 
 // WARNING! Only include this from cpp files so it does not leak to the public API!
 
+#if defined(KDGPU_NULL_BACKEND)
+#include <KDGpu/null/null_graphics_api.h>
+#else
 #include <KDGpu/vulkan/vulkan_graphics_api.h>
+#endif
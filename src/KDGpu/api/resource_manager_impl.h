@@ -12,4 +12,8 @@
 
 // WARNING! Only include this from cpp files so it does not leak to the public API!
 
+#if defined(KDGPU_NULL_BACKEND)
+#include <KDGpu/null/null_resource_manager.h>
+#else
 #include <KDGpu/vulkan/vulkan_resource_manager.h>
+#endif
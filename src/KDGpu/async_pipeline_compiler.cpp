@@ -0,0 +1,60 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "async_pipeline_compiler.h"
+
+#include <algorithm>
+
+namespace KDGpu {
+
+AsyncPipelineCompiler::AsyncPipelineCompiler(uint32_t threadCount)
+{
+    threadCount = std::max(threadCount, 1U);
+    m_threads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i)
+        m_threads.emplace_back([this] { run(); });
+}
+
+AsyncPipelineCompiler::~AsyncPipelineCompiler()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_jobAvailable.notify_all();
+    for (std::thread &thread : m_threads)
+        thread.join();
+}
+
+uint32_t AsyncPipelineCompiler::defaultThreadCount() noexcept
+{
+    // Leave one core to the thread that keeps rendering the loading screen
+    const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    return std::max(hardwareThreads, 2U) - 1;
+}
+
+void AsyncPipelineCompiler::run()
+{
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_jobAvailable.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            // Queued jobs are still completed when stopping, their futures are waited upon
+            if (m_jobs.empty())
+                return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+} // namespace KDGpu
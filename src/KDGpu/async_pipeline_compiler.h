@@ -0,0 +1,74 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/kdgpu_export.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace KDGpu {
+
+/**
+ * @brief AsyncPipelineCompiler
+ * @internal
+ *
+ * Small fixed-size worker pool used by Device::create*PipelineAsync(). Jobs
+ * run in submission order on whichever worker is free. Destroying the
+ * compiler waits for all queued jobs to complete.
+ */
+class KDGPU_EXPORT AsyncPipelineCompiler
+{
+public:
+    explicit AsyncPipelineCompiler(uint32_t threadCount = defaultThreadCount());
+    ~AsyncPipelineCompiler();
+
+    AsyncPipelineCompiler(const AsyncPipelineCompiler &) = delete;
+    AsyncPipelineCompiler &operator=(const AsyncPipelineCompiler &) = delete;
+
+    template<typename Fn>
+    std::future<std::invoke_result_t<Fn>> enqueue(Fn &&fn)
+    {
+        using Result = std::invoke_result_t<Fn>;
+        // std::function needs a copyable target, hence the shared_ptr around the task
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+        std::future<Result> future = task->get_future();
+        {
+            std::lock_guard lock(m_mutex);
+            m_jobs.emplace_back([task] { (*task)(); });
+        }
+        m_jobAvailable.notify_one();
+        return future;
+    }
+
+    uint32_t threadCount() const noexcept { return static_cast<uint32_t>(m_threads.size()); }
+
+    static uint32_t defaultThreadCount() noexcept;
+
+private:
+    void run();
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::deque<std::function<void()>> m_jobs;
+    bool m_stopping{ false };
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace KDGpu
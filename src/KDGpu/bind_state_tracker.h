@@ -0,0 +1,152 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/gpu_core.h>
+#include <KDGpu/handle.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace KDGpu {
+
+struct BindGroup_t;
+struct Buffer_t;
+struct PipelineLayout_t;
+
+/*!
+    \struct BindStateStats
+    \brief Counters reported by RenderPassCommandRecorder::bindStateStats() and ComputePassCommandRecorder::bindStateStats()
+    \ingroup public
+    \headerfile bind_state_tracker.h <KDGpu/bind_state_tracker.h>
+
+    Pass recorders remember the pipeline, bind groups, vertex buffers and index buffer they bound.
+    Setting one of them again with the same arguments is skipped rather than recorded.
+ */
+struct BindStateStats {
+    uint64_t issuedBinds{ 0 };
+    uint64_t skippedBinds{ 0 };
+};
+
+/**
+ * @brief BindStateTracker
+ * @internal
+ *
+ * State bound by a pass recorder, compared on handles only so that a redundant
+ * bind is skipped before any resource lookup. Each bind*() function returns
+ * whether the bind changes the bound state and has to be recorded.
+ *
+ * A bind group stays bound until a bind with a different pipeline layout may
+ * have disturbed it, pushing a bind group forgets all of them.
+ */
+template<typename Pipeline>
+class BindStateTracker
+{
+public:
+    bool bindPipeline(const Handle<Pipeline> &pipeline)
+    {
+        if (pipeline == m_pipeline)
+            return skip();
+        m_pipeline = pipeline;
+        m_pipelineLayout = {};
+        return issue();
+    }
+
+    // Layout of the bound pipeline, used by bind groups set without an explicit layout
+    void setPipelineLayout(const Handle<PipelineLayout_t> &pipelineLayout) { m_pipelineLayout = pipelineLayout; }
+    const Handle<PipelineLayout_t> &pipelineLayout() const noexcept { return m_pipelineLayout; }
+
+    bool bindBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroup,
+                       const Handle<PipelineLayout_t> &pipelineLayout, std::span<const uint32_t> dynamicBufferOffsets)
+    {
+        if (group < m_bindGroups.size()) {
+            const BoundBindGroup &bound = m_bindGroups[group];
+            if (bound.bindGroup == bindGroup && bound.pipelineLayout == pipelineLayout && pipelineLayout.isValid() &&
+                std::ranges::equal(bound.dynamicBufferOffsets, dynamicBufferOffsets))
+                return skip();
+        } else {
+            m_bindGroups.resize(group + 1);
+        }
+
+        // Sets bound with another layout might not be compatible anymore
+        for (BoundBindGroup &bound : m_bindGroups) {
+            if (bound.pipelineLayout != pipelineLayout)
+                bound = {};
+        }
+        BoundBindGroup &bound = m_bindGroups[group];
+        bound.bindGroup = bindGroup;
+        bound.pipelineLayout = pipelineLayout;
+        bound.dynamicBufferOffsets.assign(dynamicBufferOffsets.begin(), dynamicBufferOffsets.end());
+        return issue();
+    }
+
+    void forgetBindGroups() { m_bindGroups.clear(); }
+
+    bool bindVertexBuffer(uint32_t index, const Handle<Buffer_t> &buffer, DeviceSize offset)
+    {
+        if (index < m_vertexBuffers.size()) {
+            const BoundBuffer &bound = m_vertexBuffers[index];
+            if (bound.buffer == buffer && bound.offset == offset)
+                return skip();
+        } else {
+            m_vertexBuffers.resize(index + 1);
+        }
+        m_vertexBuffers[index] = BoundBuffer{ .buffer = buffer, .offset = offset };
+        return issue();
+    }
+
+    bool bindIndexBuffer(const Handle<Buffer_t> &buffer, DeviceSize offset, IndexType indexType)
+    {
+        if (m_indexBuffer.buffer == buffer && m_indexBuffer.offset == offset && m_indexType == indexType)
+            return skip();
+        m_indexBuffer = BoundBuffer{ .buffer = buffer, .offset = offset };
+        m_indexType = indexType;
+        return issue();
+    }
+
+    const BindStateStats &stats() const noexcept { return m_stats; }
+
+private:
+    bool issue()
+    {
+        ++m_stats.issuedBinds;
+        return true;
+    }
+
+    bool skip()
+    {
+        ++m_stats.skippedBinds;
+        return false;
+    }
+
+    struct BoundBindGroup {
+        Handle<BindGroup_t> bindGroup;
+        Handle<PipelineLayout_t> pipelineLayout;
+        std::vector<uint32_t> dynamicBufferOffsets;
+    };
+
+    struct BoundBuffer {
+        Handle<Buffer_t> buffer;
+        DeviceSize offset{ 0 };
+    };
+
+    Handle<Pipeline> m_pipeline;
+    Handle<PipelineLayout_t> m_pipelineLayout;
+    std::vector<BoundBindGroup> m_bindGroups; // Indexed by group
+    std::vector<BoundBuffer> m_vertexBuffers; // Indexed by binding
+    BoundBuffer m_indexBuffer;
+    IndexType m_indexType{ IndexType::Uint32 };
+    BindStateStats m_stats;
+};
+
+} // namespace KDGpu
@@ -22,6 +22,8 @@ Buffer::Buffer(GraphicsApi *api, const Handle<Device_t> &device, const BufferOpt
     , m_device(device)
     , m_buffer(m_api->resourceManager()->createBuffer(m_device, options, initialData))
 {
+    if ((options.persistentlyMapped || options.hostPointer != nullptr) && isValid())
+        m_persistentMapping = m_api->resourceManager()->getBuffer(m_buffer)->mappedPointer();
 }
 
 Buffer::Buffer(Buffer &&other) noexcept
@@ -29,6 +31,8 @@ Buffer::Buffer(Buffer &&other) noexcept
     m_api = std::exchange(other.m_api, nullptr);
     m_device = std::exchange(other.m_device, {});
     m_buffer = std::exchange(other.m_buffer, {});
+    m_mapped = std::exchange(other.m_mapped, nullptr);
+    m_persistentMapping = std::exchange(other.m_persistentMapping, nullptr);
 }
 
 Buffer &Buffer::operator=(Buffer &&other) noexcept
@@ -43,6 +47,8 @@ Buffer &Buffer::operator=(Buffer &&other) noexcept
         m_api = std::exchange(other.m_api, nullptr);
         m_device = std::exchange(other.m_device, {});
         m_buffer = std::exchange(other.m_buffer, {});
+        m_mapped = std::exchange(other.m_mapped, nullptr);
+        m_persistentMapping = std::exchange(other.m_persistentMapping, nullptr);
     }
     return *this;
 }
@@ -58,6 +64,8 @@ Buffer::~Buffer()
 
 void *Buffer::map()
 {
+    if (m_persistentMapping)
+        return m_persistentMapping;
     if (!m_mapped && isValid()) {
         auto apiBuffer = m_api->resourceManager()->getBuffer(m_buffer);
         m_mapped = apiBuffer->map();
@@ -74,16 +82,16 @@ void Buffer::unmap()
     m_mapped = nullptr;
 }
 
-void Buffer::invalidate()
+void Buffer::invalidate(DeviceSize offset, DeviceSize size)
 {
     auto apiBuffer = m_api->resourceManager()->getBuffer(m_buffer);
-    apiBuffer->invalidate();
+    apiBuffer->invalidate(offset, size);
 }
 
-void Buffer::flush()
+void Buffer::flush(DeviceSize offset, DeviceSize size)
 {
     auto apiBuffer = m_api->resourceManager()->getBuffer(m_buffer);
-    apiBuffer->flush();
+    apiBuffer->flush(offset, size);
 }
 
 MemoryHandle Buffer::externalMemoryHandle() const
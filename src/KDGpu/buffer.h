@@ -69,12 +69,34 @@ struct BufferOptions;
 
     \snippet kdgpu_doc_snippets.cpp buffer_mapping_unmapping
 
+    <b>Persistently mapped buffers:</b>
+
+    Buffers updated every frame can be created with BufferOptions::persistentlyMapped. Their memory is mapped
+    once at creation and mappedPointer() returns the same pointer until the buffer is destroyed, map() and
+    unmap() then no longer map or unmap anything. On memory that is not host coherent, writes have to be made
+    visible to the device with flush() and reads preceded by invalidate(). Both accept a range so that only the
+    regions that changed are flushed. They do nothing on host coherent memory.
+
+    \snippet kdgpu_doc_snippets.cpp buffer_persistent_mapping
+
+    <b>Importing host memory:</b>
+
+    On adapters exposing a non zero ExternalMemoryHostProperties::minImportedHostPointerAlignment, a buffer can
+    be created from existing host memory with BufferOptions::hostPointer instead of allocating, e.g. to use a
+    memory mapped file as the source of Queue or CommandRecorder copies without copying it into a staging buffer
+    first. The pointer and BufferOptions::size have to be multiples of that alignment and the memory has to stay
+    valid until the buffer is destroyed. BufferOptions::externalMemoryHandleType selects between
+    ExternalMemoryHandleTypeFlagBits::HostAllocation (the default) and HostMappedForeignMemor. mappedPointer()
+    returns the host pointer. Creation returns an invalid buffer when the driver refuses the memory, callers are
+    expected to fall back to a staging buffer.
+
     <b>Buffer device addresses (for bindless):</b>
 
     \snippet kdgpu_doc_snippets.cpp buffer_device_address
 
     ## Vulkan mapping:
     - Buffer creation->vkCreateBuffer() + vkAllocateMemory() + vkBindBufferMemory()
+    - Buffer creation from BufferOptions::hostPointer->vkGetMemoryHostPointerPropertiesEXT() + vkCreateBuffer() + vkAllocateMemory() with VkImportMemoryHostPointerInfoEXT + vkBindBufferMemory()
     - Buffer::map()->vkMapMemory() - Buffer::unmap()->vkUnmapMemory()
     - Buffer::flush()->vkFlushMappedMemoryRanges()
     - Buffer::invalidate()->vkInvalidateMappedMemoryRanges()
@@ -105,8 +127,11 @@ public:
     void *map();
     void unmap();
 
-    void invalidate();
-    void flush();
+    void invalidate(DeviceSize offset = 0, DeviceSize size = WholeSize);
+    void flush(DeviceSize offset = 0, DeviceSize size = WholeSize);
+
+    // Pointer to the memory of a buffer created with BufferOptions::persistentlyMapped, nullptr otherwise
+    void *mappedPointer() const noexcept { return m_persistentMapping; }
 
     MemoryHandle externalMemoryHandle() const;
     BufferDeviceAddress bufferDeviceAddress() const;
@@ -119,6 +144,7 @@ private:
     Handle<Buffer_t> m_buffer;
 
     void *m_mapped{ nullptr };
+    void *m_persistentMapping{ nullptr };
 
     friend class Device;
     friend class Queue;
@@ -24,6 +24,10 @@ struct BufferOptions {
     SharingMode sharingMode{ SharingMode::Exclusive };
     std::vector<uint32_t> queueTypeIndices{};
     ExternalMemoryHandleTypeFlags externalMemoryHandleType{ ExternalMemoryHandleTypeFlagBits::None };
+    // Keep host visible memory mapped for the lifetime of the buffer, see Buffer::mappedPointer()
+    bool persistentlyMapped{ false };
+    // Import this host memory instead of allocating, see Buffer. It has to outlive the buffer
+    const void *hostPointer{ nullptr };
 };
 
 } // namespace KDGpu
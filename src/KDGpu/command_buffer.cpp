@@ -11,7 +11,7 @@
 #include "command_buffer.h"
 #include <KDGpu/graphics_api.h>
 
-#include <KDGpu/vulkan/vulkan_graphics_api.h>
+#include <KDGpu/api/graphics_api_impl.h>
 
 namespace KDGpu {
 
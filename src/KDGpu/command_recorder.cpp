@@ -67,6 +67,11 @@ RenderPassCommandRecorder CommandRecorder::beginRenderPass(const RenderPassComma
     return RenderPassCommandRecorder(m_api, m_device, m_api->resourceManager()->createRenderPassCommandRecorder(m_device, m_commandRecorder, options));
 }
 
+RenderPassCommandRecorder CommandRecorder::continueRenderPass() const
+{
+    return RenderPassCommandRecorder(m_api, m_device, m_api->resourceManager()->createInheritedRenderPassCommandRecorder(m_device, m_commandRecorder));
+}
+
 ComputePassCommandRecorder CommandRecorder::beginComputePass(const ComputePassCommandRecorderOptions &options) const
 {
     return ComputePassCommandRecorder(m_api, m_device, m_api->resourceManager()->createComputePassCommandRecorder(m_device, m_commandRecorder, options));
@@ -154,6 +159,14 @@ void CommandRecorder::textureMemoryBarrier(const TextureMemoryBarrierOptions &op
     apiCommandRecorder->textureMemoryBarrier(options);
 }
 
+void CommandRecorder::textureMemoryBarriers(std::span<const TextureMemoryBarrierOptions> options) const
+{
+    if (options.empty())
+        return;
+    auto *apiCommandRecorder = m_api->resourceManager()->getCommandRecorder(m_commandRecorder);
+    apiCommandRecorder->textureMemoryBarriers(options);
+}
+
 CommandBuffer CommandRecorder::finish() const
 {
     auto *apiCommandRecorder = m_api->resourceManager()->getCommandRecorder(m_commandRecorder);
@@ -22,17 +22,24 @@
 #include <KDGpu/memory_barrier.h>
 #include <KDGpu/acceleration_structure_options.h>
 
+#include <span>
+
 namespace KDGpu {
 
 class VulkanGraphicsApi;
 
 struct CommandRecorder_t;
 struct Device_t;
+struct FrameCommandAllocator_t;
 struct Queue_t;
 
 struct CommandRecorderOptions {
     Handle<Queue_t> queue; // The queue on which you wish to submit the recorded commands. If not set, defaults to first queue of the device
     CommandBufferLevel level{ CommandBufferLevel::Primary };
+    // If set, the command buffer comes from the current frame of this allocator and queue is ignored in favor of its queue
+    Handle<FrameCommandAllocator_t> frameCommandAllocator;
+    // If set on a secondary command buffer, it is recorded to be executed within this render pass, see continueRenderPass()
+    std::optional<RenderPassInheritance> renderPassInheritance;
 };
 
 struct BufferCopy {
@@ -163,6 +170,13 @@ struct ClearDepthStencilTexture {
     <b>Lifetime:</b> Create a CommandRecorder when you need to record work, then call finish() to get
     the CommandBuffer. The recorder itself can be discarded after finish().
 
+    <br/>
+    <b>Threading:</b> Command buffers are allocated from a command pool per thread and queue family, so
+    separate CommandRecorders can record on several threads at once when KDGpu is built with
+    KDGPU_CONCURRENT_RESOURCE_MANAGER. To split one render pass across threads, record secondary command
+    buffers created with CommandRecorderOptions::renderPassInheritance through continueRenderPass(), then
+    execute them within a render pass begun with RenderPassCommandRecorderWithDynamicRenderingOptions::secondaryCommandBuffers.
+
     ## Usage
 
     <b>Basic command recording:</b>
@@ -198,7 +212,9 @@ struct ClearDepthStencilTexture {
     - CommandRecorder::finish() -> vkEndCommandBuffer()
     - CommandRecorder::copyBuffer() -> vkCmdCopyBuffer()
     - CommandRecorder::textureMemoryBarrier() -> vkCmdPipelineBarrier()
+    - CommandRecorder::textureMemoryBarriers() -> vkCmdPipelineBarrier()
     - CommandRecorder::beginRenderPass() -> vkCmdBeginRenderPass()
+    - CommandRecorder::continueRenderPass() -> VkCommandBufferInheritanceRenderingInfo
 
     ## See also:
     \sa CommandRecorderOptions, CommandBuffer, RenderPassCommandRecorder, ComputePassCommandRecorder, Queue, Device
@@ -224,6 +240,8 @@ public:
     RenderPassCommandRecorder beginRenderPass(const RenderPassCommandRecorderOptions &options) const;
     RenderPassCommandRecorder beginRenderPass(const RenderPassCommandRecorderWithRenderPassOptions &options) const;
     RenderPassCommandRecorder beginRenderPass(const RenderPassCommandRecorderWithDynamicRenderingOptions &options) const;
+    // Records draws of a secondary command buffer created with CommandRecorderOptions::renderPassInheritance
+    RenderPassCommandRecorder continueRenderPass() const;
 
     [[nodiscard]] ComputePassCommandRecorder beginComputePass(const ComputePassCommandRecorderOptions &options = {}) const;
     [[nodiscard]] RayTracingPassCommandRecorder beginRayTracingPass(const RayTracingPassCommandRecorderOptions &options = {}) const;
@@ -240,6 +258,8 @@ public:
     void memoryBarrier(const MemoryBarrierOptions &options) const;
     void bufferMemoryBarrier(const BufferMemoryBarrierOptions &options) const;
     void textureMemoryBarrier(const TextureMemoryBarrierOptions &options) const;
+    // Records all barriers with a single pipeline barrier
+    void textureMemoryBarriers(std::span<const TextureMemoryBarrierOptions> options) const;
     void executeSecondaryCommandBuffer(const Handle<CommandBuffer_t> &secondaryCommandBuffer) const;
     void resolveTexture(const TextureResolveOptions &options) const;
     void buildAccelerationStructures(const BuildAccelerationStructureOptions &options) const;
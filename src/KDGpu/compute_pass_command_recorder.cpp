@@ -106,4 +106,10 @@ void ComputePassCommandRecorder::end()
     apiComputePassCommandRecorder->end();
 }
 
+BindStateStats ComputePassCommandRecorder::bindStateStats() const
+{
+    auto *apiComputePassCommandRecorder = m_api->resourceManager()->getComputePassCommandRecorder(m_computePassCommandRecorder);
+    return apiComputePassCommandRecorder->bindStateStats();
+}
+
 } // namespace KDGpu
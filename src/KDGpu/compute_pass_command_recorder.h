@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <KDGpu/bind_state_tracker.h>
 #include <KDGpu/gpu_core.h>
 #include <KDGpu/handle.h>
 #include <KDGpu/kdgpu_export.h>
@@ -82,6 +83,9 @@ public:
 
     void end();
 
+    // Redundant setPipeline() and setBindGroup() calls are skipped rather than recorded
+    BindStateStats bindStateStats() const;
+
 private:
     explicit ComputePassCommandRecorder(GraphicsApi *api,
                                         const Handle<Device_t> &device,
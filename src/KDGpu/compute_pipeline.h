@@ -95,6 +95,9 @@ private:
     explicit ComputePipeline(GraphicsApi *api,
                              const Handle<Device_t> &device,
                              const ComputePipelineOptions &options);
+    explicit ComputePipeline(GraphicsApi *api,
+                             const Handle<Device_t> &device,
+                             const Handle<ComputePipeline_t> &computePipeline);
 
     GraphicsApi *m_api{ nullptr };
     Handle<Device_t> m_device;
@@ -12,7 +12,9 @@
 
 #include <KDGpu/handle.h>
 #include <KDGpu/gpu_core.h>
+#include <KDFoundation/hashutils.h>
 
+#include <string>
 #include <vector>
 
 namespace KDGpu {
@@ -25,6 +27,8 @@ struct ComputeShaderStage {
     RequiredHandle<ShaderModule_t> shaderModule;
     std::string entryPoint{ "main" };
     std::vector<SpecializationConstant> specializationConstants;
+
+    friend bool operator==(const ComputeShaderStage &, const ComputeShaderStage &) = default;
 };
 
 struct ComputePipelineOptions {
@@ -34,6 +38,40 @@ struct ComputePipelineOptions {
 
     // Optional pipeline cache to speed up pipeline creation
     OptionalHandle<PipelineCache_t> pipelineCache;
+
+    friend bool operator==(const ComputePipelineOptions &, const ComputePipelineOptions &) = default;
 };
 
 } // namespace KDGpu
+
+namespace std {
+
+template<>
+struct hash<KDGpu::ComputeShaderStage> {
+    size_t operator()(const KDGpu::ComputeShaderStage &stage) const noexcept
+    {
+        uint64_t hash = 0;
+        KDFoundation::hash_combine(hash, std::hash<std::string>()(stage.entryPoint));
+        KDFoundation::hash_combine(hash, std::hash<KDGpu::Handle<KDGpu::ShaderModule_t>>()(stage.shaderModule));
+        for (const auto &specConst : stage.specializationConstants) {
+            KDFoundation::hash_combine(hash, specConst.constantId);
+            std::visit([&hash](const auto &value) { KDFoundation::hash_combine(hash, value); }, specConst.value);
+        }
+        return hash;
+    }
+};
+
+template<>
+struct hash<KDGpu::ComputePipelineOptions> {
+    size_t operator()(const KDGpu::ComputePipelineOptions &options) const noexcept
+    {
+        uint64_t hash = 0;
+        KDFoundation::hash_combine(hash, std::hash<std::string_view>()(options.label));
+        KDFoundation::hash_combine(hash, options.layout);
+        KDFoundation::hash_combine(hash, options.shaderStage);
+        KDFoundation::hash_combine(hash, options.pipelineCache);
+        return hash;
+    }
+};
+
+} // namespace std
@@ -0,0 +1,293 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include "handle.h"
+
+#include <KDGpu/utils/logging.h>
+
+#include <assert.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace KDGpu {
+
+/**
+ * @brief ConcurrentPool
+ * @internal
+ *
+ * Thread-safe counterpart of ChunkedPool. emplace(), remove() and get() can be
+ * called concurrently from several threads.
+ *
+ * - Objects live in fixed-size chunks referenced from a two level chunk
+ *   directory. Chunks and directory blocks are allocated on demand and never
+ *   moved nor freed before the pool is destroyed, so get() is lock-free and
+ *   pointers stay valid for the lifetime of the slot. An empty pool only
+ *   costs the top level of the directory.
+ * - Fresh indices are handed out with a single atomic increment.
+ * - Released indices go to one of ShardCount free lists, picked per thread,
+ *   each with its own mutex. Threads therefore only contend when they share
+ *   a shard or when their own shard is empty and they steal from another.
+ *
+ * Using a handle from one thread while another thread removes it is still a
+ * usage error, exactly as it would be for the underlying Vulkan object.
+ *
+ * The pool holds at most ChunkSize * MaxChunkCount objects. Past that, emplace()
+ * logs an error and returns an invalid handle.
+ */
+template<typename T, typename H, uint32_t ChunkSize = 256, uint32_t MaxChunkCount = 4096>
+class ConcurrentPool
+{
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
+public:
+    ConcurrentPool() noexcept = default;
+
+    explicit ConcurrentPool(uint32_t size)
+    {
+        const uint32_t chunkCount = std::min((size + ChunkSize - 1) / ChunkSize, MaxChunkCount);
+        for (uint32_t i = 0; i < chunkCount; ++i)
+            ensureChunk(i);
+    }
+
+    ~ConcurrentPool()
+    {
+        const uint32_t chunkCount = m_chunkCount.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < chunkCount; ++i) {
+            Chunk *chunk = chunkFor(i * ChunkSize);
+            for (uint32_t j = 0; j < ChunkSize; ++j) {
+                if (chunk->entries[j].isAlive.load(std::memory_order_relaxed))
+                    chunk->object(j)->~T();
+            }
+            delete chunk;
+        }
+        for (std::atomic<DirectoryBlock *> &block : m_directory)
+            delete block.load(std::memory_order_acquire);
+    }
+
+    ConcurrentPool(ConcurrentPool const &other) = delete;
+    ConcurrentPool &operator=(ConcurrentPool const &other) = delete;
+    ConcurrentPool(ConcurrentPool &&other) = delete;
+    ConcurrentPool &operator=(ConcurrentPool &&other) = delete;
+
+    uint32_t capacity() const noexcept { return m_chunkCount.load(std::memory_order_acquire) * ChunkSize; }
+    uint32_t size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+
+    T *get(const Handle<H> &handle) const noexcept
+    {
+        const Entry *entry = entryFor(handle.m_index);
+        if (entry == nullptr ||
+            !entry->isAlive.load(std::memory_order_acquire) ||
+            entry->generation.load(std::memory_order_acquire) != handle.m_generation)
+            return nullptr;
+        return chunkFor(handle.m_index)->object(handle.m_index % ChunkSize);
+    }
+
+    template<typename... Args>
+    Handle<H> emplace(Args &&...args)
+    {
+        uint32_t index = 0;
+        if (!popFreeIndex(index)) {
+            // Never hand out an index past the chunk directory, even when called again after failing
+            index = m_nextIndex.load(std::memory_order_relaxed);
+            do {
+                if (index >= MaxIndexCount) {
+                    SPDLOG_LOGGER_ERROR(Logger::logger(), "ConcurrentPool is full, unable to allocate more than {} objects", MaxIndexCount);
+                    return {};
+                }
+            } while (!m_nextIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+            ensureChunk(index / ChunkSize);
+        }
+
+        Chunk *chunk = chunkFor(index);
+        const uint32_t slot = index % ChunkSize;
+        try {
+            ::new (static_cast<void *>(chunk->object(slot))) T(std::forward<Args>(args)...);
+        } catch (...) {
+            pushFreeIndex(index);
+            throw;
+        }
+
+        // Publish the object, the generation was set when the chunk was created or bumped on removal
+        Entry &entry = chunk->entries[slot];
+        const uint32_t generation = entry.generation.load(std::memory_order_relaxed);
+        entry.isAlive.store(true, std::memory_order_release);
+        m_size.fetch_add(1, std::memory_order_relaxed);
+
+        return Handle<H>(index, generation);
+    }
+
+    Handle<H> insert(const T &data)
+    {
+        return emplace(data);
+    }
+
+    void remove(const Handle<H> &handle)
+    {
+        Entry *entry = entryFor(handle.m_index);
+        if (entry == nullptr || !entry->isAlive.load(std::memory_order_acquire))
+            return;
+
+        // Bump the generation so we know not to deref this data from any existing handles.
+        // Doing it with a CAS also ensures only one of several threads removing the same handle wins.
+        uint32_t generation = handle.m_generation;
+        if (!entry->generation.compare_exchange_strong(generation, generation + 1, std::memory_order_acq_rel))
+            return;
+        entry->isAlive.store(false, std::memory_order_release);
+
+        chunkFor(handle.m_index)->object(handle.m_index % ChunkSize)->~T();
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+
+        pushFreeIndex(handle.m_index);
+    }
+
+    void clear()
+    {
+        const uint32_t indexCount = std::min(m_nextIndex.load(std::memory_order_acquire), capacity());
+        for (uint32_t i = 0; i < indexCount; ++i)
+            remove(handleForIndex(i));
+    }
+
+    // Convert an entry index into a Handle<H>, if possible otherwise returns an invalid handle
+    Handle<H> handleForIndex(uint32_t entryIndex) const
+    {
+        const Entry *entry = entryFor(entryIndex);
+        if (entry == nullptr || !entry->isAlive.load(std::memory_order_acquire))
+            return {};
+        return Handle<H>{ entryIndex, entry->generation.load(std::memory_order_acquire) };
+    }
+
+private:
+    static constexpr uint32_t ShardCount = 8;
+    static constexpr uint32_t MaxIndexCount = ChunkSize * MaxChunkCount;
+    static constexpr uint32_t DirectoryBlockSize = 64;
+    static constexpr uint32_t DirectoryBlockCount = (MaxChunkCount + DirectoryBlockSize - 1) / DirectoryBlockSize;
+
+    struct Entry {
+        std::atomic<uint32_t> generation{ 1 };
+        std::atomic<bool> isAlive{ false };
+    };
+
+    struct Chunk {
+        T *object(uint32_t slot) noexcept
+        {
+            return std::launder(reinterpret_cast<T *>(storage + sizeof(T) * slot));
+        }
+
+        std::array<Entry, ChunkSize> entries;
+        alignas(T) std::byte storage[sizeof(T) * ChunkSize];
+    };
+
+    struct DirectoryBlock {
+        std::array<std::atomic<Chunk *>, DirectoryBlockSize> chunks{};
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<uint32_t> freeIndices;
+    };
+
+    Chunk *chunkFor(uint32_t index) const noexcept
+    {
+        const uint32_t chunkIndex = index / ChunkSize;
+        const DirectoryBlock *block = m_directory[chunkIndex / DirectoryBlockSize].load(std::memory_order_acquire);
+        return block ? block->chunks[chunkIndex % DirectoryBlockSize].load(std::memory_order_acquire) : nullptr;
+    }
+
+    Entry *entryFor(uint32_t index) const noexcept
+    {
+        if (index / ChunkSize >= MaxChunkCount)
+            return nullptr;
+        Chunk *chunk = chunkFor(index);
+        return chunk ? &chunk->entries[index % ChunkSize] : nullptr;
+    }
+
+    void ensureChunk(uint32_t chunkIndex)
+    {
+        if (chunkFor(chunkIndex * ChunkSize) != nullptr)
+            return;
+
+        // Chunks are published in order so that capacity() and the dtor can walk them
+        std::lock_guard lock(m_growMutex);
+        for (uint32_t i = m_chunkCount.load(std::memory_order_relaxed); i <= chunkIndex; ++i) {
+            std::atomic<DirectoryBlock *> &block = m_directory[i / DirectoryBlockSize];
+            if (block.load(std::memory_order_relaxed) == nullptr)
+                block.store(new DirectoryBlock, std::memory_order_release);
+            block.load(std::memory_order_relaxed)->chunks[i % DirectoryBlockSize].store(new Chunk, std::memory_order_release);
+            m_chunkCount.store(i + 1, std::memory_order_release);
+        }
+    }
+
+    static uint32_t currentShard() noexcept
+    {
+        thread_local const uint32_t shard = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()) % ShardCount);
+        return shard;
+    }
+
+    void pushFreeIndex(uint32_t index)
+    {
+        Shard &shard = m_shards[currentShard()];
+        std::lock_guard lock(shard.mutex);
+        shard.freeIndices.push_back(index);
+    }
+
+    bool popFreeIndex(uint32_t &index)
+    {
+        // Prefer our own shard, then try to steal from the others so that
+        // indices released by one thread get reused by the others.
+        const uint32_t first = currentShard();
+        for (uint32_t i = 0; i < ShardCount; ++i) {
+            Shard &shard = m_shards[(first + i) % ShardCount];
+            std::unique_lock lock(shard.mutex, std::defer_lock);
+            if (i == 0)
+                lock.lock();
+            else if (!lock.try_lock())
+                continue;
+            if (!shard.freeIndices.empty()) {
+                index = shard.freeIndices.back();
+                shard.freeIndices.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::array<std::atomic<DirectoryBlock *>, DirectoryBlockCount> m_directory{};
+    std::atomic<uint32_t> m_chunkCount{ 0 };
+    std::atomic<uint32_t> m_nextIndex{ 0 };
+    std::atomic<uint32_t> m_size{ 0 };
+    std::mutex m_growMutex;
+    std::array<Shard, ShardCount> m_shards;
+};
+
+/**
+ * @brief NullMutex
+ * @internal
+ *
+ * Stand-in for std::mutex when the resource manager is built without
+ * KDGPU_CONCURRENT_RESOURCE_MANAGER, so that locking compiles to nothing.
+ */
+struct NullMutex {
+    void lock() noexcept { }
+    void unlock() noexcept { }
+    bool try_lock() noexcept { return true; }
+};
+
+} // namespace KDGpu
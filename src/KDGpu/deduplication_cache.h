@@ -0,0 +1,149 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/handle.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace KDGpu {
+
+/*!
+    \struct DeduplicationStats
+    \brief Counters reported by Device::samplerDeduplicationStats() and Device::bindGroupLayoutDeduplicationStats()
+    \ingroup public
+    \headerfile deduplication_cache.h <KDGpu/deduplication_cache.h>
+
+    A hit is a creation request that was answered with an existing object,
+    a miss is one that had to create a new object.
+ */
+struct DeduplicationStats {
+    uint64_t hits{ 0 };
+    uint64_t misses{ 0 };
+    size_t cachedObjects{ 0 };
+};
+
+/**
+ * @brief DeduplicationCache
+ * @internal
+ *
+ * Maps creation options to a reference counted handle so that identical
+ * requests share a single object. Options must provide operator== and be
+ * hashable by Hash. A string_view label, if any, is copied into the cache
+ * since the options only hold a view onto it.
+ *
+ * The cache does no locking of its own.
+ */
+template<typename Options, typename T, typename Hash = std::hash<Options>>
+class DeduplicationCache
+{
+public:
+    // Returns the cached object for options and takes a reference on it,
+    // or an invalid handle if there is none yet
+    Handle<T> acquire(const Options &options)
+    {
+        const Handle<T> handle = reference(options);
+        if (handle.isValid())
+            ++m_stats.hits;
+        else
+            ++m_stats.misses;
+        return handle;
+    }
+
+    // Adds a newly created object holding refCount references
+    void insert(const Options &options, const Handle<T> &handle, uint32_t refCount = 1)
+    {
+        const size_t hash = Hash()(options);
+        auto [it, inserted] = m_entries.try_emplace(handle, Entry{ .options = options, .hash = hash, .refCount = refCount });
+        if (!inserted)
+            return;
+        if constexpr (requires { options.label; }) {
+            // Point the stored label at our own copy
+            it->second.label = std::string(options.label);
+            it->second.options.label = it->second.label;
+        }
+        m_handlesByHash.emplace(hash, handle);
+    }
+
+    // Returns the cached object for options, or calls create() and caches what it returns
+    template<typename CreateFn>
+    Handle<T> getOrCreate(const Options &options, CreateFn &&create)
+    {
+        if (const Handle<T> handle = acquire(options); handle.isValid())
+            return handle;
+        const Handle<T> handle = create();
+        if (handle.isValid())
+            insert(options, handle);
+        return handle;
+    }
+
+    // Drops a reference. Returns true if the caller should destroy the object,
+    // which is also the case for objects that were never added to the cache
+    bool release(const Handle<T> &handle)
+    {
+        auto entryIt = m_entries.find(handle);
+        if (entryIt == m_entries.end())
+            return true;
+        if (--entryIt->second.refCount > 0)
+            return false;
+
+        const auto [begin, end] = m_handlesByHash.equal_range(entryIt->second.hash);
+        for (auto it = begin; it != end; ++it) {
+            if (it->second == handle) {
+                m_handlesByHash.erase(it);
+                break;
+            }
+        }
+        m_entries.erase(entryIt);
+        return true;
+    }
+
+    DeduplicationStats stats() const
+    {
+        DeduplicationStats stats = m_stats;
+        stats.cachedObjects = m_entries.size();
+        return stats;
+    }
+
+protected:
+    // Same as acquire(), without counting a hit or a miss
+    Handle<T> reference(const Options &options)
+    {
+        const size_t hash = Hash()(options);
+        const auto [begin, end] = m_handlesByHash.equal_range(hash);
+        for (auto it = begin; it != end; ++it) {
+            Entry &entry = m_entries.at(it->second);
+            if (entry.options == options) {
+                ++entry.refCount;
+                return it->second;
+            }
+        }
+        return {};
+    }
+
+    DeduplicationStats m_stats;
+
+private:
+    struct Entry {
+        std::string label;
+        Options options;
+        size_t hash{ 0 };
+        uint32_t refCount{ 1 };
+    };
+
+    std::unordered_map<Handle<T>, Entry> m_entries;
+    std::unordered_multimap<size_t, Handle<T>> m_handlesByHash;
+};
+
+} // namespace KDGpu
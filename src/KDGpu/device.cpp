@@ -11,12 +11,51 @@
 #include "device.h"
 
 #include <KDGpu/adapter.h>
+#include <KDGpu/async_pipeline_compiler.h>
+#include <KDGpu/compute_pipeline_options.h>
 #include <KDGpu/device_options.h>
+#include <KDGpu/graphics_pipeline_options.h>
+#include <KDGpu/pipeline_state_observer.h>
 #include <KDGpu/api/graphics_api_impl.h>
 #include <KDGpu/swapchain_options.h>
+#include <KDGpu/utils/logging.h>
+
+#include <mutex>
+#include <string>
+
+// Pipelines are only compiled on worker threads when the backend allows
+// resources to be created from several threads at once
+#if defined(KDGPU_CONCURRENT_RESOURCE_MANAGER) && !defined(KDGPU_NULL_BACKEND)
+#define KDGPU_ASYNC_PIPELINE_COMPILATION
+#endif
 
 namespace KDGpu {
 
+struct Device::AsyncPipelineCompilation {
+    std::once_flag initialized;
+    // Used by asynchronously compiled pipelines that don't specify their own cache
+    PipelineCache pipelineCache;
+    std::unique_ptr<AsyncPipelineCompiler> compiler;
+
+    template<typename Compile>
+    std::future<std::invoke_result_t<Compile>> run(Compile &&compile)
+    {
+#if defined(KDGPU_ASYNC_PIPELINE_COMPILATION)
+        return compiler->enqueue(std::forward<Compile>(compile));
+#else
+        return ready(compile());
+#endif
+    }
+
+    template<typename T>
+    static std::future<T> ready(T &&value)
+    {
+        std::promise<T> promise;
+        promise.set_value(std::move(value));
+        return promise.get_future();
+    }
+};
+
 /**
     @fn Device::handle()
     @brief Returns the handle used to retrieve the underlying API specific Device
@@ -56,6 +95,8 @@ Device::Device(Adapter *adapter, GraphicsApi *api, const DeviceOptions &options)
     m_queues.reserve(queueCount);
     for (uint32_t i = 0; i < queueCount; ++i)
         m_queues.emplace_back(Queue(m_api, m_device, queueDescriptions[i]));
+
+    m_asyncPipelineCompilation = std::make_unique<AsyncPipelineCompilation>();
 }
 
 Device::Device(Device &&other) noexcept
@@ -64,11 +105,15 @@ Device::Device(Device &&other) noexcept
     m_device = std::exchange(other.m_device, {});
     m_queues = std::exchange(other.m_queues, {});
     m_adapter = std::exchange(other.m_adapter, {});
+    m_pipelineStateObserver = std::exchange(other.m_pipelineStateObserver, nullptr);
+    m_asyncPipelineCompilation = std::exchange(other.m_asyncPipelineCompilation, {});
 }
 
 Device &Device::operator=(Device &&other) noexcept
 {
     if (this != &other) {
+        // Finish pending compilations and release the shared cache while the device is still alive
+        m_asyncPipelineCompilation.reset();
         if (isValid())
             m_api->resourceManager()->deleteDevice(handle());
 
@@ -76,12 +121,15 @@ Device &Device::operator=(Device &&other) noexcept
         m_device = std::exchange(other.m_device, {});
         m_queues = std::exchange(other.m_queues, {});
         m_adapter = std::exchange(other.m_adapter, {});
+        m_pipelineStateObserver = std::exchange(other.m_pipelineStateObserver, nullptr);
+        m_asyncPipelineCompilation = std::exchange(other.m_asyncPipelineCompilation, {});
     }
     return *this;
 }
 
 Device::~Device()
 {
+    m_asyncPipelineCompilation.reset();
     if (isValid())
         m_api->resourceManager()->deleteDevice(handle());
 }
@@ -91,6 +139,17 @@ const Adapter *Device::adapter() const
     return m_adapter;
 }
 
+/**
+ * @brief Returns the features requested in DeviceOptions::requestedFeatures.
+ *
+ * Unlike Adapter::features(), which lists what the adapter could enable, these are the
+ * features the Device was created with and that can actually be used with it.
+ */
+const AdapterFeatures &Device::enabledFeatures() const
+{
+    return m_api->resourceManager()->getDevice(m_device)->requestedFeatures;
+}
+
 /**
  * @brief Forces a CPU side blocking wait until the underlying device has completed execution of all its pending commands.
  */
@@ -115,9 +174,19 @@ Buffer Device::createBuffer(const BufferOptions &options, const void *initialDat
     return Buffer(m_api, m_device, options, initialData);
 }
 
+/**
+ * @brief Creates a ShaderModule from SPIR-V code
+ *
+ * Shader modules are shared between identical code: if a ShaderModule created from the
+ * same words is still alive, the returned object refers to the same underlying module,
+ * which is only destroyed once the last ShaderModule referring to it goes away.
+ */
 ShaderModule Device::createShaderModule(const std::vector<uint32_t> &code)
 {
-    return ShaderModule(m_api, m_device, code);
+    ShaderModule shaderModule(m_api, m_device, code);
+    if (m_pipelineStateObserver && shaderModule.isValid())
+        m_pipelineStateObserver->shaderModuleCreated(shaderModule.handle(), code);
+    return shaderModule;
 }
 
 RenderPass Device::createRenderPass(const RenderPassOptions &options)
@@ -127,16 +196,23 @@ RenderPass Device::createRenderPass(const RenderPassOptions &options)
 
 PipelineLayout Device::createPipelineLayout(const PipelineLayoutOptions &options)
 {
-    return PipelineLayout(m_api, m_device, options);
+    PipelineLayout pipelineLayout(m_api, m_device, options);
+    if (m_pipelineStateObserver && pipelineLayout.isValid())
+        m_pipelineStateObserver->pipelineLayoutCreated(pipelineLayout.handle(), options);
+    return pipelineLayout;
 }
 
 GraphicsPipeline Device::createGraphicsPipeline(const GraphicsPipelineOptions &options)
 {
+    if (m_pipelineStateObserver)
+        m_pipelineStateObserver->graphicsPipelineRequested(options);
     return GraphicsPipeline(m_api, m_device, options);
 }
 
 ComputePipeline Device::createComputePipeline(const ComputePipelineOptions &options)
 {
+    if (m_pipelineStateObserver)
+        m_pipelineStateObserver->computePipelineRequested(options);
     return ComputePipeline(m_api, m_device, options);
 }
 
@@ -145,11 +221,182 @@ RayTracingPipeline Device::createRayTracingPipeline(const RayTracingPipelineOpti
     return RayTracingPipeline(m_api, m_device, options);
 }
 
+/**
+ * @brief Creates a GraphicsPipeline on a worker thread and returns a future for it.
+ *
+ * @a options are copied, so the caller doesn't need to keep them alive. Pipelines that don't
+ * specify a PipelineCache are compiled with a cache shared by all asynchronous compilations on
+ * this Device. All pending compilations are completed before the Device is destroyed, however
+ * the returned futures must not outlive the Device.
+ *
+ * Compiling on worker threads requires KDGpu to be built with KDGPU_CONCURRENT_RESOURCE_MANAGER.
+ * Otherwise the pipeline is created before this function returns and the future is ready.
+ */
+std::future<GraphicsPipeline> Device::createGraphicsPipelineAsync(const GraphicsPipelineOptions &options)
+{
+    if (m_pipelineStateObserver)
+        m_pipelineStateObserver->graphicsPipelineRequested(options);
+    AsyncPipelineCompilation *compilation = asyncPipelineCompilation();
+    if (!compilation)
+        return AsyncPipelineCompilation::ready(GraphicsPipeline());
+    return compilation->run([api = m_api, device = m_device, options = options, label = std::string(options.label),
+                             sharedCache = compilation->pipelineCache.handle()]() mutable {
+        // The options only hold a view onto the label, point it at our own copy
+        options.label = label;
+        if (!options.pipelineCache.isValid())
+            options.pipelineCache = sharedCache;
+        return GraphicsPipeline(api, device, options);
+    });
+}
+
+/**
+ * @brief ComputePipeline counterpart of createGraphicsPipelineAsync()
+ */
+std::future<ComputePipeline> Device::createComputePipelineAsync(const ComputePipelineOptions &options)
+{
+    if (m_pipelineStateObserver)
+        m_pipelineStateObserver->computePipelineRequested(options);
+    AsyncPipelineCompilation *compilation = asyncPipelineCompilation();
+    if (!compilation)
+        return AsyncPipelineCompilation::ready(ComputePipeline());
+    return compilation->run([api = m_api, device = m_device, options = options, label = std::string(options.label),
+                             sharedCache = compilation->pipelineCache.handle()]() mutable {
+        options.label = label;
+        if (!options.pipelineCache.isValid())
+            options.pipelineCache = sharedCache;
+        return ComputePipeline(api, device, options);
+    });
+}
+
+Device::AsyncPipelineCompilation *Device::asyncPipelineCompilation()
+{
+    // Default constructed and moved from devices have nothing to compile pipelines for
+    if (!m_asyncPipelineCompilation) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Asynchronous pipeline creation requested on an invalid Device");
+        return nullptr;
+    }
+
+    // Only pay for the cache and the worker threads once asynchronous compilation is used
+    std::call_once(m_asyncPipelineCompilation->initialized, [this] {
+        m_asyncPipelineCompilation->pipelineCache = createPipelineCache(PipelineCacheOptions{ .label = "KDGpu async pipeline cache" });
+#if defined(KDGPU_ASYNC_PIPELINE_COMPILATION)
+        m_asyncPipelineCompilation->compiler = std::make_unique<AsyncPipelineCompiler>();
+#endif
+    });
+    return m_asyncPipelineCompilation.get();
+}
+
+/**
+ * @brief Returns a GraphicsPipeline for @a options, sharing an existing one if a pipeline with
+ * identical options was previously requested through this function and is still alive.
+ *
+ * Shared pipelines are reference counted and only destroyed once the last GraphicsPipeline
+ * referencing them goes away. Pipelines made with createGraphicsPipeline() are never shared.
+ */
+GraphicsPipeline Device::getOrCreateGraphicsPipeline(const GraphicsPipelineOptions &options)
+{
+    if (m_pipelineStateObserver)
+        m_pipelineStateObserver->graphicsPipelineRequested(options);
+    return GraphicsPipeline(m_api, m_device, m_api->resourceManager()->getOrCreateGraphicsPipeline(m_device, options));
+}
+
+/**
+ * @brief ComputePipeline counterpart of getOrCreateGraphicsPipeline()
+ */
+ComputePipeline Device::getOrCreateComputePipeline(const ComputePipelineOptions &options)
+{
+    if (m_pipelineStateObserver)
+        m_pipelineStateObserver->computePipelineRequested(options);
+    return ComputePipeline(m_api, m_device, m_api->resourceManager()->getOrCreateComputePipeline(m_device, options));
+}
+
+/**
+ * @brief RayTracingPipeline counterpart of getOrCreateGraphicsPipeline()
+ */
+RayTracingPipeline Device::getOrCreateRayTracingPipeline(const RayTracingPipelineOptions &options)
+{
+    return RayTracingPipeline(m_api, m_device, m_api->resourceManager()->getOrCreateRayTracingPipeline(m_device, options));
+}
+
+/**
+ * @brief Returns hit and miss counts of the getOrCreate*Pipeline() functions, summed over
+ * graphics, compute and ray tracing pipelines, along with the number of shared pipelines alive.
+ */
+PipelineDeduplicationStats Device::pipelineDeduplicationStats() const
+{
+    return m_api->resourceManager()->pipelineDeduplicationStats(m_device);
+}
+
+/**
+ * @brief Returns hit and miss counts of createShaderModule() lookups, along with the number
+ * of distinct shader modules alive.
+ */
+ShaderModuleDeduplicationStats Device::shaderModuleDeduplicationStats() const
+{
+    return m_api->resourceManager()->shaderModuleDeduplicationStats(m_device);
+}
+
+/**
+ * @brief Returns hit and miss counts of createSampler() lookups, along with the number of
+ * distinct samplers alive.
+ *
+ * Samplers created from identical options share a single underlying sampler.
+ */
+DeduplicationStats Device::samplerDeduplicationStats() const
+{
+    return m_api->resourceManager()->samplerDeduplicationStats(m_device);
+}
+
+/**
+ * @brief Returns hit and miss counts of createBindGroupLayout() lookups, along with the number
+ * of distinct bind group layouts alive.
+ *
+ * Bind group layouts created from identical options share a single underlying layout.
+ */
+DeduplicationStats Device::bindGroupLayoutDeduplicationStats() const
+{
+    return m_api->resourceManager()->bindGroupLayoutDeduplicationStats(m_device);
+}
+
+/**
+ * @brief Returns hit, miss and eviction counts of the render passes created when beginning a
+ * render pass from RenderPassCommandRecorderOptions, along with the number of them alive.
+ *
+ * The capacity of the cache is set with DeviceOptions::renderTargetCache.
+ */
+RenderTargetCacheStats Device::renderPassCacheStats() const
+{
+    return m_api->resourceManager()->renderPassCacheStats(m_device);
+}
+
+/**
+ * @brief Returns hit, miss and eviction counts of the framebuffers created when beginning a
+ * render pass, along with the number of them alive.
+ *
+ * The capacity of the cache is set with DeviceOptions::renderTargetCache.
+ */
+RenderTargetCacheStats Device::framebufferCacheStats() const
+{
+    return m_api->resourceManager()->framebufferCacheStats(m_device);
+}
+
 CommandRecorder Device::createCommandRecorder(const CommandRecorderOptions &options)
 {
     return CommandRecorder(m_api, m_device, options);
 }
 
+/**
+ * @brief Destroys the command pools of the threads that have no command buffer alive.
+ *
+ * Every thread creating command recorders allocates from command pools of its own, which
+ * otherwise live as long as the Device. Call this once worker threads have exited, or after
+ * a burst of recording, to give their memory back. Threads recording again get new pools.
+ */
+void Device::releaseThreadCommandPools()
+{
+    m_api->resourceManager()->releaseThreadCommandPools(m_device);
+}
+
 GpuSemaphore Device::createGpuSemaphore(const GpuSemaphoreOptions &options)
 {
     return GpuSemaphore(m_api, m_device, options);
@@ -162,7 +409,10 @@ TimelineSemaphore Device::createTimelineSemaphore(const TimelineSemaphoreOptions
 
 BindGroupLayout Device::createBindGroupLayout(const BindGroupLayoutOptions &options)
 {
-    return BindGroupLayout(m_api, m_device, options);
+    BindGroupLayout bindGroupLayout(m_api, m_device, options);
+    if (m_pipelineStateObserver && bindGroupLayout.isValid())
+        m_pipelineStateObserver->bindGroupLayoutCreated(bindGroupLayout.handle(), options);
+    return bindGroupLayout;
 }
 
 BindGroupPool Device::createBindGroupPool(const BindGroupPoolOptions &options)
@@ -200,9 +450,25 @@ PipelineCache Device::createPipelineCache(const PipelineCacheOptions &options)
     return PipelineCache(m_api, m_device, options);
 }
 
+FrameCommandAllocator Device::createFrameCommandAllocator(const FrameCommandAllocatorOptions &options)
+{
+    return FrameCommandAllocator(m_api, m_device, options);
+}
+
 GraphicsApi *Device::graphicsApi() const
 {
     return m_api;
 }
 
+/**
+ * @brief Installs @a observer to be told about shader modules, layouts and pipelines created
+ * from now on. Pass nullptr to remove it. The Device does not take ownership of @a observer.
+ *
+ * @sa PipelineStateObserver
+ */
+void Device::setPipelineStateObserver(PipelineStateObserver *observer)
+{
+    m_pipelineStateObserver = observer;
+}
+
 } // namespace KDGpu
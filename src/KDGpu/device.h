@@ -16,7 +16,10 @@
 #include <KDGpu/buffer.h>
 #include <KDGpu/command_recorder.h>
 #include <KDGpu/compute_pipeline.h>
+#include <KDGpu/deduplication_cache.h>
 #include <KDGpu/fence.h>
+#include <KDGpu/frame_command_allocator.h>
+#include <KDGpu/frame_command_allocator_options.h>
 #include <KDGpu/gpu_semaphore.h>
 #include <KDGpu/timeline_semaphore.h>
 #include <KDGpu/graphics_pipeline.h>
@@ -27,22 +30,30 @@
 #include <KDGpu/sampler.h>
 #include <KDGpu/sampler_options.h>
 #include <KDGpu/shader_module.h>
+#include <KDGpu/shader_module_deduplication_cache.h>
 #include <KDGpu/swapchain.h>
 #include <KDGpu/acceleration_structure.h>
+#include <KDGpu/adapter_features.h>
 #include <KDGpu/acceleration_structure_options.h>
 #include <KDGpu/raytracing_pipeline.h>
 #include <KDGpu/render_pass.h>
+#include <KDGpu/render_target_cache.h>
 #include <KDGpu/pipeline_cache.h>
 #include <KDGpu/pipeline_cache_options.h>
+#include <KDGpu/pipeline_deduplication_cache.h>
 
 #include <KDGpu/kdgpu_export.h>
 
+#include <future>
+#include <memory>
 #include <span>
 #include <vector>
 
 namespace KDGpu {
 
 class Adapter;
+class AsyncPipelineCompiler;
+class PipelineStateObserver;
 
 struct Device_t;
 
@@ -118,8 +129,10 @@ struct PipelineCacheOptions;
     - Device::createTexture() -> vkCreateImage() + vkAllocateMemory() + vkBindImageMemory()
     - Device::createGraphicsPipeline() -> vkCreateGraphicsPipelines()
     - Device::createComputePipeline() -> vkCreateComputePipelines()
-    - Device::createShaderModule() -> vkCreateShaderModule()
+    - Device::createShaderModule() -> vkCreateShaderModule(), shared between identical SPIR-V
     - Device::createCommandRecorder() -> vkAllocateCommandBuffers()
+    - Device::releaseThreadCommandPools() -> vkDestroyCommandPool() for idle recording threads
+    - Device::createFrameCommandAllocator() -> vkCreateCommandPool() per frame in flight
     - Device::createFence() -> vkCreateFence()
     - Device::createGpuSemaphore() -> vkCreateSemaphore()
     - Device::waitUntilIdle() -> vkDeviceWaitIdle()
@@ -155,6 +168,7 @@ public:
     void waitUntilIdle();
 
     [[nodiscard]] const Adapter *adapter() const;
+    [[nodiscard]] const AdapterFeatures &enabledFeatures() const;
 
     [[nodiscard]] Swapchain createSwapchain(const SwapchainOptions &options);
     [[nodiscard]] Texture createTexture(const TextureOptions &options);
@@ -175,8 +189,34 @@ public:
 
     [[nodiscard]] RayTracingPipeline createRayTracingPipeline(const RayTracingPipelineOptions &options);
 
+    [[nodiscard]] std::future<GraphicsPipeline> createGraphicsPipelineAsync(const GraphicsPipelineOptions &options);
+
+    [[nodiscard]] std::future<ComputePipeline> createComputePipelineAsync(const ComputePipelineOptions &options);
+
+    [[nodiscard]] GraphicsPipeline getOrCreateGraphicsPipeline(const GraphicsPipelineOptions &options);
+
+    [[nodiscard]] ComputePipeline getOrCreateComputePipeline(const ComputePipelineOptions &options);
+
+    [[nodiscard]] RayTracingPipeline getOrCreateRayTracingPipeline(const RayTracingPipelineOptions &options);
+
+    [[nodiscard]] PipelineDeduplicationStats pipelineDeduplicationStats() const;
+
+    [[nodiscard]] ShaderModuleDeduplicationStats shaderModuleDeduplicationStats() const;
+
+    [[nodiscard]] DeduplicationStats samplerDeduplicationStats() const;
+
+    [[nodiscard]] DeduplicationStats bindGroupLayoutDeduplicationStats() const;
+
+    [[nodiscard]] RenderTargetCacheStats renderPassCacheStats() const;
+
+    [[nodiscard]] RenderTargetCacheStats framebufferCacheStats() const;
+
     [[nodiscard]] CommandRecorder createCommandRecorder(const CommandRecorderOptions &options = CommandRecorderOptions());
 
+    void releaseThreadCommandPools();
+
+    [[nodiscard]] FrameCommandAllocator createFrameCommandAllocator(const FrameCommandAllocatorOptions &options = FrameCommandAllocatorOptions());
+
     [[nodiscard]] GpuSemaphore createGpuSemaphore(const GpuSemaphoreOptions &options = GpuSemaphoreOptions());
 
     [[nodiscard]] TimelineSemaphore createTimelineSemaphore(const TimelineSemaphoreOptions &options = TimelineSemaphoreOptions());
@@ -197,6 +237,9 @@ public:
 
     [[nodiscard]] GraphicsApi *graphicsApi() const;
 
+    void setPipelineStateObserver(PipelineStateObserver *observer);
+    [[nodiscard]] PipelineStateObserver *pipelineStateObserver() const noexcept { return m_pipelineStateObserver; }
+
 private:
     Device(Adapter *adapter, GraphicsApi *api, const DeviceOptions &options);
 
@@ -204,6 +247,11 @@ private:
     Adapter *m_adapter{ nullptr };
     Handle<Device_t> m_device;
     std::vector<Queue> m_queues;
+    PipelineStateObserver *m_pipelineStateObserver{ nullptr };
+
+    struct AsyncPipelineCompilation;
+    AsyncPipelineCompilation *asyncPipelineCompilation();
+    std::unique_ptr<AsyncPipelineCompilation> m_asyncPipelineCompilation;
 
     friend class Adapter;
     friend class VulkanGraphicsApi;
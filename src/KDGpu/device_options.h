@@ -13,6 +13,7 @@
 #include <KDGpu/adapter_features.h>
 #include <KDGpu/adapter_group.h>
 #include <KDGpu/gpu_core.h>
+#include <KDGpu/render_target_cache.h>
 
 #include <stdint.h>
 #include <string>
@@ -35,6 +36,7 @@ struct DeviceOptions {
     std::vector<QueueRequest> queues;
     AdapterFeatures requestedFeatures;
     AdapterGroup adapterGroup;
+    RenderTargetCacheOptions renderTargetCache;
 };
 
 } // namespace KDGpu
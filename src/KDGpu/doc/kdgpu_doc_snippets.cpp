@@ -54,6 +54,7 @@
 #include <KDGpu/sampler.h>
 #include <KDGpu/sampler_options.h>
 #include <KDGpu/render_pass_command_recorder_options.h>
+#include <KDGpu/upload_batch.h>
 #include <KDGpu/vulkan/vulkan_graphics_api.h>
 
 #include <vector>
@@ -206,6 +207,22 @@ void buffer_examples(KDGpu::Device &device)
     storageBuffer.unmap();
     //! [buffer_mapping_unmapping]
 
+    //! [buffer_persistent_mapping]
+    KDGpu::Buffer uniformBuffer = device.createBuffer(KDGpu::BufferOptions{
+            .size = 1024,
+            .usage = KDGpu::BufferUsageFlagBits::UniformBufferBit,
+            .memoryUsage = KDGpu::MemoryUsage::CpuToGpu,
+            .persistentlyMapped = true,
+    });
+
+    // Mapped once on creation, write to it every frame
+    auto *uniformData = static_cast<uint8_t *>(uniformBuffer.mappedPointer());
+    memcpy(uniformData + 256, sourceData, 64);
+
+    // Only flush the region that changed, this is a no-op on host coherent memory
+    uniformBuffer.flush(256, 64);
+    //! [buffer_persistent_mapping]
+
     //! [buffer_device_address]
     KDGpu::Buffer buffer2 = device.createBuffer(KDGpu::BufferOptions{
             .size = 1024,
@@ -1780,6 +1797,32 @@ void queue_examples(KDGpu::Device &device)
     //! [queue_wait_idle]
     queue.waitUntilIdle(); // Block until queue is empty
     //! [queue_wait_idle]
+
+    struct Mesh {
+        KDGpu::Buffer vertexBuffer;
+        std::vector<float> vertices;
+    };
+    std::vector<Mesh> meshes;
+
+    //! [upload_batch]
+    KDGpu::UploadBatch batch;
+    for (const Mesh &mesh : meshes) {
+        batch.addBufferUpload(KDGpu::BufferUploadOptions{
+                .destinationBuffer = mesh.vertexBuffer,
+                .dstStages = KDGpu::PipelineStageFlagBit::VertexAttributeInputBit,
+                .dstMask = KDGpu::AccessFlagBit::VertexAttributeReadBit,
+                .data = mesh.vertices.data(),
+                .byteSize = mesh.vertices.size() * sizeof(float),
+        });
+    }
+
+    // One staging buffer, one command buffer and one submission for all meshes
+    KDGpu::UploadStagingBuffer upload = queue.upload(batch);
+
+    // Release the staging memory of the whole batch once the GPU is done with it
+    upload.fence.wait();
+    upload = {};
+    //! [upload_batch]
 }
 
 // =============================================================================
@@ -67,6 +67,11 @@ FenceStatus Fence::status() const
     return m_api->resourceManager()->getFence(handle())->status();
 }
 
+uint64_t Fence::submissionCount() const
+{
+    return m_api->resourceManager()->getFence(handle())->submissionCount;
+}
+
 HandleOrFD Fence::externalFenceHandle() const
 {
     auto apiFence = m_api->resourceManager()->getFence(m_fence);
@@ -101,6 +101,9 @@ public:
     void reset();
     void wait();
     FenceStatus status() const;
+    // Number of queue submissions and presentations made to signal the fence so far. A signalled
+    // fence whose count did not change since an earlier check was signalled by an earlier use.
+    uint64_t submissionCount() const;
 
     HandleOrFD externalFenceHandle() const;
 
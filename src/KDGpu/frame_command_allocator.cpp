@@ -0,0 +1,77 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "frame_command_allocator.h"
+
+#include <KDGpu/api/graphics_api_impl.h>
+#include <KDGpu/frame_command_allocator_options.h>
+
+namespace KDGpu {
+
+FrameCommandAllocator::FrameCommandAllocator() = default;
+
+FrameCommandAllocator::~FrameCommandAllocator()
+{
+    if (isValid())
+        m_api->resourceManager()->deleteFrameCommandAllocator(handle());
+}
+
+FrameCommandAllocator::FrameCommandAllocator(GraphicsApi *api, const Handle<Device_t> &device, const FrameCommandAllocatorOptions &options)
+    : m_api(api)
+    , m_device(device)
+    , m_frameCommandAllocator(m_api->resourceManager()->createFrameCommandAllocator(m_device, options))
+{
+}
+
+FrameCommandAllocator::FrameCommandAllocator(FrameCommandAllocator &&other) noexcept
+{
+    m_api = std::exchange(other.m_api, nullptr);
+    m_device = std::exchange(other.m_device, {});
+    m_frameCommandAllocator = std::exchange(other.m_frameCommandAllocator, {});
+}
+
+FrameCommandAllocator &FrameCommandAllocator::operator=(FrameCommandAllocator &&other) noexcept
+{
+    if (this != &other) {
+        if (isValid())
+            m_api->resourceManager()->deleteFrameCommandAllocator(handle());
+
+        m_api = std::exchange(other.m_api, nullptr);
+        m_device = std::exchange(other.m_device, {});
+        m_frameCommandAllocator = std::exchange(other.m_frameCommandAllocator, {});
+    }
+    return *this;
+}
+
+void FrameCommandAllocator::beginFrame(uint32_t frameIndex, const Handle<Fence_t> &frameFence)
+{
+    auto apiFrameCommandAllocator = m_api->resourceManager()->getFrameCommandAllocator(handle());
+    assert(apiFrameCommandAllocator != nullptr);
+    apiFrameCommandAllocator->beginFrame(frameIndex, frameFence);
+}
+
+uint32_t FrameCommandAllocator::currentFrame() const
+{
+    auto apiFrameCommandAllocator = m_api->resourceManager()->getFrameCommandAllocator(handle());
+    assert(apiFrameCommandAllocator != nullptr);
+    return apiFrameCommandAllocator->currentFrame;
+}
+
+bool operator==(const FrameCommandAllocator &a, const FrameCommandAllocator &b)
+{
+    return a.m_api == b.m_api && a.m_device == b.m_device && a.m_frameCommandAllocator == b.m_frameCommandAllocator;
+}
+
+bool operator!=(const FrameCommandAllocator &a, const FrameCommandAllocator &b)
+{
+    return !(a == b);
+}
+
+} // namespace KDGpu
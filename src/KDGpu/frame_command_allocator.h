@@ -0,0 +1,103 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/handle.h>
+#include <KDGpu/kdgpu_export.h>
+#include <KDGpu/graphics_api.h>
+
+#include <cstdint>
+
+namespace KDGpu {
+
+struct Device_t;
+struct Fence_t;
+struct FrameCommandAllocator_t;
+struct FrameCommandAllocatorOptions;
+
+/*!
+    \class FrameCommandAllocator
+    \brief FrameCommandAllocator recycles command buffers across frames in flight
+    \ingroup public
+    \headerfile frame_command_allocator.h <KDGpu/frame_command_allocator.h>
+
+    <b>Vulkan equivalent:</b> One [VkCommandPool](https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkCommandPool.html) per frame in flight
+
+    By default, every CommandRecorder allocates a command buffer that is freed again when the
+    CommandBuffer is destroyed. Passing a FrameCommandAllocator through
+    CommandRecorderOptions::frameCommandAllocator instead hands out command buffers from the
+    pool of the current frame. beginFrame() resets that whole pool at once and makes its command
+    buffers available again, so that steady state rendering allocates nothing.
+
+    @code{.cpp}
+    FrameCommandAllocator allocator = device.createFrameCommandAllocator(FrameCommandAllocatorOptions{
+            .frameCount = maxFramesInFlight,
+    });
+
+    // Every frame
+    allocator.beginFrame(inFlightIndex, frameFences[inFlightIndex]);
+    CommandRecorder recorder = device.createCommandRecorder(CommandRecorderOptions{
+            .frameCommandAllocator = allocator,
+    });
+    @endcode
+
+    CommandBuffers obtained for a frame must not be submitted anymore once beginFrame() was called
+    again for that frame. They may be destroyed right after being submitted: the resources recorded
+    into them, such as cached framebuffers, are only released when their frame begins again. Like the command pools it wraps, an allocator must not be used from
+    several threads at once; create one per recording thread instead.
+
+    ## See also:
+    \sa FrameCommandAllocatorOptions
+    \sa Device::createFrameCommandAllocator
+    \sa CommandRecorderOptions
+ */
+class KDGPU_EXPORT FrameCommandAllocator
+{
+public:
+    FrameCommandAllocator();
+    ~FrameCommandAllocator();
+
+    FrameCommandAllocator(FrameCommandAllocator &&) noexcept;
+    FrameCommandAllocator &operator=(FrameCommandAllocator &&) noexcept;
+
+    FrameCommandAllocator(const FrameCommandAllocator &) = delete;
+    FrameCommandAllocator &operator=(const FrameCommandAllocator &) = delete;
+
+    const Handle<FrameCommandAllocator_t> &handle() const noexcept { return m_frameCommandAllocator; }
+    bool isValid() const noexcept { return m_frameCommandAllocator.isValid(); }
+
+    operator Handle<FrameCommandAllocator_t>() const noexcept { return m_frameCommandAllocator; }
+
+    /**
+     * \brief Makes frameIndex the current frame and recycles its command buffers
+     * \param frameIndex Index of the frame in flight, less than FrameCommandAllocatorOptions::frameCount
+     * \param frameFence Fence signalled by the last submission of that frame. If valid, it is
+     * waited upon before the pool is reset; otherwise the caller must have waited on it already.
+     */
+    void beginFrame(uint32_t frameIndex, const Handle<Fence_t> &frameFence = {});
+
+    uint32_t currentFrame() const;
+
+private:
+    explicit FrameCommandAllocator(GraphicsApi *api, const Handle<Device_t> &device, const FrameCommandAllocatorOptions &options);
+
+    GraphicsApi *m_api{ nullptr };
+    Handle<Device_t> m_device;
+    Handle<FrameCommandAllocator_t> m_frameCommandAllocator;
+
+    friend class Device;
+    friend KDGPU_EXPORT bool operator==(const FrameCommandAllocator &, const FrameCommandAllocator &);
+};
+
+KDGPU_EXPORT bool operator==(const FrameCommandAllocator &a, const FrameCommandAllocator &b);
+KDGPU_EXPORT bool operator!=(const FrameCommandAllocator &a, const FrameCommandAllocator &b);
+
+} // namespace KDGpu
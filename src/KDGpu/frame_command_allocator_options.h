@@ -0,0 +1,28 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/handle.h>
+
+#include <cstdint>
+#include <string_view>
+
+namespace KDGpu {
+
+struct Queue_t;
+
+struct FrameCommandAllocatorOptions {
+    std::string_view label;
+    Handle<Queue_t> queue; // The queue the recorded commands are submitted to. If not set, defaults to first queue of the device
+    uint32_t frameCount{ 2 }; // Number of frames in flight, one command pool is created per frame
+};
+
+} // namespace KDGpu
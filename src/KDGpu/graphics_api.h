@@ -12,8 +12,14 @@
 
 namespace KDGpu {
 
+#if defined(KDGPU_NULL_BACKEND)
+class NullGraphicsApi;
+
+using GraphicsApi = NullGraphicsApi;
+#else
 class VulkanGraphicsApi;
 
 using GraphicsApi = VulkanGraphicsApi;
+#endif
 
 } // namespace KDGpu
@@ -101,6 +101,7 @@ public:
 
 private:
     explicit GraphicsPipeline(GraphicsApi *api, const Handle<Device_t> &device, const GraphicsPipelineOptions &options);
+    explicit GraphicsPipeline(GraphicsApi *api, const Handle<Device_t> &device, const Handle<GraphicsPipeline_t> &graphicsPipeline);
 
     GraphicsApi *m_api{ nullptr };
     Handle<Device_t> m_device;
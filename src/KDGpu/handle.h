@@ -47,6 +47,10 @@ private:
 
     template<typename U, typename V>
     friend class Pool;
+    template<typename U, typename V, uint32_t S>
+    friend class ChunkedPool;
+    template<typename U, typename V, uint32_t S, uint32_t C>
+    friend class ConcurrentPool;
 };
 
 template<typename T>
@@ -265,6 +265,7 @@ private:
     mutable std::vector<AdapterGroup> m_adapterGroups;
 
     friend class VulkanGraphicsApi;
+    friend class NullGraphicsApi;
 };
 
 } // namespace KDGpu
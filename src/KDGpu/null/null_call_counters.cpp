@@ -0,0 +1,29 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "null_call_counters.h"
+
+namespace KDGpu {
+
+uint64_t NullCallCounters::totalCount() const noexcept
+{
+    uint64_t total = 0;
+    for (const auto &count : m_counts)
+        total += count.load(std::memory_order_relaxed);
+    return total;
+}
+
+void NullCallCounters::reset() noexcept
+{
+    for (auto &count : m_counts)
+        count.store(0, std::memory_order_relaxed);
+}
+
+} // namespace KDGpu
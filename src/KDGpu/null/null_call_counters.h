@@ -0,0 +1,146 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/kdgpu_export.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace KDGpu {
+
+/**
+ * @brief NullCall
+ * \ingroup null
+ *
+ * Identifies the backend entry points the null backend keeps a count of.
+ * Resource creation and deletion are tracked as a whole by CreateResource
+ * and DeleteResource.
+ */
+enum class NullCall : uint32_t {
+    CreateResource = 0,
+    DeleteResource,
+
+    // Instance, Device and Queue
+    QueryAdapters,
+    CreateSurface,
+    DeviceWaitUntilIdle,
+    QueueWaitUntilIdle,
+    QueueSubmit,
+    QueuePresent,
+    AcquireNextImage,
+
+    // Synchronization
+    FenceWait,
+    FenceReset,
+    FenceStatus,
+    TimelineSemaphoreSignal,
+    TimelineSemaphoreWait,
+
+    // Host access
+    TextureMap,
+    TextureUnmap,
+    HostLayoutTransition,
+    CopyHostMemoryToTexture,
+    CopyTextureToHostMemory,
+    CopyTextureToTextureHost,
+    BufferMap,
+    BufferUnmap,
+    BufferInvalidate,
+    BufferFlush,
+    BindGroupUpdate,
+    BindGroupPoolReset,
+    CommandPoolReset,
+
+    // CommandRecorder
+    Begin,
+    BlitTexture,
+    ClearBuffer,
+    ClearColorTexture,
+    ClearDepthStencilTexture,
+    CopyBuffer,
+    CopyBufferToTexture,
+    CopyTextureToBuffer,
+    CopyTextureToTexture,
+    UpdateBuffer,
+    MemoryBarrier,
+    BufferMemoryBarrier,
+    TextureMemoryBarrier,
+    ExecuteSecondaryCommandBuffer,
+    ResolveTexture,
+    BuildAccelerationStructures,
+    BeginDebugLabel,
+    EndDebugLabel,
+    Finish,
+
+    // Render, Compute and RayTracing passes
+    SetPipeline,
+    SetVertexBuffer,
+    SetIndexBuffer,
+    SetBindGroup,
+    SetViewport,
+    SetScissor,
+    SetStencilReference,
+    Draw,
+    DrawIndexed,
+    DrawIndirect,
+    DrawIndexedIndirect,
+    DrawMeshTasks,
+    DrawMeshTasksIndirect,
+    DispatchCompute,
+    DispatchComputeIndirect,
+    TraceRays,
+    PushConstant,
+    PushBindGroup,
+    NextSubpass,
+    SetInputAttachmentMapping,
+    SetOutputAttachmentMapping,
+    EndPass,
+
+    // TimestampQueryRecorder
+    WriteTimestamp,
+    ResetTimestampQueries,
+
+    Count
+};
+
+/**
+ * @brief NullCallCounters
+ * \ingroup null
+ *
+ * Per NullCall counters. Counters are relaxed atomics so that recording from
+ * several threads is well defined, ordering between counters is not guaranteed.
+ * Commands recorded through the span overloads count once per command, like the
+ * individual vkCmd* calls the Vulkan backend would have issued.
+ */
+class KDGPU_EXPORT NullCallCounters
+{
+public:
+    void record(NullCall call, uint64_t count = 1) noexcept
+    {
+        m_counts[static_cast<size_t>(call)].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    uint64_t count(NullCall call) const noexcept
+    {
+        return m_counts[static_cast<size_t>(call)].load(std::memory_order_relaxed);
+    }
+
+    uint64_t totalCount() const noexcept;
+    void reset() noexcept;
+
+private:
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(NullCall::Count)> m_counts{};
+};
+
+} // namespace KDGpu
@@ -0,0 +1,66 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/api/api_type.h>
+#include <KDGpu/kdgpu_export.h>
+#include <KDGpu/null/null_resource_manager.h>
+
+namespace KDGpu {
+
+/**
+ * @page Null
+ *
+ * The null backend is selected at build time with KDGPU_BUILD_NULL_BACKEND
+ * and provides the KDGpuNull library. It implements the whole ResourceManager
+ * interface without ever calling into Vulkan: handles are allocated as usual,
+ * submissions complete immediately and every backend call is counted in
+ * NullCallCounters. This makes it possible to benchmark the CPU cost of the
+ * KDGpu front end on machines that have no GPU or ICD installed.
+ */
+
+/**
+ * @brief NullGraphicsApi
+ * \ingroup null
+ * \ingroup public
+ *
+ */
+class KDGPU_EXPORT NullGraphicsApi
+{
+public:
+    NullGraphicsApi();
+    ~NullGraphicsApi();
+
+    ApiType api() { return ApiType::Null; }
+    std::string apiName() { return "Null"; }
+
+    /**
+     * @brief Create an Instance object given the InstanceOptions @a options
+     */
+    Instance createInstance(const InstanceOptions &options = InstanceOptions());
+
+    /**
+     * @brief Returns the ResourceManager instance for the GraphicsApi
+     */
+    NullResourceManager *resourceManager() noexcept { return &m_nullResourceManager; }
+    const NullResourceManager *resourceManager() const noexcept { return &m_nullResourceManager; }
+
+    /**
+     * @brief Returns the counters of the backend calls issued so far
+     */
+    NullCallCounters &callCounters() noexcept { return m_nullResourceManager.callCounters(); }
+    const NullCallCounters &callCounters() const noexcept { return m_nullResourceManager.callCounters(); }
+
+private:
+    NullResourceManager m_nullResourceManager;
+};
+
+} // namespace KDGpu
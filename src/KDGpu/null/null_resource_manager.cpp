@@ -0,0 +1,878 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "null_resource_manager.h"
+
+#include <KDGpu/acceleration_structure_options.h>
+#include <KDGpu/bind_group_options.h>
+#include <KDGpu/bind_group_layout_options.h>
+#include <KDGpu/bind_group_pool_options.h>
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/compute_pipeline_options.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/gpu_semaphore.h>
+#include <KDGpu/graphics_pipeline_options.h>
+#include <KDGpu/raytracing_pipeline_options.h>
+#include <KDGpu/render_pass_options.h>
+#include <KDGpu/sampler_options.h>
+#include <KDGpu/swapchain_options.h>
+#include <KDGpu/texture_options.h>
+#include <KDGpu/texture_view_options.h>
+#include <KDGpu/timeline_semaphore.h>
+#include <KDGpu/ycbcr_conversion_options.h>
+#include <KDGpu/utils/logging.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace KDGpu {
+
+NullResourceManager::NullResourceManager()
+{
+}
+
+NullResourceManager::~NullResourceManager()
+{
+}
+
+Handle<Instance_t> NullResourceManager::createInstance(const InstanceOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_instances.emplace(NullInstance{ .nullResourceManager = this });
+}
+
+void NullResourceManager::deleteInstance(const Handle<Instance_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_instances.remove(handle);
+}
+
+NullInstance *NullResourceManager::getInstance(const Handle<Instance_t> &handle) const
+{
+    return m_instances.get(handle);
+}
+
+Handle<Adapter_t> NullResourceManager::insertAdapter(const NullAdapter &adapter)
+{
+    return m_adapters.emplace(adapter);
+}
+
+void NullResourceManager::removeAdapter(const Handle<Adapter_t> &handle)
+{
+    m_adapters.remove(handle);
+}
+
+NullAdapter *NullResourceManager::getAdapter(const Handle<Adapter_t> &handle) const
+{
+    return m_adapters.get(handle);
+}
+
+Handle<Device_t> NullResourceManager::createDevice(const Handle<Adapter_t> &adapterHandle, const DeviceOptions &options, std::vector<QueueRequest> &queueRequests)
+{
+    m_callCounters.record(NullCall::CreateResource);
+
+    // Same defaulting as the Vulkan backend: a single queue from the first queue type
+    queueRequests = options.queues;
+    if (queueRequests.empty()) {
+        QueueRequest queueRequest = {
+            .queueTypeIndex = 0,
+            .count = 1,
+            .priorities = { 1.0f }
+        };
+        queueRequests.emplace_back(queueRequest);
+    }
+
+    NullDevice nullDevice{
+        .nullResourceManager = this,
+        .adapterHandle = adapterHandle,
+        .requestedFeatures = options.requestedFeatures,
+    };
+    if (options.requestedFeatures.hostImageCopy)
+        nullDevice.hostImageCopyDstLayouts = m_adapters.get(adapterHandle)->queryAdapterProperties().hostImageCopyProperties.dstCopyLayouts;
+
+    return m_devices.emplace(std::move(nullDevice));
+}
+
+void NullResourceManager::deleteDevice(const Handle<Device_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_devices.remove(handle);
+}
+
+NullDevice *NullResourceManager::getDevice(const Handle<Device_t> &handle) const
+{
+    return m_devices.get(handle);
+}
+
+Handle<Queue_t> NullResourceManager::insertQueue(const NullQueue &queue)
+{
+    return m_queues.emplace(queue);
+}
+
+void NullResourceManager::removeQueue(const Handle<Queue_t> &handle)
+{
+    m_queues.remove(handle);
+}
+
+NullQueue *NullResourceManager::getQueue(const Handle<Queue_t> &handle) const
+{
+    return m_queues.get(handle);
+}
+
+Handle<Swapchain_t> NullResourceManager::createSwapchain(const Handle<Device_t> &deviceHandle, const SwapchainOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+
+    NullSwapchain nullSwapchain{ .nullResourceManager = this, .deviceHandle = deviceHandle };
+    nullSwapchain.textures.reserve(options.minImageCount);
+    for (uint32_t i = 0; i < options.minImageCount; ++i) {
+        nullSwapchain.textures.emplace_back(m_textures.emplace(NullTexture{
+                .nullResourceManager = this,
+                .deviceHandle = deviceHandle,
+                .format = options.format,
+                .extent = { options.imageExtent.width, options.imageExtent.height, 1 },
+                .mipLevels = 1,
+                .arrayLayers = options.imageLayers,
+                .usage = options.imageUsageFlags,
+                .ownedBySwapchain = true }));
+    }
+
+    return m_swapchains.emplace(std::move(nullSwapchain));
+}
+
+void NullResourceManager::deleteSwapchain(const Handle<Swapchain_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+
+    NullSwapchain *nullSwapchain = m_swapchains.get(handle);
+    for (const Handle<Texture_t> &textureHandle : nullSwapchain->textures)
+        m_textures.remove(textureHandle);
+
+    m_swapchains.remove(handle);
+}
+
+NullSwapchain *NullResourceManager::getSwapchain(const Handle<Swapchain_t> &handle) const
+{
+    return m_swapchains.get(handle);
+}
+
+Handle<Surface_t> NullResourceManager::insertSurface(const NullSurface &surface)
+{
+    return m_surfaces.emplace(surface);
+}
+
+void NullResourceManager::deleteSurface(const Handle<Surface_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_surfaces.remove(handle);
+}
+
+NullSurface *NullResourceManager::getSurface(const Handle<Surface_t> &handle) const
+{
+    return m_surfaces.get(handle);
+}
+
+Handle<Texture_t> NullResourceManager::createTexture(const Handle<Device_t> &deviceHandle, const TextureOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_textures.emplace(NullTexture{
+            .nullResourceManager = this,
+            .deviceHandle = deviceHandle,
+            .format = options.format,
+            .extent = options.extent,
+            .mipLevels = options.mipLevels,
+            .arrayLayers = options.arrayLayers,
+            .usage = options.usage });
+}
+
+void NullResourceManager::deleteTexture(const Handle<Texture_t> &handle)
+{
+    // Swapchain textures are released along with their swapchain, which can
+    // happen before the Texture objects referencing them are destroyed
+    NullTexture *nullTexture = m_textures.get(handle);
+    if (!nullTexture || nullTexture->ownedBySwapchain)
+        return;
+
+    m_callCounters.record(NullCall::DeleteResource);
+    m_textures.remove(handle);
+}
+
+NullTexture *NullResourceManager::getTexture(const Handle<Texture_t> &handle) const
+{
+    return m_textures.get(handle);
+}
+
+Handle<TextureView_t> NullResourceManager::createTextureView(const Handle<Device_t> &deviceHandle, const Handle<Texture_t> &textureHandle, const TextureViewOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_textureViews.emplace(NullTextureView{ .deviceHandle = deviceHandle, .textureHandle = textureHandle });
+}
+
+void NullResourceManager::deleteTextureView(const Handle<TextureView_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_textureViews.remove(handle);
+}
+
+NullTextureView *NullResourceManager::getTextureView(const Handle<TextureView_t> &handle) const
+{
+    return m_textureViews.get(handle);
+}
+
+Handle<Buffer_t> NullResourceManager::createBuffer(const Handle<Device_t> &deviceHandle, const BufferOptions &options, const void *initialData)
+{
+    m_callCounters.record(NullCall::CreateResource);
+
+    NullBuffer nullBuffer{
+        .nullResourceManager = this,
+        .deviceHandle = deviceHandle,
+        .size = options.size,
+        .persistentlyMapped = options.persistentlyMapped,
+    };
+    if (options.hostPointer) {
+        const DeviceSize alignment = m_adapters.get(m_devices.get(deviceHandle)->adapterHandle)->queryAdapterProperties().externalMemoryHostProperties.minImportedHostPointerAlignment;
+        if (reinterpret_cast<uintptr_t>(options.hostPointer) % alignment != 0 || options.size % alignment != 0)
+            return {};
+        nullBuffer.hostPointer = const_cast<void *>(options.hostPointer);
+        return m_buffers.emplace(std::move(nullBuffer));
+    }
+    if (initialData || options.persistentlyMapped)
+        nullBuffer.data.resize(options.size);
+    if (initialData) {
+        std::memcpy(nullBuffer.data.data(), initialData, options.size);
+    }
+
+    return m_buffers.emplace(std::move(nullBuffer));
+}
+
+void NullResourceManager::deleteBuffer(const Handle<Buffer_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+
+    // Pool only destroys its objects when it goes away, release the backing store now
+    NullBuffer *nullBuffer = m_buffers.get(handle);
+    nullBuffer->data = {};
+    m_buffers.remove(handle);
+}
+
+NullBuffer *NullResourceManager::getBuffer(const Handle<Buffer_t> &handle) const
+{
+    return m_buffers.get(handle);
+}
+
+Handle<ShaderModule_t> NullResourceManager::createShaderModule(const Handle<Device_t> &deviceHandle, const std::vector<uint32_t> &code)
+{
+    NullDevice *nullDevice = m_devices.get(deviceHandle);
+    return nullDevice->shaderModuleCache.getOrCreate(code, [&] {
+        m_callCounters.record(NullCall::CreateResource);
+        return m_shaderModules.emplace(NullShaderModule{ .deviceHandle = deviceHandle });
+    });
+}
+
+void NullResourceManager::deleteShaderModule(const Handle<ShaderModule_t> &handle)
+{
+    NullShaderModule *nullShaderModule = m_shaderModules.get(handle);
+    NullDevice *nullDevice = m_devices.get(nullShaderModule->deviceHandle);
+    if (!nullDevice->shaderModuleCache.release(handle))
+        return;
+
+    m_callCounters.record(NullCall::DeleteResource);
+    m_shaderModules.remove(handle);
+}
+
+NullShaderModule *NullResourceManager::getShaderModule(const Handle<ShaderModule_t> &handle) const
+{
+    return m_shaderModules.get(handle);
+}
+
+Handle<RenderPass_t> NullResourceManager::createRenderPass(const Handle<Device_t> &deviceHandle, const RenderPassOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_renderPasses.emplace(NullRenderPass{ .deviceHandle = deviceHandle });
+}
+
+void NullResourceManager::deleteRenderPass(const Handle<RenderPass_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_renderPasses.remove(handle);
+}
+
+NullRenderPass *NullResourceManager::getRenderPass(const Handle<RenderPass_t> &handle) const
+{
+    return m_renderPasses.get(handle);
+}
+
+Handle<PipelineLayout_t> NullResourceManager::createPipelineLayout(const Handle<Device_t> &deviceHandle, const PipelineLayoutOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_pipelineLayouts.emplace(NullPipelineLayout{ .deviceHandle = deviceHandle });
+}
+
+void NullResourceManager::deletePipelineLayout(const Handle<PipelineLayout_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_pipelineLayouts.remove(handle);
+}
+
+NullPipelineLayout *NullResourceManager::getPipelineLayout(const Handle<PipelineLayout_t> &handle) const
+{
+    return m_pipelineLayouts.get(handle);
+}
+
+Handle<GraphicsPipeline_t> NullResourceManager::createGraphicsPipeline(const Handle<Device_t> &deviceHandle, const GraphicsPipelineOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_graphicsPipelines.emplace(NullGraphicsPipeline{ .deviceHandle = deviceHandle, .pipelineLayoutHandle = options.layout });
+}
+
+Handle<GraphicsPipeline_t> NullResourceManager::getOrCreateGraphicsPipeline(const Handle<Device_t> &deviceHandle, const GraphicsPipelineOptions &options)
+{
+    NullDevice *nullDevice = m_devices.get(deviceHandle);
+    return nullDevice->graphicsPipelineCache.getOrCreate(options, [&] { return createGraphicsPipeline(deviceHandle, options); });
+}
+
+void NullResourceManager::deleteGraphicsPipeline(const Handle<GraphicsPipeline_t> &handle)
+{
+    NullGraphicsPipeline *nullPipeline = m_graphicsPipelines.get(handle);
+    NullDevice *nullDevice = m_devices.get(nullPipeline->deviceHandle);
+    if (!nullDevice->graphicsPipelineCache.release(handle))
+        return;
+
+    m_callCounters.record(NullCall::DeleteResource);
+    m_graphicsPipelines.remove(handle);
+}
+
+NullGraphicsPipeline *NullResourceManager::getGraphicsPipeline(const Handle<GraphicsPipeline_t> &handle) const
+{
+    return m_graphicsPipelines.get(handle);
+}
+
+Handle<ComputePipeline_t> NullResourceManager::createComputePipeline(const Handle<Device_t> &deviceHandle, const ComputePipelineOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_computePipelines.emplace(NullComputePipeline{ .deviceHandle = deviceHandle, .pipelineLayoutHandle = options.layout });
+}
+
+Handle<ComputePipeline_t> NullResourceManager::getOrCreateComputePipeline(const Handle<Device_t> &deviceHandle, const ComputePipelineOptions &options)
+{
+    NullDevice *nullDevice = m_devices.get(deviceHandle);
+    return nullDevice->computePipelineCache.getOrCreate(options, [&] { return createComputePipeline(deviceHandle, options); });
+}
+
+void NullResourceManager::deleteComputePipeline(const Handle<ComputePipeline_t> &handle)
+{
+    NullComputePipeline *nullPipeline = m_computePipelines.get(handle);
+    NullDevice *nullDevice = m_devices.get(nullPipeline->deviceHandle);
+    if (!nullDevice->computePipelineCache.release(handle))
+        return;
+
+    m_callCounters.record(NullCall::DeleteResource);
+    m_computePipelines.remove(handle);
+}
+
+NullComputePipeline *NullResourceManager::getComputePipeline(const Handle<ComputePipeline_t> &handle) const
+{
+    return m_computePipelines.get(handle);
+}
+
+Handle<RayTracingPipeline_t> NullResourceManager::createRayTracingPipeline(const Handle<Device_t> &deviceHandle, const RayTracingPipelineOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_rayTracingPipelines.emplace(NullRayTracingPipeline{ .deviceHandle = deviceHandle, .pipelineLayoutHandle = options.layout });
+}
+
+Handle<RayTracingPipeline_t> NullResourceManager::getOrCreateRayTracingPipeline(const Handle<Device_t> &deviceHandle, const RayTracingPipelineOptions &options)
+{
+    NullDevice *nullDevice = m_devices.get(deviceHandle);
+    return nullDevice->rayTracingPipelineCache.getOrCreate(options, [&] { return createRayTracingPipeline(deviceHandle, options); });
+}
+
+void NullResourceManager::deleteRayTracingPipeline(const Handle<RayTracingPipeline_t> &handle)
+{
+    NullRayTracingPipeline *nullPipeline = m_rayTracingPipelines.get(handle);
+    NullDevice *nullDevice = m_devices.get(nullPipeline->deviceHandle);
+    if (!nullDevice->rayTracingPipelineCache.release(handle))
+        return;
+
+    m_callCounters.record(NullCall::DeleteResource);
+    m_rayTracingPipelines.remove(handle);
+}
+
+NullRayTracingPipeline *NullResourceManager::getRayTracingPipeline(const Handle<RayTracingPipeline_t> &handle) const
+{
+    return m_rayTracingPipelines.get(handle);
+}
+
+PipelineDeduplicationStats NullResourceManager::pipelineDeduplicationStats(const Handle<Device_t> &deviceHandle)
+{
+    NullDevice *nullDevice = m_devices.get(deviceHandle);
+
+    PipelineDeduplicationStats stats;
+    for (const PipelineDeduplicationStats &cacheStats : { nullDevice->graphicsPipelineCache.stats(),
+                                                          nullDevice->computePipelineCache.stats(),
+                                                          nullDevice->rayTracingPipelineCache.stats() }) {
+        stats.hits += cacheStats.hits;
+        stats.misses += cacheStats.misses;
+        stats.cachedPipelines += cacheStats.cachedPipelines;
+    }
+    return stats;
+}
+
+ShaderModuleDeduplicationStats NullResourceManager::shaderModuleDeduplicationStats(const Handle<Device_t> &deviceHandle)
+{
+    return m_devices.get(deviceHandle)->shaderModuleCache.stats();
+}
+
+DeduplicationStats NullResourceManager::samplerDeduplicationStats(const Handle<Device_t> &deviceHandle)
+{
+    return m_devices.get(deviceHandle)->samplerCache.stats();
+}
+
+DeduplicationStats NullResourceManager::bindGroupLayoutDeduplicationStats(const Handle<Device_t> &deviceHandle)
+{
+    return m_devices.get(deviceHandle)->bindGroupLayoutCache.stats();
+}
+
+// The null backend begins render passes without creating render pass or framebuffer objects
+RenderTargetCacheStats NullResourceManager::renderPassCacheStats(const Handle<Device_t> &)
+{
+    return {};
+}
+
+RenderTargetCacheStats NullResourceManager::framebufferCacheStats(const Handle<Device_t> &)
+{
+    return {};
+}
+
+// The null backend allocates command buffers without command pools
+void NullResourceManager::releaseThreadCommandPools(const Handle<Device_t> &)
+{
+}
+
+Handle<GpuSemaphore_t> NullResourceManager::createGpuSemaphore(const Handle<Device_t> &deviceHandle, const GpuSemaphoreOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_gpuSemaphores.emplace(NullGpuSemaphore{ .deviceHandle = deviceHandle });
+}
+
+void NullResourceManager::deleteGpuSemaphore(const Handle<GpuSemaphore_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_gpuSemaphores.remove(handle);
+}
+
+NullGpuSemaphore *NullResourceManager::getGpuSemaphore(const Handle<GpuSemaphore_t> &handle) const
+{
+    return m_gpuSemaphores.get(handle);
+}
+
+Handle<TimelineSemaphore_t> NullResourceManager::createTimelineSemaphore(const Handle<Device_t> &deviceHandle, const TimelineSemaphoreOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_timelineSemaphores.emplace(NullTimelineSemaphore{
+            .nullResourceManager = this,
+            .deviceHandle = deviceHandle,
+            .currentValue = options.initialValue });
+}
+
+void NullResourceManager::deleteTimelineSemaphore(const Handle<TimelineSemaphore_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_timelineSemaphores.remove(handle);
+}
+
+NullTimelineSemaphore *NullResourceManager::getTimelineSemaphore(const Handle<TimelineSemaphore_t> &handle) const
+{
+    return m_timelineSemaphores.get(handle);
+}
+
+Handle<CommandRecorder_t> NullResourceManager::createCommandRecorder(const Handle<Device_t> &deviceHandle, const CommandRecorderOptions &options)
+{
+    NullDevice *nullDevice = m_devices.get(deviceHandle);
+
+    // Which queue is the command recorder requested for?
+    const QueueDescription *queueDescription = nullptr;
+    if (!options.queue.isValid()) {
+        if (nullDevice->queueDescriptions.empty()) {
+            SPDLOG_LOGGER_ERROR(Logger::logger(), "No more queue descriptors available for device");
+            return {};
+        }
+        queueDescription = nullDevice->queueDescriptions.data();
+    } else {
+        const auto it = std::find_if(
+                nullDevice->queueDescriptions.begin(),
+                nullDevice->queueDescriptions.end(),
+                [&options](const QueueDescription &queueDescription) { return queueDescription.queue == options.queue; });
+        if (it == nullDevice->queueDescriptions.end()) {
+            SPDLOG_LOGGER_ERROR(Logger::logger(), "Cannot find requested queue for device");
+            return {};
+        }
+        queueDescription = &(*it);
+    }
+
+    const Handle<CommandBuffer_t> commandBufferHandle = createCommandBuffer(deviceHandle, *queueDescription, options.level);
+
+    m_callCounters.record(NullCall::CreateResource);
+    return m_commandRecorders.emplace(NullCommandRecorder{
+            .nullResourceManager = this,
+            .deviceHandle = deviceHandle,
+            .commandBufferHandle = commandBufferHandle });
+}
+
+void NullResourceManager::deleteCommandRecorder(const Handle<CommandRecorder_t> &handle)
+{
+    // The CommandBuffer created along with the recorder has its own lifetime
+    m_callCounters.record(NullCall::DeleteResource);
+    m_commandRecorders.remove(handle);
+}
+
+NullCommandRecorder *NullResourceManager::getCommandRecorder(const Handle<CommandRecorder_t> &handle) const
+{
+    return m_commandRecorders.get(handle);
+}
+
+Handle<RenderPassCommandRecorder_t> NullResourceManager::createRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                         const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                                         const RenderPassCommandRecorderOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_renderPassCommandRecorders.emplace(NullRenderPassCommandRecorder{ .nullResourceManager = this, .deviceHandle = deviceHandle });
+}
+
+Handle<RenderPassCommandRecorder_t> NullResourceManager::createRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                         const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                                         const RenderPassCommandRecorderWithRenderPassOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_renderPassCommandRecorders.emplace(NullRenderPassCommandRecorder{ .nullResourceManager = this, .deviceHandle = deviceHandle });
+}
+
+Handle<RenderPassCommandRecorder_t> NullResourceManager::createRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                         const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                                         const RenderPassCommandRecorderWithDynamicRenderingOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_renderPassCommandRecorders.emplace(NullRenderPassCommandRecorder{ .nullResourceManager = this, .deviceHandle = deviceHandle });
+}
+
+Handle<RenderPassCommandRecorder_t> NullResourceManager::createInheritedRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                                  const Handle<CommandRecorder_t> &commandRecorderHandle)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_renderPassCommandRecorders.emplace(NullRenderPassCommandRecorder{ .nullResourceManager = this, .deviceHandle = deviceHandle });
+}
+
+void NullResourceManager::deleteRenderPassCommandRecorder(const Handle<RenderPassCommandRecorder_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_renderPassCommandRecorders.remove(handle);
+}
+
+NullRenderPassCommandRecorder *NullResourceManager::getRenderPassCommandRecorder(const Handle<RenderPassCommandRecorder_t> &handle) const
+{
+    return m_renderPassCommandRecorders.get(handle);
+}
+
+Handle<ComputePassCommandRecorder_t> NullResourceManager::createComputePassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                           const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                                           const ComputePassCommandRecorderOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_computePassCommandRecorders.emplace(NullComputePassCommandRecorder{ .nullResourceManager = this, .deviceHandle = deviceHandle });
+}
+
+void NullResourceManager::deleteComputePassCommandRecorder(const Handle<ComputePassCommandRecorder_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_computePassCommandRecorders.remove(handle);
+}
+
+NullComputePassCommandRecorder *NullResourceManager::getComputePassCommandRecorder(const Handle<ComputePassCommandRecorder_t> &handle) const
+{
+    return m_computePassCommandRecorders.get(handle);
+}
+
+Handle<RayTracingPassCommandRecorder_t> NullResourceManager::createRayTracingPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                                 const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                                                 const RayTracingPassCommandRecorderOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_rayTracingPassCommandRecorders.emplace(NullRayTracingPassCommandRecorder{ .nullResourceManager = this, .deviceHandle = deviceHandle });
+}
+
+void NullResourceManager::deleteRayTracingPassCommandRecorder(const Handle<RayTracingPassCommandRecorder_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_rayTracingPassCommandRecorders.remove(handle);
+}
+
+NullRayTracingPassCommandRecorder *NullResourceManager::getRayTracingPassCommandRecorder(const Handle<RayTracingPassCommandRecorder_t> &handle) const
+{
+    return m_rayTracingPassCommandRecorders.get(handle);
+}
+
+Handle<TimestampQueryRecorder_t> NullResourceManager::createTimestampQueryRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                   const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                                   const TimestampQueryRecorderOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_timestampQueryRecorders.emplace(NullTimestampQueryRecorder{
+            .nullResourceManager = this,
+            .deviceHandle = deviceHandle,
+            .maxQueryCount = options.queryCount });
+}
+
+void NullResourceManager::deleteTimestampQueryRecorder(const Handle<TimestampQueryRecorder_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_timestampQueryRecorders.remove(handle);
+}
+
+NullTimestampQueryRecorder *NullResourceManager::getTimestampQueryRecorder(const Handle<TimestampQueryRecorder_t> &handle) const
+{
+    return m_timestampQueryRecorders.get(handle);
+}
+
+Handle<CommandBuffer_t> NullResourceManager::createCommandBuffer(const Handle<Device_t> &deviceHandle,
+                                                                 const QueueDescription &queueDescription,
+                                                                 CommandBufferLevel commandLevel)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_commandBuffers.emplace(NullCommandBuffer{ .deviceHandle = deviceHandle, .commandLevel = commandLevel });
+}
+
+void NullResourceManager::deleteCommandBuffer(const Handle<CommandBuffer_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_commandBuffers.remove(handle);
+}
+
+NullCommandBuffer *NullResourceManager::getCommandBuffer(const Handle<CommandBuffer_t> &handle) const
+{
+    return m_commandBuffers.get(handle);
+}
+
+Handle<FrameCommandAllocator_t> NullResourceManager::createFrameCommandAllocator(const Handle<Device_t> &deviceHandle, const FrameCommandAllocatorOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_frameCommandAllocators.emplace(NullFrameCommandAllocator{
+            .nullResourceManager = this,
+            .deviceHandle = deviceHandle,
+            .frameCount = options.frameCount });
+}
+
+void NullResourceManager::deleteFrameCommandAllocator(const Handle<FrameCommandAllocator_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_frameCommandAllocators.remove(handle);
+}
+
+NullFrameCommandAllocator *NullResourceManager::getFrameCommandAllocator(const Handle<FrameCommandAllocator_t> &handle) const
+{
+    return m_frameCommandAllocators.get(handle);
+}
+
+Handle<BindGroupPool_t> NullResourceManager::createBindGroupPool(const Handle<Device_t> &deviceHandle, const BindGroupPoolOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_bindGroupPools.emplace(NullBindGroupPool{
+            .nullResourceManager = this,
+            .deviceHandle = deviceHandle,
+            .maxBindGroupCount = options.maxBindGroupCount });
+}
+
+void NullResourceManager::deleteBindGroupPool(const Handle<BindGroupPool_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+
+    // Bind groups outliving their pool no longer hold an allocation
+    NullBindGroupPool *nullBindGroupPool = m_bindGroupPools.get(handle);
+    for (const Handle<BindGroup_t> &bindGroupHandle : nullBindGroupPool->bindGroups) {
+        if (NullBindGroup *nullBindGroup = m_bindGroups.get(bindGroupHandle))
+            nullBindGroup->allocated = false;
+    }
+
+    m_bindGroupPools.remove(handle);
+}
+
+NullBindGroupPool *NullResourceManager::getBindGroupPool(const Handle<BindGroupPool_t> &handle) const
+{
+    return m_bindGroupPools.get(handle);
+}
+
+Handle<BindGroup_t> NullResourceManager::createBindGroup(const Handle<Device_t> &deviceHandle, const BindGroupOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+
+    // Bind groups created without a pool are not tracked, as the Vulkan backend
+    // would allocate them from an internal pool the user never sees
+    const Handle<BindGroupPool_t> poolHandle = options.bindGroupPool;
+    NullBindGroupPool *nullBindGroupPool = m_bindGroupPools.get(poolHandle);
+    if (nullBindGroupPool && nullBindGroupPool->bindGroups.size() >= nullBindGroupPool->maxBindGroupCount) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "BindGroupPool out of memory");
+        return {};
+    }
+
+    const auto bindGroupHandle = m_bindGroups.emplace(NullBindGroup{
+            .nullResourceManager = this,
+            .deviceHandle = deviceHandle,
+            .bindGroupPoolHandle = poolHandle,
+            .implicitFree = options.implicitFree });
+    if (nullBindGroupPool)
+        nullBindGroupPool->bindGroups.push_back(bindGroupHandle);
+
+    NullBindGroup *nullBindGroup = m_bindGroups.get(bindGroupHandle);
+    for (const auto &resource : options.resources)
+        nullBindGroup->update(resource);
+
+    return bindGroupHandle;
+}
+
+void NullResourceManager::deleteBindGroup(const Handle<BindGroup_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+
+    NullBindGroup *nullBindGroup = m_bindGroups.get(handle);
+    if (nullBindGroup->allocated && nullBindGroup->implicitFree) {
+        if (NullBindGroupPool *nullBindGroupPool = m_bindGroupPools.get(nullBindGroup->bindGroupPoolHandle))
+            std::erase(nullBindGroupPool->bindGroups, handle);
+    }
+
+    m_bindGroups.remove(handle);
+}
+
+NullBindGroup *NullResourceManager::getBindGroup(const Handle<BindGroup_t> &handle) const
+{
+    return m_bindGroups.get(handle);
+}
+
+Handle<BindGroupLayout_t> NullResourceManager::createBindGroupLayout(const Handle<Device_t> &deviceHandle, const BindGroupLayoutOptions &options)
+{
+    NullDevice *nullDevice = m_devices.get(deviceHandle);
+    return nullDevice->bindGroupLayoutCache.getOrCreate(options, [&] {
+        m_callCounters.record(NullCall::CreateResource);
+        return m_bindGroupLayouts.emplace(NullBindGroupLayout{ .deviceHandle = deviceHandle, .bindings = options.bindings });
+    });
+}
+
+void NullResourceManager::deleteBindGroupLayout(const Handle<BindGroupLayout_t> &handle)
+{
+    NullBindGroupLayout *nullBindGroupLayout = m_bindGroupLayouts.get(handle);
+    NullDevice *nullDevice = m_devices.get(nullBindGroupLayout->deviceHandle);
+    if (!nullDevice->bindGroupLayoutCache.release(handle))
+        return;
+
+    m_callCounters.record(NullCall::DeleteResource);
+    m_bindGroupLayouts.remove(handle);
+}
+
+NullBindGroupLayout *NullResourceManager::getBindGroupLayout(const Handle<BindGroupLayout_t> &handle) const
+{
+    return m_bindGroupLayouts.get(handle);
+}
+
+Handle<Sampler_t> NullResourceManager::createSampler(const Handle<Device_t> &deviceHandle, const SamplerOptions &options)
+{
+    NullDevice *nullDevice = m_devices.get(deviceHandle);
+    return nullDevice->samplerCache.getOrCreate(options, [&] {
+        m_callCounters.record(NullCall::CreateResource);
+        return m_samplers.emplace(NullSampler{ .deviceHandle = deviceHandle });
+    });
+}
+
+void NullResourceManager::deleteSampler(const Handle<Sampler_t> &handle)
+{
+    NullSampler *nullSampler = m_samplers.get(handle);
+    NullDevice *nullDevice = m_devices.get(nullSampler->deviceHandle);
+    if (!nullDevice->samplerCache.release(handle))
+        return;
+
+    m_callCounters.record(NullCall::DeleteResource);
+    m_samplers.remove(handle);
+}
+
+NullSampler *NullResourceManager::getSampler(const Handle<Sampler_t> &handle) const
+{
+    return m_samplers.get(handle);
+}
+
+Handle<Fence_t> NullResourceManager::createFence(const Handle<Device_t> &deviceHandle, const FenceOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_fences.emplace(NullFence{
+            .nullResourceManager = this,
+            .deviceHandle = deviceHandle,
+            .signalled = options.createSignalled });
+}
+
+void NullResourceManager::deleteFence(const Handle<Fence_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_fences.remove(handle);
+}
+
+NullFence *NullResourceManager::getFence(const Handle<Fence_t> &handle) const
+{
+    return m_fences.get(handle);
+}
+
+Handle<AccelerationStructure_t> NullResourceManager::createAccelerationStructure(const Handle<Device_t> &deviceHandle, const AccelerationStructureOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_accelerationStructures.emplace(NullAccelerationStructure{ .deviceHandle = deviceHandle });
+}
+
+void NullResourceManager::deleteAccelerationStructure(const Handle<AccelerationStructure_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_accelerationStructures.remove(handle);
+}
+
+NullAccelerationStructure *NullResourceManager::getAccelerationStructure(const Handle<AccelerationStructure_t> &handle) const
+{
+    return m_accelerationStructures.get(handle);
+}
+
+Handle<YCbCrConversion_t> NullResourceManager::createYCbCrConversion(const Handle<Device_t> &deviceHandle, const YCbCrConversionOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_yCbCrConversions.emplace(NullYCbCrConversion{ .deviceHandle = deviceHandle });
+}
+
+void NullResourceManager::deleteYCbCrConversion(const Handle<YCbCrConversion_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_yCbCrConversions.remove(handle);
+}
+
+NullYCbCrConversion *NullResourceManager::getYCbCrConversion(const Handle<YCbCrConversion_t> &handle) const
+{
+    return m_yCbCrConversions.get(handle);
+}
+
+Handle<PipelineCache_t> NullResourceManager::createPipelineCache(const Handle<Device_t> &deviceHandle, const PipelineCacheOptions &options)
+{
+    m_callCounters.record(NullCall::CreateResource);
+    return m_pipelineCaches.emplace(NullPipelineCache{ .deviceHandle = deviceHandle });
+}
+
+void NullResourceManager::deletePipelineCache(const Handle<PipelineCache_t> &handle)
+{
+    m_callCounters.record(NullCall::DeleteResource);
+    m_pipelineCaches.remove(handle);
+}
+
+NullPipelineCache *NullResourceManager::getPipelineCache(const Handle<PipelineCache_t> &handle) const
+{
+    return m_pipelineCaches.get(handle);
+}
+
+} // namespace KDGpu
@@ -0,0 +1,251 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/null/null_call_counters.h>
+#include <KDGpu/null/null_resources.h>
+
+#include <KDGpu/instance.h>
+#include <KDGpu/pool.h>
+#include <KDGpu/kdgpu_export.h>
+#include <KDGpu/pipeline_cache_options.h>
+#include <KDGpu/frame_command_allocator_options.h>
+
+namespace KDGpu {
+
+struct AccelerationStructureOptions;
+struct BindGroupLayoutOptions;
+struct BindGroupPoolOptions;
+struct ComputePipelineOptions;
+struct FenceOptions;
+struct GpuSemaphoreOptions;
+struct GraphicsPipelineOptions;
+struct PipelineLayoutOptions;
+struct RayTracingPipelineOptions;
+struct RenderPassOptions;
+struct SamplerOptions;
+struct SwapchainOptions;
+struct TextureViewOptions;
+struct TimelineSemaphoreOptions;
+struct YCbCrConversionOptions;
+
+/**
+ * @brief NullResourceManager
+ * \ingroup null
+ *
+ * ResourceManager used when KDGpu is built with KDGPU_NULL_BACKEND. It keeps
+ * the same handle bookkeeping as VulkanResourceManager so that the cost of the
+ * front end can be measured on its own, without a driver or an ICD.
+ */
+class KDGPU_EXPORT NullResourceManager
+{
+public:
+    NullResourceManager();
+    ~NullResourceManager();
+
+    NullCallCounters &callCounters() noexcept { return m_callCounters; }
+    const NullCallCounters &callCounters() const noexcept { return m_callCounters; }
+
+    Handle<Instance_t> createInstance(const InstanceOptions &options);
+    void deleteInstance(const Handle<Instance_t> &handle);
+    [[nodiscard]] NullInstance *getInstance(const Handle<Instance_t> &handle) const;
+
+    Handle<Adapter_t> insertAdapter(const NullAdapter &adapter);
+    void removeAdapter(const Handle<Adapter_t> &handle);
+    [[nodiscard]] NullAdapter *getAdapter(const Handle<Adapter_t> &handle) const;
+
+    Handle<Device_t> createDevice(const Handle<Adapter_t> &adapterHandle, const DeviceOptions &options, std::vector<QueueRequest> &queueRequests);
+    void deleteDevice(const Handle<Device_t> &handle);
+    [[nodiscard]] NullDevice *getDevice(const Handle<Device_t> &handle) const;
+
+    Handle<Queue_t> insertQueue(const NullQueue &queue);
+    void removeQueue(const Handle<Queue_t> &handle);
+    [[nodiscard]] NullQueue *getQueue(const Handle<Queue_t> &handle) const;
+
+    Handle<Swapchain_t> createSwapchain(const Handle<Device_t> &deviceHandle, const SwapchainOptions &options);
+    void deleteSwapchain(const Handle<Swapchain_t> &handle);
+    [[nodiscard]] NullSwapchain *getSwapchain(const Handle<Swapchain_t> &handle) const;
+
+    Handle<Surface_t> insertSurface(const NullSurface &surface);
+    void deleteSurface(const Handle<Surface_t> &handle);
+    [[nodiscard]] NullSurface *getSurface(const Handle<Surface_t> &handle) const;
+
+    Handle<Texture_t> createTexture(const Handle<Device_t> &deviceHandle, const TextureOptions &options);
+    void deleteTexture(const Handle<Texture_t> &handle);
+    [[nodiscard]] NullTexture *getTexture(const Handle<Texture_t> &handle) const;
+
+    Handle<TextureView_t> createTextureView(const Handle<Device_t> &deviceHandle, const Handle<Texture_t> &textureHandle, const TextureViewOptions &options);
+    void deleteTextureView(const Handle<TextureView_t> &handle);
+    [[nodiscard]] NullTextureView *getTextureView(const Handle<TextureView_t> &handle) const;
+
+    Handle<Buffer_t> createBuffer(const Handle<Device_t> &deviceHandle, const BufferOptions &options, const void *initialData);
+    void deleteBuffer(const Handle<Buffer_t> &handle);
+    [[nodiscard]] NullBuffer *getBuffer(const Handle<Buffer_t> &handle) const;
+
+    Handle<ShaderModule_t> createShaderModule(const Handle<Device_t> &deviceHandle, const std::vector<uint32_t> &code);
+    void deleteShaderModule(const Handle<ShaderModule_t> &handle);
+    [[nodiscard]] NullShaderModule *getShaderModule(const Handle<ShaderModule_t> &handle) const;
+
+    Handle<RenderPass_t> createRenderPass(const Handle<Device_t> &deviceHandle, const RenderPassOptions &options);
+    void deleteRenderPass(const Handle<RenderPass_t> &handle);
+    [[nodiscard]] NullRenderPass *getRenderPass(const Handle<RenderPass_t> &handle) const;
+
+    Handle<PipelineLayout_t> createPipelineLayout(const Handle<Device_t> &deviceHandle, const PipelineLayoutOptions &options);
+    void deletePipelineLayout(const Handle<PipelineLayout_t> &handle);
+    [[nodiscard]] NullPipelineLayout *getPipelineLayout(const Handle<PipelineLayout_t> &handle) const;
+
+    Handle<GraphicsPipeline_t> createGraphicsPipeline(const Handle<Device_t> &deviceHandle, const GraphicsPipelineOptions &options);
+    Handle<GraphicsPipeline_t> getOrCreateGraphicsPipeline(const Handle<Device_t> &deviceHandle, const GraphicsPipelineOptions &options);
+    void deleteGraphicsPipeline(const Handle<GraphicsPipeline_t> &handle);
+    [[nodiscard]] NullGraphicsPipeline *getGraphicsPipeline(const Handle<GraphicsPipeline_t> &handle) const;
+
+    Handle<ComputePipeline_t> createComputePipeline(const Handle<Device_t> &deviceHandle, const ComputePipelineOptions &options);
+    Handle<ComputePipeline_t> getOrCreateComputePipeline(const Handle<Device_t> &deviceHandle, const ComputePipelineOptions &options);
+    void deleteComputePipeline(const Handle<ComputePipeline_t> &handle);
+    [[nodiscard]] NullComputePipeline *getComputePipeline(const Handle<ComputePipeline_t> &handle) const;
+
+    Handle<RayTracingPipeline_t> createRayTracingPipeline(const Handle<Device_t> &deviceHandle, const RayTracingPipelineOptions &options);
+    Handle<RayTracingPipeline_t> getOrCreateRayTracingPipeline(const Handle<Device_t> &deviceHandle, const RayTracingPipelineOptions &options);
+    void deleteRayTracingPipeline(const Handle<RayTracingPipeline_t> &handle);
+    [[nodiscard]] NullRayTracingPipeline *getRayTracingPipeline(const Handle<RayTracingPipeline_t> &handle) const;
+
+    [[nodiscard]] PipelineDeduplicationStats pipelineDeduplicationStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] ShaderModuleDeduplicationStats shaderModuleDeduplicationStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] DeduplicationStats samplerDeduplicationStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] DeduplicationStats bindGroupLayoutDeduplicationStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] RenderTargetCacheStats renderPassCacheStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] RenderTargetCacheStats framebufferCacheStats(const Handle<Device_t> &deviceHandle);
+    void releaseThreadCommandPools(const Handle<Device_t> &deviceHandle);
+
+    Handle<GpuSemaphore_t> createGpuSemaphore(const Handle<Device_t> &deviceHandle, const GpuSemaphoreOptions &options);
+    void deleteGpuSemaphore(const Handle<GpuSemaphore_t> &handle);
+    [[nodiscard]] NullGpuSemaphore *getGpuSemaphore(const Handle<GpuSemaphore_t> &handle) const;
+
+    Handle<TimelineSemaphore_t> createTimelineSemaphore(const Handle<Device_t> &deviceHandle, const TimelineSemaphoreOptions &options);
+    void deleteTimelineSemaphore(const Handle<TimelineSemaphore_t> &handle);
+    [[nodiscard]] NullTimelineSemaphore *getTimelineSemaphore(const Handle<TimelineSemaphore_t> &handle) const;
+
+    Handle<CommandRecorder_t> createCommandRecorder(const Handle<Device_t> &deviceHandle, const CommandRecorderOptions &options);
+    void deleteCommandRecorder(const Handle<CommandRecorder_t> &handle);
+    [[nodiscard]] NullCommandRecorder *getCommandRecorder(const Handle<CommandRecorder_t> &handle) const;
+
+    Handle<RenderPassCommandRecorder_t> createRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                        const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                        const RenderPassCommandRecorderOptions &options);
+    Handle<RenderPassCommandRecorder_t> createRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                        const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                        const RenderPassCommandRecorderWithRenderPassOptions &options);
+    Handle<RenderPassCommandRecorder_t> createRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                        const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                        const RenderPassCommandRecorderWithDynamicRenderingOptions &options);
+    Handle<RenderPassCommandRecorder_t> createInheritedRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                 const Handle<CommandRecorder_t> &commandRecorderHandle);
+    void deleteRenderPassCommandRecorder(const Handle<RenderPassCommandRecorder_t> &handle);
+    [[nodiscard]] NullRenderPassCommandRecorder *getRenderPassCommandRecorder(const Handle<RenderPassCommandRecorder_t> &handle) const;
+
+    Handle<ComputePassCommandRecorder_t> createComputePassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                          const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                          const ComputePassCommandRecorderOptions &options);
+    void deleteComputePassCommandRecorder(const Handle<ComputePassCommandRecorder_t> &handle);
+    [[nodiscard]] NullComputePassCommandRecorder *getComputePassCommandRecorder(const Handle<ComputePassCommandRecorder_t> &handle) const;
+
+    Handle<RayTracingPassCommandRecorder_t> createRayTracingPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                                const RayTracingPassCommandRecorderOptions &options);
+    void deleteRayTracingPassCommandRecorder(const Handle<RayTracingPassCommandRecorder_t> &handle);
+    [[nodiscard]] NullRayTracingPassCommandRecorder *getRayTracingPassCommandRecorder(const Handle<RayTracingPassCommandRecorder_t> &handle) const;
+
+    Handle<TimestampQueryRecorder_t> createTimestampQueryRecorder(const Handle<Device_t> &deviceHandle,
+                                                                  const Handle<CommandRecorder_t> &commandRecorderHandle,
+                                                                  const TimestampQueryRecorderOptions &options);
+    void deleteTimestampQueryRecorder(const Handle<TimestampQueryRecorder_t> &handle);
+    [[nodiscard]] NullTimestampQueryRecorder *getTimestampQueryRecorder(const Handle<TimestampQueryRecorder_t> &handle) const;
+
+    Handle<CommandBuffer_t> createCommandBuffer(const Handle<Device_t> &deviceHandle,
+                                                const QueueDescription &queueDescription,
+                                                CommandBufferLevel commandLevel);
+    void deleteCommandBuffer(const Handle<CommandBuffer_t> &handle);
+    [[nodiscard]] NullCommandBuffer *getCommandBuffer(const Handle<CommandBuffer_t> &handle) const;
+
+    Handle<FrameCommandAllocator_t> createFrameCommandAllocator(const Handle<Device_t> &deviceHandle, const FrameCommandAllocatorOptions &options);
+    void deleteFrameCommandAllocator(const Handle<FrameCommandAllocator_t> &handle);
+    [[nodiscard]] NullFrameCommandAllocator *getFrameCommandAllocator(const Handle<FrameCommandAllocator_t> &handle) const;
+
+    Handle<BindGroupPool_t> createBindGroupPool(const Handle<Device_t> &deviceHandle, const BindGroupPoolOptions &options);
+    void deleteBindGroupPool(const Handle<BindGroupPool_t> &handle);
+    [[nodiscard]] NullBindGroupPool *getBindGroupPool(const Handle<BindGroupPool_t> &handle) const;
+
+    Handle<BindGroup_t> createBindGroup(const Handle<Device_t> &deviceHandle, const BindGroupOptions &options);
+    void deleteBindGroup(const Handle<BindGroup_t> &handle);
+    [[nodiscard]] NullBindGroup *getBindGroup(const Handle<BindGroup_t> &handle) const;
+
+    Handle<BindGroupLayout_t> createBindGroupLayout(const Handle<Device_t> &deviceHandle, const BindGroupLayoutOptions &options);
+    void deleteBindGroupLayout(const Handle<BindGroupLayout_t> &handle);
+    [[nodiscard]] NullBindGroupLayout *getBindGroupLayout(const Handle<BindGroupLayout_t> &handle) const;
+
+    Handle<Sampler_t> createSampler(const Handle<Device_t> &deviceHandle, const SamplerOptions &options);
+    void deleteSampler(const Handle<Sampler_t> &handle);
+    [[nodiscard]] NullSampler *getSampler(const Handle<Sampler_t> &handle) const;
+
+    Handle<Fence_t> createFence(const Handle<Device_t> &deviceHandle, const FenceOptions &options);
+    void deleteFence(const Handle<Fence_t> &handle);
+    [[nodiscard]] NullFence *getFence(const Handle<Fence_t> &handle) const;
+
+    Handle<AccelerationStructure_t> createAccelerationStructure(const Handle<Device_t> &deviceHandle, const AccelerationStructureOptions &options);
+    void deleteAccelerationStructure(const Handle<AccelerationStructure_t> &handle);
+    [[nodiscard]] NullAccelerationStructure *getAccelerationStructure(const Handle<AccelerationStructure_t> &handle) const;
+
+    Handle<YCbCrConversion_t> createYCbCrConversion(const Handle<Device_t> &deviceHandle, const YCbCrConversionOptions &options);
+    void deleteYCbCrConversion(const Handle<YCbCrConversion_t> &handle);
+    [[nodiscard]] NullYCbCrConversion *getYCbCrConversion(const Handle<YCbCrConversion_t> &handle) const;
+
+    Handle<PipelineCache_t> createPipelineCache(const Handle<Device_t> &deviceHandle, const PipelineCacheOptions &options);
+    void deletePipelineCache(const Handle<PipelineCache_t> &handle);
+    [[nodiscard]] NullPipelineCache *getPipelineCache(const Handle<PipelineCache_t> &handle) const;
+
+private:
+    NullCallCounters m_callCounters;
+
+    Pool<NullInstance, Instance_t> m_instances{ 1 };
+    Pool<NullAdapter, Adapter_t> m_adapters{ 1 };
+    Pool<NullDevice, Device_t> m_devices{ 1 };
+    Pool<NullQueue, Queue_t> m_queues{ 4 };
+    Pool<NullSurface, Surface_t> m_surfaces{ 1 };
+    Pool<NullSwapchain, Swapchain_t> m_swapchains{ 1 };
+    Pool<NullTexture, Texture_t> m_textures{ 128 };
+    Pool<NullTextureView, TextureView_t> m_textureViews{ 128 };
+    Pool<NullBuffer, Buffer_t> m_buffers{ 128 };
+    Pool<NullShaderModule, ShaderModule_t> m_shaderModules{ 64 };
+    Pool<NullRenderPass, RenderPass_t> m_renderPasses{ 16 };
+    Pool<NullPipelineLayout, PipelineLayout_t> m_pipelineLayouts{ 64 };
+    Pool<NullGraphicsPipeline, GraphicsPipeline_t> m_graphicsPipelines{ 64 };
+    Pool<NullComputePipeline, ComputePipeline_t> m_computePipelines{ 64 };
+    Pool<NullRayTracingPipeline, RayTracingPipeline_t> m_rayTracingPipelines{ 64 };
+    Pool<NullGpuSemaphore, GpuSemaphore_t> m_gpuSemaphores{ 32 };
+    Pool<NullTimelineSemaphore, TimelineSemaphore_t> m_timelineSemaphores{ 32 };
+    Pool<NullCommandRecorder, CommandRecorder_t> m_commandRecorders{ 32 };
+    Pool<NullRenderPassCommandRecorder, RenderPassCommandRecorder_t> m_renderPassCommandRecorders{ 32 };
+    Pool<NullComputePassCommandRecorder, ComputePassCommandRecorder_t> m_computePassCommandRecorders{ 32 };
+    Pool<NullRayTracingPassCommandRecorder, RayTracingPassCommandRecorder_t> m_rayTracingPassCommandRecorders{ 32 };
+    Pool<NullTimestampQueryRecorder, TimestampQueryRecorder_t> m_timestampQueryRecorders{ 4 };
+    Pool<NullCommandBuffer, CommandBuffer_t> m_commandBuffers{ 128 };
+    Pool<NullFrameCommandAllocator, FrameCommandAllocator_t> m_frameCommandAllocators{ 4 };
+    Pool<NullBindGroupPool, BindGroupPool_t> m_bindGroupPools{ 4 };
+    Pool<NullBindGroup, BindGroup_t> m_bindGroups{ 128 };
+    Pool<NullBindGroupLayout, BindGroupLayout_t> m_bindGroupLayouts{ 128 };
+    Pool<NullSampler, Sampler_t> m_samplers{ 16 };
+    Pool<NullFence, Fence_t> m_fences{ 16 };
+    Pool<NullAccelerationStructure, AccelerationStructure_t> m_accelerationStructures{ 32 };
+    Pool<NullYCbCrConversion, YCbCrConversion_t> m_yCbCrConversions{ 16 };
+    Pool<NullPipelineCache, PipelineCache_t> m_pipelineCaches{ 4 };
+};
+
+} // namespace KDGpu
@@ -0,0 +1,833 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "null_resources.h"
+
+#include <KDGpu/null/null_resource_manager.h>
+
+#include <KDGpu/utils/logging.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace KDGpu {
+
+namespace {
+
+constexpr uint32_t NullShaderGroupHandleSize = 32;
+
+void recordCall(NullResourceManager *nullResourceManager, NullCall call, uint64_t count = 1)
+{
+    assert(nullResourceManager);
+    nullResourceManager->callCounters().record(call, count);
+}
+
+} // namespace
+
+std::vector<Extension> NullInstance::extensions() const
+{
+    return {};
+}
+
+std::vector<Handle<Adapter_t>> NullInstance::queryAdapters(const Handle<Instance_t> &instanceHandle)
+{
+    recordCall(nullResourceManager, NullCall::QueryAdapters);
+
+    if (adapterHandles.empty())
+        adapterHandles.emplace_back(nullResourceManager->insertAdapter(NullAdapter{ nullResourceManager, instanceHandle }));
+    return adapterHandles;
+}
+
+std::vector<AdapterGroup> NullInstance::queryAdapterGroups()
+{
+    return { AdapterGroup{ .adapters = adapterHandles } };
+}
+
+Handle<Surface_t> NullInstance::createSurface(const SurfaceOptions &options)
+{
+    recordCall(nullResourceManager, NullCall::CreateSurface);
+    return nullResourceManager->insertSurface(NullSurface{ nullResourceManager });
+}
+
+std::vector<Extension> NullAdapter::extensions() const
+{
+    return {};
+}
+
+AdapterProperties NullAdapter::queryAdapterProperties()
+{
+    AdapterProperties properties{
+        .apiVersion = KDGPU_MAKE_API_VERSION(0, 1, 3, 0),
+        .deviceType = AdapterDeviceType::DiscreteGpu,
+        .deviceName = "KDGpu Null Adapter",
+    };
+
+    AdapterLimits &limits = properties.limits;
+    limits.maxImageDimension1D = 16384;
+    limits.maxImageDimension2D = 16384;
+    limits.maxImageDimension3D = 2048;
+    limits.maxImageDimensionCube = 16384;
+    limits.maxImageArrayLayers = 2048;
+    limits.maxUniformBufferRange = 65536;
+    limits.maxStorageBufferRange = std::numeric_limits<uint32_t>::max();
+    limits.maxPushConstantsSize = 256;
+    limits.maxBoundDescriptorSets = 32;
+    limits.maxColorAttachments = 8;
+    limits.maxViewports = 16;
+    limits.minMemoryMapAlignment = 64;
+    limits.minTexelBufferOffsetAlignment = 16;
+    limits.minUniformBufferOffsetAlignment = 64;
+    limits.minStorageBufferOffsetAlignment = 16;
+    limits.optimalBufferCopyOffsetAlignment = 1;
+    limits.optimalBufferCopyRowPitchAlignment = 1;
+    limits.timestampPeriod = 1.0f;
+
+    properties.rayTracingProperties.shaderGroupHandleSize = NullShaderGroupHandleSize;
+    properties.rayTracingProperties.shaderGroupHandleAlignment = NullShaderGroupHandleSize;
+    properties.rayTracingProperties.shaderGroupBaseAlignment = 64;
+
+    properties.hostImageCopyProperties.srcCopyLayouts = { TextureLayout::General, TextureLayout::TransferSrcOptimal, TextureLayout::ShaderReadOnlyOptimal };
+    properties.hostImageCopyProperties.dstCopyLayouts = { TextureLayout::General, TextureLayout::TransferDstOptimal, TextureLayout::ShaderReadOnlyOptimal };
+    properties.externalMemoryHostProperties.minImportedHostPointerAlignment = 4096;
+
+    return properties;
+}
+
+AdapterFeatures NullAdapter::queryAdapterFeatures()
+{
+    // Host image copies only record their call, nothing prevents supporting them
+    return AdapterFeatures{ .hostImageCopy = true };
+}
+
+AdapterSwapchainProperties NullAdapter::querySwapchainProperties(const Handle<Surface_t> &surfaceHandle)
+{
+    return AdapterSwapchainProperties{
+        .capabilities = {
+                .minImageCount = 2,
+                .maxImageCount = 8,
+                .currentExtent = { 0, 0 },
+                .minImageExtent = { 1, 1 },
+                .maxImageExtent = { 16384, 16384 },
+                .maxImageArrayLayers = 1,
+                .supportedTransforms = SurfaceTransformFlagBits::IdentityBit,
+                .currentTransform = SurfaceTransformFlagBits::IdentityBit,
+                .supportedCompositeAlpha = CompositeAlphaFlagBits::OpaqueBit,
+                .supportedUsageFlags = TextureUsageFlagBits::ColorAttachmentBit | TextureUsageFlagBits::TransferDstBit,
+        },
+        .formats = { SurfaceFormat{ .format = Format::B8G8R8A8_UNORM, .colorSpace = ColorSpace::SRgbNonlinear } },
+        .presentModes = { PresentMode::Fifo, PresentMode::Mailbox, PresentMode::Immediate },
+    };
+}
+
+std::vector<AdapterQueueType> NullAdapter::queryQueueTypes()
+{
+    return {
+        AdapterQueueType{
+                .flags = QueueFlagBits::GraphicsBit | QueueFlagBits::ComputeBit | QueueFlagBits::TransferBit,
+                .availableQueues = 4,
+                .timestampValidBits = 64,
+                .minImageTransferGranularity = { 1, 1, 1 } },
+    };
+}
+
+bool NullAdapter::supportsPresentation(const Handle<Surface_t> surfaceHandle, uint32_t queueTypeIndex)
+{
+    return true;
+}
+
+FormatProperties NullAdapter::formatProperties(Format format) const
+{
+    const FormatFeatureFlags textureFeatures = FormatFeatureFlagBit::SampledImageBit |
+            FormatFeatureFlagBit::StorageImageBit |
+            FormatFeatureFlagBit::ColorAttachmentBit |
+            FormatFeatureFlagBit::ColorAttachmentBlendBit |
+            FormatFeatureFlagBit::DepthStencilAttachmentBit |
+            FormatFeatureFlagBit::BlitSrcBit |
+            FormatFeatureFlagBit::BlitDstBit |
+            FormatFeatureFlagBit::SampledImageFilterLinearBit |
+            FormatFeatureFlagBit::TransferSrcBit |
+            FormatFeatureFlagBit::TransferDstBit;
+    const FormatFeatureFlags bufferFeatures = FormatFeatureFlagBit::VertexBufferBit |
+            FormatFeatureFlagBit::UniformTexelBufferBit |
+            FormatFeatureFlagBit::StorageTexelBufferBit;
+
+    return FormatProperties{
+        .linearTilingFeatures = textureFeatures,
+        .optimalTilingFeatures = textureFeatures,
+        .bufferFeatures = bufferFeatures,
+    };
+}
+
+std::vector<DrmFormatModifierProperties> NullAdapter::drmFormatModifierProperties(Format format) const
+{
+    return {};
+}
+
+std::vector<QueueDescription> NullDevice::getQueues(NullResourceManager *resourceManager,
+                                                    const std::vector<QueueRequest> &queueRequests,
+                                                    std::span<AdapterQueueType> queueTypes)
+{
+    uint32_t queueCount = 0;
+    for (const auto &queueRequest : queueRequests)
+        queueCount += queueRequest.count;
+
+    queueDescriptions.clear();
+    queueDescriptions.reserve(queueCount);
+
+    for (const auto &queueRequest : queueRequests) {
+        for (uint32_t j = 0; j < queueRequest.count; ++j) {
+            const auto queueHandle = resourceManager->insertQueue(NullQueue{ resourceManager });
+
+            QueueDescription queueDescription{
+                .queue = queueHandle,
+                .flags = queueTypes[queueRequest.queueTypeIndex].flags,
+                .timestampValidBits = queueTypes[queueRequest.queueTypeIndex].timestampValidBits,
+                .minImageTransferGranularity = queueTypes[queueRequest.queueTypeIndex].minImageTransferGranularity,
+                .queueTypeIndex = queueRequest.queueTypeIndex
+            };
+            queueDescriptions.push_back(queueDescription);
+        }
+    }
+
+    return queueDescriptions;
+}
+
+void NullDevice::waitUntilIdle() const
+{
+    recordCall(nullResourceManager, NullCall::DeviceWaitUntilIdle);
+}
+
+void NullQueue::waitUntilIdle()
+{
+    recordCall(nullResourceManager, NullCall::QueueWaitUntilIdle);
+}
+
+void NullQueue::submit(const SubmitOptions &options)
+{
+    recordCall(nullResourceManager, NullCall::QueueSubmit);
+
+    // Work completes as soon as it is submitted
+    for (const TimelineSemaphoreSubmitSignalInfo &signalInfo : options.signalTimelineSemaphores) {
+        if (NullTimelineSemaphore *semaphore = nullResourceManager->getTimelineSemaphore(signalInfo.semaphore))
+            semaphore->currentValue = signalInfo.value;
+    }
+
+    if (NullFence *fence = nullResourceManager->getFence(options.signalFence)) {
+        fence->signalled = true;
+        ++fence->submissionCount;
+    }
+}
+
+PresentResult NullQueue::present(const PresentOptions &options)
+{
+    recordCall(nullResourceManager, NullCall::QueuePresent);
+
+    m_lastPerSwapchainPresentResults.assign(options.swapchainInfos.size(), PresentResult::Success);
+    for (const OptionalHandle<Fence_t> &fenceHandle : options.signalFence) {
+        if (NullFence *fence = nullResourceManager->getFence(fenceHandle)) {
+            fence->signalled = true;
+            ++fence->submissionCount;
+        }
+    }
+
+    return PresentResult::Success;
+}
+
+std::vector<PresentResult> NullQueue::lastPerSwapchainPresentResults() const
+{
+    return m_lastPerSwapchainPresentResults;
+}
+
+std::vector<Handle<Texture_t>> NullSwapchain::getTextures()
+{
+    return textures;
+}
+
+AcquireImageResult NullSwapchain::getNextImageIndex(uint32_t &imageIndex, const Handle<GpuSemaphore_t> &semaphore)
+{
+    recordCall(nullResourceManager, NullCall::AcquireNextImage);
+
+    if (textures.empty())
+        return AcquireImageResult::OutOfDate;
+
+    imageIndex = nextImageIndex;
+    nextImageIndex = (nextImageIndex + 1) % textures.size();
+    return AcquireImageResult::Success;
+}
+
+void *NullTexture::map()
+{
+    recordCall(nullResourceManager, NullCall::TextureMap);
+    return nullptr;
+}
+
+void NullTexture::unmap()
+{
+    recordCall(nullResourceManager, NullCall::TextureUnmap);
+}
+
+void NullTexture::hostLayoutTransition(const HostLayoutTransition &transition)
+{
+    recordCall(nullResourceManager, NullCall::HostLayoutTransition);
+}
+
+void NullTexture::copyHostMemoryToTexture(const HostMemoryToTextureCopy &copy)
+{
+    recordCall(nullResourceManager, NullCall::CopyHostMemoryToTexture);
+}
+
+void NullTexture::copyTextureToHostMemory(const TextureToHostMemoryCopy &copy)
+{
+    recordCall(nullResourceManager, NullCall::CopyTextureToHostMemory);
+}
+
+void NullTexture::copyTextureToTextureHost(const TextureToTextureCopyHost &copy)
+{
+    recordCall(nullResourceManager, NullCall::CopyTextureToTextureHost);
+}
+
+SubresourceLayout NullTexture::getSubresourceLayout(const TextureSubresource &subresource) const
+{
+    return {};
+}
+
+MemoryHandle NullTexture::externalMemoryHandle() const
+{
+    return {};
+}
+
+uint64_t NullTexture::drmFormatModifier() const
+{
+    return 0;
+}
+
+void *NullBuffer::map()
+{
+    recordCall(nullResourceManager, NullCall::BufferMap);
+
+    if (hostPointer)
+        return hostPointer;
+    if (data.size() != size)
+        data.resize(size);
+    return data.data();
+}
+
+void NullBuffer::unmap()
+{
+    recordCall(nullResourceManager, NullCall::BufferUnmap);
+}
+
+void NullBuffer::invalidate(DeviceSize offset, DeviceSize size)
+{
+    recordCall(nullResourceManager, NullCall::BufferInvalidate);
+}
+
+void NullBuffer::flush(DeviceSize offset, DeviceSize size)
+{
+    recordCall(nullResourceManager, NullCall::BufferFlush);
+}
+
+void *NullBuffer::mappedPointer()
+{
+    if (hostPointer)
+        return hostPointer;
+    return persistentlyMapped ? data.data() : nullptr;
+}
+
+MemoryHandle NullBuffer::externalMemoryHandle() const
+{
+    return {};
+}
+
+BufferDeviceAddress NullBuffer::bufferDeviceAddress() const
+{
+    return 0;
+}
+
+std::vector<uint8_t> NullRayTracingPipeline::shaderGroupHandles(uint32_t firstGroup, uint32_t groupCount) const
+{
+    return std::vector<uint8_t>(groupCount * NullShaderGroupHandleSize, 0);
+}
+
+HandleOrFD NullGpuSemaphore::externalSemaphoreHandle() const
+{
+    return {};
+}
+
+uint64_t NullTimelineSemaphore::value() const
+{
+    return currentValue;
+}
+
+void NullTimelineSemaphore::signal(uint64_t value) const
+{
+    recordCall(nullResourceManager, NullCall::TimelineSemaphoreSignal);
+    currentValue = value;
+}
+
+TimelineSemaphoreWaitResult NullTimelineSemaphore::wait(uint64_t value) const
+{
+    recordCall(nullResourceManager, NullCall::TimelineSemaphoreWait);
+
+    // Nothing is pending on the null backend, a value not reached yet never will be
+    return currentValue >= value ? TimelineSemaphoreWaitResult::Success : TimelineSemaphoreWaitResult::Timeout;
+}
+
+HandleOrFD NullTimelineSemaphore::externalSemaphoreHandle() const
+{
+    return {};
+}
+
+void NullFence::wait()
+{
+    recordCall(nullResourceManager, NullCall::FenceWait);
+}
+
+void NullFrameCommandAllocator::beginFrame(uint32_t frameIndex, const Handle<Fence_t> &frameFence)
+{
+    if (frameIndex >= frameCount) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Frame index {} is out of range, the allocator has {} frames", frameIndex, frameCount);
+        return;
+    }
+    if (frameFence.isValid())
+        nullResourceManager->getFence(frameFence)->wait();
+    recordCall(nullResourceManager, NullCall::CommandPoolReset);
+    currentFrame = frameIndex;
+}
+
+void NullFence::reset()
+{
+    recordCall(nullResourceManager, NullCall::FenceReset);
+    signalled = false;
+}
+
+FenceStatus NullFence::status()
+{
+    recordCall(nullResourceManager, NullCall::FenceStatus);
+    return signalled ? FenceStatus::Signalled : FenceStatus::Unsignalled;
+}
+
+HandleOrFD NullFence::externalFenceHandle() const
+{
+    return {};
+}
+
+void NullCommandRecorder::begin() const
+{
+    recordCall(nullResourceManager, NullCall::Begin);
+}
+
+void NullCommandRecorder::blitTexture(const TextureBlitOptions &options) const
+{
+    recordCall(nullResourceManager, NullCall::BlitTexture);
+}
+
+void NullCommandRecorder::clearBuffer(const BufferClear &clear) const
+{
+    recordCall(nullResourceManager, NullCall::ClearBuffer);
+}
+
+void NullCommandRecorder::clearColorTexture(const ClearColorTexture &clear) const
+{
+    recordCall(nullResourceManager, NullCall::ClearColorTexture);
+}
+
+void NullCommandRecorder::clearDepthStencilTexture(const ClearDepthStencilTexture &clear) const
+{
+    recordCall(nullResourceManager, NullCall::ClearDepthStencilTexture);
+}
+
+void NullCommandRecorder::copyBuffer(const BufferCopy &copy) const
+{
+    recordCall(nullResourceManager, NullCall::CopyBuffer);
+}
+
+void NullCommandRecorder::copyBufferToTexture(const BufferToTextureCopy &copy) const
+{
+    recordCall(nullResourceManager, NullCall::CopyBufferToTexture);
+}
+
+void NullCommandRecorder::copyTextureToBuffer(const TextureToBufferCopy &copy) const
+{
+    recordCall(nullResourceManager, NullCall::CopyTextureToBuffer);
+}
+
+void NullCommandRecorder::copyTextureToTexture(const TextureToTextureCopy &copy) const
+{
+    recordCall(nullResourceManager, NullCall::CopyTextureToTexture);
+}
+
+void NullCommandRecorder::updateBuffer(const BufferUpdate &update) const
+{
+    recordCall(nullResourceManager, NullCall::UpdateBuffer);
+}
+
+void NullCommandRecorder::memoryBarrier(const MemoryBarrierOptions &options) const
+{
+    recordCall(nullResourceManager, NullCall::MemoryBarrier);
+}
+
+void NullCommandRecorder::bufferMemoryBarrier(const BufferMemoryBarrierOptions &options) const
+{
+    recordCall(nullResourceManager, NullCall::BufferMemoryBarrier);
+}
+
+void NullCommandRecorder::textureMemoryBarrier(const TextureMemoryBarrierOptions &options) const
+{
+    recordCall(nullResourceManager, NullCall::TextureMemoryBarrier);
+}
+
+void NullCommandRecorder::textureMemoryBarriers(std::span<const TextureMemoryBarrierOptions> options) const
+{
+    recordCall(nullResourceManager, NullCall::TextureMemoryBarrier);
+}
+
+void NullCommandRecorder::executeSecondaryCommandBuffer(const Handle<CommandBuffer_t> &secondaryCommandBuffer) const
+{
+    recordCall(nullResourceManager, NullCall::ExecuteSecondaryCommandBuffer);
+}
+
+void NullCommandRecorder::resolveTexture(const TextureResolveOptions &options) const
+{
+    recordCall(nullResourceManager, NullCall::ResolveTexture);
+}
+
+void NullCommandRecorder::buildAccelerationStructures(const BuildAccelerationStructureOptions &options) const
+{
+    recordCall(nullResourceManager, NullCall::BuildAccelerationStructures);
+}
+
+void NullCommandRecorder::beginDebugLabel(const DebugLabelOptions &options) const
+{
+    recordCall(nullResourceManager, NullCall::BeginDebugLabel);
+}
+
+void NullCommandRecorder::endDebugLabel() const
+{
+    recordCall(nullResourceManager, NullCall::EndDebugLabel);
+}
+
+Handle<CommandBuffer_t> NullCommandRecorder::finish() const
+{
+    recordCall(nullResourceManager, NullCall::Finish);
+    return commandBufferHandle;
+}
+
+void NullRenderPassCommandRecorder::setPipeline(const Handle<GraphicsPipeline_t> &_pipeline)
+{
+    if (!bindState.bindPipeline(_pipeline))
+        return;
+    recordCall(nullResourceManager, NullCall::SetPipeline);
+    pipeline = _pipeline;
+    if (const NullGraphicsPipeline *nullPipeline = nullResourceManager->getGraphicsPipeline(pipeline))
+        bindState.setPipelineLayout(nullPipeline->pipelineLayoutHandle);
+}
+
+void NullRenderPassCommandRecorder::setVertexBuffer(uint32_t index, const Handle<Buffer_t> &buffer, DeviceSize offset)
+{
+    if (bindState.bindVertexBuffer(index, buffer, offset))
+        recordCall(nullResourceManager, NullCall::SetVertexBuffer);
+}
+
+void NullRenderPassCommandRecorder::setIndexBuffer(const Handle<Buffer_t> &buffer, DeviceSize offset, IndexType indexType)
+{
+    if (bindState.bindIndexBuffer(buffer, offset, indexType))
+        recordCall(nullResourceManager, NullCall::SetIndexBuffer);
+}
+
+void NullRenderPassCommandRecorder::setBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroup,
+                                                 const Handle<PipelineLayout_t> &pipelineLayout, std::span<const uint32_t> dynamicBufferOffsets)
+{
+    const Handle<PipelineLayout_t> &pipelineLayoutHandle = pipelineLayout.isValid() ? pipelineLayout : bindState.pipelineLayout();
+    if (bindState.bindBindGroup(group, bindGroup, pipelineLayoutHandle, dynamicBufferOffsets))
+        recordCall(nullResourceManager, NullCall::SetBindGroup);
+}
+
+void NullRenderPassCommandRecorder::setViewport(const Viewport &viewport) const
+{
+    recordCall(nullResourceManager, NullCall::SetViewport);
+}
+
+void NullRenderPassCommandRecorder::setScissor(const Rect2D &scissor) const
+{
+    recordCall(nullResourceManager, NullCall::SetScissor);
+}
+
+void NullRenderPassCommandRecorder::setStencilReference(StencilFaceFlags faceMask, int reference) const
+{
+    recordCall(nullResourceManager, NullCall::SetStencilReference);
+}
+
+void NullRenderPassCommandRecorder::draw(const DrawCommand &drawCommand) const
+{
+    recordCall(nullResourceManager, NullCall::Draw);
+}
+
+void NullRenderPassCommandRecorder::draw(std::span<const DrawCommand> drawCommands) const
+{
+    recordCall(nullResourceManager, NullCall::Draw, drawCommands.size());
+}
+
+void NullRenderPassCommandRecorder::drawIndexed(const DrawIndexedCommand &drawCommand) const
+{
+    recordCall(nullResourceManager, NullCall::DrawIndexed);
+}
+
+void NullRenderPassCommandRecorder::drawIndexed(std::span<const DrawIndexedCommand> drawCommands) const
+{
+    recordCall(nullResourceManager, NullCall::DrawIndexed, drawCommands.size());
+}
+
+void NullRenderPassCommandRecorder::drawIndirect(const DrawIndirectCommand &drawCommand) const
+{
+    recordCall(nullResourceManager, NullCall::DrawIndirect);
+}
+
+void NullRenderPassCommandRecorder::drawIndirect(std::span<const DrawIndirectCommand> drawCommands) const
+{
+    recordCall(nullResourceManager, NullCall::DrawIndirect, drawCommands.size());
+}
+
+void NullRenderPassCommandRecorder::drawIndexedIndirect(const DrawIndexedIndirectCommand &drawCommand) const
+{
+    recordCall(nullResourceManager, NullCall::DrawIndexedIndirect);
+}
+
+void NullRenderPassCommandRecorder::drawIndexedIndirect(std::span<const DrawIndexedIndirectCommand> drawCommands) const
+{
+    recordCall(nullResourceManager, NullCall::DrawIndexedIndirect, drawCommands.size());
+}
+
+void NullRenderPassCommandRecorder::drawMeshTasks(const DrawMeshCommand &drawCommand) const
+{
+    recordCall(nullResourceManager, NullCall::DrawMeshTasks);
+}
+
+void NullRenderPassCommandRecorder::drawMeshTasks(std::span<const DrawMeshCommand> drawCommands) const
+{
+    recordCall(nullResourceManager, NullCall::DrawMeshTasks, drawCommands.size());
+}
+
+void NullRenderPassCommandRecorder::drawMeshTasksIndirect(const DrawMeshIndirectCommand &drawCommand) const
+{
+    recordCall(nullResourceManager, NullCall::DrawMeshTasksIndirect);
+}
+
+void NullRenderPassCommandRecorder::drawMeshTasksIndirect(std::span<const DrawMeshIndirectCommand> drawCommands) const
+{
+    recordCall(nullResourceManager, NullCall::DrawMeshTasksIndirect, drawCommands.size());
+}
+
+void NullRenderPassCommandRecorder::pushConstant(const PushConstantRange &constantRange, const void *data, const Handle<PipelineLayout_t> &pipelineLayout) const
+{
+    recordCall(nullResourceManager, NullCall::PushConstant);
+}
+
+void NullRenderPassCommandRecorder::pushBindGroup(uint32_t group, std::span<const BindGroupEntry> bindGroupEntries, const Handle<PipelineLayout_t> &pipelineLayout)
+{
+    bindState.forgetBindGroups();
+    recordCall(nullResourceManager, NullCall::PushBindGroup);
+}
+
+void NullRenderPassCommandRecorder::nextSubpass() const
+{
+    recordCall(nullResourceManager, NullCall::NextSubpass);
+}
+
+void NullRenderPassCommandRecorder::setInputAttachmentMapping(std::span<const std::optional<uint32_t>> colorAttachmentIndices,
+                                                              std::optional<uint32_t> depthAttachmentIndex,
+                                                              std::optional<uint32_t> stencilAttachmentIndex) const
+{
+    recordCall(nullResourceManager, NullCall::SetInputAttachmentMapping);
+}
+
+void NullRenderPassCommandRecorder::setOutputAttachmentMapping(std::span<const std::optional<uint32_t>> remappedOutputs) const
+{
+    recordCall(nullResourceManager, NullCall::SetOutputAttachmentMapping);
+}
+
+void NullRenderPassCommandRecorder::end() const
+{
+    recordCall(nullResourceManager, NullCall::EndPass);
+}
+
+BindStateStats NullRenderPassCommandRecorder::bindStateStats() const
+{
+    return bindState.stats();
+}
+
+void NullComputePassCommandRecorder::setPipeline(const Handle<ComputePipeline_t> &_pipeline)
+{
+    if (!bindState.bindPipeline(_pipeline))
+        return;
+    recordCall(nullResourceManager, NullCall::SetPipeline);
+    pipeline = _pipeline;
+    if (const NullComputePipeline *nullPipeline = nullResourceManager->getComputePipeline(pipeline))
+        bindState.setPipelineLayout(nullPipeline->pipelineLayoutHandle);
+}
+
+void NullComputePassCommandRecorder::setBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroup,
+                                                  const Handle<PipelineLayout_t> &pipelineLayout,
+                                                  std::span<const uint32_t> dynamicBufferOffsets)
+{
+    const Handle<PipelineLayout_t> &pipelineLayoutHandle = pipelineLayout.isValid() ? pipelineLayout : bindState.pipelineLayout();
+    if (bindState.bindBindGroup(group, bindGroup, pipelineLayoutHandle, dynamicBufferOffsets))
+        recordCall(nullResourceManager, NullCall::SetBindGroup);
+}
+
+void NullComputePassCommandRecorder::dispatchCompute(const ComputeCommand &command) const
+{
+    recordCall(nullResourceManager, NullCall::DispatchCompute);
+}
+
+void NullComputePassCommandRecorder::dispatchCompute(std::span<const ComputeCommand> commands) const
+{
+    recordCall(nullResourceManager, NullCall::DispatchCompute, commands.size());
+}
+
+void NullComputePassCommandRecorder::dispatchComputeIndirect(const ComputeCommandIndirect &command) const
+{
+    recordCall(nullResourceManager, NullCall::DispatchComputeIndirect);
+}
+
+void NullComputePassCommandRecorder::dispatchComputeIndirect(std::span<const ComputeCommandIndirect> commands) const
+{
+    recordCall(nullResourceManager, NullCall::DispatchComputeIndirect, commands.size());
+}
+
+void NullComputePassCommandRecorder::pushConstant(const PushConstantRange &constantRange, const void *data) const
+{
+    recordCall(nullResourceManager, NullCall::PushConstant);
+}
+
+void NullComputePassCommandRecorder::pushBindGroup(uint32_t group,
+                                                   std::span<const BindGroupEntry> bindGroupEntries,
+                                                   const Handle<PipelineLayout_t> &pipelineLayout)
+{
+    bindState.forgetBindGroups();
+    recordCall(nullResourceManager, NullCall::PushBindGroup);
+}
+
+void NullComputePassCommandRecorder::end() const
+{
+    recordCall(nullResourceManager, NullCall::EndPass);
+}
+
+BindStateStats NullComputePassCommandRecorder::bindStateStats() const
+{
+    return bindState.stats();
+}
+
+void NullRayTracingPassCommandRecorder::setPipeline(const Handle<RayTracingPipeline_t> &_pipeline)
+{
+    recordCall(nullResourceManager, NullCall::SetPipeline);
+    pipeline = _pipeline;
+}
+
+void NullRayTracingPassCommandRecorder::setBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroup,
+                                                     const Handle<PipelineLayout_t> &pipelineLayout,
+                                                     std::span<const uint32_t> dynamicBufferOffsets) const
+{
+    recordCall(nullResourceManager, NullCall::SetBindGroup);
+}
+
+void NullRayTracingPassCommandRecorder::traceRays(const RayTracingCommand &rayTracingCommand) const
+{
+    recordCall(nullResourceManager, NullCall::TraceRays);
+}
+
+void NullRayTracingPassCommandRecorder::pushConstant(const PushConstantRange &constantRange, const void *data) const
+{
+    recordCall(nullResourceManager, NullCall::PushConstant);
+}
+
+void NullRayTracingPassCommandRecorder::pushBindGroup(uint32_t group,
+                                                      std::span<const BindGroupEntry> bindGroupEntries,
+                                                      const Handle<PipelineLayout_t> &pipelineLayout) const
+{
+    recordCall(nullResourceManager, NullCall::PushBindGroup);
+}
+
+void NullRayTracingPassCommandRecorder::end() const
+{
+    recordCall(nullResourceManager, NullCall::EndPass);
+}
+
+TimestampIndex NullTimestampQueryRecorder::writeTimestamp(PipelineStageFlags flags)
+{
+    recordCall(nullResourceManager, NullCall::WriteTimestamp);
+
+    if (queryCount == maxQueryCount) {
+        SPDLOG_LOGGER_WARN(Logger::logger(), "TimestampQueryRecorder query count exceeded, overwriting last query");
+    }
+
+    const TimestampIndex queryIndex = std::min(queryCount, maxQueryCount - 1);
+    queryCount = std::min(queryCount + 1, maxQueryCount);
+    return queryIndex;
+}
+
+std::vector<uint64_t> NullTimestampQueryRecorder::queryResults()
+{
+    std::vector<uint64_t> results(queryCount);
+    for (uint32_t i = 0; i < queryCount; ++i)
+        results[i] = i;
+    return results;
+}
+
+void NullTimestampQueryRecorder::reset()
+{
+    recordCall(nullResourceManager, NullCall::ResetTimestampQueries);
+    queryCount = 0;
+}
+
+float NullTimestampQueryRecorder::timestampPeriod() const
+{
+    return 1.0f;
+}
+
+void NullBindGroupPool::reset()
+{
+    recordCall(nullResourceManager, NullCall::BindGroupPoolReset);
+
+    // Bind groups allocated from the pool are invalidated by the reset
+    for (const Handle<BindGroup_t> &bindGroupHandle : bindGroups) {
+        if (NullBindGroup *bindGroup = nullResourceManager->getBindGroup(bindGroupHandle))
+            bindGroup->allocated = false;
+    }
+    bindGroups.clear();
+}
+
+uint16_t NullBindGroupPool::bindGroupCount() const
+{
+    return static_cast<uint16_t>(bindGroups.size());
+}
+
+void NullBindGroup::update(const BindGroupEntry &entry)
+{
+    recordCall(nullResourceManager, NullCall::BindGroupUpdate);
+}
+
+bool NullBindGroupLayout::isCompatibleWith(const NullBindGroupLayout &other) const
+{
+    return bindings == other.bindings;
+}
+
+std::vector<uint8_t> NullPipelineCache::getData() const
+{
+    return {};
+}
+
+bool NullPipelineCache::merge(const std::vector<RequiredHandle<PipelineCache_t>> &srcHandles) const
+{
+    return true;
+}
+
+} // namespace KDGpu
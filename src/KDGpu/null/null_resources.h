@@ -0,0 +1,577 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/adapter.h>
+#include <KDGpu/adapter_features.h>
+#include <KDGpu/adapter_group.h>
+#include <KDGpu/adapter_properties.h>
+#include <KDGpu/adapter_queue_type.h>
+#include <KDGpu/adapter_swapchain_properties.h>
+#include <KDGpu/acceleration_structure_options.h>
+#include <KDGpu/bind_group_layout_options.h>
+#include <KDGpu/bind_group_options.h>
+#include <KDGpu/bind_state_tracker.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/compute_pass_command_recorder.h>
+#include <KDGpu/compute_pipeline_options.h>
+#include <KDGpu/device_options.h>
+#include <KDGpu/gpu_core.h>
+#include <KDGpu/graphics_pipeline_options.h>
+#include <KDGpu/handle.h>
+#include <KDGpu/kdgpu_export.h>
+#include <KDGpu/pipeline_cache.h>
+#include <KDGpu/pipeline_deduplication_cache.h>
+#include <KDGpu/pipeline_layout_options.h>
+#include <KDGpu/queue.h>
+#include <KDGpu/queue_description.h>
+#include <KDGpu/raytracing_pass_command_recorder.h>
+#include <KDGpu/raytracing_pipeline_options.h>
+#include <KDGpu/render_pass_command_recorder.h>
+#include <KDGpu/render_pass_command_recorder_options.h>
+#include <KDGpu/sampler_options.h>
+#include <KDGpu/shader_module_deduplication_cache.h>
+#include <KDGpu/surface_options.h>
+#include <KDGpu/texture.h>
+#include <KDGpu/timestamp_query_recorder_options.h>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace KDGpu {
+
+class NullResourceManager;
+
+/**
+ * @defgroup null Null
+ *
+ * Backend that hands out handles and counts calls without talking to any GPU.
+ */
+
+/**
+ * @brief NullInstance
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullInstance {
+    std::vector<Extension> extensions() const;
+    std::vector<Handle<Adapter_t>> queryAdapters(const Handle<Instance_t> &instanceHandle);
+    std::vector<AdapterGroup> queryAdapterGroups();
+    Handle<Surface_t> createSurface(const SurfaceOptions &options);
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    std::vector<Handle<Adapter_t>> adapterHandles;
+};
+
+/**
+ * @brief NullAdapter
+ * \ingroup null
+ *
+ * Reports a single discrete GPU exposing one queue type that supports
+ * graphics, compute and transfer.
+ */
+struct KDGPU_EXPORT NullAdapter {
+    std::vector<Extension> extensions() const;
+    AdapterProperties queryAdapterProperties();
+    AdapterFeatures queryAdapterFeatures();
+    AdapterSwapchainProperties querySwapchainProperties(const Handle<Surface_t> &surfaceHandle);
+    std::vector<AdapterQueueType> queryQueueTypes();
+    bool supportsPresentation(const Handle<Surface_t> surfaceHandle, uint32_t queueTypeIndex);
+    FormatProperties formatProperties(Format format) const;
+    std::vector<DrmFormatModifierProperties> drmFormatModifierProperties(Format format) const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Instance_t> instanceHandle;
+};
+
+/**
+ * @brief NullDevice
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullDevice {
+    std::vector<QueueDescription> getQueues(NullResourceManager *resourceManager,
+                                            const std::vector<QueueRequest> &queueRequests,
+                                            std::span<AdapterQueueType> queueTypes);
+    void waitUntilIdle() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Adapter_t> adapterHandle;
+    AdapterFeatures requestedFeatures{};
+    // Layouts host image copies can write to, empty when they are not enabled
+    std::vector<TextureLayout> hostImageCopyDstLayouts;
+    std::vector<QueueDescription> queueDescriptions;
+    PipelineDeduplicationCache<GraphicsPipelineOptions, GraphicsPipeline_t> graphicsPipelineCache;
+    PipelineDeduplicationCache<ComputePipelineOptions, ComputePipeline_t> computePipelineCache;
+    PipelineDeduplicationCache<RayTracingPipelineOptions, RayTracingPipeline_t> rayTracingPipelineCache;
+    ShaderModuleDeduplicationCache shaderModuleCache;
+    DeduplicationCache<SamplerOptions, Sampler_t> samplerCache;
+    DeduplicationCache<BindGroupLayoutOptions, BindGroupLayout_t> bindGroupLayoutCache;
+};
+
+/**
+ * @brief NullQueue
+ * \ingroup null
+ *
+ * Submissions complete immediately: signal fences and timeline semaphores
+ * are updated from within submit().
+ */
+struct KDGPU_EXPORT NullQueue {
+    void waitUntilIdle();
+    void submit(const SubmitOptions &options);
+    PresentResult present(const PresentOptions &options);
+    std::vector<PresentResult> lastPerSwapchainPresentResults() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    std::vector<PresentResult> m_lastPerSwapchainPresentResults;
+};
+
+/**
+ * @brief NullSurface
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullSurface {
+    NullResourceManager *nullResourceManager{ nullptr };
+};
+
+/**
+ * @brief NullSwapchain
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullSwapchain {
+    std::vector<Handle<Texture_t>> getTextures();
+    AcquireImageResult getNextImageIndex(uint32_t &imageIndex, const Handle<GpuSemaphore_t> &semaphore);
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    std::vector<Handle<Texture_t>> textures;
+    uint32_t nextImageIndex{ 0 };
+};
+
+/**
+ * @brief NullTexture
+ * \ingroup null
+ *
+ * Textures have no backing memory, map() returns nullptr.
+ */
+struct KDGPU_EXPORT NullTexture {
+    void *map();
+    void unmap();
+    void hostLayoutTransition(const HostLayoutTransition &transition);
+    void copyHostMemoryToTexture(const HostMemoryToTextureCopy &copy);
+    void copyTextureToHostMemory(const TextureToHostMemoryCopy &copy);
+    void copyTextureToTextureHost(const TextureToTextureCopyHost &copy);
+    SubresourceLayout getSubresourceLayout(const TextureSubresource &subresource) const;
+    MemoryHandle externalMemoryHandle() const;
+    uint64_t drmFormatModifier() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    Format format{ Format::UNDEFINED };
+    Extent3D extent;
+    uint32_t mipLevels{ 1 };
+    uint32_t arrayLayers{ 1 };
+    TextureUsageFlags usage;
+    bool ownedBySwapchain{ false };
+};
+
+/**
+ * @brief NullTextureView
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullTextureView {
+    Handle<Device_t> deviceHandle;
+    Handle<Texture_t> textureHandle;
+};
+
+/**
+ * @brief NullBuffer
+ * \ingroup null
+ *
+ * Buffers get host memory backing on the first map() or when created with
+ * initial data, so that uploads and read backs work without paying for an
+ * allocation on every buffer creation. Persistently mapped buffers get it
+ * on creation.
+ */
+struct KDGPU_EXPORT NullBuffer {
+    void *map();
+    void unmap();
+    void invalidate(DeviceSize offset, DeviceSize size);
+    void flush(DeviceSize offset, DeviceSize size);
+    void *mappedPointer();
+    MemoryHandle externalMemoryHandle() const;
+    BufferDeviceAddress bufferDeviceAddress() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    DeviceSize size{ 0 };
+    bool persistentlyMapped{ false };
+    std::vector<uint8_t> data;
+    // Memory imported from BufferOptions::hostPointer, used instead of data
+    void *hostPointer{ nullptr };
+};
+
+/**
+ * @brief NullShaderModule
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullShaderModule {
+    Handle<Device_t> deviceHandle;
+};
+
+/**
+ * @brief NullRenderPass
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullRenderPass {
+    Handle<Device_t> deviceHandle;
+};
+
+/**
+ * @brief NullPipelineLayout
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullPipelineLayout {
+    Handle<Device_t> deviceHandle;
+};
+
+/**
+ * @brief NullGraphicsPipeline
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullGraphicsPipeline {
+    Handle<Device_t> deviceHandle;
+    Handle<PipelineLayout_t> pipelineLayoutHandle;
+};
+
+/**
+ * @brief NullComputePipeline
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullComputePipeline {
+    Handle<Device_t> deviceHandle;
+    Handle<PipelineLayout_t> pipelineLayoutHandle;
+};
+
+/**
+ * @brief NullRayTracingPipeline
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullRayTracingPipeline {
+    std::vector<uint8_t> shaderGroupHandles(uint32_t firstGroup, uint32_t groupCount) const;
+
+    Handle<Device_t> deviceHandle;
+    Handle<PipelineLayout_t> pipelineLayoutHandle;
+};
+
+/**
+ * @brief NullGpuSemaphore
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullGpuSemaphore {
+    HandleOrFD externalSemaphoreHandle() const;
+
+    Handle<Device_t> deviceHandle;
+};
+
+/**
+ * @brief NullTimelineSemaphore
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullTimelineSemaphore {
+    uint64_t value() const;
+    void signal(uint64_t value) const;
+    TimelineSemaphoreWaitResult wait(uint64_t value) const;
+    HandleOrFD externalSemaphoreHandle() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    mutable uint64_t currentValue{ 0 };
+};
+
+/**
+ * @brief NullFence
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullFence {
+    void wait();
+    void reset();
+    FenceStatus status();
+    HandleOrFD externalFenceHandle() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    bool signalled{ true };
+    uint64_t submissionCount{ 0 };
+};
+
+/**
+ * @brief NullCommandBuffer
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullCommandBuffer {
+    Handle<Device_t> deviceHandle;
+    CommandBufferLevel commandLevel{ CommandBufferLevel::Primary };
+};
+
+/**
+ * @brief NullFrameCommandAllocator
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullFrameCommandAllocator {
+    void beginFrame(uint32_t frameIndex, const Handle<Fence_t> &frameFence);
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    uint32_t frameCount{ 0 };
+    uint32_t currentFrame{ 0 };
+};
+
+/**
+ * @brief NullCommandRecorder
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullCommandRecorder {
+    void begin() const;
+    void blitTexture(const TextureBlitOptions &options) const;
+    void clearBuffer(const BufferClear &clear) const;
+    void clearColorTexture(const ClearColorTexture &clear) const;
+    void clearDepthStencilTexture(const ClearDepthStencilTexture &clear) const;
+    void copyBuffer(const BufferCopy &copy) const;
+    void copyBufferToTexture(const BufferToTextureCopy &copy) const;
+    void copyTextureToBuffer(const TextureToBufferCopy &copy) const;
+    void copyTextureToTexture(const TextureToTextureCopy &copy) const;
+    void updateBuffer(const BufferUpdate &update) const;
+    void memoryBarrier(const MemoryBarrierOptions &options) const;
+    void bufferMemoryBarrier(const BufferMemoryBarrierOptions &options) const;
+    void textureMemoryBarrier(const TextureMemoryBarrierOptions &options) const;
+    void textureMemoryBarriers(std::span<const TextureMemoryBarrierOptions> options) const;
+    void executeSecondaryCommandBuffer(const Handle<CommandBuffer_t> &secondaryCommandBuffer) const;
+    void resolveTexture(const TextureResolveOptions &options) const;
+    void buildAccelerationStructures(const BuildAccelerationStructureOptions &options) const;
+    void beginDebugLabel(const DebugLabelOptions &options) const;
+    void endDebugLabel() const;
+    [[nodiscard]] Handle<CommandBuffer_t> finish() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    Handle<CommandBuffer_t> commandBufferHandle;
+};
+
+/**
+ * @brief NullRenderPassCommandRecorder
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullRenderPassCommandRecorder {
+    void setPipeline(const Handle<GraphicsPipeline_t> &pipeline);
+    void setVertexBuffer(uint32_t index, const Handle<Buffer_t> &buffer, DeviceSize offset);
+    void setIndexBuffer(const Handle<Buffer_t> &buffer, DeviceSize offset, IndexType indexType);
+    void setBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroup,
+                      const Handle<PipelineLayout_t> &pipelineLayout, std::span<const uint32_t> dynamicBufferOffsets);
+    void setViewport(const Viewport &viewport) const;
+    void setScissor(const Rect2D &scissor) const;
+    void setStencilReference(StencilFaceFlags faceMask, int reference) const;
+    void draw(const DrawCommand &drawCommand) const;
+    void draw(std::span<const DrawCommand> drawCommands) const;
+    void drawIndexed(const DrawIndexedCommand &drawCommand) const;
+    void drawIndexed(std::span<const DrawIndexedCommand> drawCommands) const;
+    void drawIndirect(const DrawIndirectCommand &drawCommand) const;
+    void drawIndirect(std::span<const DrawIndirectCommand> drawCommands) const;
+    void drawIndexedIndirect(const DrawIndexedIndirectCommand &drawCommand) const;
+    void drawIndexedIndirect(std::span<const DrawIndexedIndirectCommand> drawCommands) const;
+    void drawMeshTasks(const DrawMeshCommand &drawCommand) const;
+    void drawMeshTasks(std::span<const DrawMeshCommand> drawCommands) const;
+    void drawMeshTasksIndirect(const DrawMeshIndirectCommand &drawCommand) const;
+    void drawMeshTasksIndirect(std::span<const DrawMeshIndirectCommand> drawCommands) const;
+    void pushConstant(const PushConstantRange &constantRange, const void *data, const Handle<PipelineLayout_t> &pipelineLayout = {}) const;
+    void pushBindGroup(uint32_t group, std::span<const BindGroupEntry> bindGroupEntries, const Handle<PipelineLayout_t> &pipelineLayout = {});
+    void nextSubpass() const;
+    void setInputAttachmentMapping(std::span<const std::optional<uint32_t>> colorAttachmentIndices,
+                                   std::optional<uint32_t> depthAttachmentIndex,
+                                   std::optional<uint32_t> stencilAttachmentIndex) const;
+    void setOutputAttachmentMapping(std::span<const std::optional<uint32_t>> remappedOutputs) const;
+    void end() const;
+    BindStateStats bindStateStats() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    Handle<GraphicsPipeline_t> pipeline;
+    BindStateTracker<GraphicsPipeline_t> bindState;
+};
+
+/**
+ * @brief NullComputePassCommandRecorder
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullComputePassCommandRecorder {
+    void setPipeline(const Handle<ComputePipeline_t> &pipeline);
+    void setBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroup,
+                      const Handle<PipelineLayout_t> &pipelineLayout,
+                      std::span<const uint32_t> dynamicBufferOffsets);
+    void dispatchCompute(const ComputeCommand &command) const;
+    void dispatchCompute(std::span<const ComputeCommand> commands) const;
+    void dispatchComputeIndirect(const ComputeCommandIndirect &command) const;
+    void dispatchComputeIndirect(std::span<const ComputeCommandIndirect> commands) const;
+    void pushConstant(const PushConstantRange &constantRange, const void *data) const;
+    void pushBindGroup(uint32_t group,
+                       std::span<const BindGroupEntry> bindGroupEntries,
+                       const Handle<PipelineLayout_t> &pipelineLayout);
+    void end() const;
+    BindStateStats bindStateStats() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    Handle<ComputePipeline_t> pipeline;
+    BindStateTracker<ComputePipeline_t> bindState;
+};
+
+/**
+ * @brief NullRayTracingPassCommandRecorder
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullRayTracingPassCommandRecorder {
+    void setPipeline(const Handle<RayTracingPipeline_t> &pipeline);
+    void setBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroup,
+                      const Handle<PipelineLayout_t> &pipelineLayout,
+                      std::span<const uint32_t> dynamicBufferOffsets) const;
+    void traceRays(const RayTracingCommand &rayTracingCommand) const;
+    void pushConstant(const PushConstantRange &constantRange, const void *data) const;
+    void pushBindGroup(uint32_t group,
+                       std::span<const BindGroupEntry> bindGroupEntries,
+                       const Handle<PipelineLayout_t> &pipelineLayout) const;
+    void end() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    Handle<RayTracingPipeline_t> pipeline;
+};
+
+/**
+ * @brief NullTimestampQueryRecorder
+ * \ingroup null
+ *
+ * queryResults() returns the index of each written timestamp, which keeps
+ * them monotonically increasing.
+ */
+struct KDGPU_EXPORT NullTimestampQueryRecorder {
+    TimestampIndex writeTimestamp(PipelineStageFlags flags);
+    std::vector<uint64_t> queryResults();
+    void reset();
+    float timestampPeriod() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    uint32_t queryCount{ 0 };
+    uint32_t maxQueryCount{ 0 };
+};
+
+/**
+ * @brief NullBindGroupPool
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullBindGroupPool {
+    void reset();
+    uint16_t bindGroupCount() const;
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    uint16_t maxBindGroupCount{ 0 };
+    std::vector<Handle<BindGroup_t>> bindGroups;
+};
+
+/**
+ * @brief NullBindGroup
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullBindGroup {
+    void update(const BindGroupEntry &entry);
+    bool hasValidHandle() const { return allocated; }
+
+    NullResourceManager *nullResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+    Handle<BindGroupPool_t> bindGroupPoolHandle;
+    bool implicitFree{ true };
+    bool allocated{ true };
+};
+
+/**
+ * @brief NullBindGroupLayout
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullBindGroupLayout {
+    bool isCompatibleWith(const NullBindGroupLayout &other) const;
+
+    Handle<Device_t> deviceHandle;
+    std::vector<ResourceBindingLayout> bindings;
+};
+
+/**
+ * @brief NullSampler
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullSampler {
+    Handle<Device_t> deviceHandle;
+};
+
+/**
+ * @brief NullAccelerationStructure
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullAccelerationStructure {
+    Handle<Device_t> deviceHandle;
+};
+
+/**
+ * @brief NullYCbCrConversion
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullYCbCrConversion {
+    Handle<Device_t> deviceHandle;
+};
+
+/**
+ * @brief NullPipelineCache
+ * \ingroup null
+ *
+ */
+struct KDGPU_EXPORT NullPipelineCache {
+    std::vector<uint8_t> getData() const;
+    bool merge(const std::vector<RequiredHandle<PipelineCache_t>> &srcHandles) const;
+
+    Handle<Device_t> deviceHandle;
+};
+
+} // namespace KDGpu
@@ -54,18 +54,18 @@ std::vector<uint8_t> PipelineCache::getData() const
 {
     if (!isValid())
         return {};
-    VulkanPipelineCache *vulkanPipelineCache = m_api->resourceManager()->getPipelineCache(handle());
-    assert(vulkanPipelineCache != nullptr);
-    return vulkanPipelineCache->getData();
+    auto apiPipelineCache = m_api->resourceManager()->getPipelineCache(handle());
+    assert(apiPipelineCache != nullptr);
+    return apiPipelineCache->getData();
 }
 
 bool PipelineCache::merge(const std::vector<RequiredHandle<PipelineCache_t>> &sources) const
 {
     if (!isValid())
         return false;
-    VulkanPipelineCache *vulkanPipelineCache = m_api->resourceManager()->getPipelineCache(handle());
-    assert(vulkanPipelineCache != nullptr);
-    return vulkanPipelineCache->merge(sources);
+    auto apiPipelineCache = m_api->resourceManager()->getPipelineCache(handle());
+    assert(apiPipelineCache != nullptr);
+    return apiPipelineCache->merge(sources);
 }
 
 bool operator==(const PipelineCache &a, const PipelineCache &b)
@@ -40,9 +40,10 @@ struct PipelineCacheOptions;
 
     Multiple pipeline caches can be merged using merge() to consolidate cached data.
 
-    \warning The pipeline cache is externally synchronized. When creating pipelines on multiple
-    threads with the same cache, or when calling merge() while pipelines are being created,
-    external synchronization (e.g., a mutex) must be used to ensure thread safety.
+    KDGpu synchronizes access to the cache internally: pipelines can be created from several
+    threads with the same cache, and merge() waits for pipeline creations using this cache to
+    complete. Device::createGraphicsPipelineAsync() and Device::createComputePipelineAsync()
+    rely on this.
 
     ## See also:
     \sa PipelineCacheOptions
@@ -81,8 +82,7 @@ public:
      * After merging, this cache will contain the union of all pipeline data from this cache
      * and all source caches. The source caches remain valid and unchanged.
      *
-     * \warning This operation requires external synchronization if any of the caches (this
-     * cache or any source caches) are being used concurrently for pipeline creation.
+     * Pipeline creations using this cache are blocked for the duration of the merge.
      */
     bool merge(const std::vector<RequiredHandle<PipelineCache_t>> &sources) const;
 
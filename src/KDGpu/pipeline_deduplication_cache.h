@@ -0,0 +1,111 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/deduplication_cache.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <mutex>
+
+namespace KDGpu {
+
+/*!
+    \struct PipelineDeduplicationStats
+    \brief Counters reported by Device::pipelineDeduplicationStats()
+    \ingroup public
+    \headerfile pipeline_deduplication_cache.h <KDGpu/pipeline_deduplication_cache.h>
+
+    A hit is a Device::getOrCreate*Pipeline() call that was answered with an existing pipeline,
+    a miss is one that had to create a new pipeline.
+ */
+struct PipelineDeduplicationStats {
+    uint64_t hits{ 0 };
+    uint64_t misses{ 0 };
+    size_t cachedPipelines{ 0 };
+};
+
+/**
+ * @brief PipelineDeduplicationCache
+ * @internal
+ *
+ * DeduplicationCache reporting PipelineDeduplicationStats.
+ *
+ * Compiling a pipeline can take a long time, so getOrCreate() can also be given
+ * the lock guarding the cache and releases it while creating the pipeline. Threads
+ * asking for the same options meanwhile wait for that result instead of compiling
+ * the pipeline again.
+ */
+template<typename Options, typename T>
+class PipelineDeduplicationCache : public DeduplicationCache<Options, T>
+{
+public:
+    using DeduplicationCache<Options, T>::getOrCreate;
+
+    // lock must hold the mutex guarding the cache, and holds it again on return
+    template<typename Mutex, typename CreateFn>
+    Handle<T> getOrCreate(std::unique_lock<Mutex> &lock, const Options &options, CreateFn &&create)
+    {
+        if (const Handle<T> handle = this->reference(options); handle.isValid()) {
+            ++this->m_stats.hits;
+            return handle;
+        }
+
+        // Someone else is creating the same pipeline, their result comes with a reference for us
+        const size_t hash = std::hash<Options>()(options);
+        for (InFlight &inFlight : m_inFlight) {
+            if (inFlight.hash != hash || !(inFlight.options == options))
+                continue;
+            ++inFlight.waiters;
+            ++this->m_stats.hits;
+            const std::shared_future<Handle<T>> result = inFlight.result;
+            lock.unlock();
+            const Handle<T> handle = result.get();
+            lock.lock();
+            return handle;
+        }
+
+        // The options are copied along with their label view, which stays valid until we erase the entry
+        ++this->m_stats.misses;
+        std::promise<Handle<T>> promise;
+        const auto inFlightIt = m_inFlight.insert(m_inFlight.end(), InFlight{ .options = options, .hash = hash, .result = promise.get_future().share() });
+        lock.unlock();
+        const Handle<T> handle = create();
+        lock.lock();
+
+        if (handle.isValid())
+            this->insert(options, handle, 1 + inFlightIt->waiters);
+        m_inFlight.erase(inFlightIt);
+        promise.set_value(handle);
+        return handle;
+    }
+
+    PipelineDeduplicationStats stats() const
+    {
+        const DeduplicationStats stats = DeduplicationCache<Options, T>::stats();
+        return PipelineDeduplicationStats{ .hits = stats.hits, .misses = stats.misses, .cachedPipelines = stats.cachedObjects };
+    }
+
+private:
+    struct InFlight {
+        Options options;
+        size_t hash{ 0 };
+        std::shared_future<Handle<T>> result;
+        uint32_t waiters{ 0 };
+    };
+
+    // A list, so that entries stay put while the cache is unlocked
+    std::list<InFlight> m_inFlight;
+};
+
+} // namespace KDGpu
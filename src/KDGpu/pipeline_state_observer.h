@@ -0,0 +1,55 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/handle.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace KDGpu {
+
+struct ShaderModule_t;
+struct BindGroupLayout_t;
+struct PipelineLayout_t;
+struct BindGroupLayoutOptions;
+struct PipelineLayoutOptions;
+struct GraphicsPipelineOptions;
+struct ComputePipelineOptions;
+
+/*!
+    \class PipelineStateObserver
+    \brief Gets told about every object a Device creates that pipeline state depends on
+    \ingroup public
+    \headerfile pipeline_state_observer.h <KDGpu/pipeline_state_observer.h>
+
+    Install an observer with Device::setPipelineStateObserver() to capture pipeline state,
+    for instance to replay it on a later run and warm up a PipelineCache. Pipelines are
+    reported when they are requested, including the asynchronous and getOrCreate variants.
+
+    The functions are called on whichever thread created the object, so implementations
+    must do their own locking if the Device is used from several threads.
+
+    \sa Device::setPipelineStateObserver()
+ */
+class PipelineStateObserver
+{
+public:
+    virtual ~PipelineStateObserver() = default;
+
+    virtual void shaderModuleCreated(const Handle<ShaderModule_t> &shaderModule, const std::vector<uint32_t> &code) = 0;
+    virtual void bindGroupLayoutCreated(const Handle<BindGroupLayout_t> &bindGroupLayout, const BindGroupLayoutOptions &options) = 0;
+    virtual void pipelineLayoutCreated(const Handle<PipelineLayout_t> &pipelineLayout, const PipelineLayoutOptions &options) = 0;
+    virtual void graphicsPipelineRequested(const GraphicsPipelineOptions &options) = 0;
+    virtual void computePipelineRequested(const ComputePipelineOptions &options) = 0;
+};
+
+} // namespace KDGpu
@@ -3,7 +3,11 @@
 #include "handle.h"
 
 #include <assert.h>
+#include <cstddef>
 #include <limits>
+#include <memory>
+#include <new>
+#include <utility>
 #include <vector>
 #include <KDGpu/utils/logging.h>
 
@@ -172,4 +176,190 @@ void Pool<T, H>::growCapacity()
     m_freeIndices.reserve(m_capacity);
 }
 
+/**
+ * @brief ChunkedPool
+ * @internal
+ *
+ * Same interface as Pool but the objects are stored in fixed-size chunks of
+ * ChunkSize entries that are never moved or reallocated once created. Growing
+ * the pool only appends a new chunk, so a pointer returned by get() remains
+ * valid for as long as the slot it refers to is alive, regardless of how many
+ * other entries get emplaced afterwards.
+ *
+ * The generations are kept in a separate dense array so that validating a
+ * handle does not touch the (potentially large) objects themselves. Looking up
+ * a handle is O(1): one division (a shift, as ChunkSize is a power of two)
+ * selects the chunk, the remainder selects the slot within it.
+ *
+ * Unlike Pool, the destructor of the contained object is called on remove()
+ * and a new object is constructed in place on emplace(). T therefore does not
+ * need to be default constructible nor assignable.
+ */
+template<typename T, typename H, uint32_t ChunkSize = 64>
+class ChunkedPool
+{
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
+public:
+    ChunkedPool() noexcept
+        : m_chunks(), m_generations(), m_freeIndices()
+    {
+    }
+
+    explicit ChunkedPool(uint32_t size)
+        : m_chunks(), m_generations(), m_freeIndices()
+    {
+        const uint32_t chunkCount = (size + ChunkSize - 1) / ChunkSize;
+        m_chunks.reserve(chunkCount);
+        for (uint32_t i = 0; i < chunkCount; ++i)
+            addChunk();
+    }
+
+    ~ChunkedPool()
+    {
+        destroyAll();
+    }
+
+    ChunkedPool(ChunkedPool const &other) = delete;
+    ChunkedPool &operator=(ChunkedPool const &other) = delete;
+
+    ChunkedPool(ChunkedPool &&other) noexcept
+        : m_chunks(std::exchange(other.m_chunks, {}))
+        , m_generations(std::exchange(other.m_generations, {}))
+        , m_freeIndices(std::exchange(other.m_freeIndices, {}))
+    {
+    }
+
+    ChunkedPool &operator=(ChunkedPool &&other) noexcept
+    {
+        if (this != &other) {
+            destroyAll();
+            m_chunks = std::exchange(other.m_chunks, {});
+            m_generations = std::exchange(other.m_generations, {});
+            m_freeIndices = std::exchange(other.m_freeIndices, {});
+        }
+        return *this;
+    }
+
+    uint32_t capacity() const noexcept { return static_cast<uint32_t>(m_chunks.size()) * ChunkSize; }
+    uint32_t size() const noexcept { return static_cast<uint32_t>(m_generations.size() - m_freeIndices.size()); }
+    uint32_t chunkCount() const noexcept { return static_cast<uint32_t>(m_chunks.size()); }
+
+    T *get(const Handle<H> &handle) const noexcept
+    {
+        if (!canUseHandle(handle))
+            return nullptr;
+        return slot(handle.m_index);
+    }
+
+    template<typename... Args>
+    Handle<H> emplace(Args &&...args)
+    {
+        const bool reuseSlot = !m_freeIndices.empty();
+        uint32_t index = 0;
+        if (reuseSlot) {
+            // We have a gap in one of the chunks, use that.
+            index = m_freeIndices.back();
+        } else {
+            // No gaps, append to the last chunk or start a new one. Existing chunks stay where they are.
+            index = static_cast<uint32_t>(m_generations.size());
+            assert(index < std::numeric_limits<uint32_t>::max());
+            if (index == capacity())
+                addChunk();
+        }
+
+        ::new (static_cast<void *>(slot(index))) T(std::forward<Args>(args)...);
+
+        if (reuseSlot) {
+            m_freeIndices.pop_back();
+            // The generation was already bumped when this entry was removed
+            m_generations[index].isAlive = true;
+        } else {
+            m_generations.emplace_back(GenerationEntry{ 1, true });
+        }
+
+        return Handle<H>(index, m_generations[index].generation);
+    }
+
+    Handle<H> insert(const T &data)
+    {
+        return emplace(data);
+    }
+
+    void remove(const Handle<H> &handle)
+    {
+        if (!canUseHandle(handle))
+            return;
+
+        slot(handle.m_index)->~T();
+
+        // Bump the generation so we know not to deref this data from any existing handles
+        auto &generation = m_generations[handle.m_index];
+        ++generation.generation;
+        generation.isAlive = false;
+
+        // Store the position of the unused gap in the chunks
+        m_freeIndices.push_back(handle.m_index);
+    }
+
+    void clear()
+    {
+        const uint32_t generationsSize = static_cast<uint32_t>(m_generations.size());
+        for (uint32_t i = 0; i < generationsSize; ++i) {
+            const auto handle = handleForIndex(i);
+            remove(handle);
+        }
+    }
+
+    // Convert an entry index into a Handle<H>, if possible otherwise returns an invalid handle
+    Handle<H> handleForIndex(uint32_t entryIndex) const
+    {
+        if (entryIndex >= m_generations.size() || m_generations[entryIndex].isAlive == false)
+            return {};
+        return Handle<H>{ entryIndex, m_generations[entryIndex].generation };
+    }
+
+private:
+    struct Chunk {
+        alignas(T) std::byte storage[sizeof(T) * ChunkSize];
+    };
+
+    struct GenerationEntry {
+        uint32_t generation{ 0 };
+        bool isAlive{ false };
+    };
+
+    bool canUseHandle(const Handle<H> &handle) const noexcept
+    {
+        return handle.m_index < m_generations.size() && handle.m_generation == m_generations[handle.m_index].generation && m_generations[handle.m_index].isAlive;
+    }
+
+    T *slot(uint32_t index) const noexcept
+    {
+        std::byte *chunkStorage = m_chunks[index / ChunkSize]->storage;
+        return std::launder(reinterpret_cast<T *>(chunkStorage + sizeof(T) * (index % ChunkSize)));
+    }
+
+    void addChunk()
+    {
+        // Chunks are only ever appended, the chunk directory may reallocate but the chunks it points to never move
+        m_chunks.emplace_back(std::make_unique_for_overwrite<Chunk>());
+    }
+
+    void destroyAll() noexcept
+    {
+        const uint32_t generationsSize = static_cast<uint32_t>(m_generations.size());
+        for (uint32_t i = 0; i < generationsSize; ++i) {
+            if (m_generations[i].isAlive)
+                slot(i)->~T();
+        }
+        m_generations.clear();
+        m_freeIndices.clear();
+    }
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    std::vector<GenerationEntry> m_generations;
+    std::vector<uint32_t> m_freeIndices;
+};
+
 } // namespace KDGpu
@@ -12,8 +12,11 @@
 
 #include <KDGpu/buffer_options.h>
 #include <KDGpu/command_recorder.h>
+#include <KDGpu/texture.h>
+#include <KDGpu/upload_batch.h>
 #include <KDGpu/api/graphics_api_impl.h>
 
+#include <cstring>
 #include <numeric>
 #include <algorithm>
 
@@ -178,10 +181,12 @@ UploadStagingBuffer Queue::uploadBufferData(const BufferUploadOptions &options)
     return uploadStagingBuffer;
 }
 
-namespace {
-
-TextureSubresourceRange createRangeFromRegions(const std::vector<BufferTextureCopyRegion> regions)
+TextureSubresourceRange textureUploadRange(const TextureSubresourceRange &range,
+                                           const std::vector<BufferTextureCopyRegion> &regions)
 {
+    if (range.aspectMask != TextureAspectFlagBits::None)
+        return range;
+
     const auto maxMipLayerPair = std::accumulate(
             regions.begin(), regions.end(), std::make_pair(0U, 0U),
             [](std::pair<uint32_t, uint32_t> acc, const BufferTextureCopyRegion &region) {
@@ -194,12 +199,61 @@ TextureSubresourceRange createRangeFromRegions(const std::vector<BufferTextureCo
         .levelCount = maxMipLayerPair.first + 1,
         .layerCount = maxMipLayerPair.second + 1
     };
-};
+}
 
-} // namespace
+bool Queue::uploadTextureDataFromHost(const Handle<Texture_t> &texture, const void *data,
+                                      TextureLayout oldLayout, TextureLayout newLayout,
+                                      const std::vector<BufferTextureCopyRegion> &regions,
+                                      const TextureSubresourceRange &range)
+{
+    // Host image copies need the texture to allow them and the layout it ends up in
+    // to be writable from the host, fall back to a staging buffer otherwise.
+    // They are not ordered with GPU work, so only initial uploads take this path: a
+    // texture in any other layout might still be read by submitted commands, which
+    // the barrier of the staging path waits for with dstStages and dstMask.
+    if (oldLayout != TextureLayout::Undefined)
+        return false;
+    auto apiTexture = m_api->resourceManager()->getTexture(texture);
+    if (!apiTexture || !apiTexture->usage.testFlag(TextureUsageFlagBits::HostTransferBit))
+        return false;
+    const auto apiDevice = m_api->resourceManager()->getDevice(m_device);
+    const auto &dstLayouts = apiDevice->hostImageCopyDstLayouts;
+    if (std::find(dstLayouts.begin(), dstLayouts.end(), newLayout) == dstLayouts.end())
+        return false;
+
+    if (oldLayout != newLayout) {
+        apiTexture->hostLayoutTransition(HostLayoutTransition{
+                .oldLayout = oldLayout,
+                .newLayout = newLayout,
+                .range = range,
+        });
+    }
+
+    HostMemoryToTextureCopy copy{ .dstTextureLayout = newLayout };
+    copy.regions.reserve(regions.size());
+    for (const BufferTextureCopyRegion &region : regions) {
+        copy.regions.push_back(HostMemoryToTextureCopyRegion{
+                .srcHostMemoryPointer = const_cast<uint8_t *>(static_cast<const uint8_t *>(data) + region.bufferOffset),
+                .srcMemoryRowLength = region.bufferRowLength,
+                .srcMemoryImageHeight = region.bufferTextureHeight,
+                .dstSubresource = region.textureSubResource,
+                .dstOffset = region.textureOffset,
+                .dstExtent = region.textureExtent,
+        });
+    }
+    apiTexture->copyHostMemoryToTexture(copy);
+    return true;
+}
 
 void Queue::waitForUploadTextureData(const WaitForTextureUploadOptions &options)
 {
+    // Find a suitable subresource we will be copying and transitioning
+    const TextureSubresourceRange range = textureUploadRange(options.range, options.regions);
+
+    // The host writes the texture directly, there is nothing to wait for
+    if (uploadTextureDataFromHost(options.destinationTexture, options.data, options.oldLayout, options.newLayout, options.regions, range))
+        return;
+
     // Create a staging buffer and upload initial data to it by map(), memcpy(), unmap().
     BufferOptions bufferOptions = {
         .size = options.byteSize,
@@ -213,9 +267,6 @@ void Queue::waitForUploadTextureData(const WaitForTextureUploadOptions &options)
     };
     CommandRecorder commandRecorder(m_api, m_device, commandRecorderOptions);
 
-    // Find a suitable subresource we will be copying and transitioning
-    const TextureSubresourceRange range = options.range.aspectMask == TextureAspectFlagBits::None ? createRangeFromRegions(options.regions) : options.range;
-
     // We first need to transition the texture into the TextureLayout::TransferDstOptimal layout
     const TextureMemoryBarrierOptions toTransferDstOptimal = {
         .srcStages = PipelineStageFlags(PipelineStageFlagBit::TopOfPipeBit),
@@ -261,6 +312,14 @@ void Queue::waitForUploadTextureData(const WaitForTextureUploadOptions &options)
 
 UploadStagingBuffer Queue::uploadTextureData(const TextureUploadOptions &options)
 {
+    // Find a suitable subresource we will be copying and transitioning
+    const TextureSubresourceRange range = textureUploadRange(options.range, options.regions);
+
+    // The host writes the texture directly, no staging buffer nor submission is needed.
+    // The signalled fence lets callers release the upload as they would otherwise.
+    if (uploadTextureDataFromHost(options.destinationTexture, options.data, options.oldLayout, options.newLayout, options.regions, range))
+        return UploadStagingBuffer{ .fence = Fence(m_api, m_device, FenceOptions{ .createSignalled = true }) };
+
     // Create a staging buffer and upload initial data to it by map(), memcpy(), unmap().
     BufferOptions bufferOptions = {
         .size = options.byteSize,
@@ -274,9 +333,6 @@ UploadStagingBuffer Queue::uploadTextureData(const TextureUploadOptions &options
     };
     CommandRecorder commandRecorder(m_api, m_device, commandRecorderOptions);
 
-    // Find a suitable subresource we will be copying and transitioning
-    const TextureSubresourceRange range = options.range.aspectMask == TextureAspectFlagBits::None ? createRangeFromRegions(options.regions) : options.range;
-
     // We first need to transition the texture into the TextureLayout::TransferDstOptimal layout
     const TextureMemoryBarrierOptions toTransferDstOptimal = {
         .srcStages = PipelineStageFlags(PipelineStageFlagBit::TopOfPipeBit),
@@ -330,4 +386,138 @@ UploadStagingBuffer Queue::uploadTextureData(const TextureUploadOptions &options
     return uploadStagingBuffer;
 }
 
+/**
+ * @brief Uploads all buffers and textures of @a batch with a single submission
+ *
+ * The data of every upload is copied into one staging buffer, the copies are recorded into one command
+ * buffer and submitted at once, signalling the returned fence and @a signalTimelineSemaphores on completion.
+ * The returned UploadStagingBuffer must be kept alive until then.
+ */
+UploadStagingBuffer Queue::upload(const UploadBatch &batch, const std::vector<TimelineSemaphoreSubmitSignalInfo> &signalTimelineSemaphores)
+{
+    if (batch.isEmpty())
+        return {};
+
+    // Create a single staging buffer and copy the data of every upload to it
+    const BufferOptions bufferOptions = {
+        .size = batch.stagingSize(),
+        .usage = BufferUsageFlagBits::TransferSrcBit,
+        .memoryUsage = MemoryUsage::CpuOnly, // Use a CPU heap for the staging buffer
+        .persistentlyMapped = true,
+    };
+    Buffer stagingBuffer(m_api, m_device, bufferOptions, nullptr);
+    auto *stagingData = static_cast<uint8_t *>(stagingBuffer.map());
+    if (!stagingData)
+        return {};
+
+    for (const auto &bufferUpload : batch.m_bufferUploads) {
+        if (bufferUpload.options.data)
+            std::memcpy(stagingData + bufferUpload.stagingOffset, bufferUpload.options.data, bufferUpload.options.byteSize);
+    }
+    for (const auto &textureUpload : batch.m_textureUploads) {
+        if (textureUpload.options.data)
+            std::memcpy(stagingData + textureUpload.stagingOffset, textureUpload.options.data, textureUpload.options.byteSize);
+    }
+    stagingBuffer.flush();
+
+    const CommandRecorderOptions commandRecorderOptions = {
+        .queue = m_queue
+    };
+    CommandRecorder commandRecorder(m_api, m_device, commandRecorderOptions);
+
+    // Transition all textures into the TextureLayout::TransferDstOptimal layout at once
+    std::vector<TextureMemoryBarrierOptions> toTransferDstOptimal;
+    std::vector<TextureMemoryBarrierOptions> toFinalLayout;
+    toTransferDstOptimal.reserve(batch.m_textureUploads.size());
+    toFinalLayout.reserve(batch.m_textureUploads.size());
+    for (const auto &textureUpload : batch.m_textureUploads) {
+        const TextureUploadOptions &options = textureUpload.options;
+        const TextureSubresourceRange range = textureUploadRange(options.range, options.regions);
+        toTransferDstOptimal.push_back(TextureMemoryBarrierOptions{
+                .srcStages = PipelineStageFlags(PipelineStageFlagBit::TopOfPipeBit),
+                .dstStages = PipelineStageFlags(PipelineStageFlagBit::TransferBit),
+                .dstMask = AccessFlags(AccessFlagBit::TransferWriteBit),
+                .oldLayout = options.oldLayout,
+                .newLayout = TextureLayout::TransferDstOptimal,
+                .texture = options.destinationTexture,
+                .range = range,
+        });
+        toFinalLayout.push_back(TextureMemoryBarrierOptions{
+                .srcStages = PipelineStageFlags(PipelineStageFlagBit::TransferBit),
+                .srcMask = AccessFlags(AccessFlagBit::TransferWriteBit),
+                .dstStages = options.dstStages,
+                .dstMask = options.dstMask,
+                .oldLayout = TextureLayout::TransferDstOptimal,
+                .newLayout = options.newLayout,
+                .texture = options.destinationTexture,
+                .range = range,
+        });
+    }
+    if (!toTransferDstOptimal.empty())
+        commandRecorder.textureMemoryBarriers(toTransferDstOptimal);
+
+    // Copy from the staging buffer, each upload reads from its own range of it
+    PipelineStageFlags bufferDstStages;
+    AccessFlags bufferDstMask;
+    for (const auto &bufferUpload : batch.m_bufferUploads) {
+        const BufferUploadOptions &options = bufferUpload.options;
+        commandRecorder.copyBuffer(BufferCopy{
+                .src = stagingBuffer,
+                .srcOffset = bufferUpload.stagingOffset,
+                .dst = options.destinationBuffer,
+                .dstOffset = options.dstOffset,
+                .byteSize = options.byteSize,
+        });
+        bufferDstStages |= options.dstStages;
+        bufferDstMask |= options.dstMask;
+    }
+    for (const auto &textureUpload : batch.m_textureUploads) {
+        std::vector<BufferTextureCopyRegion> regions = textureUpload.options.regions;
+        for (BufferTextureCopyRegion &region : regions)
+            region.bufferOffset += textureUpload.stagingOffset;
+        commandRecorder.copyBufferToTexture(BufferToTextureCopy{
+                .srcBuffer = stagingBuffer,
+                .dstTexture = textureUpload.options.destinationTexture,
+                .dstTextureLayout = TextureLayout::TransferDstOptimal,
+                .regions = std::move(regions),
+        });
+    }
+
+    // A single global barrier makes the copies visible to every destination buffer
+    if (!batch.m_bufferUploads.empty()) {
+        commandRecorder.memoryBarrier(MemoryBarrierOptions{
+                .srcStages = PipelineStageFlags(PipelineStageFlagBit::TransferBit),
+                .dstStages = bufferDstStages,
+                .memoryBarriers = {
+                        {
+                                .srcMask = AccessFlags(AccessFlagBit::TransferWriteBit),
+                                .dstMask = bufferDstMask,
+                        },
+                },
+        });
+    }
+
+    // Finally, we transition the textures to their final layouts
+    if (!toFinalLayout.empty())
+        commandRecorder.textureMemoryBarriers(toFinalLayout);
+
+    auto commandBuffer = commandRecorder.finish();
+    auto commandBufferHandle = commandBuffer.handle();
+
+    // We will use a fence to know when it is safe to destroy the staging buffer
+    Fence fence(m_api, m_device, FenceOptions{ .createSignalled = false });
+    auto fenceHandle = fence.handle();
+    UploadStagingBuffer uploadStagingBuffer{
+        .fence = std::move(fence),
+        .buffer = std::move(stagingBuffer),
+        .commandBuffer = std::move(commandBuffer)
+    };
+
+    submit({ .commandBuffers = { commandBufferHandle },
+             .signalTimelineSemaphores = signalTimelineSemaphores,
+             .signalFence = fenceHandle });
+
+    return uploadStagingBuffer;
+}
+
 } // namespace KDGpu
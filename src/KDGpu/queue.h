@@ -26,6 +26,7 @@
 namespace KDGpu {
 
 class Surface;
+class UploadBatch;
 
 struct Adapter_t;
 struct Buffer_t;
@@ -161,6 +162,17 @@ struct TextureUploadOptions {
     TextureSubresourceRange range{};
 };
 
+/**
+    @brief Returns the subresource range a texture upload transitions
+
+    This is @p range when its aspectMask is set. Otherwise it covers the mip levels and
+    array layers up to the highest ones @p regions write to, for the aspect of the first region.
+    @ingroup public
+    @headerfile queue.h <KDGpu/queue.h>
+*/
+KDGPU_EXPORT TextureSubresourceRange textureUploadRange(const TextureSubresourceRange &range,
+                                                        const std::vector<BufferTextureCopyRegion> &regions);
+
 /**
     @ingroup public
     @headerfile queue.h <KDGpu/queue.h>
@@ -229,10 +241,11 @@ struct UploadStagingBuffer {
     - Queue::present()->vkQueuePresentKHR()
     - Queue::waitUntilIdle()->vkQueueWaitIdle()
     - Queue::uploadBufferData()->staging buffer + vkCmdCopyBuffer()
-    - Queue::uploadTextureData()->staging buffer + vkCmdCopyBufferToImage()
+    - Queue::uploadTextureData()->staging buffer + vkCmdCopyBufferToImage(), or vkTransitionImageLayoutEXT() + vkCopyMemoryToImageEXT() when uploading from TextureLayout::Undefined to textures with TextureUsageFlagBits::HostTransferBit on devices with the hostImageCopy feature enabled
+    - Queue::upload()->one staging buffer + vkCmdCopyBuffer()/vkCmdCopyBufferToImage() per upload + one vkQueueSubmit()
 
     ## See also:
-    \sa SubmitOptions, PresentOptions, Device, CommandRecorder, CommandBuffer, Fence, GpuSemaphore, TimelineSemaphore, Swapchain
+    \sa SubmitOptions, PresentOptions, Device, CommandRecorder, CommandBuffer, Fence, GpuSemaphore, TimelineSemaphore, Swapchain, UploadBatch
     \sa \ref kdgpu_api_overview
     \sa \ref kdgpu_vulkan_mapping
 */
@@ -262,10 +275,16 @@ public:
     UploadStagingBuffer uploadBufferData(const BufferUploadOptions &options);
     void waitForUploadTextureData(const WaitForTextureUploadOptions &options);
     UploadStagingBuffer uploadTextureData(const TextureUploadOptions &options);
+    UploadStagingBuffer upload(const UploadBatch &batch, const std::vector<TimelineSemaphoreSubmitSignalInfo> &signalTimelineSemaphores = {});
 
 private:
     Queue(GraphicsApi *api, const Handle<Device_t> &device, const QueueDescription &queueDescription);
 
+    bool uploadTextureDataFromHost(const Handle<Texture_t> &texture, const void *data,
+                                   TextureLayout oldLayout, TextureLayout newLayout,
+                                   const std::vector<BufferTextureCopyRegion> &regions,
+                                   const TextureSubresourceRange &range);
+
     GraphicsApi *m_api{ nullptr };
     Handle<Device_t> m_device;
     Handle<Queue_t> m_queue;
@@ -32,6 +32,15 @@ RayTracingPipeline::RayTracingPipeline(GraphicsApi *api,
 {
 }
 
+RayTracingPipeline::RayTracingPipeline(GraphicsApi *api,
+                                       const Handle<Device_t> &device,
+                                       const Handle<RayTracingPipeline_t> &rayTracingPipeline)
+    : m_api(api)
+    , m_device(device)
+    , m_rayTracingPipeline(rayTracingPipeline)
+{
+}
+
 RayTracingPipeline::RayTracingPipeline(RayTracingPipeline &&other) noexcept
 {
     m_api = std::exchange(other.m_api, nullptr);
@@ -31,6 +31,8 @@ struct RayTracingShaderGroupOptions {
     std::optional<uint32_t> anyHitShaderIndex;       // Optional set if type == Procedural || Triangle
     std::optional<uint32_t> intersectionShaderIndex; // Optional set if type == Procedural
     // clang-format on
+
+    friend bool operator==(const RayTracingShaderGroupOptions &, const RayTracingShaderGroupOptions &) = default;
 };
 
 struct RayTracingPipelineOptions {
@@ -42,6 +44,43 @@ struct RayTracingPipelineOptions {
 
     // Optional pipeline cache to speed up pipeline creation
     OptionalHandle<PipelineCache_t> pipelineCache;
+
+    friend bool operator==(const RayTracingPipelineOptions &, const RayTracingPipelineOptions &) = default;
 };
 
 } // namespace KDGpu
+
+namespace std {
+
+template<>
+struct hash<KDGpu::RayTracingShaderGroupOptions> {
+    size_t operator()(const KDGpu::RayTracingShaderGroupOptions &group) const noexcept
+    {
+        uint64_t hash = 0;
+        KDFoundation::hash_combine(hash, static_cast<uint32_t>(group.type));
+        KDFoundation::hash_combine(hash, group.generalShaderIndex.value_or(~0U));
+        KDFoundation::hash_combine(hash, group.closestHitShaderIndex.value_or(~0U));
+        KDFoundation::hash_combine(hash, group.anyHitShaderIndex.value_or(~0U));
+        KDFoundation::hash_combine(hash, group.intersectionShaderIndex.value_or(~0U));
+        return hash;
+    }
+};
+
+template<>
+struct hash<KDGpu::RayTracingPipelineOptions> {
+    size_t operator()(const KDGpu::RayTracingPipelineOptions &options) const noexcept
+    {
+        uint64_t hash = 0;
+        KDFoundation::hash_combine(hash, std::hash<std::string_view>()(options.label));
+        for (const auto &shaderStage : options.shaderStages)
+            KDFoundation::hash_combine(hash, shaderStage);
+        for (const auto &shaderGroup : options.shaderGroups)
+            KDFoundation::hash_combine(hash, shaderGroup);
+        KDFoundation::hash_combine(hash, options.layout);
+        KDFoundation::hash_combine(hash, options.maxRecursionDepth);
+        KDFoundation::hash_combine(hash, options.pipelineCache);
+        return hash;
+    }
+};
+
+} // namespace std
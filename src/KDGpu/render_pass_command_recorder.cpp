@@ -99,6 +99,12 @@ void RenderPassCommandRecorder::end()
     apiRenderPassCommandRecorder->end();
 }
 
+BindStateStats RenderPassCommandRecorder::bindStateStats() const
+{
+    auto *apiRenderPassCommandRecorder = m_api->resourceManager()->getRenderPassCommandRecorder(m_renderPassCommandRecorder);
+    return apiRenderPassCommandRecorder->bindStateStats();
+}
+
 void RenderPassCommandRecorder::draw(const DrawCommand &drawCommand)
 {
     auto *apiRenderPassCommandRecorder = m_api->resourceManager()->getRenderPassCommandRecorder(m_renderPassCommandRecorder);
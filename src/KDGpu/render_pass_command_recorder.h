@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <KDGpu/bind_state_tracker.h>
 #include <KDGpu/gpu_core.h>
 #include <KDGpu/handle.h>
 #include <KDGpu/kdgpu_export.h>
@@ -244,6 +245,10 @@ public:
         All subsequent draw commands will use this pipeline's shaders, blend state,
         depth/stencil state, etc. Must be called before drawing.
 
+        Setting the pipeline that is already bound is skipped, as are repeated
+        setVertexBuffer(), setIndexBuffer() and setBindGroup() calls with the same
+        arguments. See bindStateStats().
+
         Vulkan: vkCmdBindPipeline(VK_PIPELINE_BIND_POINT_GRAPHICS)
     */
     void setPipeline(const RequiredHandle<GraphicsPipeline_t> &pipeline);
@@ -474,6 +479,12 @@ public:
     */
     void end();
 
+    /*!
+        \brief Returns how many pipeline, bind group, vertex and index buffer binds
+        were recorded and how many were skipped as redundant
+    */
+    BindStateStats bindStateStats() const;
+
 private:
     explicit RenderPassCommandRecorder(GraphicsApi *api,
                                        const Handle<Device_t> &device,
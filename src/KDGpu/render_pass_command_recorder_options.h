@@ -208,6 +208,30 @@ struct RenderPassCommandRecorderWithDynamicRenderingOptions {
     uint32_t framebufferWidth{ 0 }; ///< Render area width (0 = infer from first attachment)
     uint32_t framebufferHeight{ 0 }; ///< Render area height (0 = infer from first attachment)
     uint32_t framebufferArrayLayers{ 0 }; ///< Array layers (0 = infer from first attachment)
+    bool secondaryCommandBuffers{ false }; ///< Draw commands come from secondary command buffers executed with CommandRecorder::executeSecondaryCommandBuffer()
+};
+
+/*!
+    \brief Describes the dynamic rendering pass a secondary command buffer continues
+    \ingroup public
+    \headerfile render_pass_command_recorder_options.h <KDGpu/render_pass_command_recorder_options.h>
+
+    Set on CommandRecorderOptions::renderPassInheritance so that the secondary command buffer can
+    record draws with CommandRecorder::continueRenderPass(). The formats, sample count and view count
+    must match the render pass begun with RenderPassCommandRecorderWithDynamicRenderingOptions::secondaryCommandBuffers
+    set, in which the command buffer is executed.
+
+    In Vulkan, this maps to VkCommandBufferInheritanceRenderingInfo.
+
+    \sa RenderPassCommandRecorderWithDynamicRenderingOptions, CommandRecorderOptions
+ */
+struct RenderPassInheritance {
+    std::vector<Format> colorFormats; ///< Formats of the color attachments, in order
+    Format depthStencilFormat{ Format::UNDEFINED }; ///< Format of the depth/stencil attachment, if any
+    SampleCountFlagBits samples{ SampleCountFlagBits::Samples1Bit }; ///< MSAA sample count
+    uint32_t viewCount{ 1 }; ///< Number of views for multiview rendering
+    uint32_t framebufferWidth{ 0 }; ///< Render area width, used for the initial viewport and scissor
+    uint32_t framebufferHeight{ 0 }; ///< Render area height, used for the initial viewport and scissor
 };
 
 struct DebugLabelOptions {
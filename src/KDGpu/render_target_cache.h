@@ -0,0 +1,52 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace KDGpu {
+
+/*!
+    \struct RenderTargetCacheOptions
+    \brief Capacity of the render passes and framebuffers a Device creates behind the scenes
+    \ingroup public
+    \headerfile render_target_cache.h <KDGpu/render_target_cache.h>
+
+    Beginning a render pass from RenderPassCommandRecorderOptions looks up a matching render pass and
+    framebuffer and creates them on a miss. Once a cache holds more than its capacity, the least
+    recently used entries are evicted. An evicted object that is still referenced by a CommandBuffer
+    is only destroyed once that CommandBuffer is destroyed, so eviction is safe with frames in flight.
+
+    A capacity of 0 means unbounded.
+ */
+struct RenderTargetCacheOptions {
+    uint32_t maxRenderPasses{ 0 };
+    uint32_t maxFramebuffers{ 0 };
+};
+
+/*!
+    \struct RenderTargetCacheStats
+    \brief Counters reported by Device::renderPassCacheStats() and Device::framebufferCacheStats()
+    \ingroup public
+    \headerfile render_target_cache.h <KDGpu/render_target_cache.h>
+
+    liveObjects includes evicted objects that wait for the CommandBuffers using them to go away.
+    For CommandBuffers of a FrameCommandAllocator, that is when their frame begins again.
+ */
+struct RenderTargetCacheStats {
+    uint64_t hits{ 0 };
+    uint64_t misses{ 0 };
+    uint64_t evictions{ 0 };
+    size_t liveObjects{ 0 };
+};
+
+} // namespace KDGpu
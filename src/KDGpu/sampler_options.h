@@ -12,6 +12,9 @@
 
 #include <KDGpu/gpu_core.h>
 #include <KDGpu/ycbcr_conversion.h>
+#include <KDFoundation/hashutils.h>
+
+#include <tuple>
 
 namespace KDGpu {
 
@@ -39,6 +42,49 @@ struct SamplerOptions {
     bool normalizedCoordinates{ true };
 
     OptionalHandle<YCbCrConversion_t> yCbCrConversion{};
+
+    // Equality operator for caching. The label is left out, so that samplers only differing by their
+    // label are shared, keeping the label of the first one.
+    friend bool operator==(const SamplerOptions &lhs, const SamplerOptions &rhs)
+    {
+        const auto description = [](const SamplerOptions &options) {
+            return std::tie(options.magFilter, options.minFilter, options.mipmapFilter,
+                            options.u, options.v, options.w,
+                            options.lodMinClamp, options.lodMaxClamp,
+                            options.anisotropyEnabled, options.maxAnisotropy,
+                            options.compareEnabled, options.compare,
+                            options.normalizedCoordinates, options.yCbCrConversion);
+        };
+        return description(lhs) == description(rhs);
+    }
 };
 
 } // namespace KDGpu
+
+// Hash function for SamplerOptions to enable caching
+namespace std {
+
+template<>
+struct hash<KDGpu::SamplerOptions> {
+    size_t operator()(const KDGpu::SamplerOptions &options) const noexcept
+    {
+        uint64_t hash = 0;
+        KDFoundation::hash_combine(hash, static_cast<uint32_t>(options.magFilter));
+        KDFoundation::hash_combine(hash, static_cast<uint32_t>(options.minFilter));
+        KDFoundation::hash_combine(hash, static_cast<uint32_t>(options.mipmapFilter));
+        KDFoundation::hash_combine(hash, static_cast<uint32_t>(options.u));
+        KDFoundation::hash_combine(hash, static_cast<uint32_t>(options.v));
+        KDFoundation::hash_combine(hash, static_cast<uint32_t>(options.w));
+        KDFoundation::hash_combine(hash, options.lodMinClamp);
+        KDFoundation::hash_combine(hash, options.lodMaxClamp);
+        KDFoundation::hash_combine(hash, options.anisotropyEnabled);
+        KDFoundation::hash_combine(hash, options.maxAnisotropy);
+        KDFoundation::hash_combine(hash, options.compareEnabled);
+        KDFoundation::hash_combine(hash, static_cast<uint32_t>(options.compare));
+        KDFoundation::hash_combine(hash, options.normalizedCoordinates);
+        KDFoundation::hash_combine(hash, options.yCbCrConversion);
+        return hash;
+    }
+};
+
+} // namespace std
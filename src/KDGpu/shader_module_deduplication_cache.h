@@ -0,0 +1,87 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/deduplication_cache.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace KDGpu {
+
+struct ShaderModule_t;
+
+/*!
+    \struct ShaderModuleDeduplicationStats
+    \brief Counters reported by Device::shaderModuleDeduplicationStats()
+    \ingroup public
+    \headerfile shader_module_deduplication_cache.h <KDGpu/shader_module_deduplication_cache.h>
+
+    A hit is a Device::createShaderModule() call that was answered with an existing shader module,
+    a miss is one that had to create a new shader module.
+ */
+struct ShaderModuleDeduplicationStats {
+    uint64_t hits{ 0 };
+    uint64_t misses{ 0 };
+    size_t cachedShaderModules{ 0 };
+};
+
+/**
+ * @brief ShaderCodeHash
+ * @internal
+ *
+ * 64 bit FNV-1a hash of SPIR-V code words.
+ */
+struct ShaderCodeHash {
+    static uint64_t hashCode(std::span<const uint32_t> code) noexcept
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const uint32_t word : code) {
+            for (uint32_t shift = 0; shift < 32; shift += 8) {
+                hash ^= (word >> shift) & 0xff;
+                hash *= 0x100000001b3ULL;
+            }
+        }
+        return hash;
+    }
+
+    size_t operator()(const std::vector<uint32_t> &code) const noexcept
+    {
+        return static_cast<size_t>(hashCode(code));
+    }
+};
+
+/**
+ * @brief ShaderModuleDeduplicationCache
+ * @internal
+ *
+ * DeduplicationCache mapping SPIR-V code to a shader module so that identical
+ * code shares a single shader module, reporting ShaderModuleDeduplicationStats.
+ * The code itself is kept to resolve hash collisions.
+ */
+class ShaderModuleDeduplicationCache : public DeduplicationCache<std::vector<uint32_t>, ShaderModule_t, ShaderCodeHash>
+{
+public:
+    static uint64_t hashCode(std::span<const uint32_t> code) noexcept
+    {
+        return ShaderCodeHash::hashCode(code);
+    }
+
+    ShaderModuleDeduplicationStats stats() const
+    {
+        const DeduplicationStats stats = DeduplicationCache::stats();
+        return ShaderModuleDeduplicationStats{ .hits = stats.hits, .misses = stats.misses, .cachedShaderModules = stats.cachedObjects };
+    }
+};
+
+} // namespace KDGpu
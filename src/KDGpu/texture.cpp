@@ -89,6 +89,27 @@ SubresourceLayout Texture::getSubresourceLayout(const TextureSubresource &subres
 }
 
 bool Texture::generateMipMaps(Device &device, Queue &transferQueue, const Handle<Texture_t> &sourceTexture, const TextureOptions &options, TextureLayout oldLayout, TextureLayout newLayout)
+{
+    CommandRecorder commandRecorder = device.createCommandRecorder();
+    if (!generateMipMaps(device, commandRecorder, sourceTexture, options, oldLayout, newLayout))
+        return false;
+
+    CommandBuffer commandBuffer = commandRecorder.finish();
+
+    transferQueue.submit(SubmitOptions{
+            .commandBuffers = { commandBuffer },
+    });
+
+    transferQueue.waitUntilIdle();
+    return true;
+}
+
+bool Texture::generateMipMaps(Device &device, Queue &transferQueue, const TextureOptions &options, TextureLayout oldLayout, TextureLayout newLayout)
+{
+    return generateMipMaps(device, transferQueue, handle(), options, oldLayout, newLayout);
+}
+
+bool Texture::generateMipMaps(Device &device, CommandRecorder &commandRecorder, const Handle<Texture_t> &sourceTexture, const TextureOptions &options, TextureLayout oldLayout, TextureLayout newLayout)
 {
     const Adapter *adapter = device.adapter();
     if (!adapter)
@@ -97,8 +118,6 @@ bool Texture::generateMipMaps(Device &device, Queue &transferQueue, const Handle
     if (!adapter->supportsBlitting(options.format, options.tiling))
         return false;
 
-    CommandRecorder commandRecorder = device.createCommandRecorder();
-
     // Transition source to TransferSrcOptimal
     if (oldLayout != TextureLayout::TransferSrcOptimal)
         commandRecorder.textureMemoryBarrier(TextureMemoryBarrierOptions{
@@ -215,19 +234,12 @@ bool Texture::generateMipMaps(Device &device, Queue &transferQueue, const Handle
                 },
         });
 
-    CommandBuffer commandBuffer = commandRecorder.finish();
-
-    transferQueue.submit(SubmitOptions{
-            .commandBuffers = { commandBuffer },
-    });
-
-    transferQueue.waitUntilIdle();
     return true;
 }
 
-bool Texture::generateMipMaps(Device &device, Queue &transferQueue, const TextureOptions &options, TextureLayout oldLayout, TextureLayout newLayout)
+bool Texture::generateMipMaps(Device &device, CommandRecorder &commandRecorder, const TextureOptions &options, TextureLayout oldLayout, TextureLayout newLayout)
 {
-    return generateMipMaps(device, transferQueue, handle(), options, oldLayout, newLayout);
+    return generateMipMaps(device, commandRecorder, handle(), options, oldLayout, newLayout);
 }
 
 MemoryHandle Texture::externalMemoryHandle() const
@@ -20,6 +20,7 @@ namespace KDGpu {
 struct Device_t;
 struct Texture_t;
 struct TextureOptions;
+class CommandRecorder;
 class Device;
 class Queue;
 
@@ -221,6 +222,29 @@ public:
      */
     bool generateMipMaps(Device &device, Queue &transferQueue, const TextureOptions &options, TextureLayout oldLayout, TextureLayout newLayout = TextureLayout::Undefined);
 
+    /**
+     * @brief Record the generation of mipmaps from another texture without submitting it
+     * @param device KDGpu Device
+     * @param commandRecorder Recorder the blits and layout transitions are appended to
+     * @param sourceTexture Texture to copy/blit from when creating the mipmaps
+     * @param options Texture Options for the target texture
+     * @param oldLayout Transitioning from this layout
+     * @param newLayout Transitioning to this layout when the mip map creation is done
+     * @return true when the commands were recorded, false when the format cannot be blitted
+     */
+    bool generateMipMaps(Device &device, CommandRecorder &commandRecorder, const Handle<Texture_t> &sourceTexture, const TextureOptions &options, TextureLayout oldLayout, TextureLayout newLayout = TextureLayout::Undefined);
+
+    /**
+     * @brief Record the generation of mipmaps for this texture without submitting it
+     * @param device KDGpu Device
+     * @param commandRecorder Recorder the blits and layout transitions are appended to
+     * @param options Texture Options for the target texture
+     * @param oldLayout Transitioning from this layout
+     * @param newLayout Transitioning to this layout when the mip map creation is done
+     * @return true when the commands were recorded, false when the format cannot be blitted
+     */
+    bool generateMipMaps(Device &device, CommandRecorder &commandRecorder, const TextureOptions &options, TextureLayout oldLayout, TextureLayout newLayout = TextureLayout::Undefined);
+
     MemoryHandle externalMemoryHandle() const;
 
     uint64_t drmFormatModifier() const;
@@ -0,0 +1,55 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "upload_batch.h"
+
+namespace KDGpu {
+
+namespace {
+
+// Offsets of buffer to buffer copies only need to be aligned for the memcpy into the staging buffer
+constexpr DeviceSize BufferStagingAlignment = 16;
+// Buffer offsets of buffer to texture copies must be a multiple of the texel block size and of 4,
+// 96 is a multiple of every texel block size (1, 2, 3, 4, 6, 8, 12, 16, 24 and 32 bytes)
+constexpr DeviceSize TextureStagingAlignment = 96;
+
+} // namespace
+
+void UploadBatch::addBufferUpload(const BufferUploadOptions &options)
+{
+    m_bufferUploads.push_back(BufferUpload{
+            .options = options,
+            .stagingOffset = reserve(options.byteSize, BufferStagingAlignment),
+    });
+}
+
+void UploadBatch::addTextureUpload(const TextureUploadOptions &options)
+{
+    m_textureUploads.push_back(TextureUpload{
+            .options = options,
+            .stagingOffset = reserve(options.byteSize, TextureStagingAlignment),
+    });
+}
+
+void UploadBatch::clear()
+{
+    m_bufferUploads.clear();
+    m_textureUploads.clear();
+    m_stagingSize = 0;
+}
+
+DeviceSize UploadBatch::reserve(DeviceSize byteSize, DeviceSize alignment)
+{
+    const DeviceSize offset = (m_stagingSize + alignment - 1) / alignment * alignment;
+    m_stagingSize = offset + byteSize;
+    return offset;
+}
+
+} // namespace KDGpu
@@ -0,0 +1,75 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/gpu_core.h>
+#include <KDGpu/kdgpu_export.h>
+#include <KDGpu/queue.h>
+
+#include <vector>
+
+namespace KDGpu {
+
+/*!
+    \class UploadBatch
+    \brief Collects buffer and texture uploads to submit them to a Queue at once
+    \ingroup public
+    \headerfile upload_batch.h <KDGpu/upload_batch.h>
+
+    Queue::uploadBufferData() and Queue::uploadTextureData() each create a staging buffer, a command
+    buffer and a fence and submit them on their own. Uploading many resources that way costs one
+    submission per resource.
+
+    UploadBatch instead records where the data of each upload goes in a single staging buffer.
+    Queue::upload() copies all of it at once, records every copy into one command buffer, transitions
+    the textures with a single barrier before and after the copies, makes the buffers visible with one
+    global memory barrier and submits the whole batch once. The returned UploadStagingBuffer holds the
+    staging memory of the batch, which can be released as a whole once its fence is signalled.
+
+    The data pointed to by the upload options is only read by Queue::upload() and has to stay valid until then.
+
+    \snippet kdgpu_doc_snippets.cpp upload_batch
+
+    \sa Queue::upload(), BufferUploadOptions, TextureUploadOptions
+ */
+class KDGPU_EXPORT UploadBatch
+{
+public:
+    void addBufferUpload(const BufferUploadOptions &options);
+    void addTextureUpload(const TextureUploadOptions &options);
+
+    bool isEmpty() const noexcept { return m_bufferUploads.empty() && m_textureUploads.empty(); }
+    size_t uploadCount() const noexcept { return m_bufferUploads.size() + m_textureUploads.size(); }
+    DeviceSize stagingSize() const noexcept { return m_stagingSize; }
+
+    void clear();
+
+private:
+    struct BufferUpload {
+        BufferUploadOptions options;
+        DeviceSize stagingOffset{ 0 };
+    };
+
+    struct TextureUpload {
+        TextureUploadOptions options;
+        DeviceSize stagingOffset{ 0 };
+    };
+
+    DeviceSize reserve(DeviceSize byteSize, DeviceSize alignment);
+
+    std::vector<BufferUpload> m_bufferUploads;
+    std::vector<TextureUpload> m_textureUploads;
+    DeviceSize m_stagingSize{ 0 };
+
+    friend class Queue;
+};
+
+} // namespace KDGpu
@@ -118,6 +118,18 @@ AdapterProperties VulkanAdapter::queryAdapterProperties()
     addToChain(&hostImageCopyProperties);
 #endif
 
+#if VK_EXT_external_memory_host
+    VkPhysicalDeviceExternalMemoryHostPropertiesEXT externalMemoryHostProperties{};
+    // Chaining the properties of an extension the adapter lacks is invalid
+    const bool hasExternalMemoryHost = std::ranges::any_of(extensions(), [](const Extension &extension) {
+        return extension.name == VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME;
+    });
+    if (hasExternalMemoryHost) {
+        externalMemoryHostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+        addToChain(&externalMemoryHostProperties);
+    }
+#endif
+
 #if VK_KHR_push_descriptor
     VkPhysicalDevicePushDescriptorPropertiesKHR pushDescriptorProperties{};
     pushDescriptorProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR;
@@ -390,6 +402,11 @@ AdapterProperties VulkanAdapter::queryAdapterProperties()
 #if VK_EXT_host_image_copy
                 .srcCopyLayouts = toTextureLayouts(hostImageCopyProperties.copySrcLayoutCount, hostImageCopyProperties.pCopySrcLayouts),
                 .dstCopyLayouts = toTextureLayouts(hostImageCopyProperties.copyDstLayoutCount, hostImageCopyProperties.pCopyDstLayouts),
+#endif
+        },
+        .externalMemoryHostProperties = {
+#if VK_EXT_external_memory_host
+                .minImportedHostPointerAlignment = externalMemoryHostProperties.minImportedHostPointerAlignment,
 #endif
         },
 #if VK_KHR_push_descriptor
@@ -34,32 +34,43 @@ VulkanBuffer::VulkanBuffer(VkBuffer _buffer,
 
 void *VulkanBuffer::map()
 {
-    auto vulkanDevice = vulkanResourceManager->getDevice(deviceHandle);
-    vmaMapMemory(vulkanDevice->allocator, allocation, &mapped);
+    if (persistentlyMapped)
+        return mapped;
+    vmaMapMemory(allocator, allocation, &mapped);
     return mapped;
 }
 
 void VulkanBuffer::unmap()
 {
-    auto vulkanDevice = vulkanResourceManager->getDevice(deviceHandle);
-    vmaUnmapMemory(vulkanDevice->allocator, allocation);
+    if (persistentlyMapped)
+        return;
+    vmaUnmapMemory(allocator, allocation);
     mapped = nullptr;
 }
 
 // Note: invalidating before mapping is only needed on non host coherent memory
 // (AMD, Intel, NVIDIA) driver currently provide HOST_COHERENT flag on all memory types that are HOST_VISIBLE
-void VulkanBuffer::invalidate()
+// VMA returns early for host coherent memory and aligns the range to nonCoherentAtomSize otherwise
+void VulkanBuffer::invalidate(DeviceSize offset, DeviceSize size)
 {
-    auto vulkanDevice = vulkanResourceManager->getDevice(deviceHandle);
-    vmaInvalidateAllocation(vulkanDevice->allocator, allocation, 0, VK_WHOLE_SIZE);
+    // Imported host memory is accessed through the host pointer rather than a vkMapMemory() mapping
+    if (importedMemory != VK_NULL_HANDLE)
+        return;
+    vmaInvalidateAllocation(allocator, allocation, offset, size);
 }
 
 // Note: flushing after mapping is only needed on non host coherent memory
 // (AMD, Intel, NVIDIA) driver currently provide HOST_COHERENT flag on all memory types that are HOST_VISIBLE
-void VulkanBuffer::flush()
+void VulkanBuffer::flush(DeviceSize offset, DeviceSize size)
 {
-    auto vulkanDevice = vulkanResourceManager->getDevice(deviceHandle);
-    vmaFlushAllocation(vulkanDevice->allocator, allocation, 0, VK_WHOLE_SIZE);
+    if (importedMemory != VK_NULL_HANDLE)
+        return;
+    vmaFlushAllocation(allocator, allocation, offset, size);
+}
+
+void *VulkanBuffer::mappedPointer()
+{
+    return persistentlyMapped ? mapped : nullptr;
 }
 
 MemoryHandle VulkanBuffer::externalMemoryHandle() const
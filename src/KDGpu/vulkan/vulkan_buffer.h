@@ -39,8 +39,9 @@ struct KDGPU_EXPORT VulkanBuffer {
 
     void *map();
     void unmap();
-    void invalidate();
-    void flush();
+    void invalidate(DeviceSize offset, DeviceSize size);
+    void flush(DeviceSize offset, DeviceSize size);
+    void *mappedPointer();
     MemoryHandle externalMemoryHandle() const;
     BufferDeviceAddress bufferDeviceAddress() const;
 
@@ -48,6 +49,9 @@ struct KDGPU_EXPORT VulkanBuffer {
     VmaAllocation allocation{ VK_NULL_HANDLE };
     VmaAllocator allocator{ VK_NULL_HANDLE };
     void *mapped{ nullptr };
+    bool persistentlyMapped{ false };
+    // Memory of buffers created from BufferOptions::hostPointer, which VMA knows nothing about
+    VkDeviceMemory importedMemory{ VK_NULL_HANDLE };
 
     VulkanResourceManager *vulkanResourceManager;
     Handle<Device_t> deviceHandle;
@@ -10,6 +10,7 @@
 
 #include "vulkan_command_buffer.h"
 
+#include <KDGpu/vulkan/vulkan_enums.h>
 #include <KDGpu/vulkan/vulkan_formatters.h>
 
 namespace KDGpu {
@@ -36,11 +37,35 @@ void VulkanCommandBuffer::begin()
     beginInfo.pInheritanceInfo = nullptr;
 
     VkCommandBufferInheritanceInfo inheritanceInfo{};
+#if VK_KHR_dynamic_rendering
+    VkCommandBufferInheritanceRenderingInfoKHR renderingInheritanceInfo{};
+    std::vector<VkFormat> colorFormats;
+#endif
     if (commandLevel == VK_COMMAND_BUFFER_LEVEL_SECONDARY) {
         inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
 
-        // TODO: We will need a way to specify the RenderPass/FrameBuffer if we want to record
-        // commands from within a RenderPass.
+#if VK_KHR_dynamic_rendering
+        // Continue the dynamic rendering pass of the primary command buffer executing this one
+        if (renderPassInheritance.has_value()) {
+            colorFormats.reserve(renderPassInheritance->colorFormats.size());
+            for (const Format format : renderPassInheritance->colorFormats)
+                colorFormats.push_back(formatToVkFormat(format));
+
+            const uint32_t multiViewMask = uint32_t(1 << renderPassInheritance->viewCount) - 1;
+            renderingInheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+            renderingInheritanceInfo.viewMask = (renderPassInheritance->viewCount > 1) ? multiViewMask : 0;
+            renderingInheritanceInfo.colorAttachmentCount = static_cast<uint32_t>(colorFormats.size());
+            renderingInheritanceInfo.pColorAttachmentFormats = colorFormats.data();
+            // Beginning a dynamic render pass binds the depth/stencil view to the aspects its format has
+            const Format depthStencilFormat = renderPassInheritance->depthStencilFormat;
+            renderingInheritanceInfo.depthAttachmentFormat = hasDepthFormat(depthStencilFormat) ? formatToVkFormat(depthStencilFormat) : VK_FORMAT_UNDEFINED;
+            renderingInheritanceInfo.stencilAttachmentFormat = hasStencilFormat(depthStencilFormat) ? formatToVkFormat(depthStencilFormat) : VK_FORMAT_UNDEFINED;
+            renderingInheritanceInfo.rasterizationSamples = sampleCountFlagBitsToVkSampleFlagBits(renderPassInheritance->samples);
+
+            inheritanceInfo.pNext = &renderingInheritanceInfo;
+            beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        }
+#endif
         beginInfo.pInheritanceInfo = &inheritanceInfo;
     }
 
@@ -12,14 +12,21 @@
 
 #include <KDGpu/handle.h>
 #include <KDGpu/kdgpu_export.h>
+#include <KDGpu/render_pass_command_recorder_options.h>
 
 #include <vulkan/vulkan.h>
 
+#include <optional>
+
 namespace KDGpu {
 
 struct Buffer_t;
 struct Device_t;
+struct FrameCommandAllocator_t;
+struct Framebuffer_t;
+struct RenderPass_t;
 class VulkanResourceManager;
+struct VulkanThreadCommandPool;
 
 /**
  * @brief VulkanCommandBuffer
@@ -42,6 +49,18 @@ struct KDGPU_EXPORT VulkanCommandBuffer {
     VulkanResourceManager *vulkanResourceManager{ nullptr };
     Handle<Device_t> deviceHandle;
     std::vector<Handle<Buffer_t>> temporaryBuffersToRelease;
+    // Per thread pool the command buffer was allocated from, null for FrameCommandAllocator command buffers
+    VulkanThreadCommandPool *threadCommandPool{ nullptr };
+    // Allocated from a frame of a FrameCommandAllocator, which resets its pool rather than freeing the
+    // command buffer, and releases the resources recorded into it once that frame begins again
+    Handle<FrameCommandAllocator_t> frameCommandAllocator;
+    uint32_t frameIndex{ 0 };
+    // Render pass a secondary command buffer is recorded to be executed within
+    std::optional<RenderPassInheritance> renderPassInheritance;
+    // Cached render passes and framebuffers recorded into this command buffer, kept alive
+    // until it is destroyed, or its frame begins again, even if the device caches evict them
+    std::vector<Handle<RenderPass_t>> cachedRenderPassesInUse;
+    std::vector<Handle<Framebuffer_t>> cachedFramebuffersInUse;
 };
 
 } // namespace KDGpu
@@ -15,6 +15,8 @@
 #include <KDGpu/vulkan/vulkan_enums.h>
 #include <KDGpu/buffer_options.h>
 
+#include <array>
+
 // MemoryBarrier is a define in winnt.h
 #if defined(MemoryBarrier)
 #undef MemoryBarrier
@@ -22,6 +24,9 @@
 
 namespace {
 
+// Most calls only transition a few textures, their barriers are built on the stack
+constexpr size_t InlineTextureBarrierCount = 8;
+
 std::vector<VkBufferImageCopy> buildRegions(const std::vector<KDGpu::BufferTextureCopyRegion> &regions)
 {
     const uint32_t regionCount = regions.size();
@@ -440,70 +445,106 @@ void VulkanCommandRecorder::bufferMemoryBarrier(const BufferMemoryBarrierOptions
 #endif
 }
 
-// TODO: Implement an array version. Perhaps also a way to refer to the set of arguments via a
-// handle to a backend type if we find we keep issuing barriers in the same way many times.
+// TODO: Perhaps also a way to refer to the set of arguments via a handle to a backend type
+// if we find we keep issuing barriers in the same way many times.
 void VulkanCommandRecorder::textureMemoryBarrier(const TextureMemoryBarrierOptions &options) const
 {
+    textureMemoryBarriers(std::span(&options, 1));
+}
+
+void VulkanCommandRecorder::textureMemoryBarriers(std::span<const TextureMemoryBarrierOptions> options) const
+{
+    if (options.empty())
+        return;
+
     auto *vulkanDevice = vulkanResourceManager->getDevice(deviceHandle);
+    auto toVkSubresourceRange = [](const TextureSubresourceRange &range) {
+        return VkImageSubresourceRange{
+            .aspectMask = textureAspectFlagsToVkImageAspectFlags(range.aspectMask),
+            .baseMipLevel = range.baseMipLevel,
+            .levelCount = range.levelCount,
+            .baseArrayLayer = range.baseArrayLayer,
+            .layerCount = range.layerCount
+        };
+    };
+
 #if VK_KHR_synchronization2
     if (vulkanDevice->vkCmdPipelineBarrier2 != nullptr) {
-        VkImageMemoryBarrier2KHR vkImageBarrier = {};
-        vkImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
-        vkImageBarrier.srcStageMask = pipelineStageFlagsToVkPipelineStageFlagBits2(options.srcStages);
-        vkImageBarrier.srcAccessMask = accessFlagsToVkAccessFlagBits2(options.srcMask);
-        vkImageBarrier.dstStageMask = pipelineStageFlagsToVkPipelineStageFlagBits2(options.dstStages);
-        vkImageBarrier.dstAccessMask = accessFlagsToVkAccessFlagBits2(options.dstMask);
-        vkImageBarrier.srcQueueFamilyIndex = options.srcQueueTypeIndex;
-        vkImageBarrier.dstQueueFamilyIndex = options.dstQueueTypeIndex;
-        vkImageBarrier.oldLayout = textureLayoutToVkImageLayout(options.oldLayout);
-        vkImageBarrier.newLayout = textureLayoutToVkImageLayout(options.newLayout);
-
-        const auto *vulkanTexture = vulkanResourceManager->getTexture(options.texture);
-        vkImageBarrier.image = vulkanTexture->image;
-        vkImageBarrier.subresourceRange = {
-            .aspectMask = textureAspectFlagsToVkImageAspectFlags(options.range.aspectMask),
-            .baseMipLevel = options.range.baseMipLevel,
-            .levelCount = options.range.levelCount,
-            .baseArrayLayer = options.range.baseArrayLayer,
-            .layerCount = options.range.layerCount
-        };
+        std::array<VkImageMemoryBarrier2KHR, InlineTextureBarrierCount> inlineImageBarriers;
+        std::vector<VkImageMemoryBarrier2KHR> heapImageBarriers;
+        VkImageMemoryBarrier2KHR *vkImageBarriers = inlineImageBarriers.data();
+        if (options.size() > InlineTextureBarrierCount) {
+            heapImageBarriers.resize(options.size());
+            vkImageBarriers = heapImageBarriers.data();
+        }
+        DependencyFlags dependencyFlags;
+        for (size_t i = 0; i < options.size(); ++i) {
+            const TextureMemoryBarrierOptions &barrier = options[i];
+            VkImageMemoryBarrier2KHR &vkImageBarrier = vkImageBarriers[i];
+            vkImageBarrier = {};
+            vkImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+            vkImageBarrier.srcStageMask = pipelineStageFlagsToVkPipelineStageFlagBits2(barrier.srcStages);
+            vkImageBarrier.srcAccessMask = accessFlagsToVkAccessFlagBits2(barrier.srcMask);
+            vkImageBarrier.dstStageMask = pipelineStageFlagsToVkPipelineStageFlagBits2(barrier.dstStages);
+            vkImageBarrier.dstAccessMask = accessFlagsToVkAccessFlagBits2(barrier.dstMask);
+            vkImageBarrier.srcQueueFamilyIndex = barrier.srcQueueTypeIndex;
+            vkImageBarrier.dstQueueFamilyIndex = barrier.dstQueueTypeIndex;
+            vkImageBarrier.oldLayout = textureLayoutToVkImageLayout(barrier.oldLayout);
+            vkImageBarrier.newLayout = textureLayoutToVkImageLayout(barrier.newLayout);
+
+            const auto *vulkanTexture = vulkanResourceManager->getTexture(barrier.texture);
+            vkImageBarrier.image = vulkanTexture->image;
+            vkImageBarrier.subresourceRange = toVkSubresourceRange(barrier.range);
+            dependencyFlags |= barrier.depencendyFlags;
+        }
 
         VkDependencyInfoKHR vkDependencyInfo = {};
         vkDependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
-        vkDependencyInfo.imageMemoryBarrierCount = 1;
-        vkDependencyInfo.pImageMemoryBarriers = &vkImageBarrier;
-        vkDependencyInfo.dependencyFlags = dependencyFlagsToVkDependencyFlags(options.depencendyFlags);
+        vkDependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(options.size());
+        vkDependencyInfo.pImageMemoryBarriers = vkImageBarriers;
+        vkDependencyInfo.dependencyFlags = dependencyFlagsToVkDependencyFlags(dependencyFlags);
 
         vulkanDevice->vkCmdPipelineBarrier2(commandBuffer, &vkDependencyInfo);
     } else {
 #endif
-        // Fallback to the Vulkan 1.0 approach
-        VkImageMemoryBarrier vkImageBarrier = {};
-        vkImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        vkImageBarrier.srcAccessMask = accessFlagsToVkAccessFlagBits(options.srcMask);
-        vkImageBarrier.dstAccessMask = accessFlagsToVkAccessFlagBits(options.dstMask);
-        vkImageBarrier.srcQueueFamilyIndex = options.srcQueueTypeIndex;
-        vkImageBarrier.dstQueueFamilyIndex = options.dstQueueTypeIndex;
-        vkImageBarrier.oldLayout = textureLayoutToVkImageLayout(options.oldLayout);
-        vkImageBarrier.newLayout = textureLayoutToVkImageLayout(options.newLayout);
-
-        const auto *vulkanTexture = vulkanResourceManager->getTexture(options.texture);
-        vkImageBarrier.image = vulkanTexture->image;
-        vkImageBarrier.subresourceRange = {
-            .aspectMask = textureAspectFlagsToVkImageAspectFlags(options.range.aspectMask),
-            .baseMipLevel = options.range.baseMipLevel,
-            .levelCount = options.range.levelCount,
-            .baseArrayLayer = options.range.baseArrayLayer,
-            .layerCount = options.range.layerCount
-        };
+        // Fallback to the Vulkan 1.0 approach, where all barriers of a call share the same stages
+        std::array<VkImageMemoryBarrier, InlineTextureBarrierCount> inlineImageBarriers;
+        std::vector<VkImageMemoryBarrier> heapImageBarriers;
+        VkImageMemoryBarrier *vkImageBarriers = inlineImageBarriers.data();
+        if (options.size() > InlineTextureBarrierCount) {
+            heapImageBarriers.resize(options.size());
+            vkImageBarriers = heapImageBarriers.data();
+        }
+        PipelineStageFlags srcStages;
+        PipelineStageFlags dstStages;
+        DependencyFlags dependencyFlags;
+        for (size_t i = 0; i < options.size(); ++i) {
+            const TextureMemoryBarrierOptions &barrier = options[i];
+            VkImageMemoryBarrier &vkImageBarrier = vkImageBarriers[i];
+            vkImageBarrier = {};
+            vkImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            vkImageBarrier.srcAccessMask = accessFlagsToVkAccessFlagBits(barrier.srcMask);
+            vkImageBarrier.dstAccessMask = accessFlagsToVkAccessFlagBits(barrier.dstMask);
+            vkImageBarrier.srcQueueFamilyIndex = barrier.srcQueueTypeIndex;
+            vkImageBarrier.dstQueueFamilyIndex = barrier.dstQueueTypeIndex;
+            vkImageBarrier.oldLayout = textureLayoutToVkImageLayout(barrier.oldLayout);
+            vkImageBarrier.newLayout = textureLayoutToVkImageLayout(barrier.newLayout);
+
+            const auto *vulkanTexture = vulkanResourceManager->getTexture(barrier.texture);
+            vkImageBarrier.image = vulkanTexture->image;
+            vkImageBarrier.subresourceRange = toVkSubresourceRange(barrier.range);
+            srcStages |= barrier.srcStages;
+            dstStages |= barrier.dstStages;
+            dependencyFlags |= barrier.depencendyFlags;
+        }
 
         vkCmdPipelineBarrier(commandBuffer,
-                             pipelineStageFlagsToVkPipelineStageFlagBits(options.srcStages),
-                             pipelineStageFlagsToVkPipelineStageFlagBits(options.dstStages),
-                             dependencyFlagsToVkDependencyFlags(options.depencendyFlags),
+                             pipelineStageFlagsToVkPipelineStageFlagBits(srcStages),
+                             pipelineStageFlagsToVkPipelineStageFlagBits(dstStages),
+                             dependencyFlagsToVkDependencyFlags(dependencyFlags),
                              0, nullptr,
                              0, nullptr,
-                             1, &vkImageBarrier);
+                             static_cast<uint32_t>(options.size()), vkImageBarriers);
 #if VK_KHR_synchronization2
     }
 #endif
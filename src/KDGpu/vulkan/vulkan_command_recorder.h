@@ -48,6 +48,7 @@ struct KDGPU_EXPORT VulkanCommandRecorder {
     void memoryBarrier(const MemoryBarrierOptions &options) const;
     void bufferMemoryBarrier(const BufferMemoryBarrierOptions &options) const;
     void textureMemoryBarrier(const TextureMemoryBarrierOptions &options) const;
+    void textureMemoryBarriers(std::span<const TextureMemoryBarrierOptions> options) const;
     void executeSecondaryCommandBuffer(const Handle<CommandBuffer_t> &secondaryCommandBuffer) const;
     void resolveTexture(const TextureResolveOptions &options) const;
     void buildAccelerationStructures(const BuildAccelerationStructureOptions &options) const;
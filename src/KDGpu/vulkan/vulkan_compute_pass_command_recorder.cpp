@@ -27,33 +27,31 @@ VulkanComputePassCommandRecorder::VulkanComputePassCommandRecorder(VkCommandBuff
 
 void VulkanComputePassCommandRecorder::setPipeline(const Handle<ComputePipeline_t> &_pipeline)
 {
+    if (!bindState.bindPipeline(_pipeline))
+        return;
+
     pipeline = _pipeline;
     VulkanComputePipeline *vulkanPipeline = vulkanResourceManager->getComputePipeline(pipeline);
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, vulkanPipeline->pipeline);
+    bindState.setPipelineLayout(vulkanPipeline->pipelineLayoutHandle);
 }
 
 void VulkanComputePassCommandRecorder::setBindGroup(uint32_t group, const Handle<BindGroup_t> &_bindGroup,
                                                     const Handle<PipelineLayout_t> &pipelineLayout,
-                                                    std::span<const uint32_t> dynamicBufferOffsets) const
+                                                    std::span<const uint32_t> dynamicBufferOffsets)
 {
+    // Use the pipeline layout provided, otherwise fallback to the one from the currently
+    // bound pipeline (if any).
+    const Handle<PipelineLayout_t> &pipelineLayoutHandle = pipelineLayout.isValid() ? pipelineLayout : bindState.pipelineLayout();
+    if (!bindState.bindBindGroup(group, _bindGroup, pipelineLayoutHandle, dynamicBufferOffsets))
+        return;
+
     VulkanBindGroup *bindGroup = vulkanResourceManager->getBindGroup(_bindGroup);
     VkDescriptorSet set = bindGroup->descriptorSet;
 
-    // Use the pipeline layout provided, otherwise fallback to the one from the currently
-    // bound pipeline (if any).
     VkPipelineLayout vkPipelineLayout{ VK_NULL_HANDLE };
-    if (pipelineLayout.isValid()) {
-        VulkanPipelineLayout *vulkanPipelineLayout = vulkanResourceManager->getPipelineLayout(pipelineLayout);
-        if (vulkanPipelineLayout != nullptr)
-            vkPipelineLayout = vulkanPipelineLayout->pipelineLayout;
-    } else if (pipeline.isValid()) {
-        VulkanComputePipeline *vulkanPipeline = vulkanResourceManager->getComputePipeline(pipeline);
-        if (vulkanPipeline != nullptr) {
-            VulkanPipelineLayout *vulkanPipelineLayout = vulkanResourceManager->getPipelineLayout(vulkanPipeline->pipelineLayoutHandle);
-            if (vulkanPipelineLayout != nullptr)
-                vkPipelineLayout = vulkanPipelineLayout->pipelineLayout;
-        }
-    }
+    if (VulkanPipelineLayout *vulkanPipelineLayout = vulkanResourceManager->getPipelineLayout(pipelineLayoutHandle); vulkanPipelineLayout != nullptr)
+        vkPipelineLayout = vulkanPipelineLayout->pipelineLayout;
 
     assert(vkPipelineLayout != VK_NULL_HANDLE); // The PipelineLayout should outlive the pipelines
 
@@ -104,8 +102,10 @@ void VulkanComputePassCommandRecorder::pushConstant(const PushConstantRange &con
 
 void VulkanComputePassCommandRecorder::pushBindGroup(uint32_t group,
                                                      std::span<const BindGroupEntry> bindGroupEntries,
-                                                     const Handle<PipelineLayout_t> &pipelineLayout) const
+                                                     const Handle<PipelineLayout_t> &pipelineLayout)
 {
+    bindState.forgetBindGroups();
+
 #if VK_KHR_push_descriptor
     VulkanDevice *device = vulkanResourceManager->getDevice(deviceHandle);
     if (device->vkCmdPushDescriptorSetKHR) {
@@ -151,4 +151,9 @@ void VulkanComputePassCommandRecorder::end() const
     // No op
 }
 
+BindStateStats VulkanComputePassCommandRecorder::bindStateStats() const
+{
+    return bindState.stats();
+}
+
 } // namespace KDGpu
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <KDGpu/bind_group.h>
+#include <KDGpu/bind_state_tracker.h>
 #include <KDGpu/compute_pass_command_recorder.h>
 #include <KDGpu/handle.h>
 #include <KDGpu/kdgpu_export.h>
@@ -38,7 +39,7 @@ struct KDGPU_EXPORT VulkanComputePassCommandRecorder {
     void setPipeline(const Handle<ComputePipeline_t> &pipeline);
     void setBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroup,
                       const Handle<PipelineLayout_t> &pipelineLayout,
-                      std::span<const uint32_t> dynamicBufferOffsets) const;
+                      std::span<const uint32_t> dynamicBufferOffsets);
     void dispatchCompute(const ComputeCommand &command) const;
     void dispatchCompute(std::span<const ComputeCommand> commands) const;
     void dispatchComputeIndirect(const ComputeCommandIndirect &command) const;
@@ -46,14 +47,16 @@ struct KDGPU_EXPORT VulkanComputePassCommandRecorder {
     void pushConstant(const PushConstantRange &constantRange, const void *data) const;
     void pushBindGroup(uint32_t group,
                        std::span<const BindGroupEntry> bindGroupEntries,
-                       const Handle<PipelineLayout_t> &pipelineLayout) const;
+                       const Handle<PipelineLayout_t> &pipelineLayout);
     void end() const;
+    BindStateStats bindStateStats() const;
 
     // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
     VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
     VulkanResourceManager *vulkanResourceManager{ nullptr };
     Handle<Device_t> deviceHandle;
     Handle<ComputePipeline_t> pipeline;
+    BindStateTracker<ComputePipeline_t> bindState;
     // NOLINTEND(misc-non-private-member-variables-in-classes)
 };
 
@@ -112,6 +112,9 @@ std::vector<const char *> getDefaultRequestedDeviceExtensions()
 #if VK_EXT_external_memory_dma_buf
         VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME,
 #endif
+#if VK_EXT_external_memory_host
+        VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
+#endif
 #if VK_KHR_deferred_host_operations
         VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
 #endif
@@ -46,12 +46,9 @@ VulkanDevice::VulkanDevice(VkDevice _device,
     // Create an allocator for the device
     allocator = createMemoryAllocator();
 
-    // Resize the vector of command pools to have one for each queue family
+    // Resize the vector of command pools to have one set of per thread pools for each queue family
     const auto queueTypes = vulkanAdapter->queryQueueTypes();
-    const auto queueTypeCount = queueTypes.size();
-    commandPools.resize(queueTypeCount);
-    for (uint32_t i = 0; i < queueTypeCount; ++i)
-        commandPools[i] = VK_NULL_HANDLE;
+    commandPools.resize(queueTypes.size());
 
 #if VK_EXT_debug_utils
     const auto instanceExtensions = vulkanInstance->extensions();
@@ -186,6 +183,22 @@ VulkanDevice::VulkanDevice(VkDevice _device,
                 this->vkCopyImageToImage = (PFN_vkCopyImageToImageEXT)vkGetDeviceProcAddr(device, "vkCopyImageToImageEXT");
             }
         }
+        if (requestedFeatures.hostImageCopy && this->vkCopyMemoryToImage != nullptr)
+            hostImageCopyDstLayouts = vulkanAdapter->queryAdapterProperties().hostImageCopyProperties.dstCopyLayouts;
+    }
+#endif
+
+#if VK_EXT_external_memory_host
+    {
+        const auto adapterExtensions = vulkanAdapter->extensions();
+        for (const auto &extension : adapterExtensions) {
+            if (extension.name == VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME) {
+                this->vkGetMemoryHostPointerPropertiesEXT = (PFN_vkGetMemoryHostPointerPropertiesEXT)vkGetDeviceProcAddr(device, "vkGetMemoryHostPointerPropertiesEXT");
+            }
+        }
+        // Devices created from an existing VkDevice might not have enabled the extension
+        if (isOwned && this->vkGetMemoryHostPointerPropertiesEXT != nullptr)
+            minImportedHostPointerAlignment = vulkanAdapter->queryAdapterProperties().externalMemoryHostProperties.minImportedHostPointerAlignment;
     }
 #endif
 
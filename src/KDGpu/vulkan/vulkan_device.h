@@ -12,6 +12,7 @@
 
 #include <span>
 #include <KDGpu/vulkan/vulkan_framebuffer.h>
+#include <KDGpu/vulkan/vulkan_lru_cache.h>
 #include <KDGpu/vulkan/vulkan_render_pass.h>
 
 #include <KDGpu/handle.h>
@@ -21,12 +22,20 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include <KDGpu/adapter_features.h>
 #include <KDGpu/adapter_queue_type.h>
+#include <KDGpu/bind_group_layout_options.h>
+#include <KDGpu/compute_pipeline_options.h>
 #include <KDGpu/device_options.h>
+#include <KDGpu/graphics_pipeline_options.h>
+#include <KDGpu/pipeline_deduplication_cache.h>
 #include <KDGpu/queue_description.h>
+#include <KDGpu/raytracing_pipeline_options.h>
+#include <KDGpu/sampler_options.h>
+#include <KDGpu/shader_module_deduplication_cache.h>
 
 #if defined(KDGPU_PLATFORM_WIN32)
 struct VkSemaphoreGetWin32HandleInfoKHR;
@@ -48,6 +57,19 @@ struct WriteBindGroupData {
     VkWriteDescriptorSet descriptorWrite{};
 };
 
+// Command pools must be externally synchronized, so every thread recording
+// commands for a queue family allocates from a pool of its own
+struct VulkanThreadCommandPool {
+    VkCommandPool commandPool{ VK_NULL_HANDLE };
+    std::thread::id thread;
+    // Command buffers allocated from the pool and not deleted yet. A pool without any
+    // is not used by its thread, which might have exited, and can be reclaimed
+    uint32_t liveCommandBuffers{ 0 };
+    // Command buffers deleted from another thread, freed by the owning thread
+    // the next time it allocates from this pool
+    std::vector<VkCommandBuffer> pendingFrees;
+};
+
 /**
  * @brief VulkanDevice
  * \ingroup vulkan
@@ -83,6 +105,10 @@ struct KDGPU_EXPORT VulkanDevice {
     VkDevice device{ VK_NULL_HANDLE };
     uint32_t apiVersion{};
     AdapterFeatures requestedFeatures{};
+    // Layouts host image copies can write to, empty when they are not enabled
+    std::vector<TextureLayout> hostImageCopyDstLayouts;
+    // Alignment of host pointers imported into buffers, 0 when importing is unsupported
+    DeviceSize minImportedHostPointerAlignment{ 0 };
 
     VulkanResourceManager *vulkanResourceManager{ nullptr };
     Handle<Adapter_t> adapterHandle;
@@ -93,10 +119,27 @@ struct KDGPU_EXPORT VulkanDevice {
     };
     std::vector<MemoryHandleTypeAndAllocator> externalAllocators;
     std::vector<QueueDescription> queueDescriptions;
-    std::vector<VkCommandPool> commandPools; // Indexed by queue type (family)
+    std::vector<std::unordered_map<std::thread::id, VulkanThreadCommandPool>> commandPools; // Indexed by queue type (family), then by recording thread
     std::vector<Handle<BindGroupPool_t>> descriptorSetPools;
-    std::unordered_map<VulkanRenderPassKey, Handle<RenderPass_t>> renderPasses;
-    std::unordered_map<VulkanFramebufferKey, Handle<Framebuffer_t>> framebuffers;
+    // Render passes and framebuffers created when beginning a render pass from
+    // RenderPassCommandRecorderOptions, bounded by DeviceOptions::renderTargetCache
+    VulkanLruCache<VulkanRenderPassKey, RenderPass_t> renderPasses;
+    VulkanLruCache<VulkanFramebufferKey, Framebuffer_t> framebuffers;
+    // Reverse index of framebuffers by attachment, so that deleting a texture view
+    // only visits the framebuffers it is attached to
+    std::unordered_multimap<Handle<TextureView_t>, VulkanFramebufferKey> framebufferKeysByAttachment;
+    // Index of framebuffers by render pass, so that evicting a render pass also evicts
+    // the framebuffers created for it, which can no longer be found either
+    std::unordered_multimap<Handle<RenderPass_t>, VulkanFramebufferKey> framebufferKeysByRenderPass;
+    // Pipelines shared through Device::getOrCreate*Pipeline()
+    PipelineDeduplicationCache<GraphicsPipelineOptions, GraphicsPipeline_t> graphicsPipelineCache;
+    PipelineDeduplicationCache<ComputePipelineOptions, ComputePipeline_t> computePipelineCache;
+    PipelineDeduplicationCache<RayTracingPipelineOptions, RayTracingPipeline_t> rayTracingPipelineCache;
+    // Shader modules shared between identical SPIR-V passed to Device::createShaderModule()
+    ShaderModuleDeduplicationCache shaderModuleCache;
+    // Samplers and bind group layouts shared between identical options
+    DeduplicationCache<SamplerOptions, Sampler_t> samplerCache;
+    DeduplicationCache<BindGroupLayoutOptions, BindGroupLayout_t> bindGroupLayoutCache;
     VkQueryPool timestampQueryPool{ VK_NULL_HANDLE };
 
 #if VK_EXT_debug_utils
@@ -149,6 +192,10 @@ struct KDGPU_EXPORT VulkanDevice {
     PFN_vkCopyImageToImageEXT vkCopyImageToImage{ nullptr };
 #endif
 
+#if VK_EXT_external_memory_host
+    PFN_vkGetMemoryHostPointerPropertiesEXT vkGetMemoryHostPointerPropertiesEXT{ nullptr };
+#endif
+
 #if VK_EXT_mesh_shader
     PFN_vkCmdDrawMeshTasksEXT vkCmdDrawMeshTasksEXT{ nullptr };
     PFN_vkCmdDrawMeshTasksIndirectEXT vkCmdDrawMeshTasksIndirectEXT{ nullptr };
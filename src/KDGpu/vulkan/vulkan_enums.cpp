@@ -48,6 +48,34 @@ VkFormat formatToVkFormat(Format format)
     return static_cast<VkFormat>(static_cast<uint32_t>(format));
 }
 
+bool hasDepthFormat(Format format)
+{
+    switch (format) {
+    case Format::D16_UNORM:
+    case Format::X8_D24_UNORM_PACK32:
+    case Format::D32_SFLOAT:
+    case Format::D16_UNORM_S8_UINT:
+    case Format::D24_UNORM_S8_UINT:
+    case Format::D32_SFLOAT_S8_UINT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool hasStencilFormat(Format format)
+{
+    switch (format) {
+    case Format::S8_UINT:
+    case Format::D16_UNORM_S8_UINT:
+    case Format::D24_UNORM_S8_UINT:
+    case Format::D32_SFLOAT_S8_UINT:
+        return true;
+    default:
+        return false;
+    }
+}
+
 VkSampleCountFlagBits sampleCountFlagBitsToVkSampleFlagBits(SampleCountFlagBits samples)
 {
     return static_cast<VkSampleCountFlagBits>(static_cast<uint32_t>(samples));
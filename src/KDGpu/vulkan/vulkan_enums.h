@@ -22,6 +22,8 @@ AdapterDeviceType vkPhysicalDeviceTypeToAdapterDeviceType(VkPhysicalDeviceType d
 
 KDGPU_EXPORT Format vkFormatToFormat(VkFormat format);
 VkFormat formatToVkFormat(Format format);
+bool hasDepthFormat(Format format);
+bool hasStencilFormat(Format format);
 
 VkSampleCountFlagBits sampleCountFlagBitsToVkSampleFlagBits(SampleCountFlagBits samples);
 SampleCountFlagBits vkSampleCountFlagBitsToSampleFlagBits(VkSampleCountFlagBits samples);
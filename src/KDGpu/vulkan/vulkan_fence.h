@@ -37,6 +37,8 @@ struct KDGPU_EXPORT VulkanFence {
     VulkanResourceManager *vulkanResourceManager{ nullptr };
     Handle<Device_t> deviceHandle;
     HandleOrFD m_externalFenceHandle{};
+    // Queue submissions and presentations made to signal the fence so far
+    uint64_t submissionCount{ 0 };
 
     void wait();
     void reset();
@@ -0,0 +1,84 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "vulkan_frame_command_allocator.h"
+
+#include <KDGpu/vulkan/vulkan_resource_manager.h>
+#include <KDGpu/vulkan/vulkan_formatters.h>
+
+namespace KDGpu {
+
+VulkanFrameCommandAllocator::VulkanFrameCommandAllocator(std::vector<Frame> &&_frames,
+                                                         uint32_t _queueTypeIndex,
+                                                         VulkanResourceManager *_vulkanResourceManager,
+                                                         const Handle<Device_t> &_deviceHandle)
+    : frames(std::move(_frames))
+    , queueTypeIndex(_queueTypeIndex)
+    , vulkanResourceManager(_vulkanResourceManager)
+    , deviceHandle(_deviceHandle)
+{
+}
+
+void VulkanFrameCommandAllocator::beginFrame(uint32_t frameIndex, const Handle<Fence_t> &frameFence)
+{
+    if (frameIndex >= frames.size()) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Frame index {} is out of range, the allocator has {} frames", frameIndex, frames.size());
+        return;
+    }
+
+    if (frameFence.isValid()) {
+        VulkanFence *vulkanFence = vulkanResourceManager->getFence(frameFence);
+        assert(vulkanFence != nullptr);
+        vulkanFence->wait();
+    }
+
+    VulkanDevice *vulkanDevice = vulkanResourceManager->getDevice(deviceHandle);
+    Frame &frame = frames[frameIndex];
+    vulkanResourceManager->releaseCommandBufferResources(deviceHandle,
+                                                         frame.temporaryBuffersToRelease,
+                                                         frame.cachedRenderPassesInUse,
+                                                         frame.cachedFramebuffersInUse);
+    if (auto result = vkResetCommandPool(vulkanDevice->device, frame.commandPool, 0); result != VK_SUCCESS) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Error when resetting command pool: {}", result);
+        return;
+    }
+    frame.nextCommandBuffer[VK_COMMAND_BUFFER_LEVEL_PRIMARY] = 0;
+    frame.nextCommandBuffer[VK_COMMAND_BUFFER_LEVEL_SECONDARY] = 0;
+    currentFrame = frameIndex;
+}
+
+VkCommandBuffer VulkanFrameCommandAllocator::acquireCommandBuffer(VkCommandBufferLevel level)
+{
+    Frame &frame = frames[currentFrame];
+    std::vector<VkCommandBuffer> &commandBuffers = frame.commandBuffers[level];
+    size_t &nextCommandBuffer = frame.nextCommandBuffer[level];
+
+    // Reuse the command buffers reset along with the pool first
+    if (nextCommandBuffer < commandBuffers.size())
+        return commandBuffers[nextCommandBuffer++];
+
+    VulkanDevice *vulkanDevice = vulkanResourceManager->getDevice(deviceHandle);
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = frame.commandPool;
+    allocInfo.level = level;
+    allocInfo.commandBufferCount = 1U;
+
+    VkCommandBuffer vkCommandBuffer{ VK_NULL_HANDLE };
+    if (auto result = vkAllocateCommandBuffers(vulkanDevice->device, &allocInfo, &vkCommandBuffer); result != VK_SUCCESS) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Error when allocating command buffers: {}", result);
+        return VK_NULL_HANDLE;
+    }
+    commandBuffers.push_back(vkCommandBuffer);
+    ++nextCommandBuffer;
+    return vkCommandBuffer;
+}
+
+} // namespace KDGpu
@@ -0,0 +1,67 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/handle.h>
+#include <KDGpu/kdgpu_export.h>
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+namespace KDGpu {
+
+class VulkanResourceManager;
+struct Buffer_t;
+struct Device_t;
+struct Fence_t;
+struct Framebuffer_t;
+struct RenderPass_t;
+
+/**
+ * @brief VulkanFrameCommandAllocator
+ * \ingroup vulkan
+ *
+ * Holds one command pool per frame in flight. Command buffers allocated from
+ * a frame's pool are kept when the CommandBuffer using them is destroyed, and
+ * are handed out again after beginFrame() reset the pool. The GPU may still execute
+ * them at that point, so the resources recorded into them are only released by
+ * beginFrame() as well.
+ */
+struct KDGPU_EXPORT VulkanFrameCommandAllocator {
+    struct Frame {
+        VkCommandPool commandPool{ VK_NULL_HANDLE };
+        // Indexed by VkCommandBufferLevel
+        std::vector<VkCommandBuffer> commandBuffers[2];
+        size_t nextCommandBuffer[2]{ 0, 0 };
+        // Handed over by the command buffers of the frame that were destroyed
+        std::vector<Handle<Buffer_t>> temporaryBuffersToRelease;
+        std::vector<Handle<RenderPass_t>> cachedRenderPassesInUse;
+        std::vector<Handle<Framebuffer_t>> cachedFramebuffersInUse;
+    };
+
+    explicit VulkanFrameCommandAllocator(std::vector<Frame> &&_frames,
+                                         uint32_t _queueTypeIndex,
+                                         VulkanResourceManager *_vulkanResourceManager,
+                                         const Handle<Device_t> &_deviceHandle);
+
+    void beginFrame(uint32_t frameIndex, const Handle<Fence_t> &frameFence);
+    // Returns a command buffer of the current frame that is ready to begin recording
+    VkCommandBuffer acquireCommandBuffer(VkCommandBufferLevel level);
+
+    std::vector<Frame> frames;
+    uint32_t currentFrame{ 0 };
+    uint32_t queueTypeIndex{ 0 };
+    VulkanResourceManager *vulkanResourceManager{ nullptr };
+    Handle<Device_t> deviceHandle;
+};
+
+} // namespace KDGpu
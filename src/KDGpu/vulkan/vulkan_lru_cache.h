@@ -0,0 +1,181 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpu/handle.h>
+#include <KDGpu/render_target_cache.h>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace KDGpu {
+
+/**
+ * @brief VulkanLruCache
+ * \ingroup vulkan
+ * @internal
+ *
+ * Maps keys to handles of objects created on demand, evicting the least
+ * recently used entries once it holds more than its capacity (0 meaning
+ * unbounded). Command buffers recording with an object take a use on it; an
+ * evicted object is only handed back for destruction once it has no uses left.
+ *
+ * The cache does not destroy anything itself, callers pass a function taking
+ * the handle and key of each object to destroy.
+ */
+template<typename Key, typename T>
+class VulkanLruCache
+{
+public:
+    void setCapacity(uint32_t capacity) noexcept { m_capacity = capacity; }
+    uint32_t capacity() const noexcept { return m_capacity; }
+
+    // Returns the handle for key and marks it as most recently used,
+    // or an invalid handle if there is none
+    Handle<T> find(const Key &key)
+    {
+        const auto it = m_handlesByKey.find(key);
+        if (it == m_handlesByKey.end()) {
+            ++m_stats.misses;
+            return {};
+        }
+        ++m_stats.hits;
+        Entry &entry = m_entries.at(it->second);
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+        return it->second;
+    }
+
+    // Adds a newly created object as the most recently used one, then evicts
+    // entries over capacity. The new entry itself is never evicted. evicted is
+    // called with the handle and key of every entry that can no longer be found,
+    // destroy with those among them that no command buffer uses.
+    template<typename EvictFn, typename DestroyFn>
+    void insert(const Key &key, const Handle<T> &handle, EvictFn &&evicted, DestroyFn &&destroy)
+    {
+        m_lru.push_front(handle);
+        m_entries.emplace(handle, Entry{ .key = key, .lruPosition = m_lru.begin() });
+        m_handlesByKey.emplace(key, handle);
+
+        while (m_capacity > 0 && m_handlesByKey.size() > m_capacity) {
+            const Handle<T> evictedHandle = m_lru.back();
+            m_lru.pop_back();
+            ++m_stats.evictions;
+
+            auto entryIt = m_entries.find(evictedHandle);
+            m_handlesByKey.erase(entryIt->second.key);
+            evicted(evictedHandle, entryIt->second.key);
+            if (entryIt->second.uses > 0) {
+                entryIt->second.evicted = true;
+                continue;
+            }
+            const Key evictedKey = std::move(entryIt->second.key);
+            m_entries.erase(entryIt);
+            destroy(evictedHandle, evictedKey);
+        }
+    }
+
+    // Records that a command buffer uses the object
+    void use(const Handle<T> &handle)
+    {
+        if (auto it = m_entries.find(handle); it != m_entries.end())
+            ++it->second.uses;
+    }
+
+    // Drops a use taken with use(). Destroys the object if it was evicted
+    // and this was its last use.
+    template<typename DestroyFn>
+    void release(const Handle<T> &handle, DestroyFn &&destroy)
+    {
+        auto it = m_entries.find(handle);
+        if (it == m_entries.end() || --it->second.uses > 0 || !it->second.evicted)
+            return;
+        const Key key = std::move(it->second.key);
+        m_entries.erase(it);
+        destroy(handle, key);
+    }
+
+    // Evicts the entry for key ahead of its turn, e.g. once it can no longer be
+    // found. Like insert(), only destroys it if no command buffer uses it.
+    template<typename DestroyFn>
+    void evict(const Key &key, DestroyFn &&destroy)
+    {
+        const auto it = m_handlesByKey.find(key);
+        if (it == m_handlesByKey.end())
+            return;
+        const Handle<T> handle = it->second;
+        m_handlesByKey.erase(it);
+        ++m_stats.evictions;
+
+        auto entryIt = m_entries.find(handle);
+        m_lru.erase(entryIt->second.lruPosition);
+        if (entryIt->second.uses > 0) {
+            entryIt->second.evicted = true;
+            return;
+        }
+        const Key evictedKey = std::move(entryIt->second.key);
+        m_entries.erase(entryIt);
+        destroy(handle, evictedKey);
+    }
+
+    // Removes the entry for key right away, regardless of its uses.
+    // Returns the handle the caller should destroy, if any.
+    Handle<T> take(const Key &key)
+    {
+        const auto it = m_handlesByKey.find(key);
+        if (it == m_handlesByKey.end())
+            return {};
+        const Handle<T> handle = it->second;
+        m_handlesByKey.erase(it);
+        auto entryIt = m_entries.find(handle);
+        m_lru.erase(entryIt->second.lruPosition);
+        m_entries.erase(entryIt);
+        return handle;
+    }
+
+    // Removes all entries, including evicted ones still in use
+    template<typename DestroyFn>
+    void clear(DestroyFn &&destroy)
+    {
+        for (const auto &[handle, entry] : m_entries)
+            destroy(handle, entry.key);
+        m_entries.clear();
+        m_handlesByKey.clear();
+        m_lru.clear();
+    }
+
+    // Number of entries that can be found, evicted entries excluded
+    size_t size() const noexcept { return m_handlesByKey.size(); }
+    bool empty() const noexcept { return m_handlesByKey.empty(); }
+
+    RenderTargetCacheStats stats() const
+    {
+        RenderTargetCacheStats stats = m_stats;
+        stats.liveObjects = m_entries.size();
+        return stats;
+    }
+
+private:
+    struct Entry {
+        Key key;
+        typename std::list<Handle<T>>::iterator lruPosition;
+        uint32_t uses{ 0 };
+        bool evicted{ false };
+    };
+
+    uint32_t m_capacity{ 0 };
+    std::unordered_map<Handle<T>, Entry> m_entries;
+    std::unordered_map<Key, Handle<T>> m_handlesByKey;
+    std::list<Handle<T>> m_lru; // Most recently used first, evicted entries excluded
+    RenderTargetCacheStats m_stats;
+};
+
+} // namespace KDGpu
@@ -26,6 +26,7 @@ VulkanPipelineCache::VulkanPipelineCache(VkPipelineCache _pipelineCache,
 std::vector<uint8_t> VulkanPipelineCache::getData() const
 {
     VulkanDevice *vulkanDevice = vulkanResourceManager->getDevice(deviceHandle);
+    std::shared_lock lock(*mutex);
 
     size_t dataSize = 0;
     if (auto result = vkGetPipelineCacheData(vulkanDevice->device, pipelineCache, &dataSize, nullptr); result != VK_SUCCESS) {
@@ -60,6 +61,7 @@ bool VulkanPipelineCache::merge(const std::vector<RequiredHandle<PipelineCache_t
         srcCaches.push_back(srcCache->pipelineCache);
     }
 
+    std::unique_lock lock(*mutex);
     const VkResult result = vkMergePipelineCaches(vulkanDevice->device, pipelineCache,
                                                   static_cast<uint32_t>(srcCaches.size()), srcCaches.data());
     if (result != VK_SUCCESS) {
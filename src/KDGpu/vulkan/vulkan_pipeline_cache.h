@@ -14,6 +14,10 @@
 #include <KDGpu/kdgpu_export.h>
 #include <vulkan/vulkan.h>
 
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
 namespace KDGpu {
 
 class VulkanResourceManager;
@@ -35,6 +39,10 @@ struct KDGPU_EXPORT VulkanPipelineCache {
     VulkanResourceManager *vulkanResourceManager{ nullptr };
     Handle<Device_t> deviceHandle;
 
+    // Pipeline creation shares the cache, merging into it needs exclusive
+    // access as the destination of vkMergePipelineCaches is externally synchronized
+    std::unique_ptr<std::shared_mutex> mutex{ std::make_unique<std::shared_mutex>() };
+
     std::vector<uint8_t> getData() const;
     bool merge(const std::vector<RequiredHandle<PipelineCache_t>> &srcHandles) const;
 };
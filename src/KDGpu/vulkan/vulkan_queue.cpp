@@ -129,6 +129,8 @@ void VulkanQueue::submit(const SubmitOptions &options)
     const VkResult result = vkQueueSubmit(queue, 1, &submitInfo, vkFenceToSignal);
     if (result != VK_SUCCESS) {
         SPDLOG_LOGGER_ERROR(Logger::logger(), "Queue Submission failed {}", result);
+    } else if (vulkanFence) {
+        ++vulkanFence->submissionCount;
     }
 }
 
@@ -207,6 +209,7 @@ PresentResult VulkanQueue::present(const PresentOptions &options)
             VulkanFence *vulkanFence = vulkanResourceManager->getFence(fenceHandle);
             if (vulkanFence != nullptr) {
                 presentVkFencesToSignal[lastFenceIndex++] = vulkanFence->fence;
+                ++vulkanFence->submissionCount;
             }
         }
         presentFenceInfo.pFences = presentVkFencesToSignal.data();
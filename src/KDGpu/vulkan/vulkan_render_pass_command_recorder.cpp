@@ -33,9 +33,13 @@ VulkanRenderPassCommandRecorder::VulkanRenderPassCommandRecorder(VkCommandBuffer
 
 void VulkanRenderPassCommandRecorder::setPipeline(const Handle<GraphicsPipeline_t> &_pipeline)
 {
+    if (!bindState.bindPipeline(_pipeline))
+        return;
+
     pipeline = _pipeline;
     VulkanGraphicsPipeline *vulkanGraphicsPipeline = vulkanResourceManager->getGraphicsPipeline(pipeline);
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vulkanGraphicsPipeline->pipeline);
+    bindState.setPipelineLayout(vulkanGraphicsPipeline->pipelineLayoutHandle);
 
     if (!firstPipelineWasSet) {
         // Set the initial viewport and scissor rect to the full extent of the render area
@@ -54,8 +58,11 @@ void VulkanRenderPassCommandRecorder::setPipeline(const Handle<GraphicsPipeline_
     }
 }
 
-void VulkanRenderPassCommandRecorder::setVertexBuffer(uint32_t index, const Handle<Buffer_t> &buffer, DeviceSize offset) const
+void VulkanRenderPassCommandRecorder::setVertexBuffer(uint32_t index, const Handle<Buffer_t> &buffer, DeviceSize offset)
 {
+    if (!bindState.bindVertexBuffer(index, buffer, offset))
+        return;
+
     VulkanBuffer *vulkanBuffer = vulkanResourceManager->getBuffer(buffer);
     const std::array<VkBuffer, 1> buffers = { vulkanBuffer->buffer };
     const std::array<VkDeviceSize, 1> offsets = { offset };
@@ -63,34 +70,31 @@ void VulkanRenderPassCommandRecorder::setVertexBuffer(uint32_t index, const Hand
     vkCmdBindVertexBuffers(commandBuffer, index, 1, buffers.data(), offsets.data());
 }
 
-void VulkanRenderPassCommandRecorder::setIndexBuffer(const Handle<Buffer_t> &buffer, DeviceSize offset, IndexType indexType) const
+void VulkanRenderPassCommandRecorder::setIndexBuffer(const Handle<Buffer_t> &buffer, DeviceSize offset, IndexType indexType)
 {
+    if (!bindState.bindIndexBuffer(buffer, offset, indexType))
+        return;
+
     VulkanBuffer *vulkanBuffer = vulkanResourceManager->getBuffer(buffer);
     vkCmdBindIndexBuffer(commandBuffer, vulkanBuffer->buffer, offset, indexTypeToVkIndexType(indexType));
 }
 
 void VulkanRenderPassCommandRecorder::setBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroupH,
                                                    const Handle<PipelineLayout_t> &pipelineLayout,
-                                                   std::span<const uint32_t> dynamicBufferOffsets) const
+                                                   std::span<const uint32_t> dynamicBufferOffsets)
 {
+    // Use the pipeline layout provided, otherwise fallback to the one from the currently
+    // bound pipeline (if any).
+    const Handle<PipelineLayout_t> &pipelineLayoutHandle = pipelineLayout.isValid() ? pipelineLayout : bindState.pipelineLayout();
+    if (!bindState.bindBindGroup(group, bindGroupH, pipelineLayoutHandle, dynamicBufferOffsets))
+        return;
+
     VulkanBindGroup *bindGroup = vulkanResourceManager->getBindGroup(bindGroupH);
     VkDescriptorSet set = bindGroup->descriptorSet;
 
-    // Use the pipeline layout provided, otherwise fallback to the one from the currently
-    // bound pipeline (if any).
     VkPipelineLayout vkPipelineLayout{ VK_NULL_HANDLE };
-    if (pipelineLayout.isValid()) {
-        VulkanPipelineLayout *vulkanPipelineLayout = vulkanResourceManager->getPipelineLayout(pipelineLayout);
-        if (vulkanPipelineLayout)
-            vkPipelineLayout = vulkanPipelineLayout->pipelineLayout;
-    } else if (pipeline.isValid()) {
-        VulkanGraphicsPipeline *vulkanPipeline = vulkanResourceManager->getGraphicsPipeline(pipeline);
-        if (vulkanPipeline) {
-            VulkanPipelineLayout *vulkanPipelineLayout = vulkanResourceManager->getPipelineLayout(vulkanPipeline->pipelineLayoutHandle);
-            if (vulkanPipelineLayout)
-                vkPipelineLayout = vulkanPipelineLayout->pipelineLayout;
-        }
-    }
+    if (VulkanPipelineLayout *vulkanPipelineLayout = vulkanResourceManager->getPipelineLayout(pipelineLayoutHandle))
+        vkPipelineLayout = vulkanPipelineLayout->pipelineLayout;
 
     assert(vkPipelineLayout != VK_NULL_HANDLE); // The PipelineLayout should outlive the pipelines
 
@@ -263,8 +267,10 @@ void VulkanRenderPassCommandRecorder::pushConstant(const PushConstantRange &cons
 
 void VulkanRenderPassCommandRecorder::pushBindGroup(uint32_t group,
                                                     std::span<const BindGroupEntry> bindGroupEntries,
-                                                    const Handle<PipelineLayout_t> &pipelineLayout) const
+                                                    const Handle<PipelineLayout_t> &pipelineLayout)
 {
+    bindState.forgetBindGroups();
+
 #if VK_KHR_push_descriptor
     VulkanDevice *device = vulkanResourceManager->getDevice(deviceHandle);
     if (device->vkCmdPushDescriptorSetKHR) {
@@ -367,8 +373,17 @@ void VulkanRenderPassCommandRecorder::setInputAttachmentMapping(std::span<const
 #endif
 }
 
+BindStateStats VulkanRenderPassCommandRecorder::bindStateStats() const
+{
+    return bindState.stats();
+}
+
 void VulkanRenderPassCommandRecorder::end() const
 {
+    // The primary command buffer ends the render pass it executes us in
+    if (inheritedRenderPass)
+        return;
+
     if (dynamicRendering) {
 #if VK_KHR_dynamic_rendering
         VulkanDevice *device = vulkanResourceManager->getDevice(deviceHandle);
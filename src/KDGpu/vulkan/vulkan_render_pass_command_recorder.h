@@ -11,6 +11,7 @@
 #pragma once
 
 #include <KDGpu/bind_group.h>
+#include <KDGpu/bind_state_tracker.h>
 #include <KDGpu/buffer.h>
 #include <KDGpu/graphics_pipeline.h>
 #include <KDGpu/kdgpu_export.h>
@@ -39,10 +40,10 @@ struct KDGPU_EXPORT VulkanRenderPassCommandRecorder {
                                              bool _dynamicRendering);
 
     void setPipeline(const Handle<GraphicsPipeline_t> &pipeline);
-    void setVertexBuffer(uint32_t index, const Handle<Buffer_t> &buffer, DeviceSize offset) const;
-    void setIndexBuffer(const Handle<Buffer_t> &buffer, DeviceSize offset, IndexType indexType) const;
+    void setVertexBuffer(uint32_t index, const Handle<Buffer_t> &buffer, DeviceSize offset);
+    void setIndexBuffer(const Handle<Buffer_t> &buffer, DeviceSize offset, IndexType indexType);
     void setBindGroup(uint32_t group, const Handle<BindGroup_t> &bindGroup,
-                      const Handle<PipelineLayout_t> &pipelineLayout, std::span<const uint32_t> dynamicBufferOffsets) const;
+                      const Handle<PipelineLayout_t> &pipelineLayout, std::span<const uint32_t> dynamicBufferOffsets);
     void setViewport(const Viewport &viewport) const;
     void setScissor(const Rect2D &scissor) const;
     void setStencilReference(StencilFaceFlags faceMask, int reference) const;
@@ -59,13 +60,14 @@ struct KDGPU_EXPORT VulkanRenderPassCommandRecorder {
     void drawMeshTasksIndirect(const DrawMeshIndirectCommand &drawCommand) const;
     void drawMeshTasksIndirect(std::span<const DrawMeshIndirectCommand> drawCommands) const;
     void pushConstant(const PushConstantRange &constantRange, const void *data, const Handle<PipelineLayout_t> &pipelineLayout = {}) const;
-    void pushBindGroup(uint32_t group, std::span<const BindGroupEntry> bindGroupEntries, const Handle<PipelineLayout_t> &pipelineLayout = {}) const;
+    void pushBindGroup(uint32_t group, std::span<const BindGroupEntry> bindGroupEntries, const Handle<PipelineLayout_t> &pipelineLayout = {});
     void nextSubpass() const;
     void setInputAttachmentMapping(std::span<const std::optional<uint32_t>> colorAttachmentIndices,
                                    std::optional<uint32_t> depthAttachmentIndex,
                                    std::optional<uint32_t> stencilAttachmentIndex) const;
     void setOutputAttachmentMapping(std::span<const std::optional<uint32_t>> remappedOutputs) const;
     void end() const;
+    BindStateStats bindStateStats() const;
 
     // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
     VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
@@ -74,7 +76,10 @@ struct KDGPU_EXPORT VulkanRenderPassCommandRecorder {
     Handle<Device_t> deviceHandle;
     Handle<GraphicsPipeline_t> pipeline;
     bool firstPipelineWasSet{ false };
+    BindStateTracker<GraphicsPipeline_t> bindState;
     bool dynamicRendering{ false };
+    // Records into a secondary command buffer within a render pass begun by the primary one
+    bool inheritedRenderPass{ false };
     // NOLINTEND(misc-non-private-member-variables-in-classes)
 };
 
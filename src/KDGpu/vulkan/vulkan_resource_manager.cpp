@@ -80,19 +80,6 @@ VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
     return VK_FALSE;
 }
 
-bool hasStencilFormat(KDGpu::Format f)
-{
-    switch (f) {
-    case KDGpu::Format::S8_UINT:
-    case KDGpu::Format::D16_UNORM_S8_UINT:
-    case KDGpu::Format::D24_UNORM_S8_UINT:
-    case KDGpu::Format::D32_SFLOAT_S8_UINT:
-        return true;
-    default:
-        return false;
-    }
-};
-
 bool hasExtension(const std::vector<KDGpu::Extension> &extensions, const std::string_view &name)
 {
     const auto it = std::find_if(extensions.begin(),
@@ -761,6 +748,10 @@ Handle<Device_t> VulkanResourceManager::createDevice(const Handle<Adapter_t> &ad
 
     const auto deviceHandle = m_devices.emplace(vkDevice, apiVersion, this, adapterHandle, options.requestedFeatures);
 
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    vulkanDevice->renderPasses.setCapacity(options.renderTargetCache.maxRenderPasses);
+    vulkanDevice->framebuffers.setCapacity(options.renderTargetCache.maxFramebuffers);
+
     return deviceHandle;
 }
 
@@ -778,21 +769,21 @@ void VulkanResourceManager::deleteDevice(const Handle<Device_t> &handle)
     VulkanDevice *vulkanDevice = m_devices.get(handle);
 
     // Destroy Render Passes
-    for (const auto &[passKey, passHandle] : vulkanDevice->renderPasses) {
-        VulkanRenderPass *pass = m_renderPasses.get(passHandle);
-        vkDestroyRenderPass(vulkanDevice->device, pass->renderPass, nullptr);
-        m_renderPasses.remove(passHandle);
-    }
+    vulkanDevice->renderPasses.clear([this](const Handle<RenderPass_t> &passHandle, const VulkanRenderPassKey &) {
+        deleteRenderPass(passHandle);
+    });
 
     // Framebuffers with TextureViews attachments ought to have all been destroyed
     // since all TextureViews used as attached ought to have been destroyed by now;
     // This means we should only have imageless Framebuffers left
 
     // Destroy imageless FrameBuffers
-    for (const auto &[fbKey, fbHandle] : vulkanDevice->framebuffers) {
+    vulkanDevice->framebuffers.clear([this](const Handle<Framebuffer_t> &fbHandle, const VulkanFramebufferKey &fbKey) {
         assert(fbKey.attachmentsKey.handles.empty());
         deleteFramebuffer(fbHandle);
-    }
+    });
+    vulkanDevice->framebufferKeysByAttachment.clear();
+    vulkanDevice->framebufferKeysByRenderPass.clear();
 
     // Destroy Descriptor Pools
     for (const Handle<BindGroupPool_t> &poolHandle : vulkanDevice->descriptorSetPools) {
@@ -800,9 +791,12 @@ void VulkanResourceManager::deleteDevice(const Handle<Device_t> &handle)
     }
     vulkanDevice->descriptorSetPools.clear();
 
-    // Destroy Command Pool
-    for (VkCommandPool commandPool : vulkanDevice->commandPools)
-        vkDestroyCommandPool(vulkanDevice->device, commandPool, nullptr);
+    // Destroy Command Pools, which also frees the command buffers still pending
+    for (const auto &threadCommandPools : vulkanDevice->commandPools) {
+        for (const auto &[thread, commandPool] : threadCommandPools)
+            vkDestroyCommandPool(vulkanDevice->device, commandPool.commandPool, nullptr);
+    }
+    vulkanDevice->commandPools.clear();
 
     // Destroy Timestamp Query Pool
     if (vulkanDevice->timestampQueryPool != VK_NULL_HANDLE)
@@ -973,6 +967,7 @@ Handle<Texture_t> VulkanResourceManager::createTexture(const Handle<Device_t> &d
         vkExternalMemImageCreateInfo.handleTypes = externalMemoryHandleTypeToVkExternalMemoryHandleType(options.externalMemoryHandleType);
 
         // We have to use a dedicated allocator for external handles that has been created with VkExportMemoryAllocateInfo
+        std::lock_guard lock(m_deviceStateMutex);
         allocator = vulkanDevice->getOrCreateExternalMemoryAllocator(options.externalMemoryHandleType);
 
         allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
@@ -1125,19 +1120,22 @@ void VulkanResourceManager::deleteTextureView(const Handle<TextureView_t> &handl
     VulkanTextureView *vulkanTextureView = m_textureViews.get(handle);
     VulkanDevice *vulkanDevice = m_devices.get(vulkanTextureView->deviceHandle);
 
-    // Iterate over Framebuffers to destroy Framebuffers where texture view was being used as an attachment
-    auto it = vulkanDevice->framebuffers.begin();
-    while (it != vulkanDevice->framebuffers.end()) {
-        const VulkanFramebufferKey &fbKey = it->first;
-        const std::vector<Handle<TextureView_t>> &fbAttachmentHandles = fbKey.attachmentsKey.handles;
-        const bool viewReferencedAsAttachment = std::ranges::find(fbAttachmentHandles, handle) != fbAttachmentHandles.end();
-        if (viewReferencedAsAttachment) {
-            // Destroy Framebuffer
-            deleteFramebuffer(it->second);
-            // Remove Framebuffer entry from the device
-            it = vulkanDevice->framebuffers.erase(it);
-        } else {
-            ++it;
+    // Destroy Framebuffers where texture view was being used as an attachment
+    {
+        std::lock_guard lock(m_renderTargetCacheMutex);
+        std::vector<VulkanFramebufferKey> fbKeys;
+        const auto [begin, end] = vulkanDevice->framebufferKeysByAttachment.equal_range(handle);
+        for (auto it = begin; it != end; ++it)
+            fbKeys.push_back(std::move(it->second));
+        vulkanDevice->framebufferKeysByAttachment.erase(begin, end);
+
+        for (const VulkanFramebufferKey &fbKey : fbKeys) {
+            // Already gone if the view was attached more than once
+            const Handle<Framebuffer_t> fbHandle = vulkanDevice->framebuffers.take(fbKey);
+            if (!fbHandle.isValid())
+                continue;
+            deleteFramebuffer(fbHandle);
+            removeFramebufferIndexKeys(vulkanDevice, fbKey, handle);
         }
     }
 
@@ -1151,10 +1149,56 @@ VulkanTextureView *VulkanResourceManager::getTextureView(const Handle<TextureVie
     return m_textureViews.get(handle);
 }
 
+void VulkanResourceManager::removeFramebufferIndexKeys(VulkanDevice *vulkanDevice,
+                                                            const VulkanFramebufferKey &fbKey,
+                                                            const Handle<TextureView_t> &skippedAttachment)
+{
+    for (const Handle<TextureView_t> &attachment : fbKey.attachmentsKey.handles) {
+        if (attachment == skippedAttachment)
+            continue;
+        const auto [attachmentBegin, attachmentEnd] = vulkanDevice->framebufferKeysByAttachment.equal_range(attachment);
+        const auto entry = std::find_if(attachmentBegin, attachmentEnd, [&fbKey](const auto &keyByAttachment) {
+            return keyByAttachment.second == fbKey;
+        });
+        if (entry != attachmentEnd)
+            vulkanDevice->framebufferKeysByAttachment.erase(entry);
+    }
+
+    const auto [renderPassBegin, renderPassEnd] = vulkanDevice->framebufferKeysByRenderPass.equal_range(fbKey.renderPass);
+    const auto entry = std::find_if(renderPassBegin, renderPassEnd, [&fbKey](const auto &keyByRenderPass) {
+        return keyByRenderPass.second == fbKey;
+    });
+    if (entry != renderPassEnd)
+        vulkanDevice->framebufferKeysByRenderPass.erase(entry);
+}
+
+void VulkanResourceManager::evictRenderPassFramebuffers(VulkanDevice *vulkanDevice, const Handle<RenderPass_t> &renderPass)
+{
+    std::vector<VulkanFramebufferKey> fbKeys;
+    const auto [begin, end] = vulkanDevice->framebufferKeysByRenderPass.equal_range(renderPass);
+    for (auto it = begin; it != end; ++it)
+        fbKeys.push_back(std::move(it->second));
+    vulkanDevice->framebufferKeysByRenderPass.erase(begin, end);
+
+    // Framebuffers still used by command buffers are destroyed with their last use
+    for (const VulkanFramebufferKey &fbKey : fbKeys) {
+        removeFramebufferIndexKeys(vulkanDevice, fbKey);
+        vulkanDevice->framebuffers.evict(fbKey, [this](const Handle<Framebuffer_t> &evictedHandle, const VulkanFramebufferKey &) {
+            deleteFramebuffer(evictedHandle);
+        });
+    }
+}
+
 Handle<Buffer_t> VulkanResourceManager::createBuffer(const Handle<Device_t> &deviceHandle, const BufferOptions &options, const void *initialData)
 {
     VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
 
+    if (options.hostPointer != nullptr) {
+        if (initialData)
+            SPDLOG_LOGGER_WARN(Logger::logger(), "Ignoring the initial data of a buffer importing host memory");
+        return importHostBuffer(vulkanDevice, deviceHandle, options);
+    }
+
     VkBufferCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     createInfo.size = options.size;
@@ -1177,11 +1221,16 @@ Handle<Buffer_t> VulkanResourceManager::createBuffer(const Handle<Device_t> &dev
         createInfo.pNext = &vkExternalMemBufferCreateInfo;
 
         // We have to use a dedicated allocator for external handles that has been created with VkExportMemoryAllocateInfo
+        std::lock_guard lock(m_deviceStateMutex);
         allocator = vulkanDevice->getOrCreateExternalMemoryAllocator(options.externalMemoryHandleType);
 
         allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
     }
 
+    // Only takes effect on host visible memory, pMappedData stays null otherwise
+    if (options.persistentlyMapped)
+        allocInfo.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
     VkBuffer vkBuffer;
     VmaAllocation vmaAllocation;
 
@@ -1213,12 +1262,18 @@ Handle<Buffer_t> VulkanResourceManager::createBuffer(const Handle<Device_t> &dev
     setObjectName(vulkanDevice, VK_OBJECT_TYPE_BUFFER, vulkanHandleToUint64(vkBuffer), options.label);
 
     const auto vulkanBufferHandle = m_buffers.emplace(VulkanBuffer(vkBuffer, vmaAllocation, allocator, this, deviceHandle, memoryHandle, bufferDeviceAddress));
+    VulkanBuffer *vulkanBuffer = m_buffers.get(vulkanBufferHandle);
+
+    if (options.persistentlyMapped && allocationInfo.pMappedData != nullptr) {
+        vulkanBuffer->mapped = allocationInfo.pMappedData;
+        vulkanBuffer->persistentlyMapped = true;
+    }
 
     if (initialData) {
-        VulkanBuffer *vulkanBuffer = m_buffers.get(vulkanBufferHandle);
         auto *bufferData = vulkanBuffer->map();
         if (bufferData != nullptr) {
             std::memcpy(bufferData, initialData, createInfo.size);
+            vulkanBuffer->flush(0, WholeSize);
             vulkanBuffer->unmap();
         } else {
             SPDLOG_LOGGER_ERROR(Logger::logger(), "Unable to map buffer to transfer initial data");
@@ -1228,11 +1283,146 @@ Handle<Buffer_t> VulkanResourceManager::createBuffer(const Handle<Device_t> &dev
     return vulkanBufferHandle;
 }
 
+Handle<Buffer_t> VulkanResourceManager::importHostBuffer(VulkanDevice *vulkanDevice, const Handle<Device_t> &deviceHandle, const BufferOptions &options)
+{
+#if VK_EXT_external_memory_host
+    const DeviceSize alignment = vulkanDevice->minImportedHostPointerAlignment;
+    if (alignment == 0) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Importing host memory into a buffer requires VK_EXT_external_memory_host");
+        return {};
+    }
+    if (reinterpret_cast<uintptr_t>(options.hostPointer) % alignment != 0 || options.size % alignment != 0) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Imported host memory has to be aligned to {} bytes", alignment);
+        return {};
+    }
+
+    // Memory mapped from files or devices is foreign memory, everything else a host allocation
+    const ExternalMemoryHandleTypeFlags handleType = options.externalMemoryHandleType != ExternalMemoryHandleTypeFlagBits::None
+            ? options.externalMemoryHandleType
+            : ExternalMemoryHandleTypeFlags(ExternalMemoryHandleTypeFlagBits::HostAllocation);
+    const VkExternalMemoryHandleTypeFlagBits vkHandleType = externalMemoryHandleTypeToVkExternalMemoryHandleType(handleType);
+
+    // The driver may refuse some host memory, e.g. file mappings it cannot pin
+    VkMemoryHostPointerPropertiesEXT hostPointerProperties = {};
+    hostPointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+    if (auto result = vulkanDevice->vkGetMemoryHostPointerPropertiesEXT(vulkanDevice->device, vkHandleType, options.hostPointer, &hostPointerProperties);
+        result != VK_SUCCESS) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Unable to import host memory: {}", result);
+        return {};
+    }
+
+    VkExternalMemoryBufferCreateInfo externalMemoryBufferCreateInfo = {};
+    externalMemoryBufferCreateInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+    externalMemoryBufferCreateInfo.handleTypes = vkHandleType;
+
+    VkBufferCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    createInfo.pNext = &externalMemoryBufferCreateInfo;
+    createInfo.size = options.size;
+    createInfo.usage = options.usage.toInt();
+    createInfo.sharingMode = sharingModeToVkSharingMode(options.sharingMode);
+    if (!options.queueTypeIndices.empty()) {
+        createInfo.queueFamilyIndexCount = options.queueTypeIndices.size();
+        createInfo.pQueueFamilyIndices = options.queueTypeIndices.data();
+    }
+
+    VkBuffer vkBuffer{ VK_NULL_HANDLE };
+    if (auto result = vkCreateBuffer(vulkanDevice->device, &createInfo, nullptr, &vkBuffer); result != VK_SUCCESS) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Error when creating buffer: {}", result);
+        return {};
+    }
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetBufferMemoryRequirements(vulkanDevice->device, vkBuffer, &memoryRequirements);
+
+    // Flush and invalidate are not available on imported memory, prefer host coherent types
+    VulkanAdapter *adapter = getAdapter(vulkanDevice->adapterHandle);
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(adapter->physicalDevice, &memoryProperties);
+    const uint32_t memoryTypeBits = memoryRequirements.memoryTypeBits & hostPointerProperties.memoryTypeBits;
+    uint32_t memoryTypeIndex = VK_MAX_MEMORY_TYPES;
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        if ((memoryTypeBits & (1u << i)) == 0)
+            continue;
+        if (memoryTypeIndex == VK_MAX_MEMORY_TYPES)
+            memoryTypeIndex = i;
+        if (memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+            memoryTypeIndex = i;
+            break;
+        }
+    }
+    if (memoryTypeIndex == VK_MAX_MEMORY_TYPES || memoryRequirements.size > options.size) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "No memory type can import host memory for this buffer");
+        vkDestroyBuffer(vulkanDevice->device, vkBuffer, nullptr);
+        return {};
+    }
+
+    VkImportMemoryHostPointerInfoEXT importInfo = {};
+    importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+    importInfo.handleType = vkHandleType;
+    importInfo.pHostPointer = const_cast<void *>(options.hostPointer);
+
+    VkMemoryAllocateFlagsInfo allocateFlagsInfo = {};
+    allocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    if (options.usage.testFlag(BufferUsageFlagBits::ShaderDeviceAddressBit))
+        importInfo.pNext = &allocateFlagsInfo;
+
+    VkMemoryAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.pNext = &importInfo;
+    allocateInfo.allocationSize = options.size;
+    allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VkDeviceMemory vkMemory{ VK_NULL_HANDLE };
+    if (auto result = vkAllocateMemory(vulkanDevice->device, &allocateInfo, nullptr, &vkMemory); result != VK_SUCCESS) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Unable to import host memory: {}", result);
+        vkDestroyBuffer(vulkanDevice->device, vkBuffer, nullptr);
+        return {};
+    }
+    if (auto result = vkBindBufferMemory(vulkanDevice->device, vkBuffer, vkMemory, 0); result != VK_SUCCESS) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Unable to bind imported host memory: {}", result);
+        vkDestroyBuffer(vulkanDevice->device, vkBuffer, nullptr);
+        vkFreeMemory(vulkanDevice->device, vkMemory, nullptr);
+        return {};
+    }
+
+    BufferDeviceAddress bufferDeviceAddress{ 0 };
+    if (options.usage.testFlag(BufferUsageFlagBits::ShaderDeviceAddressBit)) {
+        const VkBufferDeviceAddressInfo addressInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = vkBuffer,
+        };
+        bufferDeviceAddress = vkGetBufferDeviceAddress(vulkanDevice->device, &addressInfo);
+    }
+
+    setObjectName(vulkanDevice, VK_OBJECT_TYPE_BUFFER, vulkanHandleToUint64(vkBuffer), options.label);
+
+    const auto vulkanBufferHandle = m_buffers.emplace(VulkanBuffer(vkBuffer, VK_NULL_HANDLE, VK_NULL_HANDLE, this, deviceHandle, MemoryHandle{}, bufferDeviceAddress));
+    VulkanBuffer *vulkanBuffer = m_buffers.get(vulkanBufferHandle);
+    vulkanBuffer->importedMemory = vkMemory;
+    // The host memory is the buffer memory, it is always mapped
+    vulkanBuffer->mapped = const_cast<void *>(options.hostPointer);
+    vulkanBuffer->persistentlyMapped = true;
+
+    return vulkanBufferHandle;
+#else
+    SPDLOG_LOGGER_ERROR(Logger::logger(), "Importing host memory into a buffer requires VK_EXT_external_memory_host");
+    return {};
+#endif
+}
+
 void VulkanResourceManager::deleteBuffer(const Handle<Buffer_t> &handle)
 {
     VulkanBuffer *vulkanBuffer = m_buffers.get(handle);
 
-    vmaDestroyBuffer(vulkanBuffer->allocator, vulkanBuffer->buffer, vulkanBuffer->allocation);
+    if (vulkanBuffer->importedMemory != VK_NULL_HANDLE) {
+        VulkanDevice *vulkanDevice = m_devices.get(vulkanBuffer->deviceHandle);
+        vkDestroyBuffer(vulkanDevice->device, vulkanBuffer->buffer, nullptr);
+        vkFreeMemory(vulkanDevice->device, vulkanBuffer->importedMemory, nullptr);
+    } else {
+        vmaDestroyBuffer(vulkanBuffer->allocator, vulkanBuffer->buffer, vulkanBuffer->allocation);
+    }
 
     m_buffers.remove(handle);
 }
@@ -1246,19 +1436,22 @@ Handle<ShaderModule_t> VulkanResourceManager::createShaderModule(const Handle<De
 {
     VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
 
-    VkShaderModuleCreateInfo createInfo = {};
-    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = code.size() * sizeof(uint32_t);
-    createInfo.pCode = code.data();
-
-    VkShaderModule vkShaderModule;
-    if (auto result = vkCreateShaderModule(vulkanDevice->device, &createInfo, nullptr, &vkShaderModule); result != VK_SUCCESS) {
-        SPDLOG_LOGGER_ERROR(Logger::logger(), "Error when creating shader module: {}", result);
-        return {};
-    }
+    // Identical SPIR-V shares a single VkShaderModule
+    std::lock_guard lock(m_shaderModuleDeduplicationMutex);
+    return vulkanDevice->shaderModuleCache.getOrCreate(code, [&]() -> Handle<ShaderModule_t> {
+        VkShaderModuleCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = code.size() * sizeof(uint32_t);
+        createInfo.pCode = code.data();
+
+        VkShaderModule vkShaderModule;
+        if (auto result = vkCreateShaderModule(vulkanDevice->device, &createInfo, nullptr, &vkShaderModule); result != VK_SUCCESS) {
+            SPDLOG_LOGGER_ERROR(Logger::logger(), "Error when creating shader module: {}", result);
+            return {};
+        }
 
-    const auto vulkanShaderModuleHandle = m_shaderModules.emplace(vkShaderModule, this, deviceHandle);
-    return vulkanShaderModuleHandle;
+        return m_shaderModules.emplace(vkShaderModule, this, deviceHandle);
+    });
 }
 
 void VulkanResourceManager::deleteShaderModule(const Handle<ShaderModule_t> &handle)
@@ -1266,6 +1459,13 @@ void VulkanResourceManager::deleteShaderModule(const Handle<ShaderModule_t> &han
     VulkanShaderModule *shaderModule = m_shaderModules.get(handle);
     VulkanDevice *vulkanDevice = m_devices.get(shaderModule->deviceHandle);
 
+    {
+        // Shared shader modules are only destroyed once the last user lets go of them
+        std::lock_guard lock(m_shaderModuleDeduplicationMutex);
+        if (!vulkanDevice->shaderModuleCache.release(handle))
+            return;
+    }
+
     vkDestroyShaderModule(vulkanDevice->device, shaderModule->shaderModule, nullptr);
 
     m_shaderModules.remove(handle);
@@ -1952,10 +2152,12 @@ Handle<GraphicsPipeline_t> VulkanResourceManager::createGraphicsPipeline(const H
     }
 
     VkPipelineCache vkPipelineCache = VK_NULL_HANDLE;
+    std::shared_lock<std::shared_mutex> pipelineCacheLock;
     if (options.pipelineCache.isValid()) {
         VulkanPipelineCache *pipelineCache = getPipelineCache(options.pipelineCache);
         assert(pipelineCache != nullptr);
         vkPipelineCache = pipelineCache->pipelineCache;
+        pipelineCacheLock = std::shared_lock(*pipelineCache->mutex);
     }
 
     VkPipeline vkPipeline{ VK_NULL_HANDLE };
@@ -1979,11 +2181,26 @@ Handle<GraphicsPipeline_t> VulkanResourceManager::createGraphicsPipeline(const H
     return vulkanGraphicsPipelineHandle;
 }
 
+Handle<GraphicsPipeline_t> VulkanResourceManager::getOrCreateGraphicsPipeline(const Handle<Device_t> &deviceHandle, const GraphicsPipelineOptions &options)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    // Unlocked while the driver compiles the pipeline
+    std::unique_lock lock(m_pipelineDeduplicationMutex);
+    return vulkanDevice->graphicsPipelineCache.getOrCreate(lock, options, [&] { return createGraphicsPipeline(deviceHandle, options); });
+}
+
 void VulkanResourceManager::deleteGraphicsPipeline(const Handle<GraphicsPipeline_t> &handle)
 {
     VulkanGraphicsPipeline *vulkanPipeline = m_graphicsPipelines.get(handle);
     VulkanDevice *vulkanDevice = m_devices.get(vulkanPipeline->deviceHandle);
 
+    {
+        // Shared pipelines are only destroyed once the last user lets go of them
+        std::lock_guard lock(m_pipelineDeduplicationMutex);
+        if (!vulkanDevice->graphicsPipelineCache.release(handle))
+            return;
+    }
+
     vkDestroyPipeline(vulkanDevice->device, vulkanPipeline->pipeline, nullptr);
 
     if (vulkanPipeline->renderPassHandle.isValid()) { // If the renderpass is not explicitly created by the user, we're in charge of releasing it
@@ -2065,10 +2282,12 @@ Handle<ComputePipeline_t> VulkanResourceManager::createComputePipeline(const Han
     pipelineInfo.layout = vulkanPipelineLayout->pipelineLayout;
 
     VkPipelineCache vkPipelineCache = VK_NULL_HANDLE;
+    std::shared_lock<std::shared_mutex> pipelineCacheLock;
     if (options.pipelineCache.isValid()) {
         VulkanPipelineCache *pipelineCache = getPipelineCache(options.pipelineCache);
         assert(pipelineCache != nullptr);
         vkPipelineCache = pipelineCache->pipelineCache;
+        pipelineCacheLock = std::shared_lock(*pipelineCache->mutex);
     }
 
     VkPipeline vkPipeline{ VK_NULL_HANDLE };
@@ -2089,11 +2308,25 @@ Handle<ComputePipeline_t> VulkanResourceManager::createComputePipeline(const Han
 
     return vulkanComputePipelineHandle;
 }
+
+Handle<ComputePipeline_t> VulkanResourceManager::getOrCreateComputePipeline(const Handle<Device_t> &deviceHandle, const ComputePipelineOptions &options)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    std::unique_lock lock(m_pipelineDeduplicationMutex);
+    return vulkanDevice->computePipelineCache.getOrCreate(lock, options, [&] { return createComputePipeline(deviceHandle, options); });
+}
+
 void VulkanResourceManager::deleteComputePipeline(const Handle<ComputePipeline_t> &handle)
 {
     VulkanComputePipeline *vulkanPipeline = m_computePipelines.get(handle);
     VulkanDevice *vulkanDevice = m_devices.get(vulkanPipeline->deviceHandle);
 
+    {
+        std::lock_guard lock(m_pipelineDeduplicationMutex);
+        if (!vulkanDevice->computePipelineCache.release(handle))
+            return;
+    }
+
     vkDestroyPipeline(vulkanDevice->device, vulkanPipeline->pipeline, nullptr);
 
     m_computePipelines.remove(handle);
@@ -2187,10 +2420,12 @@ Handle<RayTracingPipeline_t> VulkanResourceManager::createRayTracingPipeline(con
     pipelineInfo.layout = vulkanPipelineLayout->pipelineLayout;
 
     VkPipelineCache vkPipelineCache = VK_NULL_HANDLE;
+    std::shared_lock<std::shared_mutex> pipelineCacheLock;
     if (options.pipelineCache.isValid()) {
         VulkanPipelineCache *pipelineCache = getPipelineCache(options.pipelineCache);
         assert(pipelineCache != nullptr);
         vkPipelineCache = pipelineCache->pipelineCache;
+        pipelineCacheLock = std::shared_lock(*pipelineCache->mutex);
     }
 
     VkPipeline vkPipeline{ VK_NULL_HANDLE };
@@ -2217,11 +2452,24 @@ Handle<RayTracingPipeline_t> VulkanResourceManager::createRayTracingPipeline(con
 #endif
 }
 
+Handle<RayTracingPipeline_t> VulkanResourceManager::getOrCreateRayTracingPipeline(const Handle<Device_t> &deviceHandle, const RayTracingPipelineOptions &options)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    std::unique_lock lock(m_pipelineDeduplicationMutex);
+    return vulkanDevice->rayTracingPipelineCache.getOrCreate(lock, options, [&] { return createRayTracingPipeline(deviceHandle, options); });
+}
+
 void VulkanResourceManager::deleteRayTracingPipeline(const Handle<RayTracingPipeline_t> &handle)
 {
     VulkanRayTracingPipeline *vulkanPipeline = m_rayTracingPipelines.get(handle);
     VulkanDevice *vulkanDevice = m_devices.get(vulkanPipeline->deviceHandle);
 
+    {
+        std::lock_guard lock(m_pipelineDeduplicationMutex);
+        if (!vulkanDevice->rayTracingPipelineCache.release(handle))
+            return;
+    }
+
     vkDestroyPipeline(vulkanDevice->device, vulkanPipeline->pipeline, nullptr);
 
     m_rayTracingPipelines.remove(handle);
@@ -2232,6 +2480,57 @@ VulkanRayTracingPipeline *VulkanResourceManager::getRayTracingPipeline(const Han
     return m_rayTracingPipelines.get(handle);
 }
 
+PipelineDeduplicationStats VulkanResourceManager::pipelineDeduplicationStats(const Handle<Device_t> &deviceHandle)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    std::lock_guard lock(m_pipelineDeduplicationMutex);
+
+    PipelineDeduplicationStats stats;
+    for (const PipelineDeduplicationStats &cacheStats : { vulkanDevice->graphicsPipelineCache.stats(),
+                                                          vulkanDevice->computePipelineCache.stats(),
+                                                          vulkanDevice->rayTracingPipelineCache.stats() }) {
+        stats.hits += cacheStats.hits;
+        stats.misses += cacheStats.misses;
+        stats.cachedPipelines += cacheStats.cachedPipelines;
+    }
+    return stats;
+}
+
+ShaderModuleDeduplicationStats VulkanResourceManager::shaderModuleDeduplicationStats(const Handle<Device_t> &deviceHandle)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    std::lock_guard lock(m_shaderModuleDeduplicationMutex);
+    return vulkanDevice->shaderModuleCache.stats();
+}
+
+DeduplicationStats VulkanResourceManager::samplerDeduplicationStats(const Handle<Device_t> &deviceHandle)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    std::lock_guard lock(m_objectDeduplicationMutex);
+    return vulkanDevice->samplerCache.stats();
+}
+
+DeduplicationStats VulkanResourceManager::bindGroupLayoutDeduplicationStats(const Handle<Device_t> &deviceHandle)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    std::lock_guard lock(m_objectDeduplicationMutex);
+    return vulkanDevice->bindGroupLayoutCache.stats();
+}
+
+RenderTargetCacheStats VulkanResourceManager::renderPassCacheStats(const Handle<Device_t> &deviceHandle)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    std::lock_guard lock(m_renderTargetCacheMutex);
+    return vulkanDevice->renderPasses.stats();
+}
+
+RenderTargetCacheStats VulkanResourceManager::framebufferCacheStats(const Handle<Device_t> &deviceHandle)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    std::lock_guard lock(m_renderTargetCacheMutex);
+    return vulkanDevice->framebuffers.stats();
+}
+
 template<typename SemaphoreOptionType>
 std::pair<VkSemaphore, HandleOrFD> createSemaphore(VulkanDevice *vulkanDevice, const SemaphoreOptionType &options)
 {
@@ -2381,62 +2680,85 @@ VulkanTimelineSemaphore *VulkanResourceManager::getTimelineSemaphore(const Handl
     return m_timelineSemaphores.get(handle);
 }
 
+QueueDescription *VulkanResourceManager::findQueueDescription(VulkanDevice *vulkanDevice, const Handle<Queue_t> &queue)
+{
+    if (!queue.isValid()) {
+        if (vulkanDevice->queueDescriptions.empty()) {
+            SPDLOG_LOGGER_ERROR(Logger::logger(), "No more queue descriptors available for device");
+            return nullptr;
+        }
+        return vulkanDevice->queueDescriptions.data();
+    }
+
+    // Look for this queue on the device
+    const auto it = std::find_if(
+            vulkanDevice->queueDescriptions.begin(),
+            vulkanDevice->queueDescriptions.end(),
+            [queue](const QueueDescription &queueDescription) { return queueDescription.queue == queue; });
+    if (it == vulkanDevice->queueDescriptions.end()) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Cannot find requested queue for device");
+        return nullptr;
+    }
+    return &(*it);
+}
+
 Handle<CommandRecorder_t> VulkanResourceManager::createCommandRecorder(const Handle<Device_t> &deviceHandle, const CommandRecorderOptions &options)
 {
     VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
 
-    // Which queue is the command recorder requested for?
-
-    QueueDescription *queueDescription = nullptr;
+    // Command buffers of a frame command allocator come from the pool of its current frame
+    if (options.frameCommandAllocator.isValid()) {
+        VulkanFrameCommandAllocator *frameCommandAllocator = m_frameCommandAllocators.get(options.frameCommandAllocator);
+        assert(frameCommandAllocator != nullptr);
 
-    if (!options.queue.isValid()) {
-        if (vulkanDevice->queueDescriptions.empty()) {
-            SPDLOG_LOGGER_ERROR(Logger::logger(), "No more queue descriptors available for device");
-            return {};
-        }
-        queueDescription = vulkanDevice->queueDescriptions.data();
-    } else {
-        // Look for this queue on the device
-        const auto it = std::find_if(
-                vulkanDevice->queueDescriptions.begin(),
-                vulkanDevice->queueDescriptions.end(),
-                [options](const QueueDescription &queueDescription) { return queueDescription.queue == options.queue; });
-        if (it == vulkanDevice->queueDescriptions.end()) {
-            SPDLOG_LOGGER_ERROR(Logger::logger(), "Cannot find requested queue for device");
+        const VkCommandBufferLevel level = commandBufferLevelToVkCommandBufferLevel(options.level);
+        VkCommandBuffer vkCommandBuffer = frameCommandAllocator->acquireCommandBuffer(level);
+        if (vkCommandBuffer == VK_NULL_HANDLE)
             return {};
-        }
-        queueDescription = &(*it);
+
+        VkCommandPool vkCommandPool = frameCommandAllocator->frames[frameCommandAllocator->currentFrame].commandPool;
+        VulkanCommandBuffer vulkanCommandBuffer(vkCommandBuffer, vkCommandPool, level, this, deviceHandle);
+        vulkanCommandBuffer.frameCommandAllocator = options.frameCommandAllocator;
+        vulkanCommandBuffer.frameIndex = frameCommandAllocator->currentFrame;
+        vulkanCommandBuffer.renderPassInheritance = options.renderPassInheritance;
+        const Handle<CommandBuffer_t> commandBufferHandle = m_commandBuffers.emplace(std::move(vulkanCommandBuffer));
+
+        return m_commandRecorders.emplace(VulkanCommandRecorder(
+                vkCommandPool,
+                commandBufferHandle,
+                this,
+                deviceHandle));
     }
 
+    // Which queue is the command recorder requested for?
+    QueueDescription *queueDescription = findQueueDescription(vulkanDevice, options.queue);
+    if (!queueDescription)
+        return {};
+
     Handle<Queue_t> queueHandle = queueDescription->queue;
     const uint32_t queueTypeIndex = queueDescription->queueTypeIndex;
     assert(queueHandle.isValid());
     assert(queueTypeIndex != std::numeric_limits<uint32_t>::max());
 
     // Find or create a command pool for this combination of thread and queue family
-    if (vulkanDevice->commandPools[queueTypeIndex] == VK_NULL_HANDLE) {
-        // No command pool exists yet for this queue family, let's create one why not!
-        VkCommandPoolCreateInfo poolInfo = {};
-        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolInfo.queueFamilyIndex = queueTypeIndex;
-
-        VkCommandPool vkCommandPool = VK_NULL_HANDLE;
-        if (auto result = vkCreateCommandPool(vulkanDevice->device, &poolInfo, nullptr, &vkCommandPool); result != VK_SUCCESS) {
-            SPDLOG_LOGGER_ERROR(Logger::logger(), "Error when creating command pool for queue family {}: {}", queueTypeIndex, result);
-            return {};
-        }
-        vulkanDevice->commandPools[queueTypeIndex] = vkCommandPool;
-    }
+    VulkanThreadCommandPool *commandPool = threadCommandPool(vulkanDevice, queueTypeIndex);
+    if (!commandPool)
+        return {};
 
     // Create the Command Buffer
-    VkCommandPool vkCommandPool = vulkanDevice->commandPools[queueTypeIndex];
     const Handle<CommandBuffer_t> commandBufferHandle = createCommandBuffer(deviceHandle,
-                                                                            *queueDescription,
+                                                                            commandPool,
                                                                             options.level);
+    if (!commandBufferHandle.isValid()) {
+        std::lock_guard lock(m_commandPoolsMutex);
+        --commandPool->liveCommandBuffers;
+        return {};
+    }
+    m_commandBuffers.get(commandBufferHandle)->renderPassInheritance = options.renderPassInheritance;
 
     // Finally, we can create the command recorder object
     const auto vulkanCommandRecorderHandle = m_commandRecorders.emplace(VulkanCommandRecorder(
-            vkCommandPool,
+            commandPool->commandPool,
             commandBufferHandle,
             this,
             deviceHandle));
@@ -2444,6 +2766,57 @@ Handle<CommandRecorder_t> VulkanResourceManager::createCommandRecorder(const Han
     return vulkanCommandRecorderHandle;
 }
 
+VulkanThreadCommandPool *VulkanResourceManager::threadCommandPool(VulkanDevice *vulkanDevice, uint32_t queueTypeIndex)
+{
+    const std::thread::id thread = std::this_thread::get_id();
+    VulkanThreadCommandPool *commandPool = nullptr;
+    std::vector<VkCommandBuffer> pendingFrees;
+    {
+        std::lock_guard lock(m_commandPoolsMutex);
+        auto &threadCommandPools = vulkanDevice->commandPools[queueTypeIndex];
+        auto it = threadCommandPools.find(thread);
+        if (it == threadCommandPools.end()) {
+            // No command pool exists yet for this thread and queue family, let's create one why not!
+            VkCommandPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.queueFamilyIndex = queueTypeIndex;
+
+            VkCommandPool vkCommandPool = VK_NULL_HANDLE;
+            if (auto result = vkCreateCommandPool(vulkanDevice->device, &poolInfo, nullptr, &vkCommandPool); result != VK_SUCCESS) {
+                SPDLOG_LOGGER_ERROR(Logger::logger(), "Error when creating command pool for queue family {}: {}", queueTypeIndex, result);
+                return nullptr;
+            }
+            it = threadCommandPools.emplace(thread, VulkanThreadCommandPool{ .commandPool = vkCommandPool, .thread = thread }).first;
+        }
+        commandPool = &it->second;
+        // Keeps releaseThreadCommandPools() off the pool while the command buffer is allocated
+        ++commandPool->liveCommandBuffers;
+        pendingFrees.swap(commandPool->pendingFrees);
+    }
+
+    // Only this thread uses the pool, no need to hold the lock while freeing
+    if (!pendingFrees.empty())
+        vkFreeCommandBuffers(vulkanDevice->device, commandPool->commandPool, static_cast<uint32_t>(pendingFrees.size()), pendingFrees.data());
+    return commandPool;
+}
+
+void VulkanResourceManager::releaseThreadCommandPools(const Handle<Device_t> &deviceHandle)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+    std::lock_guard lock(m_commandPoolsMutex);
+    for (auto &threadCommandPools : vulkanDevice->commandPools) {
+        // A pool without live command buffers is not used by its thread, destroying it
+        // also frees the command buffers left pending
+        std::erase_if(threadCommandPools, [vulkanDevice](const auto &entry) {
+            const VulkanThreadCommandPool &commandPool = entry.second;
+            if (commandPool.liveCommandBuffers != 0)
+                return false;
+            vkDestroyCommandPool(vulkanDevice->device, commandPool.commandPool, nullptr);
+            return true;
+        });
+    }
+}
+
 void VulkanResourceManager::deleteCommandRecorder(const Handle<CommandRecorder_t> &handle)
 {
     // VulkanCommandRecorder actually doesn't map to an actual Vulkan Resource.
@@ -2457,11 +2830,11 @@ VulkanCommandRecorder *VulkanResourceManager::getCommandRecorder(const Handle<Co
 }
 
 Handle<CommandBuffer_t> VulkanResourceManager::createCommandBuffer(const Handle<Device_t> &deviceHandle,
-                                                                   const QueueDescription &queueDescription,
+                                                                   VulkanThreadCommandPool *commandPool,
                                                                    CommandBufferLevel commandLevel)
 {
     VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
-    VkCommandPool vkCommandPool = vulkanDevice->commandPools[queueDescription.queueTypeIndex];
+    VkCommandPool vkCommandPool = commandPool->commandPool;
 
     // Allocate a command buffer object from the pool
     VkCommandBufferAllocateInfo allocInfo = {};
@@ -2476,11 +2849,9 @@ Handle<CommandBuffer_t> VulkanResourceManager::createCommandBuffer(const Handle<
         return {};
     }
 
-    const auto vulkanCommandBufferHandle = m_commandBuffers.emplace(VulkanCommandBuffer(vkCommandBuffer,
-                                                                                        vkCommandPool,
-                                                                                        allocInfo.level,
-                                                                                        this,
-                                                                                        deviceHandle));
+    VulkanCommandBuffer vulkanCommandBuffer(vkCommandBuffer, vkCommandPool, allocInfo.level, this, deviceHandle);
+    vulkanCommandBuffer.threadCommandPool = commandPool;
+    const auto vulkanCommandBufferHandle = m_commandBuffers.emplace(std::move(vulkanCommandBuffer));
 
     return vulkanCommandBufferHandle;
 }
@@ -2490,11 +2861,76 @@ void VulkanResourceManager::deleteCommandBuffer(const Handle<CommandBuffer_t> &h
     VulkanCommandBuffer *commandBuffer = m_commandBuffers.get(handle);
     VulkanDevice *vulkanDevice = m_devices.get(commandBuffer->deviceHandle);
 
-    for (const Handle<Buffer_t> buf : commandBuffer->temporaryBuffersToRelease)
+    // Command buffers of a frame command allocator may be destroyed right after being submitted.
+    // Their frame holds on to what was recorded into them until it begins again, after its fence
+    // signalled. An allocator destroyed first implies the GPU is done with them.
+    VulkanFrameCommandAllocator *frameCommandAllocator = commandBuffer->frameCommandAllocator.isValid()
+            ? m_frameCommandAllocators.get(commandBuffer->frameCommandAllocator)
+            : nullptr;
+    if (frameCommandAllocator) {
+        VulkanFrameCommandAllocator::Frame &frame = frameCommandAllocator->frames[commandBuffer->frameIndex];
+        frame.temporaryBuffersToRelease.insert(frame.temporaryBuffersToRelease.end(),
+                                               commandBuffer->temporaryBuffersToRelease.begin(), commandBuffer->temporaryBuffersToRelease.end());
+        frame.cachedRenderPassesInUse.insert(frame.cachedRenderPassesInUse.end(),
+                                             commandBuffer->cachedRenderPassesInUse.begin(), commandBuffer->cachedRenderPassesInUse.end());
+        frame.cachedFramebuffersInUse.insert(frame.cachedFramebuffersInUse.end(),
+                                             commandBuffer->cachedFramebuffersInUse.begin(), commandBuffer->cachedFramebuffersInUse.end());
+    } else {
+        releaseCommandBufferResources(commandBuffer->deviceHandle,
+                                      commandBuffer->temporaryBuffersToRelease,
+                                      commandBuffer->cachedRenderPassesInUse,
+                                      commandBuffer->cachedFramebuffersInUse);
+    }
+
+    // Command buffers of a frame command allocator are reused once their pool is reset.
+    // Others go back to the pool of the thread that allocated them, which might be
+    // recording into it right now. Leave them for that thread to free in that case,
+    // unless this was its last command buffer: the thread is not using the pool then
+    // and might never allocate from it again.
+    if (!commandBuffer->frameCommandAllocator.isValid()) {
+        VulkanThreadCommandPool *commandPool = commandBuffer->threadCommandPool;
+        if (commandPool->thread == std::this_thread::get_id()) {
+            vkFreeCommandBuffers(vulkanDevice->device, commandBuffer->commandPool, 1, &commandBuffer->commandBuffer);
+            std::lock_guard lock(m_commandPoolsMutex);
+            --commandPool->liveCommandBuffers;
+        } else {
+            std::lock_guard lock(m_commandPoolsMutex);
+            commandPool->pendingFrees.push_back(commandBuffer->commandBuffer);
+            if (--commandPool->liveCommandBuffers == 0) {
+                vkFreeCommandBuffers(vulkanDevice->device, commandPool->commandPool,
+                                     static_cast<uint32_t>(commandPool->pendingFrees.size()), commandPool->pendingFrees.data());
+                commandPool->pendingFrees.clear();
+            }
+        }
+    }
+    m_commandBuffers.remove(handle);
+}
+
+void VulkanResourceManager::releaseCommandBufferResources(const Handle<Device_t> &deviceHandle,
+                                                          std::vector<Handle<Buffer_t>> &temporaryBuffers,
+                                                          std::vector<Handle<RenderPass_t>> &cachedRenderPasses,
+                                                          std::vector<Handle<Framebuffer_t>> &cachedFramebuffers)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+
+    for (const Handle<Buffer_t> buf : temporaryBuffers)
         deleteBuffer(buf);
+    temporaryBuffers.clear();
 
-    vkFreeCommandBuffers(vulkanDevice->device, commandBuffer->commandPool, 1, &commandBuffer->commandBuffer);
-    m_commandBuffers.remove(handle);
+    // Destroy cached render passes and framebuffers that were evicted while the command buffers used them
+    std::lock_guard lock(m_renderTargetCacheMutex);
+    for (const Handle<RenderPass_t> &passHandle : cachedRenderPasses) {
+        vulkanDevice->renderPasses.release(passHandle, [this](const Handle<RenderPass_t> &evictedHandle, const VulkanRenderPassKey &) {
+            deleteRenderPass(evictedHandle);
+        });
+    }
+    for (const Handle<Framebuffer_t> &fbHandle : cachedFramebuffers) {
+        vulkanDevice->framebuffers.release(fbHandle, [this](const Handle<Framebuffer_t> &evictedHandle, const VulkanFramebufferKey &) {
+            deleteFramebuffer(evictedHandle);
+        });
+    }
+    cachedRenderPasses.clear();
+    cachedFramebuffers.clear();
 }
 
 VulkanCommandBuffer *VulkanResourceManager::getCommandBuffer(const Handle<CommandBuffer_t> &handle) const
@@ -2502,6 +2938,62 @@ VulkanCommandBuffer *VulkanResourceManager::getCommandBuffer(const Handle<Comman
     return m_commandBuffers.get(handle);
 }
 
+Handle<FrameCommandAllocator_t> VulkanResourceManager::createFrameCommandAllocator(const Handle<Device_t> &deviceHandle, const FrameCommandAllocatorOptions &options)
+{
+    VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
+
+    const QueueDescription *queueDescription = findQueueDescription(vulkanDevice, options.queue);
+    if (!queueDescription)
+        return {};
+    const uint32_t queueTypeIndex = queueDescription->queueTypeIndex;
+
+    if (options.frameCount == 0) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "A frame command allocator needs at least one frame");
+        return {};
+    }
+
+    // Command buffers are only ever reset along with their pool
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = queueTypeIndex;
+
+    std::vector<VulkanFrameCommandAllocator::Frame> frames(options.frameCount);
+    for (VulkanFrameCommandAllocator::Frame &frame : frames) {
+        if (auto result = vkCreateCommandPool(vulkanDevice->device, &poolInfo, nullptr, &frame.commandPool); result != VK_SUCCESS) {
+            SPDLOG_LOGGER_ERROR(Logger::logger(), "Error when creating command pool for queue family {}: {}", queueTypeIndex, result);
+            for (const VulkanFrameCommandAllocator::Frame &createdFrame : frames)
+                vkDestroyCommandPool(vulkanDevice->device, createdFrame.commandPool, nullptr);
+            return {};
+        }
+        setObjectName(vulkanDevice, VK_OBJECT_TYPE_COMMAND_POOL, vulkanHandleToUint64(frame.commandPool), options.label);
+    }
+
+    return m_frameCommandAllocators.emplace(VulkanFrameCommandAllocator(std::move(frames), queueTypeIndex, this, deviceHandle));
+}
+
+void VulkanResourceManager::deleteFrameCommandAllocator(const Handle<FrameCommandAllocator_t> &handle)
+{
+    VulkanFrameCommandAllocator *frameCommandAllocator = m_frameCommandAllocators.get(handle);
+    VulkanDevice *vulkanDevice = m_devices.get(frameCommandAllocator->deviceHandle);
+
+    // Destroying the pools frees the command buffers allocated from them
+    for (VulkanFrameCommandAllocator::Frame &frame : frameCommandAllocator->frames) {
+        releaseCommandBufferResources(frameCommandAllocator->deviceHandle,
+                                      frame.temporaryBuffersToRelease,
+                                      frame.cachedRenderPassesInUse,
+                                      frame.cachedFramebuffersInUse);
+        vkDestroyCommandPool(vulkanDevice->device, frame.commandPool, nullptr);
+    }
+
+    m_frameCommandAllocators.remove(handle);
+}
+
+VulkanFrameCommandAllocator *VulkanResourceManager::getFrameCommandAllocator(const Handle<FrameCommandAllocator_t> &handle) const
+{
+    return m_frameCommandAllocators.get(handle);
+}
+
 Handle<BindGroupPool_t> VulkanResourceManager::createBindGroupPool(const Handle<Device_t> &deviceHandle, const BindGroupPoolOptions &options)
 {
     VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
@@ -2580,19 +3072,31 @@ Handle<RenderPassCommandRecorder_t> VulkanResourceManager::createRenderPassComma
 
     // Find or create a render pass object that matches the request
     const VulkanRenderPassKey renderPassKey(options, this);
-    auto itRenderPass = vulkanDevice->renderPasses.find(renderPassKey);
     Handle<RenderPass_t> vulkanRenderPassHandle{};
+    {
+        std::lock_guard lock(m_renderTargetCacheMutex);
+        vulkanRenderPassHandle = vulkanDevice->renderPasses.find(renderPassKey);
+        if (!vulkanRenderPassHandle.isValid()) {
+            // Create the render pass and cache the handle for it
+            vulkanRenderPassHandle = createImplicitRenderPass(deviceHandle,
+                                                              options.colorAttachments,
+                                                              options.depthStencilAttachment,
+                                                              options.samples,
+                                                              options.viewCount);
+            vulkanDevice->renderPasses.insert(
+                    renderPassKey, vulkanRenderPassHandle,
+                    [this, vulkanDevice](const Handle<RenderPass_t> &evictedHandle, const VulkanRenderPassKey &) {
+                        evictRenderPassFramebuffers(vulkanDevice, evictedHandle);
+                    },
+                    [this](const Handle<RenderPass_t> &evictedHandle, const VulkanRenderPassKey &) {
+                        deleteRenderPass(evictedHandle);
+                    });
+        }
 
-    if (itRenderPass == vulkanDevice->renderPasses.end()) {
-        // Create the render pass and cache the handle for it
-        vulkanRenderPassHandle = createImplicitRenderPass(deviceHandle,
-                                                          options.colorAttachments,
-                                                          options.depthStencilAttachment,
-                                                          options.samples,
-                                                          options.viewCount);
-        vulkanDevice->renderPasses.insert({ renderPassKey, vulkanRenderPassHandle });
-    } else {
-        vulkanRenderPassHandle = itRenderPass->second;
+        // Keep the render pass alive until the command buffer is gone, even if evicted meanwhile
+        vulkanDevice->renderPasses.use(vulkanRenderPassHandle);
+        VulkanCommandRecorder *vulkanCommandRecorder = getCommandRecorder(commandRecorderHandle);
+        getCommandBuffer(vulkanCommandRecorder->commandBufferHandle)->cachedRenderPassesInUse.push_back(vulkanRenderPassHandle);
     }
 
     // Create Attachments from the ColorAttachments and DepthAttachment
@@ -2714,14 +3218,30 @@ Handle<RenderPassCommandRecorder_t> VulkanResourceManager::createRenderPassComma
     if (options.viewCount > 1)
         framebufferKey.layers = 1;
 
-    auto itFramebuffer = vulkanDevice->framebuffers.find(framebufferKey);
     Handle<Framebuffer_t> vulkanFramebufferHandle;
-    if (itFramebuffer == vulkanDevice->framebuffers.end()) {
-        // Create the framebuffer and cache the handle for it
-        vulkanFramebufferHandle = createFramebuffer(deviceHandle, framebufferKey);
-        vulkanDevice->framebuffers.insert({ framebufferKey, vulkanFramebufferHandle });
-    } else {
-        vulkanFramebufferHandle = itFramebuffer->second;
+    {
+        std::lock_guard lock(m_renderTargetCacheMutex);
+        vulkanFramebufferHandle = vulkanDevice->framebuffers.find(framebufferKey);
+        if (!vulkanFramebufferHandle.isValid()) {
+            // Create the framebuffer and cache the handle for it
+            vulkanFramebufferHandle = createFramebuffer(deviceHandle, framebufferKey);
+            for (const Handle<TextureView_t> &attachment : framebufferKey.attachmentsKey.handles)
+                vulkanDevice->framebufferKeysByAttachment.emplace(attachment, framebufferKey);
+            vulkanDevice->framebufferKeysByRenderPass.emplace(framebufferKey.renderPass, framebufferKey);
+            vulkanDevice->framebuffers.insert(
+                    framebufferKey, vulkanFramebufferHandle,
+                    [vulkanDevice](const Handle<Framebuffer_t> &, const VulkanFramebufferKey &evictedKey) {
+                        removeFramebufferIndexKeys(vulkanDevice, evictedKey);
+                    },
+                    [this](const Handle<Framebuffer_t> &evictedHandle, const VulkanFramebufferKey &) {
+                        deleteFramebuffer(evictedHandle);
+                    });
+        }
+
+        // Keep the framebuffer alive until the command buffer is gone, even if evicted meanwhile
+        vulkanDevice->framebuffers.use(vulkanFramebufferHandle);
+        VulkanCommandRecorder *vulkanCommandRecorder = getCommandRecorder(commandRecorderHandle);
+        getCommandBuffer(vulkanCommandRecorder->commandBufferHandle)->cachedFramebuffersInUse.push_back(vulkanFramebufferHandle);
     }
 
     VulkanFramebuffer *vulkanFramebuffer = m_framebuffers.get(vulkanFramebufferHandle);
@@ -2942,6 +3462,7 @@ Handle<RenderPassCommandRecorder_t> VulkanResourceManager::createRenderPassComma
     };
     renderingInfo.layerCount = fbArrayLayers;
     renderingInfo.layerCount = fbArrayLayers;
+    renderingInfo.flags = options.secondaryCommandBuffers ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR : 0;
 
     const uint32_t multiViewMaskMask = uint32_t(1 << options.viewCount) - 1;
     renderingInfo.viewMask = (options.viewCount > 1) ? multiViewMaskMask : 0;
@@ -2962,6 +3483,36 @@ Handle<RenderPassCommandRecorder_t> VulkanResourceManager::createRenderPassComma
 #endif
 }
 
+Handle<RenderPassCommandRecorder_t> VulkanResourceManager::createInheritedRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                                    const Handle<CommandRecorder_t> &commandRecorderHandle)
+{
+#if VK_KHR_dynamic_rendering
+    VulkanCommandRecorder *vulkanCommandRecorder = m_commandRecorders.get(commandRecorderHandle);
+    if (!vulkanCommandRecorder) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Could not find a valid command recorder");
+        return {};
+    }
+
+    const VulkanCommandBuffer *vulkanCommandBuffer = m_commandBuffers.get(vulkanCommandRecorder->commandBufferHandle);
+    if (vulkanCommandBuffer->commandLevel != VK_COMMAND_BUFFER_LEVEL_SECONDARY || !vulkanCommandBuffer->renderPassInheritance.has_value()) {
+        SPDLOG_LOGGER_ERROR(Logger::logger(), "Continuing a render pass requires a secondary command buffer with a render pass inheritance");
+        return {};
+    }
+
+    const VkRect2D renderArea = {
+        .offset = { .x = 0, .y = 0 },
+        .extent = { .width = vulkanCommandBuffer->renderPassInheritance->framebufferWidth,
+                    .height = vulkanCommandBuffer->renderPassInheritance->framebufferHeight }
+    };
+    VulkanRenderPassCommandRecorder vulkanRenderPassCommandRecorder(vulkanCommandRecorder->commandBuffer, renderArea, this, deviceHandle, true);
+    vulkanRenderPassCommandRecorder.inheritedRenderPass = true;
+    return m_renderPassCommandRecorders.emplace(std::move(vulkanRenderPassCommandRecorder));
+#else
+    SPDLOG_LOGGER_ERROR(Logger::logger(), "Dynamic Rendering not supported by this Vulkan SDK");
+    return {};
+#endif
+}
+
 VulkanRenderPassCommandRecorder *VulkanResourceManager::getRenderPassCommandRecorder(const Handle<RenderPassCommandRecorder_t> &handle) const
 {
     return m_renderPassCommandRecorders.get(handle);
@@ -3416,6 +3967,9 @@ Handle<BindGroup_t> VulkanResourceManager::createBindGroup(const Handle<Device_t
         .flags = BindGroupPoolFlagBits::CreateFreeBindGroups
     };
 
+    // Descriptor pools are externally synchronized objects and the internal pools are shared
+    std::unique_lock deviceStateLock(m_deviceStateMutex);
+
     if (useInternalPool) {
         // Use or create a default pool from the device's pool vector
         if (vulkanDevice->descriptorSetPools.empty()) {
@@ -3470,6 +4024,7 @@ Handle<BindGroup_t> VulkanResourceManager::createBindGroup(const Handle<Device_t
                                                                             options.implicitFree));
     // Record new bindgroup handle against pool
     vulkanBindGroupPool->addBindGroup(vulkanBindGroupHandle);
+    deviceStateLock.unlock();
 
     // Set up the initial bindings
     auto *vulkanBindGroup = m_bindGroups.get(vulkanBindGroupHandle);
@@ -3488,6 +4043,7 @@ void VulkanResourceManager::deleteBindGroup(const Handle<BindGroup_t> &handle)
 
     // Destroy underlying Vulkan resource if still valid and bind group doesn't require explicit free
     if (vulkanBindGroup->descriptorSet != VK_NULL_HANDLE && vulkanBindGroup->implicitFree) {
+        std::lock_guard lock(m_deviceStateMutex);
         vkFreeDescriptorSets(vulkanDevice->device, vulkanBindGroupPool->descriptorPool, 1, &vulkanBindGroup->descriptorSet);
 
         // Remove the bind group handle from the bindGroupPool if using implicit free
@@ -3508,6 +4064,11 @@ Handle<BindGroupLayout_t> VulkanResourceManager::createBindGroupLayout(const Han
 {
     VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
 
+    // Identical options share a single VkDescriptorSetLayout
+    std::lock_guard lock(m_objectDeduplicationMutex);
+    if (const Handle<BindGroupLayout_t> handle = vulkanDevice->bindGroupLayoutCache.acquire(options); handle.isValid())
+        return handle;
+
     assert(options.bindings.size() <= std::numeric_limits<uint32_t>::max());
     const uint32_t bindingLayoutCount = static_cast<uint32_t>(options.bindings.size());
     std::vector<VkDescriptorSetLayoutBinding> vkBindingLayouts;
@@ -3565,6 +4126,7 @@ Handle<BindGroupLayout_t> VulkanResourceManager::createBindGroupLayout(const Han
     setObjectName(vulkanDevice, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, vulkanHandleToUint64(vkDescriptorSetLayout), options.label);
 
     const auto vulkanBindGroupLayoutHandle = m_bindGroupLayouts.emplace(VulkanBindGroupLayout(vkDescriptorSetLayout, deviceHandle, options.bindings));
+    vulkanDevice->bindGroupLayoutCache.insert(options, vulkanBindGroupLayoutHandle);
     return vulkanBindGroupLayoutHandle;
 }
 
@@ -3573,6 +4135,13 @@ void VulkanResourceManager::deleteBindGroupLayout(const Handle<BindGroupLayout_t
     VulkanBindGroupLayout *vulkanBindGroupLayout = m_bindGroupLayouts.get(handle);
     VulkanDevice *vulkanDevice = m_devices.get(vulkanBindGroupLayout->deviceHandle);
 
+    {
+        // Shared layouts are only destroyed once the last user lets go of them
+        std::lock_guard lock(m_objectDeduplicationMutex);
+        if (!vulkanDevice->bindGroupLayoutCache.release(handle))
+            return;
+    }
+
     vkDestroyDescriptorSetLayout(vulkanDevice->device, vulkanBindGroupLayout->descriptorSetLayout, nullptr);
 
     m_bindGroupLayouts.remove(handle);
@@ -3587,6 +4156,11 @@ Handle<Sampler_t> VulkanResourceManager::createSampler(const Handle<Device_t> &d
 {
     VulkanDevice *vulkanDevice = m_devices.get(deviceHandle);
 
+    // Identical options share a single VkSampler, drivers only allow a limited number of them
+    std::lock_guard lock(m_objectDeduplicationMutex);
+    if (const Handle<Sampler_t> handle = vulkanDevice->samplerCache.acquire(options); handle.isValid())
+        return handle;
+
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     samplerInfo.magFilter = filterModeToVkFilterMode(options.magFilter);
@@ -3637,6 +4211,7 @@ Handle<Sampler_t> VulkanResourceManager::createSampler(const Handle<Device_t> &d
     setObjectName(vulkanDevice, VK_OBJECT_TYPE_SAMPLER, vulkanHandleToUint64(sampler), options.label);
 
     auto samplerHandle = m_samplers.emplace(VulkanSampler(sampler, deviceHandle));
+    vulkanDevice->samplerCache.insert(options, samplerHandle);
     return samplerHandle;
 }
 
@@ -3645,6 +4220,12 @@ void VulkanResourceManager::deleteSampler(const Handle<Sampler_t> &handle)
     VulkanSampler *sampler = m_samplers.get(handle);
     VulkanDevice *vulkanDevice = m_devices.get(sampler->deviceHandle);
 
+    {
+        std::lock_guard lock(m_objectDeduplicationMutex);
+        if (!vulkanDevice->samplerCache.release(handle))
+            return;
+    }
+
     vkDestroySampler(vulkanDevice->device, sampler->sampler, nullptr);
     m_samplers.remove(handle);
 }
@@ -21,6 +21,7 @@
 #include <KDGpu/vulkan/vulkan_compute_pass_command_recorder.h>
 #include <KDGpu/vulkan/vulkan_device.h>
 #include <KDGpu/vulkan/vulkan_fence.h>
+#include <KDGpu/vulkan/vulkan_frame_command_allocator.h>
 #include <KDGpu/vulkan/vulkan_framebuffer.h>
 #include <KDGpu/vulkan/vulkan_gpu_semaphore.h>
 #include <KDGpu/vulkan/vulkan_timeline_semaphore.h>
@@ -47,13 +48,32 @@
 
 #include <KDGpu/instance.h>
 #include <KDGpu/pool.h>
+#include <KDGpu/concurrent_pool.h>
 #include <KDGpu/kdgpu_export.h>
 #include <KDGpu/pipeline_cache_options.h>
+#include <KDGpu/frame_command_allocator_options.h>
 
 #include <vulkan/vulkan.h>
 
+#include <mutex>
+
 namespace KDGpu {
 
+#if defined(KDGPU_CONCURRENT_RESOURCE_MANAGER)
+// Resources can be created, looked up and deleted from several threads
+template<typename T, typename H>
+using VulkanResourcePool = ConcurrentPool<T, H>;
+template<typename T, typename H>
+using VulkanStableResourcePool = ConcurrentPool<T, H>;
+using VulkanResourceMutex = std::mutex;
+#else
+template<typename T, typename H>
+using VulkanResourcePool = Pool<T, H>;
+template<typename T, typename H>
+using VulkanStableResourcePool = ChunkedPool<T, H>;
+using VulkanResourceMutex = NullMutex;
+#endif
+
 /**
  * @brief VulkanResourceManager
  * \ingroup vulkan
@@ -128,17 +148,34 @@ public:
     [[nodiscard]] VulkanPipelineLayout *getPipelineLayout(const Handle<PipelineLayout_t> &handle) const;
 
     Handle<GraphicsPipeline_t> createGraphicsPipeline(const Handle<Device_t> &deviceHandle, const GraphicsPipelineOptions &options);
+    Handle<GraphicsPipeline_t> getOrCreateGraphicsPipeline(const Handle<Device_t> &deviceHandle, const GraphicsPipelineOptions &options);
     void deleteGraphicsPipeline(const Handle<GraphicsPipeline_t> &handle);
     [[nodiscard]] VulkanGraphicsPipeline *getGraphicsPipeline(const Handle<GraphicsPipeline_t> &handle) const;
 
     Handle<ComputePipeline_t> createComputePipeline(const Handle<Device_t> &deviceHandle, const ComputePipelineOptions &options);
+    Handle<ComputePipeline_t> getOrCreateComputePipeline(const Handle<Device_t> &deviceHandle, const ComputePipelineOptions &options);
     void deleteComputePipeline(const Handle<ComputePipeline_t> &handle);
     [[nodiscard]] VulkanComputePipeline *getComputePipeline(const Handle<ComputePipeline_t> &handle) const;
 
     Handle<RayTracingPipeline_t> createRayTracingPipeline(const Handle<Device_t> &deviceHandle, const RayTracingPipelineOptions &options);
+    Handle<RayTracingPipeline_t> getOrCreateRayTracingPipeline(const Handle<Device_t> &deviceHandle, const RayTracingPipelineOptions &options);
     void deleteRayTracingPipeline(const Handle<RayTracingPipeline_t> &handle);
     [[nodiscard]] VulkanRayTracingPipeline *getRayTracingPipeline(const Handle<RayTracingPipeline_t> &handle) const;
 
+    [[nodiscard]] PipelineDeduplicationStats pipelineDeduplicationStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] ShaderModuleDeduplicationStats shaderModuleDeduplicationStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] DeduplicationStats samplerDeduplicationStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] DeduplicationStats bindGroupLayoutDeduplicationStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] RenderTargetCacheStats renderPassCacheStats(const Handle<Device_t> &deviceHandle);
+    [[nodiscard]] RenderTargetCacheStats framebufferCacheStats(const Handle<Device_t> &deviceHandle);
+    void releaseThreadCommandPools(const Handle<Device_t> &deviceHandle);
+    // Deletes the temporary buffers and releases the cached render targets recorded into
+    // command buffers the GPU is done with, then clears the vectors
+    void releaseCommandBufferResources(const Handle<Device_t> &deviceHandle,
+                                       std::vector<Handle<Buffer_t>> &temporaryBuffers,
+                                       std::vector<Handle<RenderPass_t>> &cachedRenderPasses,
+                                       std::vector<Handle<Framebuffer_t>> &cachedFramebuffers);
+
     Handle<GpuSemaphore_t> createGpuSemaphore(const Handle<Device_t> &deviceHandle, const GpuSemaphoreOptions &options);
     void deleteGpuSemaphore(const Handle<GpuSemaphore_t> &handle);
     [[nodiscard]] VulkanGpuSemaphore *getGpuSemaphore(const Handle<GpuSemaphore_t> &handle) const;
@@ -160,6 +197,8 @@ public:
     Handle<RenderPassCommandRecorder_t> createRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
                                                                         const Handle<CommandRecorder_t> &commandRecorderHandle,
                                                                         const RenderPassCommandRecorderWithDynamicRenderingOptions &options);
+    Handle<RenderPassCommandRecorder_t> createInheritedRenderPassCommandRecorder(const Handle<Device_t> &deviceHandle,
+                                                                                 const Handle<CommandRecorder_t> &commandRecorderHandle);
     void deleteRenderPassCommandRecorder(const Handle<RenderPassCommandRecorder_t> &handle);
     [[nodiscard]] VulkanRenderPassCommandRecorder *getRenderPassCommandRecorder(const Handle<RenderPassCommandRecorder_t> &handle) const;
 
@@ -187,11 +226,15 @@ public:
     // command pool (command recorder).
     // Yet we add the usual create/destroy functions to make it more consistent
     Handle<CommandBuffer_t> createCommandBuffer(const Handle<Device_t> &deviceHandle,
-                                                const QueueDescription &queueDescription,
+                                                VulkanThreadCommandPool *commandPool,
                                                 CommandBufferLevel commandLevel);
     void deleteCommandBuffer(const Handle<CommandBuffer_t> &handle);
     [[nodiscard]] VulkanCommandBuffer *getCommandBuffer(const Handle<CommandBuffer_t> &handle) const;
 
+    Handle<FrameCommandAllocator_t> createFrameCommandAllocator(const Handle<Device_t> &deviceHandle, const FrameCommandAllocatorOptions &options);
+    void deleteFrameCommandAllocator(const Handle<FrameCommandAllocator_t> &handle);
+    [[nodiscard]] VulkanFrameCommandAllocator *getFrameCommandAllocator(const Handle<FrameCommandAllocator_t> &handle) const;
+
     Handle<BindGroupPool_t> createBindGroupPool(const Handle<Device_t> &deviceHandle, const BindGroupPoolOptions &options);
     void deleteBindGroupPool(const Handle<BindGroupPool_t> &handle);
     [[nodiscard]] VulkanBindGroupPool *getBindGroupPool(const Handle<BindGroupPool_t> &handle) const;
@@ -237,6 +280,22 @@ private:
                                                                                                  const std::vector<RenderTargetOptions> &colorAttachments,
                                                                                                  const DepthStencilOptions &depthStencilAttachment,
                                                                                                  SampleCountFlagBits samples);
+
+    // Returns the description of queue, or of the first queue of the device if queue is not set
+    static QueueDescription *findQueueDescription(VulkanDevice *vulkanDevice, const Handle<Queue_t> &queue);
+
+    // Returns the command pool of the calling thread for a queue family, creating it on first use.
+    // Frees the command buffers other threads deleted in the meantime. The returned pool counts
+    // one more live command buffer, which the caller allocates or gives back on failure.
+    VulkanThreadCommandPool *threadCommandPool(VulkanDevice *vulkanDevice, uint32_t queueTypeIndex);
+
+    // Drops the attachment and render pass index entries of a framebuffer that left the device framebuffer cache
+    static void removeFramebufferIndexKeys(VulkanDevice *vulkanDevice,
+                                           const VulkanFramebufferKey &fbKey,
+                                           const Handle<TextureView_t> &skippedAttachment = {});
+    // Evicts the cached framebuffers created for a render pass evicted from the device render pass cache
+    void evictRenderPassFramebuffers(VulkanDevice *vulkanDevice, const Handle<RenderPass_t> &renderPass);
+
     struct ShaderStagesInfo {
         std::vector<VkPipelineShaderStageCreateInfo> shaderInfos;
         std::vector<VkSpecializationInfo> shaderSpecializationInfos;
@@ -265,6 +324,8 @@ private:
                                             const VulkanFramebufferKey &frameBufferKey);
     void deleteFramebuffer(const Handle<Framebuffer_t> &handle);
 
+    Handle<Buffer_t> importHostBuffer(VulkanDevice *vulkanDevice, const Handle<Device_t> &deviceHandle, const BufferOptions &options);
+
     static void setObjectName(VulkanDevice *device, VkObjectType type, uint64_t handle, std::string_view name);
 
     [[nodiscard]] static std::vector<std::string> getAvailableLayers();
@@ -274,38 +335,61 @@ private:
                                                                    const VmaAllocationInfo &allocationInfo,
                                                                    ExternalMemoryHandleTypeFlags handleType);
 
-    Pool<VulkanInstance, Instance_t> m_instances{ 1 };
-    Pool<VulkanAdapter, Adapter_t> m_adapters{ 1 };
-    Pool<VulkanDevice, Device_t> m_devices{ 1 };
-    Pool<VulkanQueue, Queue_t> m_queues{ 4 };
-    Pool<VulkanSurface, Surface_t> m_surfaces{ 1 };
-    Pool<VulkanSwapchain, Swapchain_t> m_swapchains{ 1 };
-    Pool<VulkanTexture, Texture_t> m_textures{ 128 };
-    Pool<VulkanTextureView, TextureView_t> m_textureViews{ 128 };
-    Pool<VulkanBuffer, Buffer_t> m_buffers{ 128 };
-    Pool<VulkanShaderModule, ShaderModule_t> m_shaderModules{ 64 };
-    Pool<VulkanPipelineLayout, PipelineLayout_t> m_pipelineLayouts{ 64 };
-    Pool<VulkanBindGroupLayout, BindGroupLayout_t> m_bindGroupLayouts{ 128 };
-    Pool<VulkanBindGroup, BindGroup_t> m_bindGroups{ 128 };
-    Pool<VulkanBindGroupPool, BindGroupPool_t> m_bindGroupPools{ 4 };
-    Pool<VulkanGraphicsPipeline, GraphicsPipeline_t> m_graphicsPipelines{ 64 };
-    Pool<VulkanComputePipeline, ComputePipeline_t> m_computePipelines{ 64 };
-    Pool<VulkanRayTracingPipeline, RayTracingPipeline_t> m_rayTracingPipelines{ 64 };
-    Pool<VulkanGpuSemaphore, GpuSemaphore_t> m_gpuSemaphores{ 32 };
-    Pool<VulkanTimelineSemaphore, TimelineSemaphore_t> m_timelineSemaphores{ 32 };
-    Pool<VulkanCommandRecorder, CommandRecorder_t> m_commandRecorders{ 32 };
-    Pool<VulkanRenderPassCommandRecorder, RenderPassCommandRecorder_t> m_renderPassCommandRecorders{ 32 };
-    Pool<VulkanComputePassCommandRecorder, ComputePassCommandRecorder_t> m_computePassCommandRecorders{ 32 };
-    Pool<VulkanRayTracingPassCommandRecorder, RayTracingPassCommandRecorder_t> m_rayTracingPassCommandRecorders{ 32 };
-    Pool<VulkanCommandBuffer, CommandBuffer_t> m_commandBuffers{ 128 };
-    Pool<VulkanRenderPass, RenderPass_t> m_renderPasses{ 16 };
-    Pool<VulkanPipelineCache, PipelineCache_t> m_pipelineCaches{ 4 };
-    Pool<VulkanFramebuffer, Framebuffer_t> m_framebuffers{ 16 };
-    Pool<VulkanSampler, Sampler_t> m_samplers{ 16 };
-    Pool<VulkanFence, Fence_t> m_fences{ 16 };
-    Pool<VulkanTimestampQueryRecorder, TimestampQueryRecorder_t> m_timestampQueryRecorders{ 4 };
-    Pool<VulkanAccelerationStructure, AccelerationStructure_t> m_accelerationStructures{ 32 };
-    Pool<VulkanYCbCrConversion, YCbCrConversion_t> m_yCbCrConversions{ 16 };
+    VulkanResourcePool<VulkanInstance, Instance_t> m_instances{ 1 };
+    VulkanResourcePool<VulkanAdapter, Adapter_t> m_adapters{ 1 };
+    VulkanResourcePool<VulkanDevice, Device_t> m_devices{ 1 };
+    VulkanResourcePool<VulkanQueue, Queue_t> m_queues{ 4 };
+    VulkanResourcePool<VulkanSurface, Surface_t> m_surfaces{ 1 };
+    VulkanResourcePool<VulkanSwapchain, Swapchain_t> m_swapchains{ 1 };
+    VulkanStableResourcePool<VulkanTexture, Texture_t> m_textures{ 128 };
+    VulkanStableResourcePool<VulkanTextureView, TextureView_t> m_textureViews{ 128 };
+    VulkanStableResourcePool<VulkanBuffer, Buffer_t> m_buffers{ 128 };
+    VulkanResourcePool<VulkanShaderModule, ShaderModule_t> m_shaderModules{ 64 };
+    VulkanResourcePool<VulkanPipelineLayout, PipelineLayout_t> m_pipelineLayouts{ 64 };
+    VulkanResourcePool<VulkanBindGroupLayout, BindGroupLayout_t> m_bindGroupLayouts{ 128 };
+    VulkanResourcePool<VulkanBindGroup, BindGroup_t> m_bindGroups{ 128 };
+    VulkanResourcePool<VulkanBindGroupPool, BindGroupPool_t> m_bindGroupPools{ 4 };
+    VulkanResourcePool<VulkanGraphicsPipeline, GraphicsPipeline_t> m_graphicsPipelines{ 64 };
+    VulkanResourcePool<VulkanComputePipeline, ComputePipeline_t> m_computePipelines{ 64 };
+    VulkanResourcePool<VulkanRayTracingPipeline, RayTracingPipeline_t> m_rayTracingPipelines{ 64 };
+    VulkanResourcePool<VulkanGpuSemaphore, GpuSemaphore_t> m_gpuSemaphores{ 32 };
+    VulkanResourcePool<VulkanTimelineSemaphore, TimelineSemaphore_t> m_timelineSemaphores{ 32 };
+    VulkanResourcePool<VulkanCommandRecorder, CommandRecorder_t> m_commandRecorders{ 32 };
+    VulkanResourcePool<VulkanRenderPassCommandRecorder, RenderPassCommandRecorder_t> m_renderPassCommandRecorders{ 32 };
+    VulkanResourcePool<VulkanComputePassCommandRecorder, ComputePassCommandRecorder_t> m_computePassCommandRecorders{ 32 };
+    VulkanResourcePool<VulkanRayTracingPassCommandRecorder, RayTracingPassCommandRecorder_t> m_rayTracingPassCommandRecorders{ 32 };
+    VulkanResourcePool<VulkanCommandBuffer, CommandBuffer_t> m_commandBuffers{ 128 };
+    VulkanResourcePool<VulkanFrameCommandAllocator, FrameCommandAllocator_t> m_frameCommandAllocators{ 4 };
+    VulkanResourcePool<VulkanRenderPass, RenderPass_t> m_renderPasses{ 16 };
+    VulkanResourcePool<VulkanPipelineCache, PipelineCache_t> m_pipelineCaches{ 4 };
+    VulkanResourcePool<VulkanFramebuffer, Framebuffer_t> m_framebuffers{ 16 };
+    VulkanResourcePool<VulkanSampler, Sampler_t> m_samplers{ 16 };
+    VulkanResourcePool<VulkanFence, Fence_t> m_fences{ 16 };
+    VulkanResourcePool<VulkanTimestampQueryRecorder, TimestampQueryRecorder_t> m_timestampQueryRecorders{ 4 };
+    VulkanResourcePool<VulkanAccelerationStructure, AccelerationStructure_t> m_accelerationStructures{ 32 };
+    VulkanResourcePool<VulkanYCbCrConversion, YCbCrConversion_t> m_yCbCrConversions{ 16 };
+
+    // Guards per device state shared by resource creation and deletion
+    // (internal descriptor pools, external memory allocators). Only an
+    // actual mutex when built with KDGPU_CONCURRENT_RESOURCE_MANAGER.
+    VulkanResourceMutex m_deviceStateMutex;
+
+    // Guards the per device pipeline deduplication caches. Held while a cached
+    // pipeline is created so that concurrent requests for it don't race.
+    VulkanResourceMutex m_pipelineDeduplicationMutex;
+
+    // Guards the per device shader module deduplication caches
+    VulkanResourceMutex m_shaderModuleDeduplicationMutex;
+
+    // Guards the per device sampler and bind group layout deduplication caches
+    VulkanResourceMutex m_objectDeduplicationMutex;
+
+    // Guards the per device render pass and framebuffer caches and the framebuffer attachment index
+    VulkanResourceMutex m_renderTargetCacheMutex;
+
+    // Guards the per device maps of per thread command pools and their pending frees
+    VulkanResourceMutex m_commandPoolsMutex;
+
     struct TimestampQueryBucket {
         uint32_t start;
         uint32_t count;
@@ -238,6 +238,7 @@ bool ImGuiRenderer::updateGeometryBuffers(uint32_t inFlightIndex)
                 .size = vertexBufferSize,
                 .usage = BufferUsageFlagBits::VertexBufferBit,
                 .memoryUsage = MemoryUsage::CpuToGpu,
+                .persistentlyMapped = true,
         });
         m_mesh->vertexCount = imDrawData->TotalVtxCount;
     }
@@ -249,13 +250,14 @@ bool ImGuiRenderer::updateGeometryBuffers(uint32_t inFlightIndex)
                 .size = indexBufferSize,
                 .usage = BufferUsageFlagBits::IndexBufferBit,
                 .memoryUsage = MemoryUsage::CpuToGpu,
+                .persistentlyMapped = true,
         });
         m_mesh->indexCount = imDrawData->TotalIdxCount;
     }
 
     // Upload data
-    ImDrawVert *vtxDst = static_cast<ImDrawVert *>(m_mesh->vertices.map());
-    ImDrawIdx *idxDst = static_cast<ImDrawIdx *>(m_mesh->indexBuffer.map());
+    ImDrawVert *vtxDst = static_cast<ImDrawVert *>(m_mesh->vertices.mappedPointer());
+    ImDrawIdx *idxDst = static_cast<ImDrawIdx *>(m_mesh->indexBuffer.mappedPointer());
 
     for (int n = 0; n < imDrawData->CmdListsCount; n++) {
         const ImDrawList *cmd_list = imDrawData->CmdLists[n];
@@ -265,9 +267,9 @@ bool ImGuiRenderer::updateGeometryBuffers(uint32_t inFlightIndex)
         idxDst += cmd_list->IdxBuffer.Size;
     }
 
-    // Flush
-    m_mesh->vertices.unmap();
-    m_mesh->indexBuffer.unmap();
+    // Flush the written ranges, the buffers stay mapped
+    m_mesh->vertices.flush(0, vertexBufferSize);
+    m_mesh->indexBuffer.flush(0, indexBufferSize);
 
     return m_mesh->vertexCount != 0;
 }
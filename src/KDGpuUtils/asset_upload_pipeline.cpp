@@ -0,0 +1,448 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/asset_upload_pipeline.h>
+
+#include <KDGpu/adapter.h>
+#include <KDGpu/adapter_properties.h>
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/memory_barrier.h>
+#include <KDGpu/queue.h>
+
+#include <KDUtils/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iterator>
+#include <numeric>
+
+namespace KDGpuUtils {
+
+namespace {
+
+KDGpu::DeviceSize alignUp(KDGpu::DeviceSize value, KDGpu::DeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+KDGpu::TextureSubresourceRange mipRange(const KDGpu::TextureOptions &options, uint32_t baseMipLevel, uint32_t levelCount)
+{
+    return KDGpu::TextureSubresourceRange{
+        .aspectMask = KDGpu::TextureAspectFlagBits::ColorBit,
+        .baseMipLevel = baseMipLevel,
+        .levelCount = levelCount,
+        .layerCount = options.arrayLayers,
+    };
+}
+
+} // namespace
+
+AssetUploadPipeline::DecodeContext::DecodeContext(AssetUploadPipeline *pipeline)
+    : m_pipeline(pipeline)
+{
+}
+
+void *AssetUploadPipeline::DecodeContext::allocate(KDGpu::DeviceSize byteSize)
+{
+    if (m_staging.chunk)
+        m_pipeline->releaseStaging(m_staging);
+    m_staging = m_pipeline->allocateStaging(byteSize);
+    return m_staging.chunk ? m_staging.chunk->mapped + m_staging.offset : nullptr;
+}
+
+AssetUploadPipeline::AssetUploadPipeline(KDGpu::Device *device, KDGpu::Queue *queue, const AssetUploadPipelineOptions &options)
+    : m_device(device)
+    , m_queue(queue)
+    , m_options(options)
+    , m_mipMapGenerator(device)
+{
+    // Copy offsets have to be a multiple of the texel block size, 96 is one of every size up to 32 bytes
+    const KDGpu::DeviceSize optimalAlignment = m_device->adapter()->properties().limits.optimalBufferCopyOffsetAlignment;
+    m_stagingAlignment = std::lcm<KDGpu::DeviceSize>(96, std::max<KDGpu::DeviceSize>(optimalAlignment, 1));
+
+    const uint32_t workerThreadCount = std::max(m_options.workerThreadCount, 1U);
+    m_workers.reserve(workerThreadCount);
+    for (uint32_t i = 0; i < workerThreadCount; ++i)
+        m_workers.emplace_back([this] { runWorkerThread(); });
+    m_submitThread = std::thread([this] { runSubmitThread(); });
+}
+
+AssetUploadPipeline::~AssetUploadPipeline()
+{
+    // Workers finish their queued decodes before the submit thread is told to stop
+    {
+        std::lock_guard lock(m_mutex);
+        m_stoppingWorkers = true;
+    }
+    m_jobAvailable.notify_all();
+    for (std::thread &worker : m_workers)
+        worker.join();
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_submitWorkAvailable.notify_all();
+    m_submitThread.join();
+}
+
+std::future<KDGpu::Texture> AssetUploadPipeline::loadTexture(Decoder decoder)
+{
+    auto promise = std::make_shared<std::promise<KDGpu::Texture>>();
+    std::future<KDGpu::Texture> future = promise->get_future();
+    loadTexture(std::move(decoder), [promise](KDGpu::Texture &&texture) {
+        promise->set_value(std::move(texture));
+    });
+    return future;
+}
+
+void AssetUploadPipeline::loadTexture(Decoder decoder, CompletionCallback onCompleted)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_pendingCount;
+        m_jobs.push_back(DecodeJob{ .decoder = std::move(decoder), .onCompleted = std::move(onCompleted) });
+    }
+    m_jobAvailable.notify_one();
+}
+
+void AssetUploadPipeline::waitForIdle()
+{
+    std::unique_lock lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_pendingCount == 0; });
+}
+
+size_t AssetUploadPipeline::pendingCount() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_pendingCount;
+}
+
+size_t AssetUploadPipeline::stagingChunkCount() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_stagingChunks.size();
+}
+
+AssetUploadPipeline::StagingAllocation AssetUploadPipeline::allocateStaging(KDGpu::DeviceSize byteSize)
+{
+    std::unique_lock lock(m_mutex);
+
+    for (StagingChunk &chunk : m_stagingChunks) {
+        const KDGpu::DeviceSize offset = alignUp(chunk.head, m_stagingAlignment);
+        if (offset + byteSize <= chunk.capacity) {
+            chunk.head = offset + byteSize;
+            ++chunk.liveAllocations;
+            return StagingAllocation{ .chunk = &chunk, .offset = offset, .size = byteSize };
+        }
+    }
+
+    // Buffers are only created on the submit thread, which hands back a new chunk
+    StagingRequest request{ .byteSize = byteSize };
+    m_stagingRequests.push_back(&request);
+    m_submitWorkAvailable.notify_one();
+    m_stagingServed.wait(lock, [&request] { return request.served; });
+    return request.allocation;
+}
+
+void AssetUploadPipeline::releaseStaging(const StagingAllocation &allocation)
+{
+    std::lock_guard lock(m_mutex);
+    StagingChunk *chunk = allocation.chunk;
+    // Drained chunks are reused from the start until the submit thread frees them
+    if (--chunk->liveAllocations == 0)
+        chunk->head = 0;
+}
+
+void AssetUploadPipeline::serveStagingRequests(std::unique_lock<std::mutex> &lock)
+{
+    if (m_stagingRequests.empty())
+        return;
+
+    while (!m_stagingRequests.empty()) {
+        StagingRequest *request = m_stagingRequests.front();
+        m_stagingRequests.pop_front();
+
+        // Assets larger than a chunk get a chunk of their own
+        const KDGpu::DeviceSize capacity = std::max(m_options.stagingChunkSize, request->byteSize);
+        lock.unlock();
+        KDGpu::Buffer buffer = m_device->createBuffer(KDGpu::BufferOptions{
+                .label = "AssetUploadPipeline",
+                .size = capacity,
+                .usage = KDGpu::BufferUsageFlagBits::TransferSrcBit,
+                .memoryUsage = KDGpu::MemoryUsage::CpuOnly,
+                .persistentlyMapped = true,
+        });
+        auto *mapped = static_cast<uint8_t *>(buffer.mappedPointer());
+        lock.lock();
+
+        if (mapped) {
+            StagingChunk &chunk = m_stagingChunks.emplace_back(StagingChunk{
+                    .buffer = std::move(buffer),
+                    .mapped = mapped,
+                    .capacity = capacity,
+                    .head = request->byteSize,
+                    .liveAllocations = 1,
+            });
+            request->allocation = StagingAllocation{ .chunk = &chunk, .offset = 0, .size = request->byteSize };
+        } else {
+            SPDLOG_WARN("AssetUploadPipeline: unable to map a staging buffer of {} bytes", capacity);
+        }
+        request->served = true;
+    }
+    m_stagingServed.notify_all();
+}
+
+void AssetUploadPipeline::freeDrainedStagingChunks()
+{
+    // The first chunk is kept for the next assets. Others only served a burst of assets,
+    // or a single large one, and are given back once drained.
+    std::list<StagingChunk> drained;
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto it = m_stagingChunks.begin(); it != m_stagingChunks.end();) {
+            const auto next = std::next(it);
+            const bool kept = it == m_stagingChunks.begin() && it->capacity == m_options.stagingChunkSize;
+            if (it->liveAllocations == 0 && !kept)
+                drained.splice(drained.end(), m_stagingChunks, it);
+            it = next;
+        }
+    }
+    // Their buffers are destroyed here, outside of the lock
+}
+
+void AssetUploadPipeline::runWorkerThread()
+{
+    while (true) {
+        DecodeJob job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_jobAvailable.wait(lock, [this] { return m_stoppingWorkers || !m_jobs.empty(); });
+            if (m_jobs.empty())
+                return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        decode(job);
+    }
+}
+
+void AssetUploadPipeline::decode(DecodeJob &job)
+{
+    DecodeContext context(this);
+    bool decoded = false;
+    try {
+        decoded = job.decoder(context);
+    } catch (const std::exception &e) {
+        SPDLOG_WARN("AssetUploadPipeline: decoder failed with an exception: {}", e.what());
+    } catch (...) {
+        SPDLOG_WARN("AssetUploadPipeline: decoder failed with an exception");
+    }
+    if (!decoded && context.m_staging.chunk) {
+        releaseStaging(context.m_staging);
+        context.m_staging = {};
+    }
+
+    // Failed decodes go through the submit thread too, so that every completion is reported from there
+    {
+        std::lock_guard lock(m_mutex);
+        m_decoded.push_back(DecodedTexture{
+                .options = context.textureOptions,
+                .staging = context.m_staging,
+                .onCompleted = std::move(job.onCompleted),
+        });
+    }
+    m_submitWorkAvailable.notify_one();
+}
+
+void AssetUploadPipeline::runSubmitThread()
+{
+    const size_t maxBatchesInFlight = std::max(m_options.maxBatchesInFlight, 1U);
+
+    while (true) {
+        retireBatches();
+
+        std::vector<DecodedTexture> batch;
+        {
+            std::unique_lock lock(m_mutex);
+            const auto hasWork = [this, maxBatchesInFlight] {
+                return !m_stagingRequests.empty() || (!m_decoded.empty() && m_inFlightBatches.size() < maxBatchesInFlight);
+            };
+            if (m_inFlightBatches.empty())
+                m_submitWorkAvailable.wait(lock, [this, &hasWork] { return m_stopping || hasWork(); });
+            else // Polls the fences of the batches in flight meanwhile
+                m_submitWorkAvailable.wait_for(lock, std::chrono::milliseconds(1), hasWork);
+
+            serveStagingRequests(lock);
+
+            if (m_stopping && m_decoded.empty() && m_inFlightBatches.empty())
+                return;
+
+            if (m_inFlightBatches.size() < maxBatchesInFlight) {
+                // Take everything decoded meanwhile, up to maxBatchSize
+                const size_t count = std::min(m_decoded.size(), std::max<size_t>(m_options.maxBatchSize, 1));
+                batch.reserve(count);
+                std::move(m_decoded.begin(), m_decoded.begin() + count, std::back_inserter(batch));
+                m_decoded.erase(m_decoded.begin(), m_decoded.begin() + count);
+            }
+        }
+
+        if (!batch.empty())
+            upload(std::move(batch));
+    }
+}
+
+void AssetUploadPipeline::retireBatches()
+{
+    // Batches are submitted to a single queue, so their fences signal in order
+    while (!m_inFlightBatches.empty()) {
+        InFlightBatch &batch = m_inFlightBatches.front();
+        if (batch.fence.status() != KDGpu::FenceStatus::Signalled)
+            return;
+        complete(batch.decoded, batch.textures);
+        m_inFlightBatches.pop_front();
+    }
+}
+
+void AssetUploadPipeline::complete(std::vector<DecodedTexture> &decoded, std::vector<KDGpu::Texture> &textures)
+{
+    for (const DecodedTexture &texture : decoded) {
+        if (texture.staging.chunk)
+            releaseStaging(texture.staging);
+    }
+    // Before reporting completion, so that callers see the staging memory given back
+    freeDrainedStagingChunks();
+
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        if (decoded[i].onCompleted)
+            decoded[i].onCompleted(std::move(textures[i]));
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_pendingCount -= decoded.size();
+    }
+    m_idle.notify_all();
+}
+
+void AssetUploadPipeline::upload(std::vector<DecodedTexture> &&batch)
+{
+    const bool canBlit = m_queue->flags().testFlag(KDGpu::QueueFlagBits::GraphicsBit);
+    const bool canDispatch = m_queue->flags().testFlag(KDGpu::QueueFlagBits::ComputeBit);
+
+    std::vector<KDGpu::Texture> textures(batch.size());
+    std::vector<KDGpu::TextureMemoryBarrierOptions> toTransferDst;
+    std::vector<MipMapGenerationTarget> mipMapTargets;
+    toTransferDst.reserve(batch.size());
+    mipMapTargets.reserve(batch.size());
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        DecodedTexture &decoded = batch[i];
+        if (!decoded.staging.chunk)
+            continue;
+
+        KDGpu::TextureOptions &options = decoded.options;
+        options.mipLevels = std::max(options.mipLevels, 1U);
+        const MipMapMethod mipMapMethod = options.mipLevels > 1 ? m_mipMapGenerator.method(options.format, options.tiling) : MipMapMethod::Unsupported;
+        if (options.mipLevels > 1 &&
+            !(mipMapMethod == MipMapMethod::Blit && canBlit) &&
+            !(mipMapMethod == MipMapMethod::Compute && canDispatch && options.extent.depth == 1)) {
+            SPDLOG_WARN("AssetUploadPipeline: unable to generate mip levels, uploading the first one only");
+            options.mipLevels = 1;
+        }
+        options.usage |= KDGpu::TextureUsageFlagBits::TransferDstBit;
+        if (options.mipLevels > 1 && mipMapMethod == MipMapMethod::Blit)
+            options.usage |= KDGpu::TextureUsageFlagBits::TransferSrcBit;
+        else if (options.mipLevels > 1)
+            options.usage |= KDGpu::TextureUsageFlagBits::SampledBit | KDGpu::TextureUsageFlagBits::StorageBit;
+
+        textures[i] = m_device->createTexture(options);
+        decoded.staging.chunk->buffer.flush(decoded.staging.offset, decoded.staging.size);
+
+        toTransferDst.push_back(KDGpu::TextureMemoryBarrierOptions{
+                .srcStages = KDGpu::PipelineStageFlagBit::TopOfPipeBit,
+                .dstStages = KDGpu::PipelineStageFlagBit::TransferBit,
+                .dstMask = KDGpu::AccessFlagBit::TransferWriteBit,
+                .oldLayout = KDGpu::TextureLayout::Undefined,
+                .newLayout = KDGpu::TextureLayout::TransferDstOptimal,
+                .texture = textures[i],
+                .range = mipRange(options, 0, 1),
+        });
+    }
+
+    // Nothing to submit if every decode of the batch failed
+    if (toTransferDst.empty()) {
+        complete(batch, textures);
+        return;
+    }
+
+    KDGpu::CommandRecorder commandRecorder = m_device->createCommandRecorder(KDGpu::CommandRecorderOptions{
+            .queue = m_queue->handle(),
+    });
+    commandRecorder.textureMemoryBarriers(toTransferDst);
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const DecodedTexture &decoded = batch[i];
+        if (!decoded.staging.chunk)
+            continue;
+
+        const KDGpu::TextureOptions &options = decoded.options;
+        commandRecorder.copyBufferToTexture(KDGpu::BufferToTextureCopy{
+                .srcBuffer = decoded.staging.chunk->buffer,
+                .dstTexture = textures[i],
+                .dstTextureLayout = KDGpu::TextureLayout::TransferDstOptimal,
+                .regions = {
+                        {
+                                .bufferOffset = decoded.staging.offset,
+                                .textureSubResource = {
+                                        .aspectMask = KDGpu::TextureAspectFlagBits::ColorBit,
+                                        .layerCount = options.arrayLayers,
+                                },
+                                .textureExtent = options.extent,
+                        },
+                },
+        });
+
+        mipMapTargets.push_back(MipMapGenerationTarget{
+                .texture = &textures[i],
+                .format = options.format,
+                .tiling = options.tiling,
+                .extent = options.extent,
+                .mipLevels = options.mipLevels,
+                .arrayLayers = options.arrayLayers,
+                .oldLayout = KDGpu::TextureLayout::TransferDstOptimal,
+                .newLayout = m_options.finalLayout,
+        });
+    }
+
+    // Generates the remaining mip levels of all textures together, or only transitions them
+    MipMapGenerationResources mipMapResources = m_mipMapGenerator.record(commandRecorder, mipMapTargets);
+
+    KDGpu::CommandBuffer commandBuffer = commandRecorder.finish();
+    KDGpu::Fence fence = m_device->createFence(KDGpu::FenceOptions{ .createSignalled = false });
+    m_queue->submit(KDGpu::SubmitOptions{
+            .commandBuffers = { commandBuffer },
+            .signalFence = fence,
+    });
+
+    // Kept alive, along with the staging memory, until the fence signalled
+    m_inFlightBatches.push_back(InFlightBatch{
+            .fence = std::move(fence),
+            .commandBuffer = std::move(commandBuffer),
+            .mipMapResources = std::move(mipMapResources),
+            .textures = std::move(textures),
+            .decoded = std::move(batch),
+    });
+}
+
+} // namespace KDGpuUtils
@@ -0,0 +1,204 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+#include <KDGpuUtils/mip_map_generator.h>
+
+#include <KDGpu/buffer.h>
+#include <KDGpu/command_buffer.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/gpu_core.h>
+#include <KDGpu/texture.h>
+#include <KDGpu/texture_options.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace KDGpu {
+class Device;
+class Queue;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+struct AssetUploadPipelineOptions {
+    // Leaves one core to the thread that keeps rendering the loading screen
+    uint32_t workerThreadCount{ std::max(std::thread::hardware_concurrency(), 2U) - 1 };
+    KDGpu::DeviceSize stagingChunkSize{ 32 * 1024 * 1024 };
+    // Decoded textures uploaded by a single submission at most
+    size_t maxBatchSize{ 64 };
+    // Submitted batches waiting for the GPU before the next one is held back
+    uint32_t maxBatchesInFlight{ 2 };
+    KDGpu::TextureLayout finalLayout{ KDGpu::TextureLayout::ShaderReadOnlyOptimal };
+};
+
+/**
+ * @brief Decodes textures on worker threads and uploads them in batches
+ *
+ * Decoders run on a pool of worker threads and write the texels of the first mip level
+ * straight into staging memory from DecodeContext::allocate(). A single submit thread
+ * creates the textures of all decoded assets available, records their copies and the
+ * generation of their remaining mip levels into one command buffer and submits it to
+ * the queue. Decoding and recording carry on while up to maxBatchesInFlight batches are
+ * being uploaded, each is retired once its fence signalled.
+ *
+ * Completion is reported per asset through the returned future or the callback, both
+ * are fulfilled on the submit thread. Failed decodes, including decoders throwing an
+ * exception, produce an invalid Texture.
+ *
+ * Only color textures are supported. Mip levels are generated by a MipMapGenerator,
+ * blits need a queue supporting graphics and the compute path one supporting compute,
+ * otherwise textures get a single mip level. The queue must not be submitted to by
+ * other threads meanwhile; a second queue of the graphics type avoids both the locking
+ * and queue family ownership transfers.
+ *
+ * Every resource is created and destroyed on the submit thread, workers ask it for staging
+ * chunks when the existing ones are full. Other threads creating resources on the same
+ * Device meanwhile still requires KDGPU_CONCURRENT_RESOURCE_MANAGER.
+ *
+ * Staging memory is allocated in chunks of stagingChunkSize bytes. The first one is kept
+ * for the next assets once drained, the others are freed, along with the dedicated chunks
+ * of assets larger than that.
+ *
+ * Destroying the pipeline completes all queued assets first.
+ */
+class KDGPUUTILS_EXPORT AssetUploadPipeline
+{
+private:
+    struct StagingChunk {
+        KDGpu::Buffer buffer;
+        uint8_t *mapped{ nullptr };
+        KDGpu::DeviceSize capacity{ 0 };
+        KDGpu::DeviceSize head{ 0 };
+        size_t liveAllocations{ 0 };
+    };
+
+    struct StagingAllocation {
+        StagingChunk *chunk{ nullptr };
+        KDGpu::DeviceSize offset{ 0 };
+        KDGpu::DeviceSize size{ 0 };
+    };
+
+public:
+    class KDGPUUTILS_EXPORT DecodeContext
+    {
+    public:
+        // Thread safe. Returns staging memory for byteSize bytes of tightly packed texels,
+        // or nullptr when none could be allocated. Only the last allocation is uploaded.
+        void *allocate(KDGpu::DeviceSize byteSize);
+
+        // Set by the decoder. mipLevels beyond the first are generated.
+        KDGpu::TextureOptions textureOptions;
+
+    private:
+        explicit DecodeContext(AssetUploadPipeline *pipeline);
+
+        AssetUploadPipeline *m_pipeline{ nullptr };
+        StagingAllocation m_staging;
+
+        friend class AssetUploadPipeline;
+    };
+
+    // Returns false when decoding failed
+    using Decoder = std::function<bool(DecodeContext &context)>;
+    using CompletionCallback = std::function<void(KDGpu::Texture &&texture)>;
+
+    AssetUploadPipeline(KDGpu::Device *device, KDGpu::Queue *queue, const AssetUploadPipelineOptions &options = {});
+    ~AssetUploadPipeline();
+
+    AssetUploadPipeline(const AssetUploadPipeline &) = delete;
+    AssetUploadPipeline &operator=(const AssetUploadPipeline &) = delete;
+
+    std::future<KDGpu::Texture> loadTexture(Decoder decoder);
+    void loadTexture(Decoder decoder, CompletionCallback onCompleted);
+
+    // Blocks until every asset loaded so far completed
+    void waitForIdle();
+
+    size_t pendingCount() const;
+    size_t stagingChunkCount() const;
+
+private:
+    struct DecodeJob {
+        Decoder decoder;
+        CompletionCallback onCompleted;
+    };
+
+    struct DecodedTexture {
+        KDGpu::TextureOptions options;
+        StagingAllocation staging;
+        CompletionCallback onCompleted;
+    };
+
+    // Posted by a worker, which waits until the submit thread created the chunk
+    struct StagingRequest {
+        KDGpu::DeviceSize byteSize{ 0 };
+        StagingAllocation allocation;
+        bool served{ false };
+    };
+
+    struct InFlightBatch {
+        KDGpu::Fence fence;
+        KDGpu::CommandBuffer commandBuffer;
+        MipMapGenerationResources mipMapResources;
+        std::vector<KDGpu::Texture> textures;
+        std::vector<DecodedTexture> decoded;
+    };
+
+    StagingAllocation allocateStaging(KDGpu::DeviceSize byteSize);
+    void releaseStaging(const StagingAllocation &allocation);
+    void serveStagingRequests(std::unique_lock<std::mutex> &lock);
+    void freeDrainedStagingChunks();
+
+    void runWorkerThread();
+    void decode(DecodeJob &job);
+    void runSubmitThread();
+    void upload(std::vector<DecodedTexture> &&batch);
+    void retireBatches();
+    void complete(std::vector<DecodedTexture> &decoded, std::vector<KDGpu::Texture> &textures);
+
+    KDGpu::Device *m_device{ nullptr };
+    KDGpu::Queue *m_queue{ nullptr };
+    AssetUploadPipelineOptions m_options;
+    KDGpu::DeviceSize m_stagingAlignment{ 1 };
+    MipMapGenerator m_mipMapGenerator;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_submitWorkAvailable;
+    std::condition_variable m_stagingServed;
+    std::condition_variable m_idle;
+    std::deque<DecodeJob> m_jobs;
+    std::deque<DecodedTexture> m_decoded;
+    std::deque<StagingRequest *> m_stagingRequests;
+    // A list, so that allocations keep pointing to their chunk while drained ones are freed
+    std::list<StagingChunk> m_stagingChunks;
+    size_t m_pendingCount{ 0 };
+    bool m_stoppingWorkers{ false };
+    bool m_stopping{ false };
+
+    // Only touched by the submit thread
+    std::deque<InFlightBatch> m_inFlightBatches;
+
+    std::vector<std::thread> m_workers;
+    std::thread m_submitThread;
+};
+
+} // namespace KDGpuUtils
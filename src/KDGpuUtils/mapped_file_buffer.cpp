@@ -0,0 +1,264 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/mapped_file_buffer.h>
+
+#include <KDGpu/adapter.h>
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/device.h>
+
+#include <KDUtils/logging.h>
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace KDGpuUtils {
+
+namespace {
+
+KDGpu::DeviceSize alignDown(KDGpu::DeviceSize value, KDGpu::DeviceSize alignment)
+{
+    return value - value % alignment;
+}
+
+KDGpu::DeviceSize alignUp(KDGpu::DeviceSize value, KDGpu::DeviceSize alignment)
+{
+    return alignDown(value + alignment - 1, alignment);
+}
+
+// Granularity of the file offsets a mapping can start at
+KDGpu::DeviceSize mappingGranularity()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwAllocationGranularity;
+#else
+    return static_cast<KDGpu::DeviceSize>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Usages through which the device only ever reads the buffer. The file mapping is read only
+// and private, anything else has to be given a copy of the region.
+bool isReadOnlyUsage(KDGpu::BufferUsageFlags usage)
+{
+    const KDGpu::BufferUsageFlags readOnlyUsages = KDGpu::BufferUsageFlagBits::TransferSrcBit |
+            KDGpu::BufferUsageFlagBits::UniformTexelBufferBit |
+            KDGpu::BufferUsageFlagBits::UniformBufferBit |
+            KDGpu::BufferUsageFlagBits::IndexBufferBit |
+            KDGpu::BufferUsageFlagBits::VertexBufferBit |
+            KDGpu::BufferUsageFlagBits::IndirectBufferBit |
+            KDGpu::BufferUsageFlagBits::ConditionalRenderingBit |
+            KDGpu::BufferUsageFlagBits::AccelerationStructureBuildInputReadOnlyBit |
+            KDGpu::BufferUsageFlagBits::MicromapBuildInputReadOnlyBit |
+            KDGpu::BufferUsageFlagBits::VideoDecodeSrcBit |
+            KDGpu::BufferUsageFlagBits::VideoEncodeSrcBit;
+    return (usage.toInt() & ~readOnlyUsages.toInt()) == 0;
+}
+
+void *mapFile(const std::filesystem::path &path, KDGpu::DeviceSize offset, size_t size)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *view = nullptr;
+    if (mapping) {
+        view = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset & 0xffffffff), size);
+        // The view keeps the mapping alive
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    return view;
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(offset));
+    close(fd);
+    return view == MAP_FAILED ? nullptr : view;
+#endif
+}
+
+void unmapFile(void *mapping, size_t size)
+{
+#if defined(_WIN32)
+    UnmapViewOfFile(mapping);
+#else
+    munmap(mapping, size);
+#endif
+}
+
+} // namespace
+
+MappedFileBuffer::MappedFileBuffer(KDGpu::Device *device, const MappedFileBufferOptions &options)
+{
+    std::error_code error;
+    const KDGpu::DeviceSize fileSize = std::filesystem::file_size(options.path, error);
+    if (error || options.offset > fileSize) {
+        SPDLOG_WARN("MappedFileBuffer: unable to read {} from offset {}", options.path.string(), options.offset);
+        return;
+    }
+
+    m_size = options.size == KDGpu::WholeSize ? fileSize - options.offset : options.size;
+    if (m_size == 0 || options.offset + m_size > fileSize) {
+        SPDLOG_WARN("MappedFileBuffer: {} bytes at offset {} are outside of {}", m_size, options.offset, options.path.string());
+        m_size = 0;
+        return;
+    }
+
+    if (options.allowImport && importRegion(device, options, fileSize))
+        return;
+    if (!readRegion(device, options))
+        m_size = 0;
+}
+
+MappedFileBuffer::~MappedFileBuffer()
+{
+    release();
+}
+
+MappedFileBuffer::MappedFileBuffer(MappedFileBuffer &&other) noexcept
+    : m_buffer(std::move(other.m_buffer))
+    , m_mapping(std::exchange(other.m_mapping, nullptr))
+    , m_mappingSize(std::exchange(other.m_mappingSize, 0))
+    , m_offset(std::exchange(other.m_offset, 0))
+    , m_size(std::exchange(other.m_size, 0))
+{
+}
+
+MappedFileBuffer &MappedFileBuffer::operator=(MappedFileBuffer &&other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_buffer = std::move(other.m_buffer);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_mappingSize = std::exchange(other.m_mappingSize, 0);
+        m_offset = std::exchange(other.m_offset, 0);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+bool MappedFileBuffer::importRegion(KDGpu::Device *device, const MappedFileBufferOptions &options, KDGpu::DeviceSize fileSize)
+{
+    if (!isReadOnlyUsage(options.usage)) {
+        SPDLOG_WARN("MappedFileBuffer: usage {:#x} can write to the buffer, reading {} instead of importing it",
+                    options.usage.toInt(), options.path.string());
+        return false;
+    }
+
+    const KDGpu::DeviceSize importAlignment = device->adapter()->properties().externalMemoryHostProperties.minImportedHostPointerAlignment;
+    if (importAlignment == 0)
+        return false;
+
+    // Mappings start at aligned file offsets and the imported size has to be aligned as well
+    const KDGpu::DeviceSize granularity = mappingGranularity();
+    const KDGpu::DeviceSize alignment = std::max(importAlignment, granularity);
+    const KDGpu::DeviceSize mappingOffset = alignDown(options.offset, alignment);
+    const KDGpu::DeviceSize mappingEnd = alignUp(options.offset + m_size, alignment);
+
+    // Pages past the end of the file cannot be accessed, only the tail of the last one is zero filled
+#if defined(_WIN32)
+    const KDGpu::DeviceSize mappableEnd = fileSize;
+#else
+    const KDGpu::DeviceSize mappableEnd = alignUp(fileSize, granularity);
+#endif
+    if (mappingEnd > mappableEnd)
+        return false;
+
+    const auto mappingSize = static_cast<size_t>(mappingEnd - mappingOffset);
+    void *mapping = mapFile(options.path, mappingOffset, mappingSize);
+    if (!mapping)
+        return false;
+
+    KDGpu::Buffer buffer = device->createBuffer(KDGpu::BufferOptions{
+            .label = "MappedFileBuffer",
+            .size = mappingSize,
+            .usage = options.usage,
+            .memoryUsage = KDGpu::MemoryUsage::CpuToGpu,
+            .hostPointer = mapping,
+    });
+    if (!buffer.isValid()) {
+        SPDLOG_WARN("MappedFileBuffer: unable to import {}, reading it instead", options.path.string());
+        unmapFile(mapping, mappingSize);
+        return false;
+    }
+
+    m_buffer = std::move(buffer);
+    m_mapping = mapping;
+    m_mappingSize = mappingSize;
+    m_offset = options.offset - mappingOffset;
+    return true;
+}
+
+bool MappedFileBuffer::readRegion(KDGpu::Device *device, const MappedFileBufferOptions &options)
+{
+    std::ifstream file(options.path, std::ios::binary);
+    if (!file) {
+        SPDLOG_WARN("MappedFileBuffer: unable to open {}", options.path.string());
+        return false;
+    }
+
+    KDGpu::Buffer buffer = device->createBuffer(KDGpu::BufferOptions{
+            .label = "MappedFileBuffer",
+            .size = m_size,
+            .usage = options.usage,
+            .memoryUsage = KDGpu::MemoryUsage::CpuToGpu,
+            .persistentlyMapped = true,
+    });
+    void *data = buffer.mappedPointer() ? buffer.mappedPointer() : buffer.map();
+    if (!data) {
+        SPDLOG_WARN("MappedFileBuffer: unable to map a buffer of {} bytes", m_size);
+        return false;
+    }
+
+    // Read into the buffer memory directly rather than through an intermediate copy
+    file.seekg(static_cast<std::streamoff>(options.offset));
+    const bool read = static_cast<bool>(file.read(static_cast<char *>(data), static_cast<std::streamsize>(m_size)));
+    buffer.flush();
+    buffer.unmap();
+    if (!read) {
+        SPDLOG_WARN("MappedFileBuffer: unable to read {} bytes from {}", m_size, options.path.string());
+        return false;
+    }
+
+    m_buffer = std::move(buffer);
+    m_offset = 0;
+    return true;
+}
+
+void MappedFileBuffer::release()
+{
+    // The buffer has to go before the memory it imported
+    m_buffer = {};
+    if (m_mapping)
+        unmapFile(m_mapping, m_mappingSize);
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+}
+
+} // namespace KDGpuUtils
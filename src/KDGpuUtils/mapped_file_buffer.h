@@ -0,0 +1,88 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+
+#include <KDGpu/buffer.h>
+#include <KDGpu/gpu_core.h>
+
+#include <filesystem>
+
+namespace KDGpu {
+class Device;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+struct MappedFileBufferOptions {
+    std::filesystem::path path;
+    KDGpu::DeviceSize offset{ 0 };
+    // WholeSize covers the file up to its end
+    KDGpu::DeviceSize size{ KDGpu::WholeSize };
+    // Only read-only usages are imported, others such as storage or transfer destination get a copy
+    KDGpu::BufferUsageFlags usage{ KDGpu::BufferUsageFlagBits::TransferSrcBit };
+    // Read through a staging buffer even when the file could be imported
+    bool allowImport{ true };
+};
+
+/**
+ * @brief Exposes a region of a file as a Buffer, without copying it when possible
+ *
+ * When the adapter supports importing host memory, the region is memory mapped and the
+ * mapping imported as the memory of buffer(): copies from it read the file pages directly
+ * and the region never goes through a std::vector or a staging buffer. The mapping starts
+ * at a file offset aligned to the import alignment, the requested region starts at offset()
+ * in buffer().
+ *
+ * The mapping is read only, so the region is only imported when usage allows nothing but
+ * reads from the buffer, such as transfer source, vertex, index or uniform buffer usages.
+ *
+ * Otherwise, or when the driver refuses the mapping, the region is read straight into a
+ * host visible staging buffer and offset() is 0.
+ *
+ * Either way the buffer can be used as the source of copyBuffer() or copyBufferToTexture()
+ * and has to outlive the commands reading it. The file should not be modified meanwhile.
+ */
+class KDGPUUTILS_EXPORT MappedFileBuffer
+{
+public:
+    MappedFileBuffer() = default;
+    MappedFileBuffer(KDGpu::Device *device, const MappedFileBufferOptions &options);
+    ~MappedFileBuffer();
+
+    MappedFileBuffer(MappedFileBuffer &&other) noexcept;
+    MappedFileBuffer &operator=(MappedFileBuffer &&other) noexcept;
+
+    MappedFileBuffer(const MappedFileBuffer &) = delete;
+    MappedFileBuffer &operator=(const MappedFileBuffer &) = delete;
+
+    bool isValid() const noexcept { return m_buffer.isValid(); }
+    // True when buffer() uses the file mapping rather than a copy of the region
+    bool isImported() const noexcept { return m_mapping != nullptr; }
+
+    const KDGpu::Buffer &buffer() const noexcept { return m_buffer; }
+    KDGpu::DeviceSize offset() const noexcept { return m_offset; }
+    KDGpu::DeviceSize size() const noexcept { return m_size; }
+
+private:
+    bool importRegion(KDGpu::Device *device, const MappedFileBufferOptions &options, KDGpu::DeviceSize fileSize);
+    bool readRegion(KDGpu::Device *device, const MappedFileBufferOptions &options);
+    void release();
+
+    KDGpu::Buffer m_buffer;
+    void *m_mapping{ nullptr };
+    size_t m_mappingSize{ 0 };
+    KDGpu::DeviceSize m_offset{ 0 };
+    KDGpu::DeviceSize m_size{ 0 };
+};
+
+} // namespace KDGpuUtils
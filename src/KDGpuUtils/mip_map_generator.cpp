@@ -0,0 +1,460 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/mip_map_generator.h>
+
+#include <KDGpu/adapter.h>
+#include <KDGpu/bind_group_layout_options.h>
+#include <KDGpu/bind_group_options.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/compute_pass_command_recorder.h>
+#include <KDGpu/compute_pipeline_options.h>
+#include <KDGpu/device.h>
+#include <KDGpu/memory_barrier.h>
+#include <KDGpu/pipeline_layout_options.h>
+#include <KDGpu/sampler_options.h>
+#include <KDGpu/texture.h>
+#include <KDGpu/texture_view_options.h>
+
+#include <KDUtils/logging.h>
+
+#include <algorithm>
+#include <cstdint>
+
+// Generated from mip_map_downsample.comp at build time
+#include "mip_map_downsample.comp.h"
+
+namespace KDGpuUtils {
+
+namespace {
+
+constexpr uint32_t WorkGroupSize = 8;
+
+KDGpu::Extent3D mipExtent(const KDGpu::Extent3D &extent, uint32_t mipLevel)
+{
+    return KDGpu::Extent3D{
+        .width = std::max(extent.width >> mipLevel, 1U),
+        .height = std::max(extent.height >> mipLevel, 1U),
+        .depth = std::max(extent.depth >> mipLevel, 1U),
+    };
+}
+
+KDGpu::TextureSubresourceRange mipRange(const MipMapGenerationTarget &target, uint32_t baseMipLevel, uint32_t levelCount)
+{
+    return KDGpu::TextureSubresourceRange{
+        .aspectMask = KDGpu::TextureAspectFlagBits::ColorBit,
+        .baseMipLevel = baseMipLevel,
+        .levelCount = levelCount,
+        .layerCount = target.arrayLayers,
+    };
+}
+
+bool isIntegerFormat(KDGpu::Format format)
+{
+    using KDGpu::Format;
+    switch (format) {
+    case Format::R8_UINT:
+    case Format::R8_SINT:
+    case Format::R8G8_UINT:
+    case Format::R8G8_SINT:
+    case Format::R8G8B8_UINT:
+    case Format::R8G8B8_SINT:
+    case Format::B8G8R8_UINT:
+    case Format::B8G8R8_SINT:
+    case Format::R8G8B8A8_UINT:
+    case Format::R8G8B8A8_SINT:
+    case Format::B8G8R8A8_UINT:
+    case Format::B8G8R8A8_SINT:
+    case Format::A8B8G8R8_UINT_PACK32:
+    case Format::A8B8G8R8_SINT_PACK32:
+    case Format::A2R10G10B10_UINT_PACK32:
+    case Format::A2R10G10B10_SINT_PACK32:
+    case Format::A2B10G10R10_UINT_PACK32:
+    case Format::A2B10G10R10_SINT_PACK32:
+    case Format::R16_UINT:
+    case Format::R16_SINT:
+    case Format::R16G16_UINT:
+    case Format::R16G16_SINT:
+    case Format::R16G16B16_UINT:
+    case Format::R16G16B16_SINT:
+    case Format::R16G16B16A16_UINT:
+    case Format::R16G16B16A16_SINT:
+    case Format::R32_UINT:
+    case Format::R32_SINT:
+    case Format::R32G32_UINT:
+    case Format::R32G32_SINT:
+    case Format::R32G32B32_UINT:
+    case Format::R32G32B32_SINT:
+    case Format::R32G32B32A32_UINT:
+    case Format::R32G32B32A32_SINT:
+    case Format::R64_UINT:
+    case Format::R64_SINT:
+    case Format::R64G64_UINT:
+    case Format::R64G64_SINT:
+    case Format::R64G64B64_UINT:
+    case Format::R64G64B64_SINT:
+    case Format::R64G64B64A64_UINT:
+    case Format::R64G64B64A64_SINT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Layouts, stages and accesses of the levels being read and written by each method
+struct MethodState {
+    KDGpu::TextureLayout readLayout;
+    KDGpu::TextureLayout writeLayout;
+    KDGpu::PipelineStageFlags stages;
+    KDGpu::AccessFlags readMask;
+    KDGpu::AccessFlags writeMask;
+};
+
+MethodState methodState(MipMapMethod method)
+{
+    if (method == MipMapMethod::Compute) {
+        return MethodState{
+            .readLayout = KDGpu::TextureLayout::ShaderReadOnlyOptimal,
+            .writeLayout = KDGpu::TextureLayout::General,
+            .stages = KDGpu::PipelineStageFlagBit::ComputeShaderBit,
+            .readMask = KDGpu::AccessFlagBit::ShaderReadBit,
+            .writeMask = KDGpu::AccessFlagBit::ShaderWriteBit,
+        };
+    }
+    return MethodState{
+        .readLayout = KDGpu::TextureLayout::TransferSrcOptimal,
+        .writeLayout = KDGpu::TextureLayout::TransferDstOptimal,
+        .stages = KDGpu::PipelineStageFlagBit::TransferBit,
+        .readMask = KDGpu::AccessFlagBit::TransferReadBit,
+        .writeMask = KDGpu::AccessFlagBit::TransferWriteBit,
+    };
+}
+
+} // namespace
+
+MipMapGenerator::MipMapGenerator(KDGpu::Device *device)
+    : m_device(device)
+{
+}
+
+MipMapMethod MipMapGenerator::method(KDGpu::Format format, KDGpu::TextureTiling tiling) const
+{
+    if (supports(MipMapMethod::Blit, format, tiling))
+        return MipMapMethod::Blit;
+    if (supports(MipMapMethod::Compute, format, tiling))
+        return MipMapMethod::Compute;
+    return MipMapMethod::Unsupported;
+}
+
+bool MipMapGenerator::supports(MipMapMethod method, KDGpu::Format format, KDGpu::TextureTiling tiling) const
+{
+    const KDGpu::Adapter *adapter = m_device->adapter();
+    if (!adapter)
+        return false;
+
+    const KDGpu::FormatProperties properties = adapter->formatProperties(format);
+    const KDGpu::FormatFeatureFlags features = (tiling == KDGpu::TextureTiling::Linear) ? properties.linearTilingFeatures : properties.optimalTilingFeatures;
+
+    switch (method) {
+    case MipMapMethod::Automatic:
+        return supports(MipMapMethod::Blit, format, tiling) || supports(MipMapMethod::Compute, format, tiling);
+    case MipMapMethod::Blit:
+        return features.testFlag(KDGpu::FormatFeatureFlagBit::BlitSrcBit) &&
+                features.testFlag(KDGpu::FormatFeatureFlagBit::BlitDstBit) &&
+                features.testFlag(KDGpu::FormatFeatureFlagBit::SampledImageFilterLinearBit);
+    case MipMapMethod::Compute:
+        return features.testFlag(KDGpu::FormatFeatureFlagBit::SampledImageBit) &&
+                features.testFlag(KDGpu::FormatFeatureFlagBit::StorageImageBit) &&
+                m_device->enabledFeatures().shaderStorageImageWriteWithoutFormat &&
+                !isIntegerFormat(format);
+    case MipMapMethod::Unsupported:
+        break;
+    }
+    return false;
+}
+
+void MipMapGenerator::createComputePipeline()
+{
+    const std::vector<uint32_t> code(std::begin(mipMapDownsampleSpirv), std::end(mipMapDownsampleSpirv));
+    m_shaderModule = m_device->createShaderModule(code);
+
+    m_bindGroupLayout = m_device->createBindGroupLayout(KDGpu::BindGroupLayoutOptions{
+            .label = "MipMapGenerator",
+            .bindings = {
+                    {
+                            .binding = 0,
+                            .resourceType = KDGpu::ResourceBindingType::CombinedImageSampler,
+                            .shaderStages = KDGpu::ShaderStageFlagBits::ComputeBit,
+                    },
+                    {
+                            .binding = 1,
+                            .resourceType = KDGpu::ResourceBindingType::StorageImage,
+                            .shaderStages = KDGpu::ShaderStageFlagBits::ComputeBit,
+                    },
+            },
+    });
+    m_pipelineLayout = m_device->createPipelineLayout(KDGpu::PipelineLayoutOptions{
+            .label = "MipMapGenerator",
+            .bindGroupLayouts = { m_bindGroupLayout },
+    });
+    m_computePipeline = m_device->createComputePipeline(KDGpu::ComputePipelineOptions{
+            .label = "MipMapGenerator",
+            .layout = m_pipelineLayout,
+            .shaderStage = { .shaderModule = m_shaderModule },
+    });
+    // Only used to fetch texels, the filtering is done by the shader
+    m_sampler = m_device->createSampler(KDGpu::SamplerOptions{
+            .label = "MipMapGenerator",
+            .u = KDGpu::AddressMode::ClampToEdge,
+            .v = KDGpu::AddressMode::ClampToEdge,
+            .w = KDGpu::AddressMode::ClampToEdge,
+    });
+}
+
+MipMapGenerationResources MipMapGenerator::record(KDGpu::CommandRecorder &recorder, std::span<const MipMapGenerationTarget> targets)
+{
+    struct Job {
+        const MipMapGenerationTarget *target{ nullptr };
+        MipMapMethod method{ MipMapMethod::Unsupported };
+        MethodState state;
+        // Index of the view of the first mip level in MipMapGenerationResources::textureViews
+        size_t firstView{ 0 };
+    };
+
+    MipMapGenerationResources resources;
+    std::vector<Job> jobs;
+    jobs.reserve(targets.size());
+    uint32_t maxMipLevels = 1;
+    bool usesCompute = false;
+
+    std::vector<KDGpu::TextureMemoryBarrierOptions> finalBarriers;
+    for (const MipMapGenerationTarget &target : targets) {
+        // Nothing to generate, only the layout has to change
+        if (target.mipLevels <= 1) {
+            finalBarriers.push_back(KDGpu::TextureMemoryBarrierOptions{
+                    .srcStages = KDGpu::PipelineStageFlagBit::AllCommandsBit,
+                    .srcMask = KDGpu::AccessFlagBit::MemoryWriteBit,
+                    .dstStages = target.dstStages,
+                    .dstMask = target.dstMask,
+                    .oldLayout = target.oldLayout,
+                    .newLayout = target.newLayout,
+                    .texture = *target.texture,
+                    .range = mipRange(target, 0, 1),
+            });
+            continue;
+        }
+
+        MipMapMethod targetMethod = target.method;
+        if (targetMethod == MipMapMethod::Automatic)
+            targetMethod = method(target.format, target.tiling);
+        else if (!supports(targetMethod, target.format, target.tiling))
+            targetMethod = MipMapMethod::Unsupported;
+        if (targetMethod == MipMapMethod::Compute && target.extent.depth > 1)
+            targetMethod = MipMapMethod::Unsupported;
+        if (targetMethod == MipMapMethod::Unsupported) {
+            SPDLOG_WARN("MipMapGenerator: unable to generate the mip levels of a texture of format {}", static_cast<int>(target.format));
+            ++resources.skippedCount;
+            // Still hand the texture over in newLayout, the levels past the first stay undefined
+            finalBarriers.push_back(KDGpu::TextureMemoryBarrierOptions{
+                    .srcStages = KDGpu::PipelineStageFlagBit::AllCommandsBit,
+                    .srcMask = KDGpu::AccessFlagBit::MemoryWriteBit,
+                    .dstStages = target.dstStages,
+                    .dstMask = target.dstMask,
+                    .oldLayout = target.oldLayout,
+                    .newLayout = target.newLayout,
+                    .texture = *target.texture,
+                    .range = mipRange(target, 0, 1),
+            });
+            finalBarriers.push_back(KDGpu::TextureMemoryBarrierOptions{
+                    .srcStages = KDGpu::PipelineStageFlagBit::TopOfPipeBit,
+                    .dstStages = target.dstStages,
+                    .dstMask = target.dstMask,
+                    .oldLayout = KDGpu::TextureLayout::Undefined,
+                    .newLayout = target.newLayout,
+                    .texture = *target.texture,
+                    .range = mipRange(target, 1, target.mipLevels - 1),
+            });
+            continue;
+        }
+
+        jobs.push_back(Job{ .target = &target, .method = targetMethod, .state = methodState(targetMethod) });
+        maxMipLevels = std::max(maxMipLevels, target.mipLevels);
+        usesCompute |= targetMethod == MipMapMethod::Compute;
+    }
+
+    if (usesCompute && !m_computePipeline.isValid())
+        createComputePipeline();
+
+    // Move the first level of every texture to be read from and the others to be written to
+    std::vector<KDGpu::TextureMemoryBarrierOptions> barriers;
+    barriers.reserve(2 * jobs.size());
+    for (Job &job : jobs) {
+        const MipMapGenerationTarget &target = *job.target;
+        barriers.push_back(KDGpu::TextureMemoryBarrierOptions{
+                .srcStages = KDGpu::PipelineStageFlagBit::AllCommandsBit,
+                .srcMask = KDGpu::AccessFlagBit::MemoryWriteBit,
+                .dstStages = job.state.stages,
+                .dstMask = job.state.readMask,
+                .oldLayout = target.oldLayout,
+                .newLayout = job.state.readLayout,
+                .texture = *target.texture,
+                .range = mipRange(target, 0, 1),
+        });
+        barriers.push_back(KDGpu::TextureMemoryBarrierOptions{
+                .srcStages = KDGpu::PipelineStageFlagBit::TopOfPipeBit,
+                .dstStages = job.state.stages,
+                .dstMask = job.state.writeMask,
+                .oldLayout = KDGpu::TextureLayout::Undefined,
+                .newLayout = job.state.writeLayout,
+                .texture = *target.texture,
+                .range = mipRange(target, 1, target.mipLevels - 1),
+        });
+
+        if (job.method == MipMapMethod::Compute) {
+            job.firstView = resources.textureViews.size();
+            for (uint32_t mipLevel = 0; mipLevel < target.mipLevels; ++mipLevel) {
+                resources.textureViews.push_back(target.texture->createView(KDGpu::TextureViewOptions{
+                        .viewType = KDGpu::ViewType::ViewType2DArray,
+                        .format = target.format,
+                        .range = mipRange(target, mipLevel, 1),
+                }));
+            }
+        }
+    }
+    if (!barriers.empty())
+        recorder.textureMemoryBarriers(barriers);
+
+    for (uint32_t mipLevel = 1; mipLevel < maxMipLevels; ++mipLevel) {
+        // The previous level of every texture becomes readable at once
+        if (mipLevel > 1) {
+            barriers.clear();
+            for (const Job &job : jobs) {
+                if (job.target->mipLevels <= mipLevel)
+                    continue;
+                barriers.push_back(KDGpu::TextureMemoryBarrierOptions{
+                        .srcStages = job.state.stages,
+                        .srcMask = job.state.writeMask,
+                        .dstStages = job.state.stages,
+                        .dstMask = job.state.readMask,
+                        .oldLayout = job.state.writeLayout,
+                        .newLayout = job.state.readLayout,
+                        .texture = *job.target->texture,
+                        .range = mipRange(*job.target, mipLevel - 1, 1),
+                });
+            }
+            recorder.textureMemoryBarriers(barriers);
+        }
+
+        bool hasComputeJob = false;
+        for (const Job &job : jobs) {
+            if (job.target->mipLevels <= mipLevel)
+                continue;
+            if (job.method == MipMapMethod::Compute) {
+                hasComputeJob = true;
+                continue;
+            }
+
+            const MipMapGenerationTarget &target = *job.target;
+            recorder.blitTexture(KDGpu::TextureBlitOptions{
+                    .srcTexture = *target.texture,
+                    .srcLayout = KDGpu::TextureLayout::TransferSrcOptimal,
+                    .dstTexture = *target.texture,
+                    .dstLayout = KDGpu::TextureLayout::TransferDstOptimal,
+                    .regions = {
+                            {
+                                    .srcSubresource = {
+                                            .aspectMask = KDGpu::TextureAspectFlagBits::ColorBit,
+                                            .mipLevel = mipLevel - 1,
+                                            .layerCount = target.arrayLayers,
+                                    },
+                                    .srcExtent = mipExtent(target.extent, mipLevel - 1),
+                                    .dstSubresource = {
+                                            .aspectMask = KDGpu::TextureAspectFlagBits::ColorBit,
+                                            .mipLevel = mipLevel,
+                                            .layerCount = target.arrayLayers,
+                                    },
+                                    .dstExtent = mipExtent(target.extent, mipLevel),
+                            },
+                    },
+                    .scalingFilter = KDGpu::FilterMode::Linear,
+            });
+        }
+
+        if (!hasComputeJob)
+            continue;
+
+        KDGpu::ComputePassCommandRecorder computePass = recorder.beginComputePass();
+        computePass.setPipeline(m_computePipeline);
+        for (const Job &job : jobs) {
+            if (job.method != MipMapMethod::Compute || job.target->mipLevels <= mipLevel)
+                continue;
+
+            const size_t srcView = job.firstView + mipLevel - 1;
+            resources.bindGroups.push_back(m_device->createBindGroup(KDGpu::BindGroupOptions{
+                    .layout = m_bindGroupLayout,
+                    .resources = {
+                            {
+                                    .binding = 0,
+                                    .resource = KDGpu::TextureViewSamplerBinding{
+                                            .textureView = resources.textureViews[srcView],
+                                            .sampler = m_sampler,
+                                    },
+                            },
+                            {
+                                    .binding = 1,
+                                    .resource = KDGpu::ImageBinding{
+                                            .textureView = resources.textureViews[srcView + 1],
+                                    },
+                            },
+                    },
+            }));
+            computePass.setBindGroup(0, resources.bindGroups.back(), m_pipelineLayout);
+
+            const KDGpu::Extent3D extent = mipExtent(job.target->extent, mipLevel);
+            computePass.dispatchCompute(KDGpu::ComputeCommand{
+                    .workGroupX = (extent.width + WorkGroupSize - 1) / WorkGroupSize,
+                    .workGroupY = (extent.height + WorkGroupSize - 1) / WorkGroupSize,
+                    .workGroupZ = job.target->arrayLayers,
+            });
+        }
+        computePass.end();
+    }
+
+    // Every level but the last one was read from, the last one was only written to
+    for (const Job &job : jobs) {
+        const MipMapGenerationTarget &target = *job.target;
+        finalBarriers.push_back(KDGpu::TextureMemoryBarrierOptions{
+                .srcStages = job.state.stages,
+                .srcMask = job.state.readMask,
+                .dstStages = target.dstStages,
+                .dstMask = target.dstMask,
+                .oldLayout = job.state.readLayout,
+                .newLayout = target.newLayout,
+                .texture = *target.texture,
+                .range = mipRange(target, 0, target.mipLevels - 1),
+        });
+        finalBarriers.push_back(KDGpu::TextureMemoryBarrierOptions{
+                .srcStages = job.state.stages,
+                .srcMask = job.state.writeMask,
+                .dstStages = target.dstStages,
+                .dstMask = target.dstMask,
+                .oldLayout = job.state.writeLayout,
+                .newLayout = target.newLayout,
+                .texture = *target.texture,
+                .range = mipRange(target, target.mipLevels - 1, 1),
+        });
+    }
+    if (!finalBarriers.empty())
+        recorder.textureMemoryBarriers(finalBarriers);
+
+    return resources;
+}
+
+} // namespace KDGpuUtils
@@ -0,0 +1,112 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+
+#include <KDGpu/bind_group.h>
+#include <KDGpu/bind_group_layout.h>
+#include <KDGpu/compute_pipeline.h>
+#include <KDGpu/gpu_core.h>
+#include <KDGpu/pipeline_layout.h>
+#include <KDGpu/sampler.h>
+#include <KDGpu/shader_module.h>
+#include <KDGpu/texture_view.h>
+
+#include <span>
+#include <vector>
+
+namespace KDGpu {
+class CommandRecorder;
+class Device;
+class Texture;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+enum class MipMapMethod : uint8_t {
+    Automatic,
+    Blit,
+    Compute,
+    Unsupported,
+};
+
+struct MipMapGenerationTarget {
+    const KDGpu::Texture *texture{ nullptr };
+    KDGpu::Format format{ KDGpu::Format::UNDEFINED };
+    KDGpu::TextureTiling tiling{ KDGpu::TextureTiling::Optimal };
+    KDGpu::Extent3D extent{};
+    uint32_t mipLevels{ 1 };
+    uint32_t arrayLayers{ 1 };
+    // Layout of the first mip level, the content of the others is discarded
+    KDGpu::TextureLayout oldLayout{ KDGpu::TextureLayout::TransferDstOptimal };
+    KDGpu::TextureLayout newLayout{ KDGpu::TextureLayout::ShaderReadOnlyOptimal };
+    KDGpu::PipelineStageFlags dstStages{ KDGpu::PipelineStageFlagBit::AllCommandsBit };
+    KDGpu::AccessFlags dstMask{ KDGpu::AccessFlagBit::MemoryReadBit };
+    // Automatic prefers blits. When the method is unsupported, the target is only transitioned
+    // to newLayout, with undefined content past the first level, and counted as skipped.
+    MipMapMethod method{ MipMapMethod::Automatic };
+};
+
+// Views and bind groups used by the compute path, to keep until the commands completed
+struct MipMapGenerationResources {
+    std::vector<KDGpu::TextureView> textureViews;
+    std::vector<KDGpu::BindGroup> bindGroups;
+    // Targets whose levels past the first were not generated
+    size_t skippedCount{ 0 };
+};
+
+/**
+ * @brief Records the mip level generation of many textures into a single CommandRecorder
+ *
+ * Each level is written from the previous one, for all textures at once: the layout
+ * transitions of a level are merged into a single barrier, so a batch costs as many
+ * barriers as its largest texture has levels rather than several per texture and level.
+ *
+ * Formats supporting linear filtered blits are downsampled with blits, their textures
+ * need TransferSrcBit and TransferDstBit usages. Other color formats that can be sampled
+ * and used as storage images are downsampled by a compute shader averaging 2x2 texels,
+ * their textures need SampledBit and StorageBit usages and the Device has to enable the
+ * shaderStorageImageWriteWithoutFormat feature. The compute path handles normalized and
+ * floating point 2D textures only. Targets no method applies to are skipped, they still end
+ * up in their newLayout.
+ *
+ * The CommandRecorder has to be submitted to a queue supporting graphics when blitting
+ * and compute when downsampling with the compute shader.
+ */
+class KDGPUUTILS_EXPORT MipMapGenerator
+{
+public:
+    explicit MipMapGenerator(KDGpu::Device *device);
+
+    MipMapGenerator(const MipMapGenerator &) = delete;
+    MipMapGenerator &operator=(const MipMapGenerator &) = delete;
+
+    // Returns the method used for textures of format, Blit when both are supported
+    MipMapMethod method(KDGpu::Format format, KDGpu::TextureTiling tiling = KDGpu::TextureTiling::Optimal) const;
+    bool supports(MipMapMethod method, KDGpu::Format format, KDGpu::TextureTiling tiling = KDGpu::TextureTiling::Optimal) const;
+
+    [[nodiscard]] MipMapGenerationResources record(KDGpu::CommandRecorder &recorder, std::span<const MipMapGenerationTarget> targets);
+
+private:
+    void createComputePipeline();
+
+    KDGpu::Device *m_device{ nullptr };
+
+    // Created with the first target downsampled by the compute shader
+    KDGpu::ShaderModule m_shaderModule;
+    KDGpu::BindGroupLayout m_bindGroupLayout;
+    KDGpu::PipelineLayout m_pipelineLayout;
+    KDGpu::ComputePipeline m_computePipeline;
+    KDGpu::Sampler m_sampler;
+};
+
+} // namespace KDGpuUtils
@@ -0,0 +1,191 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/persistent_pipeline_cache.h>
+
+#include <KDGpu/adapter.h>
+#include <KDGpu/adapter_properties.h>
+#include <KDGpu/device.h>
+#include <KDGpu/pipeline_cache_options.h>
+
+#include <KDUtils/logging.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+namespace KDGpuUtils {
+
+namespace {
+
+// Layout of VkPipelineCacheHeaderVersionOne
+constexpr size_t HeaderVersionOneSize = 4 * sizeof(uint32_t) + KDGpu::UuidSize;
+constexpr uint32_t HeaderVersionOne = 1;
+constexpr size_t VendorIdOffset = 8;
+constexpr size_t DeviceIdOffset = 12;
+constexpr size_t UuidOffset = 16;
+
+// Header fields are stored least significant byte first
+uint32_t readUint32(std::span<const uint8_t> data, size_t offset)
+{
+    return uint32_t(data[offset]) |
+            (uint32_t(data[offset + 1]) << 8) |
+            (uint32_t(data[offset + 2]) << 16) |
+            (uint32_t(data[offset + 3]) << 24);
+}
+
+size_t hashData(const std::vector<uint8_t> &data)
+{
+    return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char *>(data.data()), data.size()));
+}
+
+std::vector<uint8_t> readFile(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return {};
+
+    const std::streamsize size = file.tellg();
+    if (size <= 0)
+        return {};
+
+    std::vector<uint8_t> data(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char *>(data.data()), size))
+        return {};
+    return data;
+}
+
+} // namespace
+
+PersistentPipelineCache::PersistentPipelineCache(KDGpu::Device *device, const PersistentPipelineCacheOptions &options)
+    : m_device{ device }
+    , m_options{ options }
+    , m_lastSaveTime{ std::chrono::steady_clock::now() }
+{
+    std::vector<uint8_t> data = readFile(m_options.path);
+    if (!data.empty()) {
+        if (isCompatible(data, m_device->adapter()->properties())) {
+            m_loadResult = LoadResult::Loaded;
+            m_savedDataHash = hashData(data);
+        } else {
+            SPDLOG_WARN("Discarding pipeline cache {} which was created for a different device or driver", m_options.path.string());
+            m_loadResult = LoadResult::Incompatible;
+            data.clear();
+        }
+    }
+
+    m_pipelineCache = m_device->createPipelineCache(KDGpu::PipelineCacheOptions{
+            .label = "PersistentPipelineCache",
+            .initialData = data,
+    });
+}
+
+PersistentPipelineCache::~PersistentPipelineCache()
+{
+    save();
+}
+
+KDGpu::Handle<KDGpu::PipelineCache_t> PersistentPipelineCache::threadCache()
+{
+    std::lock_guard lock(m_threadCachesMutex);
+    auto it = m_threadCaches.find(std::this_thread::get_id());
+    if (it == m_threadCaches.end())
+        it = m_threadCaches.emplace(std::this_thread::get_id(), m_device->createPipelineCache()).first;
+    return it->second.handle();
+}
+
+bool PersistentPipelineCache::mergeThreadCaches()
+{
+    std::vector<KDGpu::RequiredHandle<KDGpu::PipelineCache_t>> sources;
+    {
+        std::lock_guard lock(m_threadCachesMutex);
+        sources.reserve(m_threadCaches.size());
+        for (const auto &[threadId, cache] : m_threadCaches)
+            sources.emplace_back(cache.handle());
+    }
+    if (sources.empty())
+        return true;
+    return m_pipelineCache.merge(sources);
+}
+
+bool PersistentPipelineCache::save()
+{
+    m_lastSaveTime = std::chrono::steady_clock::now();
+    if (!m_pipelineCache.isValid() || m_options.path.empty())
+        return false;
+
+    if (!mergeThreadCaches())
+        SPDLOG_WARN("Failed to merge thread pipeline caches, saving what the main cache holds");
+
+    const std::vector<uint8_t> data = m_pipelineCache.getData();
+    if (data.empty())
+        return false;
+
+    const size_t dataHash = hashData(data);
+    if (dataHash == m_savedDataHash)
+        return true;
+
+    std::error_code error;
+    if (m_options.path.has_parent_path())
+        std::filesystem::create_directories(m_options.path.parent_path(), error);
+
+    std::filesystem::path tmpPath = m_options.path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), std::streamsize(data.size()));
+        file.close();
+        if (!file) {
+            SPDLOG_WARN("Failed to write pipeline cache to {}", tmpPath.string());
+            std::filesystem::remove(tmpPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, m_options.path, error);
+    if (error) {
+        SPDLOG_WARN("Failed to replace pipeline cache {}: {}", m_options.path.string(), error.message());
+        std::filesystem::remove(tmpPath, error);
+        return false;
+    }
+
+    m_savedDataHash = dataHash;
+    return true;
+}
+
+bool PersistentPipelineCache::saveIfDue()
+{
+    if (m_options.autoSaveInterval.count() <= 0)
+        return false;
+    if (std::chrono::steady_clock::now() - m_lastSaveTime < m_options.autoSaveInterval)
+        return false;
+    return save();
+}
+
+bool PersistentPipelineCache::isCompatible(std::span<const uint8_t> data, const KDGpu::AdapterProperties &properties)
+{
+    if (data.size() < HeaderVersionOneSize)
+        return false;
+
+    const uint32_t headerSize = readUint32(data, 0);
+    if (headerSize < HeaderVersionOneSize || headerSize > data.size())
+        return false;
+    if (readUint32(data, 4) != HeaderVersionOne)
+        return false;
+    if (readUint32(data, VendorIdOffset) != properties.vendorID || readUint32(data, DeviceIdOffset) != properties.deviceID)
+        return false;
+
+    const auto uuid = data.subspan(UuidOffset, KDGpu::UuidSize);
+    return std::equal(uuid.begin(), uuid.end(), properties.pipelineCacheUUID.begin());
+}
+
+} // namespace KDGpuUtils
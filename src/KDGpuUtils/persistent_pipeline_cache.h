@@ -0,0 +1,102 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+
+#include <KDGpu/handle.h>
+#include <KDGpu/pipeline_cache.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+
+namespace KDGpu {
+class Device;
+struct AdapterProperties;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+struct PersistentPipelineCacheOptions {
+    std::filesystem::path path;
+    // How often saveIfDue() writes the cache back. Zero disables periodic saving.
+    std::chrono::milliseconds autoSaveInterval{ 0 };
+};
+
+/**
+ * @brief Keeps a PipelineCache in sync with a file on disk
+ *
+ * The file is loaded on construction. Its pipeline cache header must match the
+ * vendor ID, device ID and pipeline cache UUID of the device's adapter, otherwise
+ * it is discarded and the cache starts out empty. The cache is written back on
+ * destruction, by save() and, when an autoSaveInterval is set, by saveIfDue().
+ * Writes go to a temporary file which is then renamed over the old one so that
+ * an interrupted save never leaves a truncated cache behind.
+ *
+ * Pipelines should be created with pipelineCache(), or with threadCache() when
+ * several threads create pipelines at the same time. Thread caches are merged
+ * into the main cache before each save.
+ */
+class KDGPUUTILS_EXPORT PersistentPipelineCache
+{
+public:
+    enum class LoadResult {
+        NotFound,
+        Incompatible,
+        Loaded,
+    };
+
+    PersistentPipelineCache(KDGpu::Device *device, const PersistentPipelineCacheOptions &options);
+    ~PersistentPipelineCache();
+
+    PersistentPipelineCache(const PersistentPipelineCache &) = delete;
+    PersistentPipelineCache &operator=(const PersistentPipelineCache &) = delete;
+
+    const KDGpu::PipelineCache &pipelineCache() const noexcept { return m_pipelineCache; }
+
+    // Returns a cache only used by the calling thread, creating it on first use
+    KDGpu::Handle<KDGpu::PipelineCache_t> threadCache();
+
+    // Merges all thread caches into pipelineCache()
+    bool mergeThreadCaches();
+
+    // Merges the thread caches and writes the result to disk. Does nothing if
+    // the data did not change since the last save.
+    bool save();
+
+    // Meant to be called once per frame. Saves if autoSaveInterval elapsed since the last save.
+    bool saveIfDue();
+
+    LoadResult loadResult() const noexcept { return m_loadResult; }
+    const std::filesystem::path &path() const noexcept { return m_options.path; }
+
+    // Checks the header at the start of a pipeline cache blob against the adapter it would be used with
+    static bool isCompatible(std::span<const uint8_t> data, const KDGpu::AdapterProperties &properties);
+
+private:
+    KDGpu::Device *m_device{ nullptr };
+    PersistentPipelineCacheOptions m_options;
+    LoadResult m_loadResult{ LoadResult::NotFound };
+    KDGpu::PipelineCache m_pipelineCache;
+
+    std::mutex m_threadCachesMutex;
+    std::unordered_map<std::thread::id, KDGpu::PipelineCache> m_threadCaches;
+
+    std::chrono::steady_clock::time_point m_lastSaveTime;
+    size_t m_savedDataHash{ 0 };
+};
+
+} // namespace KDGpuUtils
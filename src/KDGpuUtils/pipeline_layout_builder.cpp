@@ -0,0 +1,79 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/pipeline_layout_builder.h>
+
+#include <KDGpu/device.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace KDGpuUtils {
+
+PipelineLayoutBuilder::PipelineLayoutBuilder(KDGpu::Device *device, uint32_t unboundedArraySize)
+    : m_device{ device }
+    , m_unboundedArraySize{ unboundedArraySize }
+{
+}
+
+void PipelineLayoutBuilder::addBindGroupLayout(const KDGpu::Handle<KDGpu::BindGroupLayout_t> &bindGroupLayout)
+{
+    m_externalBindGroupLayouts.push_back(bindGroupLayout);
+}
+
+ReflectedPipelineLayout PipelineLayoutBuilder::build(const ShaderReflection &reflection)
+{
+    ReflectedPipelineLayout result;
+    for (KDGpu::BindGroupLayoutOptions &options : reflection.bindGroupLayoutOptions(m_unboundedArraySize))
+        result.bindGroupLayouts.push_back(bindGroupLayout(std::move(options)));
+
+    auto it = std::find_if(m_pipelineLayouts.begin(), m_pipelineLayouts.end(), [&](const OwnedPipelineLayout &layout) {
+        return layout.bindGroupLayouts == result.bindGroupLayouts && layout.pushConstantRanges == reflection.pushConstantRanges;
+    });
+    if (it == m_pipelineLayouts.end()) {
+        KDGpu::PipelineLayoutOptions options{
+            .pushConstantRanges = reflection.pushConstantRanges,
+        };
+        options.bindGroupLayouts.assign(result.bindGroupLayouts.begin(), result.bindGroupLayouts.end());
+        m_pipelineLayouts.push_back(OwnedPipelineLayout{
+                .bindGroupLayouts = result.bindGroupLayouts,
+                .pushConstantRanges = reflection.pushConstantRanges,
+                .pipelineLayout = m_device->createPipelineLayout(options),
+        });
+        it = std::prev(m_pipelineLayouts.end());
+    }
+
+    result.pipelineLayout = it->pipelineLayout.handle();
+    return result;
+}
+
+KDGpu::Handle<KDGpu::BindGroupLayout_t> PipelineLayoutBuilder::bindGroupLayout(KDGpu::BindGroupLayoutOptions &&options)
+{
+    // Same comparison as BindGroupLayout::isCompatibleWith(), without creating the layout first
+    const auto owned = std::find_if(m_bindGroupLayouts.begin(), m_bindGroupLayouts.end(), [&options](const OwnedBindGroupLayout &layout) {
+        return layout.bindings == options.bindings;
+    });
+    if (owned != m_bindGroupLayouts.end())
+        return owned->bindGroupLayout.handle();
+
+    KDGpu::BindGroupLayout bindGroupLayout = m_device->createBindGroupLayout(options);
+    for (const auto &external : m_externalBindGroupLayouts) {
+        if (bindGroupLayout.isCompatibleWith(external))
+            return external;
+    }
+
+    m_bindGroupLayouts.push_back(OwnedBindGroupLayout{
+            .bindings = std::move(options.bindings),
+            .bindGroupLayout = std::move(bindGroupLayout),
+    });
+    return m_bindGroupLayouts.back().bindGroupLayout.handle();
+}
+
+} // namespace KDGpuUtils
@@ -0,0 +1,80 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+#include <KDGpuUtils/shader_reflection.h>
+
+#include <KDGpu/bind_group_layout.h>
+#include <KDGpu/handle.h>
+#include <KDGpu/pipeline_layout.h>
+
+#include <vector>
+
+namespace KDGpu {
+class Device;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+struct ReflectedPipelineLayout {
+    KDGpu::Handle<KDGpu::PipelineLayout_t> pipelineLayout;
+    std::vector<KDGpu::Handle<KDGpu::BindGroupLayout_t>> bindGroupLayouts; // Indexed by set
+};
+
+/**
+ * @brief Creates PipelineLayouts from the reflected interface of a set of shader stages
+ *
+ * Merge the ShaderReflection of every stage of a pipeline and hand it to build().
+ * The builder owns the layouts it creates and shares them between all pipelines
+ * asking for the same interface: a bind group layout is reused if one compatible
+ * with it exists, and a pipeline layout if one with the same bind group layouts and
+ * push constant ranges does. Layouts created by the application can be offered for
+ * reuse with addBindGroupLayout().
+ */
+class KDGPUUTILS_EXPORT PipelineLayoutBuilder
+{
+public:
+    explicit PipelineLayoutBuilder(KDGpu::Device *device, uint32_t unboundedArraySize = 1024);
+
+    PipelineLayoutBuilder(const PipelineLayoutBuilder &) = delete;
+    PipelineLayoutBuilder &operator=(const PipelineLayoutBuilder &) = delete;
+
+    // bindGroupLayout must outlive the builder
+    void addBindGroupLayout(const KDGpu::Handle<KDGpu::BindGroupLayout_t> &bindGroupLayout);
+
+    ReflectedPipelineLayout build(const ShaderReflection &reflection);
+
+    size_t bindGroupLayoutCount() const noexcept { return m_bindGroupLayouts.size(); }
+    size_t pipelineLayoutCount() const noexcept { return m_pipelineLayouts.size(); }
+
+private:
+    KDGpu::Handle<KDGpu::BindGroupLayout_t> bindGroupLayout(KDGpu::BindGroupLayoutOptions &&options);
+
+    struct OwnedBindGroupLayout {
+        std::vector<KDGpu::ResourceBindingLayout> bindings;
+        KDGpu::BindGroupLayout bindGroupLayout;
+    };
+
+    struct OwnedPipelineLayout {
+        std::vector<KDGpu::Handle<KDGpu::BindGroupLayout_t>> bindGroupLayouts;
+        std::vector<KDGpu::PushConstantRange> pushConstantRanges;
+        KDGpu::PipelineLayout pipelineLayout;
+    };
+
+    KDGpu::Device *m_device{ nullptr };
+    uint32_t m_unboundedArraySize{ 1024 };
+    std::vector<OwnedBindGroupLayout> m_bindGroupLayouts;
+    std::vector<KDGpu::Handle<KDGpu::BindGroupLayout_t>> m_externalBindGroupLayouts;
+    std::vector<OwnedPipelineLayout> m_pipelineLayouts;
+};
+
+} // namespace KDGpuUtils
@@ -0,0 +1,362 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+// Internal header shared by PipelineStateRecorder and PipelineStateReplayer, not installed.
+//
+// A manifest is a header followed by five sections: shader modules, bind group layouts,
+// pipeline layouts, graphics pipelines and compute pipelines. Each section is an entry count
+// followed by length prefixed entries. Objects refer to each other by their index in the
+// section that holds them. All values are stored little endian.
+
+#include <KDGpu/bind_group_layout_options.h>
+#include <KDGpu/compute_pipeline_options.h>
+#include <KDGpu/graphics_pipeline_options.h>
+#include <KDGpu/pipeline_layout_options.h>
+
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace KDGpuUtils::PipelineStateManifest {
+
+constexpr uint32_t Magic = 0x5350444b; // "KDPS"
+constexpr uint32_t Version = 1;
+
+enum Section : uint32_t {
+    ShaderModules,
+    BindGroupLayouts,
+    PipelineLayouts,
+    GraphicsPipelines,
+    ComputePipelines,
+    SectionCount
+};
+
+template<typename T>
+struct IsVector : std::false_type {
+};
+template<typename T>
+struct IsVector<std::vector<T>> : std::true_type {
+};
+
+template<typename T>
+struct IsOptional : std::false_type {
+};
+template<typename T>
+struct IsOptional<std::optional<T>> : std::true_type {
+};
+
+template<typename T>
+struct IsVariant : std::false_type {
+};
+template<typename... Ts>
+struct IsVariant<std::variant<Ts...>> : std::true_type {
+};
+
+template<typename T>
+struct IsFlags : std::false_type {
+};
+template<typename E>
+struct IsFlags<KDGpu::Flags<E>> : std::true_type {
+};
+
+// Lets a single serialize() overload describe a struct for both Writer (const) and Reader
+template<typename T, typename U>
+concept OfType = std::is_same_v<std::remove_const_t<T>, U>;
+
+class Writer
+{
+public:
+    template<typename... Ts>
+    void operator()(const Ts &...values)
+    {
+        (write(values), ...);
+    }
+
+    void append(std::span<const uint8_t> bytes)
+    {
+        write(uint32_t(bytes.size()));
+        m_data.insert(m_data.end(), bytes.begin(), bytes.end());
+    }
+
+    std::vector<uint8_t> take() { return std::move(m_data); }
+
+private:
+    template<typename T>
+    void write(const T &value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            m_data.push_back(value ? 1 : 0);
+        } else if constexpr (std::is_enum_v<T>) {
+            write(static_cast<uint32_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            write(std::bit_cast<std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>>(value));
+        } else if constexpr (std::is_integral_v<T>) {
+            using U = std::make_unsigned_t<T>;
+            for (size_t i = 0; i < sizeof(T); ++i)
+                m_data.push_back(uint8_t(static_cast<U>(value) >> (8 * i)));
+        } else if constexpr (IsFlags<T>::value) {
+            write(static_cast<uint32_t>(value.toInt()));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            write(uint32_t(value.size()));
+            m_data.insert(m_data.end(), value.begin(), value.end());
+        } else if constexpr (IsVector<T>::value) {
+            write(uint32_t(value.size()));
+            for (const auto &element : value)
+                write(element);
+        } else if constexpr (IsOptional<T>::value) {
+            write(value.has_value());
+            if (value.has_value())
+                write(*value);
+        } else if constexpr (IsVariant<T>::value) {
+            write(uint32_t(value.index()));
+            std::visit([this](const auto &alternative) { write(alternative); }, value);
+        } else {
+            serialize(*this, value);
+        }
+    }
+
+    std::vector<uint8_t> m_data;
+};
+
+class Reader
+{
+public:
+    explicit Reader(std::span<const uint8_t> data)
+        : m_data{ data }
+    {
+    }
+
+    template<typename... Ts>
+    void operator()(Ts &...values)
+    {
+        (read(values), ...);
+    }
+
+    // Reads a length prefixed entry written by Writer::append()
+    std::span<const uint8_t> entry()
+    {
+        uint32_t size = 0;
+        read(size);
+        if (!m_ok || size > remaining()) {
+            m_ok = false;
+            return {};
+        }
+        const auto bytes = m_data.subspan(m_offset, size);
+        m_offset += size;
+        return bytes;
+    }
+
+    bool ok() const noexcept { return m_ok; }
+    bool atEnd() const noexcept { return m_offset == m_data.size(); }
+
+private:
+    size_t remaining() const noexcept { return m_data.size() - m_offset; }
+
+    template<typename T>
+    void read(T &value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            uint8_t byte = 0;
+            read(byte);
+            value = byte != 0;
+        } else if constexpr (std::is_enum_v<T>) {
+            uint32_t underlying = 0;
+            read(underlying);
+            value = static_cast<T>(underlying);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t> bits = 0;
+            read(bits);
+            value = std::bit_cast<T>(bits);
+        } else if constexpr (std::is_integral_v<T>) {
+            if (sizeof(T) > remaining()) {
+                m_ok = false;
+                value = 0;
+                return;
+            }
+            std::make_unsigned_t<T> bits = 0;
+            for (size_t i = 0; i < sizeof(T); ++i)
+                bits |= static_cast<std::make_unsigned_t<T>>(m_data[m_offset + i]) << (8 * i);
+            m_offset += sizeof(T);
+            value = static_cast<T>(bits);
+        } else if constexpr (IsFlags<T>::value) {
+            uint32_t bits = 0;
+            read(bits);
+            value = T::fromInt(bits);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            const uint32_t size = count();
+            value.assign(reinterpret_cast<const char *>(m_data.data()) + m_offset, size);
+            m_offset += size;
+        } else if constexpr (IsVector<T>::value) {
+            // Every element takes at least a byte, which bounds what corrupt data can make us allocate
+            value.resize(count());
+            for (auto &element : value)
+                read(element);
+        } else if constexpr (IsOptional<T>::value) {
+            bool hasValue = false;
+            read(hasValue);
+            if (hasValue)
+                read(value.emplace());
+            else
+                value.reset();
+        } else if constexpr (IsVariant<T>::value) {
+            uint32_t index = 0;
+            read(index);
+            readAlternative<0>(value, index);
+        } else {
+            serialize(*this, value);
+        }
+    }
+
+    uint32_t count()
+    {
+        uint32_t size = 0;
+        read(size);
+        if (size > remaining()) {
+            m_ok = false;
+            return 0;
+        }
+        return size;
+    }
+
+    template<size_t I, typename T>
+    void readAlternative(T &value, uint32_t index)
+    {
+        if constexpr (I < std::variant_size_v<T>) {
+            if (index != I)
+                return readAlternative<I + 1>(value, index);
+            std::variant_alternative_t<I, T> alternative{};
+            read(alternative);
+            value = alternative;
+        } else {
+            m_ok = false;
+        }
+    }
+
+    std::span<const uint8_t> m_data;
+    size_t m_offset{ 0 };
+    bool m_ok{ true };
+};
+
+// Handles are not part of these, the recorder and replayer store them as section indices
+
+void serialize(auto &ar, OfType<KDGpu::SpecializationConstant> auto &constant)
+{
+    ar(constant.constantId, constant.value);
+}
+
+void serialize(auto &ar, OfType<KDGpu::ResourceBindingLayout> auto &binding)
+{
+    ar(binding.binding, binding.count, binding.resourceType, binding.shaderStages, binding.flags);
+}
+
+void serialize(auto &ar, OfType<KDGpu::BindGroupLayoutOptions> auto &options)
+{
+    ar(options.bindings, options.flags);
+}
+
+void serialize(auto &ar, OfType<KDGpu::PushConstantRange> auto &range)
+{
+    ar(range.offset, range.size, range.shaderStages);
+}
+
+void serialize(auto &ar, OfType<KDGpu::VertexBufferLayout> auto &layout)
+{
+    ar(layout.binding, layout.stride, layout.inputRate);
+}
+
+void serialize(auto &ar, OfType<KDGpu::VertexAttribute> auto &attribute)
+{
+    ar(attribute.location, attribute.binding, attribute.format, attribute.offset);
+}
+
+void serialize(auto &ar, OfType<KDGpu::VertexOptions> auto &options)
+{
+    ar(options.buffers, options.attributes);
+}
+
+void serialize(auto &ar, OfType<KDGpu::BlendComponent> auto &component)
+{
+    ar(component.operation, component.srcFactor, component.dstFactor);
+}
+
+void serialize(auto &ar, OfType<KDGpu::BlendOptions> auto &options)
+{
+    ar(options.blendingEnabled, options.color, options.alpha);
+}
+
+void serialize(auto &ar, OfType<KDGpu::RenderTargetOptions> auto &options)
+{
+    ar(options.format, options.writeMask, options.blending);
+}
+
+void serialize(auto &ar, OfType<KDGpu::StencilOperationOptions> auto &options)
+{
+    ar(options.failOp, options.passOp, options.depthFailOp, options.compareOp,
+       options.compareMask, options.writeMask, options.reference);
+}
+
+void serialize(auto &ar, OfType<KDGpu::DepthStencilOptions> auto &options)
+{
+    ar(options.format, options.depthTestEnabled, options.depthWritesEnabled, options.depthCompareOperation,
+       options.stencilTestEnabled, options.stencilFront, options.stencilBack, options.resolveDepthStencil,
+       options.depthClampEnabled);
+}
+
+void serialize(auto &ar, OfType<KDGpu::DepthBiasOptions> auto &options)
+{
+    ar(options.enabled, options.biasConstantFactor, options.biasClamp, options.biasSlopeFactor);
+}
+
+void serialize(auto &ar, OfType<KDGpu::PrimitiveOptions> auto &options)
+{
+    ar(options.topology, options.primitiveRestart, options.cullMode, options.frontFace, options.polygonMode,
+       options.patchControlPoints, options.depthBias, options.lineWidth, options.rasterizerDiscardEnabled);
+}
+
+void serialize(auto &ar, OfType<KDGpu::MultisampleOptions> auto &options)
+{
+    ar(options.samples, options.sampleMasks, options.alphaToCoverageEnabled);
+}
+
+void serialize(auto &ar, OfType<KDGpu::DynamicAttachmentMapping> auto &mapping)
+{
+    ar(mapping.enabled, mapping.remappedIndex);
+}
+
+void serialize(auto &ar, OfType<KDGpu::DynamicInputAttachmentLocations> auto &locations)
+{
+    ar(locations.inputColorAttachments, locations.inputDepthAttachment, locations.inputStencilAttachment);
+}
+
+void serialize(auto &ar, OfType<KDGpu::DynamicOutputAttachmentLocations> auto &locations)
+{
+    ar(locations.outputAttachments);
+}
+
+void serialize(auto &ar, OfType<KDGpu::GraphicsPipelineOptions::DynamicRendering> auto &options)
+{
+    ar(options.enabled, options.dynamicInputLocations, options.dynamicOutputLocations);
+}
+
+// Everything but the label, the shader stages, the layout and the caches
+void serialize(auto &ar, OfType<KDGpu::GraphicsPipelineOptions> auto &options)
+{
+    ar(options.vertex, options.renderTargets, options.depthStencil, options.primitive, options.multisample,
+       options.viewCount, options.dynamicState.enabledDynamicStates, options.subpassIndex, options.dynamicRendering);
+}
+
+} // namespace KDGpuUtils::PipelineStateManifest
@@ -0,0 +1,184 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/pipeline_state_recorder.h>
+#include <KDGpuUtils/pipeline_state_manifest.h>
+
+#include <KDGpu/device.h>
+
+#include <KDUtils/logging.h>
+
+#include <fstream>
+#include <optional>
+
+namespace KDGpuUtils {
+
+namespace {
+
+template<typename T>
+std::optional<uint32_t> indexOf(const std::unordered_map<KDGpu::Handle<T>, uint32_t> &indices, const KDGpu::Handle<T> &handle)
+{
+    const auto it = indices.find(handle);
+    if (it == indices.end())
+        return std::nullopt;
+    return it->second;
+}
+
+} // namespace
+
+uint32_t PipelineStateRecorder::Section::add(std::vector<uint8_t> &&entry)
+{
+    const auto [it, inserted] = indices.try_emplace(std::move(entry), uint32_t(entries.size()));
+    if (inserted)
+        entries.push_back(&it->first);
+    return it->second;
+}
+
+PipelineStateRecorder::PipelineStateRecorder(KDGpu::Device *device)
+    : m_device{ device }
+{
+    m_device->setPipelineStateObserver(this);
+}
+
+PipelineStateRecorder::~PipelineStateRecorder()
+{
+    if (m_device->pipelineStateObserver() == this)
+        m_device->setPipelineStateObserver(nullptr);
+}
+
+std::vector<uint8_t> PipelineStateRecorder::manifest() const
+{
+    std::lock_guard lock(m_mutex);
+
+    PipelineStateManifest::Writer writer;
+    writer(PipelineStateManifest::Magic, PipelineStateManifest::Version);
+    for (const Section *section : { &m_shaderModules, &m_bindGroupLayouts, &m_pipelineLayouts, &m_graphicsPipelines, &m_computePipelines }) {
+        writer(uint32_t(section->entries.size()));
+        for (const auto *entry : section->entries)
+            writer.append(*entry);
+    }
+    return writer.take();
+}
+
+bool PipelineStateRecorder::save(const std::filesystem::path &path) const
+{
+    const std::vector<uint8_t> data = manifest();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), std::streamsize(data.size()));
+    file.close();
+    if (!file) {
+        SPDLOG_WARN("Failed to write pipeline state manifest to {}", path.string());
+        return false;
+    }
+    return true;
+}
+
+size_t PipelineStateRecorder::graphicsPipelineCount() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_graphicsPipelines.entries.size();
+}
+
+size_t PipelineStateRecorder::computePipelineCount() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_computePipelines.entries.size();
+}
+
+size_t PipelineStateRecorder::skippedPipelineCount() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_skippedPipelineCount;
+}
+
+void PipelineStateRecorder::shaderModuleCreated(const KDGpu::Handle<KDGpu::ShaderModule_t> &shaderModule, const std::vector<uint32_t> &code)
+{
+    PipelineStateManifest::Writer writer;
+    writer(code);
+
+    std::lock_guard lock(m_mutex);
+    m_shaderModuleIndices[shaderModule] = m_shaderModules.add(writer.take());
+}
+
+void PipelineStateRecorder::bindGroupLayoutCreated(const KDGpu::Handle<KDGpu::BindGroupLayout_t> &bindGroupLayout, const KDGpu::BindGroupLayoutOptions &options)
+{
+    // Samplers are not captured, pipelines using this layout will be skipped
+    for (const auto &binding : options.bindings) {
+        if (!binding.immutableSamplers.empty())
+            return;
+    }
+
+    PipelineStateManifest::Writer writer;
+    writer(options);
+
+    std::lock_guard lock(m_mutex);
+    m_bindGroupLayoutIndices[bindGroupLayout] = m_bindGroupLayouts.add(writer.take());
+}
+
+void PipelineStateRecorder::pipelineLayoutCreated(const KDGpu::Handle<KDGpu::PipelineLayout_t> &pipelineLayout, const KDGpu::PipelineLayoutOptions &options)
+{
+    std::lock_guard lock(m_mutex);
+
+    std::vector<uint32_t> bindGroupLayoutIndices;
+    bindGroupLayoutIndices.reserve(options.bindGroupLayouts.size());
+    for (const auto &bindGroupLayout : options.bindGroupLayouts) {
+        const auto index = indexOf(m_bindGroupLayoutIndices, KDGpu::Handle<KDGpu::BindGroupLayout_t>(bindGroupLayout));
+        if (!index)
+            return;
+        bindGroupLayoutIndices.push_back(*index);
+    }
+
+    PipelineStateManifest::Writer writer;
+    writer(bindGroupLayoutIndices, options.pushConstantRanges);
+    m_pipelineLayoutIndices[pipelineLayout] = m_pipelineLayouts.add(writer.take());
+}
+
+void PipelineStateRecorder::graphicsPipelineRequested(const KDGpu::GraphicsPipelineOptions &options)
+{
+    std::lock_guard lock(m_mutex);
+
+    // Render passes are not captured
+    const auto layoutIndex = indexOf(m_pipelineLayoutIndices, KDGpu::Handle<KDGpu::PipelineLayout_t>(options.layout));
+    if (options.renderPass.isValid() || !layoutIndex) {
+        ++m_skippedPipelineCount;
+        return;
+    }
+
+    PipelineStateManifest::Writer writer;
+    writer(*layoutIndex, uint32_t(options.shaderStages.size()));
+    for (const auto &stage : options.shaderStages) {
+        const auto shaderModuleIndex = indexOf(m_shaderModuleIndices, KDGpu::Handle<KDGpu::ShaderModule_t>(stage.shaderModule));
+        if (!shaderModuleIndex) {
+            ++m_skippedPipelineCount;
+            return;
+        }
+        writer(*shaderModuleIndex, stage.stage, stage.entryPoint, stage.specializationConstants);
+    }
+    writer(options);
+    m_graphicsPipelines.add(writer.take());
+}
+
+void PipelineStateRecorder::computePipelineRequested(const KDGpu::ComputePipelineOptions &options)
+{
+    std::lock_guard lock(m_mutex);
+
+    const auto layoutIndex = indexOf(m_pipelineLayoutIndices, KDGpu::Handle<KDGpu::PipelineLayout_t>(options.layout));
+    const auto shaderModuleIndex = indexOf(m_shaderModuleIndices, KDGpu::Handle<KDGpu::ShaderModule_t>(options.shaderStage.shaderModule));
+    if (!layoutIndex || !shaderModuleIndex) {
+        ++m_skippedPipelineCount;
+        return;
+    }
+
+    PipelineStateManifest::Writer writer;
+    writer(*layoutIndex, *shaderModuleIndex, options.shaderStage.entryPoint, options.shaderStage.specializationConstants);
+    m_computePipelines.add(writer.take());
+}
+
+} // namespace KDGpuUtils
@@ -0,0 +1,89 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+
+#include <KDGpu/handle.h>
+#include <KDGpu/pipeline_state_observer.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace KDGpu {
+class Device;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+/**
+ * @brief Captures the pipelines created on a Device into a manifest
+ *
+ * The recorder installs itself as the Device's PipelineStateObserver and keeps
+ * the SPIR-V of every shader module, the bind group and pipeline layouts and the
+ * options of every graphics and compute pipeline requested afterwards. Identical
+ * objects are only stored once. The resulting manifest can be handed to a
+ * PipelineStateReplayer on the next run to fill a PipelineCache before the
+ * pipelines are needed.
+ *
+ * Pipelines are skipped if they use an explicit RenderPass, immutable samplers,
+ * or objects that were created before the recorder was installed.
+ */
+class KDGPUUTILS_EXPORT PipelineStateRecorder : public KDGpu::PipelineStateObserver
+{
+public:
+    explicit PipelineStateRecorder(KDGpu::Device *device);
+    ~PipelineStateRecorder() override;
+
+    PipelineStateRecorder(const PipelineStateRecorder &) = delete;
+    PipelineStateRecorder &operator=(const PipelineStateRecorder &) = delete;
+
+    std::vector<uint8_t> manifest() const;
+    bool save(const std::filesystem::path &path) const;
+
+    size_t graphicsPipelineCount() const;
+    size_t computePipelineCount() const;
+    size_t skippedPipelineCount() const;
+
+    void shaderModuleCreated(const KDGpu::Handle<KDGpu::ShaderModule_t> &shaderModule, const std::vector<uint32_t> &code) override;
+    void bindGroupLayoutCreated(const KDGpu::Handle<KDGpu::BindGroupLayout_t> &bindGroupLayout, const KDGpu::BindGroupLayoutOptions &options) override;
+    void pipelineLayoutCreated(const KDGpu::Handle<KDGpu::PipelineLayout_t> &pipelineLayout, const KDGpu::PipelineLayoutOptions &options) override;
+    void graphicsPipelineRequested(const KDGpu::GraphicsPipelineOptions &options) override;
+    void computePipelineRequested(const KDGpu::ComputePipelineOptions &options) override;
+
+private:
+    // Serialized entries in the order they were first seen
+    struct Section {
+        std::map<std::vector<uint8_t>, uint32_t> indices;
+        std::vector<const std::vector<uint8_t> *> entries;
+
+        uint32_t add(std::vector<uint8_t> &&entry);
+    };
+
+    KDGpu::Device *m_device{ nullptr };
+
+    mutable std::mutex m_mutex;
+    Section m_shaderModules;
+    Section m_bindGroupLayouts;
+    Section m_pipelineLayouts;
+    Section m_graphicsPipelines;
+    Section m_computePipelines;
+    std::unordered_map<KDGpu::Handle<KDGpu::ShaderModule_t>, uint32_t> m_shaderModuleIndices;
+    std::unordered_map<KDGpu::Handle<KDGpu::BindGroupLayout_t>, uint32_t> m_bindGroupLayoutIndices;
+    std::unordered_map<KDGpu::Handle<KDGpu::PipelineLayout_t>, uint32_t> m_pipelineLayoutIndices;
+    size_t m_skippedPipelineCount{ 0 };
+};
+
+} // namespace KDGpuUtils
@@ -0,0 +1,194 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/pipeline_state_replayer.h>
+#include <KDGpuUtils/pipeline_state_manifest.h>
+
+#include <KDGpu/bind_group_layout.h>
+#include <KDGpu/compute_pipeline.h>
+#include <KDGpu/device.h>
+#include <KDGpu/graphics_pipeline.h>
+#include <KDGpu/pipeline_layout.h>
+#include <KDGpu/shader_module.h>
+
+#include <KDUtils/logging.h>
+
+#include <fstream>
+#include <future>
+#include <vector>
+
+namespace KDGpuUtils {
+
+namespace {
+
+template<typename Resource>
+bool isValidIndex(const std::vector<Resource> &resources, uint32_t index)
+{
+    return index < resources.size() && resources[index].isValid();
+}
+
+// Calls fn with a Reader over each entry of the next section. Returns false if the manifest is truncated.
+template<typename Fn>
+bool forEachEntry(PipelineStateManifest::Reader &reader, Fn &&fn)
+{
+    uint32_t count = 0;
+    reader(count);
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        const std::span<const uint8_t> entry = reader.entry();
+        if (!reader.ok())
+            break;
+        PipelineStateManifest::Reader entryReader(entry);
+        fn(entryReader);
+    }
+    return reader.ok();
+}
+
+} // namespace
+
+PipelineStateReplayer::PipelineStateReplayer(KDGpu::Device *device)
+    : m_device{ device }
+{
+}
+
+PipelineReplayResult PipelineStateReplayer::replay(std::span<const uint8_t> manifest, const KDGpu::Handle<KDGpu::PipelineCache_t> &pipelineCache)
+{
+    using namespace PipelineStateManifest;
+
+    PipelineReplayResult result;
+    Reader reader(manifest);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    reader(magic, version);
+    if (!reader.ok() || magic != Magic || version != Version) {
+        SPDLOG_WARN("Ignoring pipeline state manifest with an unknown format");
+        return result;
+    }
+
+    // Entries that fail to parse or create are kept as invalid objects so that indices still line up
+    std::vector<KDGpu::ShaderModule> shaderModules;
+    bool complete = forEachEntry(reader, [&](Reader &entry) {
+        std::vector<uint32_t> code;
+        entry(code);
+        shaderModules.emplace_back(entry.ok() && !code.empty() ? m_device->createShaderModule(code) : KDGpu::ShaderModule());
+    });
+
+    std::vector<KDGpu::BindGroupLayout> bindGroupLayouts;
+    complete = complete && forEachEntry(reader, [&](Reader &entry) {
+        KDGpu::BindGroupLayoutOptions options;
+        entry(options);
+        bindGroupLayouts.emplace_back(entry.ok() ? m_device->createBindGroupLayout(options) : KDGpu::BindGroupLayout());
+    });
+
+    std::vector<KDGpu::PipelineLayout> pipelineLayouts;
+    complete = complete && forEachEntry(reader, [&](Reader &entry) {
+        std::vector<uint32_t> bindGroupLayoutIndices;
+        KDGpu::PipelineLayoutOptions options;
+        entry(bindGroupLayoutIndices, options.pushConstantRanges);
+
+        bool resolved = entry.ok();
+        for (const uint32_t index : bindGroupLayoutIndices) {
+            resolved = resolved && isValidIndex(bindGroupLayouts, index);
+            if (resolved)
+                options.bindGroupLayouts.emplace_back(bindGroupLayouts[index].handle());
+        }
+        pipelineLayouts.emplace_back(resolved ? m_device->createPipelineLayout(options) : KDGpu::PipelineLayout());
+    });
+
+    std::vector<std::future<KDGpu::GraphicsPipeline>> graphicsPipelines;
+    complete = complete && forEachEntry(reader, [&](Reader &entry) {
+        uint32_t layoutIndex = 0;
+        uint32_t stageCount = 0;
+        entry(layoutIndex, stageCount);
+
+        bool resolved = entry.ok() && isValidIndex(pipelineLayouts, layoutIndex);
+        std::vector<KDGpu::ShaderStage> shaderStages;
+        for (uint32_t i = 0; i < stageCount && resolved; ++i) {
+            uint32_t shaderModuleIndex = 0;
+            entry(shaderModuleIndex);
+            resolved = entry.ok() && isValidIndex(shaderModules, shaderModuleIndex);
+            if (!resolved)
+                break;
+            KDGpu::ShaderStage stage{ .shaderModule = shaderModules[shaderModuleIndex].handle() };
+            entry(stage.stage, stage.entryPoint, stage.specializationConstants);
+            shaderStages.push_back(std::move(stage));
+        }
+        if (!resolved) {
+            ++result.failedPipelines;
+            return;
+        }
+
+        KDGpu::GraphicsPipelineOptions options{
+            .shaderStages = std::move(shaderStages),
+            .layout = pipelineLayouts[layoutIndex].handle(),
+            .pipelineCache = pipelineCache,
+        };
+        entry(options);
+        if (!entry.ok()) {
+            ++result.failedPipelines;
+            return;
+        }
+        graphicsPipelines.push_back(m_device->createGraphicsPipelineAsync(options));
+    });
+
+    std::vector<std::future<KDGpu::ComputePipeline>> computePipelines;
+    complete = complete && forEachEntry(reader, [&](Reader &entry) {
+        uint32_t layoutIndex = 0;
+        uint32_t shaderModuleIndex = 0;
+        entry(layoutIndex, shaderModuleIndex);
+        if (!entry.ok() || !isValidIndex(pipelineLayouts, layoutIndex) || !isValidIndex(shaderModules, shaderModuleIndex)) {
+            ++result.failedPipelines;
+            return;
+        }
+
+        KDGpu::ComputePipelineOptions options{
+            .layout = pipelineLayouts[layoutIndex].handle(),
+            .shaderStage = { .shaderModule = shaderModules[shaderModuleIndex].handle() },
+            .pipelineCache = pipelineCache,
+        };
+        entry(options.shaderStage.entryPoint, options.shaderStage.specializationConstants);
+        if (!entry.ok()) {
+            ++result.failedPipelines;
+            return;
+        }
+        computePipelines.push_back(m_device->createComputePipelineAsync(options));
+    });
+
+    if (!complete)
+        SPDLOG_WARN("Pipeline state manifest is truncated, replaying what could be read");
+    result.manifestValid = complete;
+
+    // The pipelines themselves are not needed, only what they left in the cache
+    for (auto &future : graphicsPipelines) {
+        if (future.get().isValid())
+            ++result.graphicsPipelines;
+        else
+            ++result.failedPipelines;
+    }
+    for (auto &future : computePipelines) {
+        if (future.get().isValid())
+            ++result.computePipelines;
+        else
+            ++result.failedPipelines;
+    }
+    return result;
+}
+
+PipelineReplayResult PipelineStateReplayer::replay(const std::filesystem::path &path, const KDGpu::Handle<KDGpu::PipelineCache_t> &pipelineCache)
+{
+    std::ifstream file(path, std::ios::binary);
+    const std::vector<uint8_t> manifest{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    if (manifest.empty()) {
+        SPDLOG_WARN("Failed to read pipeline state manifest {}", path.string());
+        return {};
+    }
+    return replay(manifest, pipelineCache);
+}
+
+} // namespace KDGpuUtils
@@ -0,0 +1,59 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+
+#include <KDGpu/handle.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace KDGpu {
+class Device;
+struct PipelineCache_t;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+struct PipelineReplayResult {
+    bool manifestValid{ false };
+    uint32_t graphicsPipelines{ 0 };
+    uint32_t computePipelines{ 0 };
+    uint32_t failedPipelines{ 0 };
+};
+
+/**
+ * @brief Recreates the pipelines captured by a PipelineStateRecorder
+ *
+ * All pipelines in the manifest are compiled with the given PipelineCache and
+ * destroyed again once they are done, leaving the cache warm for when the
+ * application requests them. Compilation goes through
+ * Device::createGraphicsPipelineAsync() and Device::createComputePipelineAsync()
+ * and so runs in parallel when KDGpu is built with KDGPU_CONCURRENT_RESOURCE_MANAGER.
+ *
+ * Combined with a PersistentPipelineCache this can also run as an offline step
+ * that produces the cache file shipped with the application.
+ */
+class KDGPUUTILS_EXPORT PipelineStateReplayer
+{
+public:
+    explicit PipelineStateReplayer(KDGpu::Device *device);
+
+    PipelineReplayResult replay(std::span<const uint8_t> manifest, const KDGpu::Handle<KDGpu::PipelineCache_t> &pipelineCache);
+    PipelineReplayResult replay(const std::filesystem::path &path, const KDGpu::Handle<KDGpu::PipelineCache_t> &pipelineCache);
+
+private:
+    KDGpu::Device *m_device{ nullptr };
+};
+
+} // namespace KDGpuUtils
@@ -0,0 +1,169 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/readback_ring.h>
+
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/memory_barrier.h>
+#include <KDGpu/timeline_semaphore.h>
+
+#include <KDUtils/logging.h>
+
+namespace KDGpuUtils {
+
+ReadbackRing::ReadbackRing(KDGpu::Device *device, uint32_t slotCount, KDGpu::DeviceSize slotSize)
+    : m_slotSize(slotSize)
+{
+    m_slots.reserve(slotCount);
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        KDGpu::Buffer buffer = device->createBuffer(KDGpu::BufferOptions{
+                .label = "ReadbackRing",
+                .size = slotSize,
+                .usage = KDGpu::BufferUsageFlagBits::TransferDstBit,
+                .memoryUsage = KDGpu::MemoryUsage::GpuToCpu,
+                .persistentlyMapped = true,
+        });
+        const auto *mapped = static_cast<const uint8_t *>(buffer.mappedPointer());
+        if (!mapped) {
+            SPDLOG_WARN("ReadbackRing: unable to map a buffer of {} bytes", slotSize);
+            m_slots.clear();
+            return;
+        }
+        m_slots.push_back(Slot{ .buffer = std::move(buffer), .mapped = mapped });
+    }
+}
+
+ReadbackRing::Slot *ReadbackRing::acquireSlot(KDGpu::DeviceSize byteSize)
+{
+    if (byteSize > m_slotSize) {
+        SPDLOG_WARN("ReadbackRing: {} bytes do not fit in a slot of {} bytes", byteSize, m_slotSize);
+        return nullptr;
+    }
+    if (m_slots.empty() || m_slots[m_next].state != SlotState::Free)
+        return nullptr;
+    return &m_slots[m_next];
+}
+
+uint64_t ReadbackRing::finishRecording(KDGpu::CommandRecorder &recorder, Slot &slot, KDGpu::DeviceSize byteSize, Callback &&onReady)
+{
+    // Make the copy visible to the host once the submission completed
+    recorder.bufferMemoryBarrier(KDGpu::BufferMemoryBarrierOptions{
+            .srcStages = KDGpu::PipelineStageFlagBit::TransferBit,
+            .srcMask = KDGpu::AccessFlagBit::TransferWriteBit,
+            .dstStages = KDGpu::PipelineStageFlagBit::HostBit,
+            .dstMask = KDGpu::AccessFlagBit::HostReadBit,
+            .buffer = slot.buffer,
+            .size = byteSize,
+    });
+
+    slot.state = SlotState::Recorded;
+    slot.id = m_nextId++;
+    slot.byteSize = byteSize;
+    slot.onReady = std::move(onReady);
+    m_next = (m_next + 1) % static_cast<uint32_t>(m_slots.size());
+    ++m_inFlightCount;
+    return slot.id;
+}
+
+std::optional<uint64_t> ReadbackRing::readBuffer(KDGpu::CommandRecorder &recorder, const KDGpu::Handle<KDGpu::Buffer_t> &buffer,
+                                                 KDGpu::DeviceSize offset, KDGpu::DeviceSize byteSize, Callback onReady)
+{
+    Slot *slot = acquireSlot(byteSize);
+    if (!slot)
+        return std::nullopt;
+
+    recorder.copyBuffer(KDGpu::BufferCopy{
+            .src = buffer,
+            .srcOffset = offset,
+            .dst = slot->buffer,
+            .byteSize = byteSize,
+    });
+    return finishRecording(recorder, *slot, byteSize, std::move(onReady));
+}
+
+std::optional<uint64_t> ReadbackRing::readTexture(KDGpu::CommandRecorder &recorder, const TextureReadbackOptions &options, Callback onReady)
+{
+    Slot *slot = acquireSlot(options.byteSize);
+    if (!slot)
+        return std::nullopt;
+
+    KDGpu::BufferTextureCopyRegion region = options.region;
+    region.bufferOffset = 0;
+    recorder.copyTextureToBuffer(KDGpu::TextureToBufferCopy{
+            .srcTexture = options.texture,
+            .srcTextureLayout = options.layout,
+            .dstBuffer = slot->buffer,
+            .regions = { region },
+    });
+    return finishRecording(recorder, *slot, options.byteSize, std::move(onReady));
+}
+
+void ReadbackRing::submitted(const KDGpu::Fence &fence)
+{
+    for (Slot &slot : m_slots) {
+        if (slot.state != SlotState::Recorded)
+            continue;
+        slot.state = SlotState::Submitted;
+        slot.fence = &fence;
+        slot.timelineSemaphore = nullptr;
+    }
+}
+
+void ReadbackRing::submitted(const KDGpu::TimelineSemaphore &timelineSemaphore, uint64_t value)
+{
+    for (Slot &slot : m_slots) {
+        if (slot.state != SlotState::Recorded)
+            continue;
+        slot.state = SlotState::Submitted;
+        slot.fence = nullptr;
+        slot.timelineSemaphore = &timelineSemaphore;
+        slot.timelineValue = value;
+    }
+}
+
+bool ReadbackRing::isComplete(const Slot &slot) const
+{
+    if (slot.state != SlotState::Submitted)
+        return false;
+    if (slot.fence)
+        return slot.fence->status() == KDGpu::FenceStatus::Signalled;
+    return slot.timelineSemaphore->value() >= slot.timelineValue;
+}
+
+size_t ReadbackRing::poll(const Callback &visitor)
+{
+    size_t delivered = 0;
+
+    // Readbacks complete in submission order, stop at the first one still in flight
+    while (m_inFlightCount > 0 && isComplete(m_slots[m_oldest])) {
+        Slot &slot = m_slots[m_oldest];
+        slot.buffer.invalidate(0, slot.byteSize);
+
+        const std::span<const uint8_t> data(slot.mapped, slot.byteSize);
+        if (slot.onReady)
+            slot.onReady(slot.id, data);
+        if (visitor)
+            visitor(slot.id, data);
+
+        slot.state = SlotState::Free;
+        slot.onReady = {};
+        slot.fence = nullptr;
+        slot.timelineSemaphore = nullptr;
+        m_oldest = (m_oldest + 1) % static_cast<uint32_t>(m_slots.size());
+        --m_inFlightCount;
+        ++delivered;
+    }
+
+    return delivered;
+}
+
+} // namespace KDGpuUtils
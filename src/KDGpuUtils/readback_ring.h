@@ -0,0 +1,115 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+
+#include <KDGpu/buffer.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/gpu_core.h>
+#include <KDGpu/handle.h>
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace KDGpu {
+class Device;
+class Fence;
+class TimelineSemaphore;
+struct Buffer_t;
+struct Texture_t;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+struct TextureReadbackOptions {
+    KDGpu::Handle<KDGpu::Texture_t> texture;
+    KDGpu::TextureLayout layout{ KDGpu::TextureLayout::TransferSrcOptimal };
+    // bufferOffset is ignored, texels are tightly packed unless bufferRowLength says otherwise
+    KDGpu::BufferTextureCopyRegion region;
+    KDGpu::DeviceSize byteSize{ 0 };
+};
+
+/**
+ * @brief Reads buffers and textures back to the CPU without waiting for the GPU
+ *
+ * The ring holds slotCount persistently mapped GpuToCpu buffers of slotSize bytes.
+ * readBuffer() and readTexture() record a copy into the next free slot; the readbacks
+ * recorded since the previous submitted() call complete with the Fence or the
+ * TimelineSemaphore value passed to it. poll() hands the data of completed readbacks,
+ * oldest first, to their callback and to the visitor passed to it, then recycles
+ * their slots. The data is only valid during these calls.
+ *
+ * With slotCount readbacks in flight, readBuffer() and readTexture() return no id
+ * until poll() recycled a slot.
+ */
+class KDGPUUTILS_EXPORT ReadbackRing
+{
+public:
+    using Callback = std::function<void(uint64_t id, std::span<const uint8_t> data)>;
+
+    ReadbackRing(KDGpu::Device *device, uint32_t slotCount, KDGpu::DeviceSize slotSize);
+
+    ReadbackRing(const ReadbackRing &) = delete;
+    ReadbackRing &operator=(const ReadbackRing &) = delete;
+
+    // The buffer has to be written before the copy, its access is synchronized by the caller
+    std::optional<uint64_t> readBuffer(KDGpu::CommandRecorder &recorder, const KDGpu::Handle<KDGpu::Buffer_t> &buffer,
+                                       KDGpu::DeviceSize offset, KDGpu::DeviceSize byteSize, Callback onReady = {});
+    // The texture has to be in options.layout already
+    std::optional<uint64_t> readTexture(KDGpu::CommandRecorder &recorder, const TextureReadbackOptions &options, Callback onReady = {});
+
+    // fence and timelineSemaphore must outlive the readbacks
+    void submitted(const KDGpu::Fence &fence);
+    void submitted(const KDGpu::TimelineSemaphore &timelineSemaphore, uint64_t value);
+
+    // Returns the number of readbacks delivered
+    size_t poll(const Callback &visitor = {});
+
+    uint32_t slotCount() const noexcept { return static_cast<uint32_t>(m_slots.size()); }
+    KDGpu::DeviceSize slotSize() const noexcept { return m_slotSize; }
+    uint32_t inFlightCount() const noexcept { return m_inFlightCount; }
+
+private:
+    enum class SlotState : uint8_t {
+        Free,
+        Recorded,
+        Submitted,
+    };
+
+    struct Slot {
+        KDGpu::Buffer buffer;
+        const uint8_t *mapped{ nullptr };
+        SlotState state{ SlotState::Free };
+        uint64_t id{ 0 };
+        KDGpu::DeviceSize byteSize{ 0 };
+        Callback onReady;
+        const KDGpu::Fence *fence{ nullptr };
+        const KDGpu::TimelineSemaphore *timelineSemaphore{ nullptr };
+        uint64_t timelineValue{ 0 };
+    };
+
+    Slot *acquireSlot(KDGpu::DeviceSize byteSize);
+    uint64_t finishRecording(KDGpu::CommandRecorder &recorder, Slot &slot, KDGpu::DeviceSize byteSize, Callback &&onReady);
+    bool isComplete(const Slot &slot) const;
+
+    KDGpu::DeviceSize m_slotSize{ 0 };
+    std::vector<Slot> m_slots;
+    // Slots are used in order, m_oldest is the next one to complete
+    uint32_t m_next{ 0 };
+    uint32_t m_oldest{ 0 };
+    uint32_t m_inFlightCount{ 0 };
+    uint64_t m_nextId{ 1 };
+};
+
+} // namespace KDGpuUtils
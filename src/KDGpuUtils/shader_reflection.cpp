@@ -0,0 +1,533 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/shader_reflection.h>
+
+#include <KDUtils/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <unordered_map>
+
+namespace KDGpuUtils {
+
+namespace {
+
+// The subset of the SPIR-V specification needed to find a shader's resource interface
+namespace Spv {
+constexpr uint32_t MagicNumber = 0x07230203;
+constexpr size_t HeaderWordCount = 5;
+
+enum Op : uint32_t {
+    OpEntryPoint = 15,
+    OpTypeBool = 20,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpSpecConstant = 50,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+    OpTypeAccelerationStructureKHR = 5341,
+};
+
+enum Decoration : uint32_t {
+    Block = 2,
+    BufferBlock = 3,
+    ArrayStride = 6,
+    MatrixStride = 7,
+    BuiltIn = 11,
+    Location = 30,
+    Binding = 33,
+    DescriptorSet = 34,
+    Offset = 35,
+};
+
+enum StorageClass : uint32_t {
+    UniformConstant = 0,
+    Input = 1,
+    Uniform = 2,
+    PushConstant = 9,
+    StorageBuffer = 12,
+};
+
+enum Dim : uint32_t {
+    DimBuffer = 5,
+    DimSubpassData = 6,
+};
+} // namespace Spv
+
+std::optional<KDGpu::ShaderStageFlagBits> stageForExecutionModel(uint32_t model)
+{
+    switch (model) {
+    case 0:
+        return KDGpu::ShaderStageFlagBits::VertexBit;
+    case 1:
+        return KDGpu::ShaderStageFlagBits::TessellationControlBit;
+    case 2:
+        return KDGpu::ShaderStageFlagBits::TessellationEvaluationBit;
+    case 3:
+        return KDGpu::ShaderStageFlagBits::GeometryBit;
+    case 4:
+        return KDGpu::ShaderStageFlagBits::FragmentBit;
+    case 5:
+        return KDGpu::ShaderStageFlagBits::ComputeBit;
+    case 5267:
+    case 5364:
+        return KDGpu::ShaderStageFlagBits::TaskBit;
+    case 5268:
+    case 5365:
+        return KDGpu::ShaderStageFlagBits::MeshBit;
+    case 5313:
+        return KDGpu::ShaderStageFlagBits::RaygenBit;
+    case 5314:
+        return KDGpu::ShaderStageFlagBits::IntersectionBit;
+    case 5315:
+        return KDGpu::ShaderStageFlagBits::AnyHitBit;
+    case 5316:
+        return KDGpu::ShaderStageFlagBits::ClosestHitBit;
+    case 5317:
+        return KDGpu::ShaderStageFlagBits::MissBit;
+    case 5318:
+        return KDGpu::ShaderStageFlagBits::CallableBit;
+    default:
+        return std::nullopt;
+    }
+}
+
+KDGpu::Format vertexFormat(uint32_t componentOpcode, bool isSigned, uint32_t width, uint32_t componentCount)
+{
+    using KDGpu::Format;
+    constexpr std::array<Format, 4> floatFormats = { Format::R32_SFLOAT, Format::R32G32_SFLOAT, Format::R32G32B32_SFLOAT, Format::R32G32B32A32_SFLOAT };
+    constexpr std::array<Format, 4> intFormats = { Format::R32_SINT, Format::R32G32_SINT, Format::R32G32B32_SINT, Format::R32G32B32A32_SINT };
+    constexpr std::array<Format, 4> uintFormats = { Format::R32_UINT, Format::R32G32_UINT, Format::R32G32B32_UINT, Format::R32G32B32A32_UINT };
+
+    if (width != 32 || componentCount < 1 || componentCount > 4)
+        return Format::UNDEFINED;
+    if (componentOpcode == Spv::OpTypeFloat)
+        return floatFormats[componentCount - 1];
+    return isSigned ? intFormats[componentCount - 1] : uintFormats[componentCount - 1];
+}
+
+struct Decorations {
+    std::optional<uint32_t> set;
+    std::optional<uint32_t> binding;
+    std::optional<uint32_t> location;
+    uint32_t arrayStride{ 0 };
+    bool builtIn{ false };
+    bool block{ false };
+    bool bufferBlock{ false };
+};
+
+struct MemberDecorations {
+    uint32_t offset{ 0 };
+    uint32_t matrixStride{ 0 };
+};
+
+class Module
+{
+public:
+    bool parse(std::span<const uint32_t> code)
+    {
+        if (code.size() < Spv::HeaderWordCount || code[0] != Spv::MagicNumber)
+            return false;
+
+        size_t offset = Spv::HeaderWordCount;
+        while (offset < code.size()) {
+            const uint32_t wordCount = code[offset] >> 16;
+            const uint32_t opcode = code[offset] & 0xffff;
+            if (wordCount == 0 || offset + wordCount > code.size())
+                return false;
+            addInstruction(opcode, code.subspan(offset + 1, wordCount - 1));
+            offset += wordCount;
+        }
+        return true;
+    }
+
+    ShaderReflection reflect() const
+    {
+        ShaderReflection reflection;
+        reflection.shaderStages = m_stages;
+
+        for (const auto &[id, variable] : m_variables) {
+            const auto &decorations = decorationsFor(id);
+            const auto pointer = m_types.find(variable.typeId);
+            if (pointer == m_types.end() || pointer->second.opcode != Spv::OpTypePointer || pointer->second.operands.size() < 2)
+                continue;
+            const uint32_t pointeeId = pointer->second.operands[1];
+
+            switch (variable.storageClass) {
+            case Spv::UniformConstant:
+            case Spv::Uniform:
+            case Spv::StorageBuffer:
+                if (auto binding = bindingFor(variable.storageClass, pointeeId, decorations))
+                    reflection.bindings.push_back(*binding);
+                break;
+            case Spv::PushConstant:
+                if (const auto range = pushConstantRangeFor(pointeeId))
+                    reflection.pushConstantRanges.push_back(*range);
+                break;
+            case Spv::Input:
+                if (m_stages.testFlag(KDGpu::ShaderStageFlagBits::VertexBit) && decorations.location && !decorations.builtIn)
+                    addVertexInputs(reflection.vertexInputs, *decorations.location, pointeeId);
+                break;
+            default:
+                break;
+            }
+        }
+
+        std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const auto &a, const auto &b) {
+            return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+        });
+        std::sort(reflection.vertexInputs.begin(), reflection.vertexInputs.end(), [](const auto &a, const auto &b) {
+            return a.location < b.location;
+        });
+        return reflection;
+    }
+
+private:
+    struct Type {
+        uint32_t opcode{ 0 };
+        std::vector<uint32_t> operands; // Without the result id
+    };
+
+    struct Variable {
+        uint32_t typeId{ 0 };
+        uint32_t storageClass{ 0 };
+    };
+
+    void addInstruction(uint32_t opcode, std::span<const uint32_t> operands)
+    {
+        switch (opcode) {
+        case Spv::OpEntryPoint:
+            if (const auto stage = operands.empty() ? std::nullopt : stageForExecutionModel(operands[0]))
+                m_stages |= *stage;
+            break;
+        case Spv::OpTypeBool:
+        case Spv::OpTypeInt:
+        case Spv::OpTypeFloat:
+        case Spv::OpTypeVector:
+        case Spv::OpTypeMatrix:
+        case Spv::OpTypeImage:
+        case Spv::OpTypeSampler:
+        case Spv::OpTypeSampledImage:
+        case Spv::OpTypeArray:
+        case Spv::OpTypeRuntimeArray:
+        case Spv::OpTypeStruct:
+        case Spv::OpTypePointer:
+        case Spv::OpTypeAccelerationStructureKHR:
+            if (!operands.empty())
+                m_types[operands[0]] = Type{ opcode, { operands.begin() + 1, operands.end() } };
+            break;
+        case Spv::OpConstant:
+        case Spv::OpSpecConstant:
+            // Only 32 bit values are needed, array lengths
+            if (operands.size() >= 3)
+                m_constants[operands[1]] = operands[2];
+            break;
+        case Spv::OpVariable:
+            if (operands.size() >= 3)
+                m_variables[operands[1]] = Variable{ operands[0], operands[2] };
+            break;
+        case Spv::OpDecorate:
+            if (operands.size() >= 2)
+                addDecoration(m_decorations[operands[0]], operands[1], operands.subspan(2));
+            break;
+        case Spv::OpMemberDecorate:
+            if (operands.size() >= 4) {
+                auto &member = m_memberDecorations[memberKey(operands[0], operands[1])];
+                if (operands[2] == Spv::Offset)
+                    member.offset = operands[3];
+                else if (operands[2] == Spv::MatrixStride)
+                    member.matrixStride = operands[3];
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    static void addDecoration(Decorations &decorations, uint32_t decoration, std::span<const uint32_t> values)
+    {
+        const uint32_t value = values.empty() ? 0 : values[0];
+        switch (decoration) {
+        case Spv::DescriptorSet:
+            decorations.set = value;
+            break;
+        case Spv::Binding:
+            decorations.binding = value;
+            break;
+        case Spv::Location:
+            decorations.location = value;
+            break;
+        case Spv::ArrayStride:
+            decorations.arrayStride = value;
+            break;
+        case Spv::BuiltIn:
+            decorations.builtIn = true;
+            break;
+        case Spv::Block:
+            decorations.block = true;
+            break;
+        case Spv::BufferBlock:
+            decorations.bufferBlock = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    static uint64_t memberKey(uint32_t structId, uint32_t member)
+    {
+        return (uint64_t(structId) << 32) | member;
+    }
+
+    const Decorations &decorationsFor(uint32_t id) const
+    {
+        static const Decorations none;
+        const auto it = m_decorations.find(id);
+        return it != m_decorations.end() ? it->second : none;
+    }
+
+    const Type *typeFor(uint32_t id) const
+    {
+        const auto it = m_types.find(id);
+        return it != m_types.end() ? &it->second : nullptr;
+    }
+
+    std::optional<ReflectedBinding> bindingFor(uint32_t storageClass, uint32_t typeId, const Decorations &decorations) const
+    {
+        if (!decorations.binding)
+            return std::nullopt;
+
+        ReflectedBinding binding{
+            .set = decorations.set.value_or(0),
+            .binding = *decorations.binding,
+            .shaderStages = m_stages,
+        };
+
+        // Arrays of resources become a binding with several entries
+        const Type *type = typeFor(typeId);
+        while (type && (type->opcode == Spv::OpTypeArray || type->opcode == Spv::OpTypeRuntimeArray)) {
+            if (type->opcode == Spv::OpTypeRuntimeArray) {
+                binding.count = 0;
+            } else if (type->operands.size() >= 2) {
+                const auto length = m_constants.find(type->operands[1]);
+                binding.count *= length != m_constants.end() ? length->second : 1;
+            }
+            typeId = type->operands[0];
+            type = typeFor(typeId);
+        }
+        if (!type)
+            return std::nullopt;
+
+        switch (type->opcode) {
+        case Spv::OpTypeSampler:
+            binding.resourceType = KDGpu::ResourceBindingType::Sampler;
+            return binding;
+        case Spv::OpTypeSampledImage:
+            binding.resourceType = KDGpu::ResourceBindingType::CombinedImageSampler;
+            return binding;
+        case Spv::OpTypeAccelerationStructureKHR:
+            binding.resourceType = KDGpu::ResourceBindingType::AccelerationStructure;
+            return binding;
+        case Spv::OpTypeImage: {
+            // Operands are sampled type, dim, depth, arrayed, ms, sampled, format
+            if (type->operands.size() < 6)
+                return std::nullopt;
+            const uint32_t dim = type->operands[1];
+            const bool storage = type->operands[5] == 2;
+            if (dim == Spv::DimSubpassData)
+                binding.resourceType = KDGpu::ResourceBindingType::InputAttachment;
+            else if (dim == Spv::DimBuffer)
+                binding.resourceType = storage ? KDGpu::ResourceBindingType::StorageTexelBuffer : KDGpu::ResourceBindingType::UniformTexelBuffer;
+            else
+                binding.resourceType = storage ? KDGpu::ResourceBindingType::StorageImage : KDGpu::ResourceBindingType::SampledImage;
+            return binding;
+        }
+        case Spv::OpTypeStruct: {
+            // Before SPIR-V 1.3 storage buffers were Uniform blocks decorated with BufferBlock
+            const bool storageBuffer = storageClass == Spv::StorageBuffer || decorationsFor(typeId).bufferBlock;
+            binding.resourceType = storageBuffer ? KDGpu::ResourceBindingType::StorageBuffer : KDGpu::ResourceBindingType::UniformBuffer;
+            return binding;
+        }
+        default:
+            return std::nullopt;
+        }
+    }
+
+    uint32_t sizeOf(uint32_t typeId, uint32_t matrixStride = 0) const
+    {
+        const Type *type = typeFor(typeId);
+        if (!type)
+            return 0;
+
+        switch (type->opcode) {
+        case Spv::OpTypeBool:
+            return 4;
+        case Spv::OpTypeInt:
+        case Spv::OpTypeFloat:
+            return type->operands.empty() ? 0 : type->operands[0] / 8;
+        case Spv::OpTypeVector:
+            return type->operands.size() < 2 ? 0 : type->operands[1] * sizeOf(type->operands[0]);
+        case Spv::OpTypeMatrix: {
+            if (type->operands.size() < 2)
+                return 0;
+            const uint32_t columnSize = matrixStride ? matrixStride : sizeOf(type->operands[0]);
+            return type->operands[1] * columnSize;
+        }
+        case Spv::OpTypeArray: {
+            if (type->operands.size() < 2)
+                return 0;
+            const auto length = m_constants.find(type->operands[1]);
+            const uint32_t stride = decorationsFor(typeId).arrayStride;
+            const uint32_t elementSize = stride ? stride : sizeOf(type->operands[0], matrixStride);
+            return length != m_constants.end() ? length->second * elementSize : 0;
+        }
+        case Spv::OpTypeStruct: {
+            uint32_t size = 0;
+            for (uint32_t member = 0; member < type->operands.size(); ++member) {
+                const auto it = m_memberDecorations.find(memberKey(typeId, member));
+                const MemberDecorations decorations = it != m_memberDecorations.end() ? it->second : MemberDecorations{};
+                size = std::max(size, decorations.offset + sizeOf(type->operands[member], decorations.matrixStride));
+            }
+            return size;
+        }
+        default:
+            return 0;
+        }
+    }
+
+    std::optional<KDGpu::PushConstantRange> pushConstantRangeFor(uint32_t structId) const
+    {
+        const Type *type = typeFor(structId);
+        if (!type || type->opcode != Spv::OpTypeStruct || type->operands.empty())
+            return std::nullopt;
+
+        // The block may start at an explicit offset, the range only covers what is declared
+        uint32_t begin = UINT32_MAX;
+        uint32_t end = 0;
+        for (uint32_t member = 0; member < type->operands.size(); ++member) {
+            const auto it = m_memberDecorations.find(memberKey(structId, member));
+            const MemberDecorations decorations = it != m_memberDecorations.end() ? it->second : MemberDecorations{};
+            begin = std::min(begin, decorations.offset);
+            end = std::max(end, decorations.offset + sizeOf(type->operands[member], decorations.matrixStride));
+        }
+        return KDGpu::PushConstantRange{ .offset = begin, .size = end - begin, .shaderStages = m_stages };
+    }
+
+    void addVertexInputs(std::vector<ReflectedVertexInput> &inputs, uint32_t location, uint32_t typeId) const
+    {
+        const Type *type = typeFor(typeId);
+        if (!type)
+            return;
+
+        // Matrices take one location per column
+        uint32_t columns = 1;
+        if (type->opcode == Spv::OpTypeMatrix && type->operands.size() >= 2) {
+            columns = type->operands[1];
+            type = typeFor(type->operands[0]);
+        }
+
+        uint32_t componentCount = 1;
+        if (type && type->opcode == Spv::OpTypeVector && type->operands.size() >= 2) {
+            componentCount = type->operands[1];
+            type = typeFor(type->operands[0]);
+        }
+        if (!type || (type->opcode != Spv::OpTypeFloat && type->opcode != Spv::OpTypeInt) || type->operands.empty())
+            return;
+
+        const bool isSigned = type->opcode == Spv::OpTypeInt && type->operands.size() >= 2 && type->operands[1] == 1;
+        const KDGpu::Format format = vertexFormat(type->opcode, isSigned, type->operands[0], componentCount);
+        for (uint32_t column = 0; column < columns; ++column)
+            inputs.push_back(ReflectedVertexInput{ .location = location + column, .format = format });
+    }
+
+    KDGpu::ShaderStageFlags m_stages;
+    std::unordered_map<uint32_t, Type> m_types;
+    std::unordered_map<uint32_t, uint32_t> m_constants;
+    std::unordered_map<uint32_t, Variable> m_variables;
+    std::unordered_map<uint32_t, Decorations> m_decorations;
+    std::unordered_map<uint64_t, MemberDecorations> m_memberDecorations;
+};
+
+} // namespace
+
+bool ShaderReflection::merge(const ShaderReflection &other)
+{
+    bool compatible = true;
+    shaderStages |= other.shaderStages;
+
+    for (const ReflectedBinding &binding : other.bindings) {
+        auto it = std::lower_bound(bindings.begin(), bindings.end(), binding, [](const auto &a, const auto &b) {
+            return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+        });
+        if (it == bindings.end() || it->set != binding.set || it->binding != binding.binding) {
+            bindings.insert(it, binding);
+        } else if (it->resourceType == binding.resourceType && it->count == binding.count) {
+            it->shaderStages |= binding.shaderStages;
+        } else {
+            SPDLOG_WARN("Shader stages disagree on set {} binding {}", binding.set, binding.binding);
+            compatible = false;
+        }
+    }
+
+    // Stages using the same range share it, anything else gets a range of its own
+    for (const KDGpu::PushConstantRange &range : other.pushConstantRanges) {
+        auto it = std::find_if(pushConstantRanges.begin(), pushConstantRanges.end(), [&range](const auto &existing) {
+            return existing.offset == range.offset && existing.size == range.size;
+        });
+        if (it != pushConstantRanges.end())
+            it->shaderStages |= range.shaderStages;
+        else
+            pushConstantRanges.push_back(range);
+    }
+
+    if (!other.vertexInputs.empty())
+        vertexInputs = other.vertexInputs;
+
+    return compatible;
+}
+
+std::vector<KDGpu::BindGroupLayoutOptions> ShaderReflection::bindGroupLayoutOptions(uint32_t unboundedArraySize) const
+{
+    std::vector<KDGpu::BindGroupLayoutOptions> options;
+    for (const ReflectedBinding &binding : bindings) {
+        if (binding.set >= options.size())
+            options.resize(binding.set + 1);
+        options[binding.set].bindings.push_back(KDGpu::ResourceBindingLayout{
+                .binding = binding.binding,
+                .count = binding.count ? binding.count : unboundedArraySize,
+                .resourceType = binding.resourceType,
+                .shaderStages = binding.shaderStages,
+        });
+    }
+    return options;
+}
+
+std::optional<ShaderReflection> reflectShader(std::span<const uint32_t> code)
+{
+    Module module;
+    if (!module.parse(code))
+        return std::nullopt;
+    return module.reflect();
+}
+
+} // namespace KDGpuUtils
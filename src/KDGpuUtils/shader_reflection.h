@@ -0,0 +1,70 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+
+#include <KDGpu/bind_group_layout_options.h>
+#include <KDGpu/gpu_core.h>
+#include <KDGpu/pipeline_layout_options.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace KDGpuUtils {
+
+struct ReflectedBinding {
+    uint32_t set{ 0 };
+    uint32_t binding{ 0 };
+    uint32_t count{ 1 }; // 0 for runtime sized arrays
+    KDGpu::ResourceBindingType resourceType{ KDGpu::ResourceBindingType::UniformBuffer };
+    KDGpu::ShaderStageFlags shaderStages;
+
+    friend bool operator==(const ReflectedBinding &, const ReflectedBinding &) = default;
+};
+
+struct ReflectedVertexInput {
+    uint32_t location{ 0 };
+    KDGpu::Format format{ KDGpu::Format::UNDEFINED };
+
+    friend bool operator==(const ReflectedVertexInput &, const ReflectedVertexInput &) = default;
+};
+
+/**
+ * @brief Resource interface of one or more shader stages, as read from their SPIR-V
+ *
+ * Uniform buffers are always reported as UniformBuffer and storage buffers as
+ * StorageBuffer since SPIR-V doesn't say whether they are bound with a dynamic
+ * offset.
+ */
+struct KDGPUUTILS_EXPORT ShaderReflection {
+    KDGpu::ShaderStageFlags shaderStages;
+    std::vector<ReflectedBinding> bindings; // Sorted by set, then binding
+    std::vector<KDGpu::PushConstantRange> pushConstantRanges;
+    std::vector<ReflectedVertexInput> vertexInputs; // Sorted by location, vertex stage only
+
+    // Adds the interface of another stage. Bindings declared by both stages must agree on
+    // their type and count, returns false and keeps the existing binding if they don't.
+    bool merge(const ShaderReflection &other);
+
+    // One entry per set up to the highest set used, sets without bindings are empty.
+    // Runtime sized arrays are given unboundedArraySize entries.
+    std::vector<KDGpu::BindGroupLayoutOptions> bindGroupLayoutOptions(uint32_t unboundedArraySize = 1024) const;
+
+    friend bool operator==(const ShaderReflection &, const ShaderReflection &) = default;
+};
+
+// Returns nullopt if code is not a SPIR-V module
+KDGPUUTILS_EXPORT std::optional<ShaderReflection> reflectShader(std::span<const uint32_t> code);
+
+} // namespace KDGpuUtils
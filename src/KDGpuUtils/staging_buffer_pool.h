@@ -16,8 +16,11 @@
 #include <KDGpu/buffer_options.h>
 #include <KDGpuUtils/resource_deleter.h>
 
-#include <map>
 #include <cassert>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
 
 constexpr unsigned long long operator""_Mb(unsigned long long const x)
 {
@@ -43,7 +46,7 @@ public:
 
     void derefFrameIndex(size_t frameIndex)
     {
-        assert(m_lastBin == nullptr); // Flush should have been called
+        assert(m_lastBin == NoBin); // Flush should have been called
         m_frameIndex = frameIndex;
     }
 
@@ -53,141 +56,137 @@ public:
         for (auto &bin : m_bins)
             m_deleter->deleteLater(std::move(bin.buffer));
         m_bins.clear();
+        m_frameBins.clear();
     }
 
-    std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> stage(std::span<const uint8_t> data)
+    std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> stage(std::span<const uint8_t> data, size_t alignment = 1)
     {
-        return stage(data.data(), data.size());
+        return stage(data.data(), data.size(), alignment);
     }
 
     // Returns offset at which data was copied into the staging buffer
-    // and handle to the underlying VkBuffer
-    std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> stage(const void *data, size_t byteSize)
+    // and handle to the underlying VkBuffer. The offset is a multiple of alignment,
+    // use AdapterLimits::optimalBufferCopyOffsetAlignment for buffer to texture copies
+    std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> stage(const void *data, size_t byteSize, size_t alignment = 1)
     {
-        assert(byteSize <= BinSize); // We can allocate a buffer largen than the BinSize for the StagingBuffer Pool
+        assert(alignment > 0);
 
-        auto copyContent = [this](const void *data, size_t byteSize) {
-            const Allocation alloc = m_lastBin->allocate(byteSize);
+        auto copyContent = [this](size_t binIndex, const void *data, size_t byteSize, size_t alignment) {
+            Bin &bin = m_bins[binIndex];
+            const size_t offset = bin.allocate(byteSize, alignment);
 
             // Copy content into buffer
-            std::memcpy(reinterpret_cast<uint8_t *>(m_lastBin->mapped) + alloc.offset, data, byteSize);
-            return std::make_pair(alloc.offset, m_lastBin->buffer.handle());
+            std::memcpy(reinterpret_cast<uint8_t *>(bin.mapped) + offset, data, byteSize);
+            return std::make_pair(offset, bin.buffer.handle());
         };
 
+        // Data larger than a bin gets a dedicated bin, released when moving to the next frame
+        if (byteSize > BinSize) {
+            const size_t binIndex = createBin(byteSize);
+            const auto result = copyContent(binIndex, data, byteSize, alignment);
+            m_bins[binIndex].unmap();
+            return result;
+        }
+
         // Find Bin with enough empty space to store around allocation
-        if (m_lastBin) {
-            if (m_lastBin->canAccommodate(byteSize)) {
+        if (m_lastBin != NoBin) {
+            if (m_bins[m_lastBin].canAccommodate(byteSize, alignment)) {
                 // We can use the bin and bin already mapped
-                return copyContent(data, byteSize);
+                return copyContent(m_lastBin, data, byteSize, alignment);
             }
             // Else -> last bin not big enough
 
             // Unmap and unset lastBin
-            m_lastBin->unmap();
-            m_lastBin = nullptr;
+            m_bins[m_lastBin].unmap();
+            m_lastBin = NoBin;
         }
 
-        // Check if any bin big enough
-        for (auto it = m_bins.begin(), end = m_bins.end(); it != end; ++it) {
-            if (it->frameIndex == m_frameIndex && it->canAccommodate(byteSize)) {
+        // Check if any bin of the current frame is big enough
+        for (const size_t binIndex : frameBins(m_frameIndex)) {
+            if (m_bins[binIndex].canAccommodate(byteSize, alignment)) {
                 // If satisfactory bin found, record it as lastBin
                 // and map it
-                m_lastBin = &(*it);
-                m_lastBin->map();
-                return copyContent(data, byteSize);
+                m_lastBin = binIndex;
+                m_bins[m_lastBin].map();
+                return copyContent(m_lastBin, data, byteSize, alignment);
             }
         }
 
         // Else -> create new bin if nothing can accommodate
-        m_bins.emplace_back(Bin{ m_frameIndex });
-        m_lastBin = &m_bins.back();
-
-        // Init bin (create VK Buffer) and map it
-        m_lastBin->init(m_device);
-        m_lastBin->map();
-        return copyContent(data, byteSize);
+        m_lastBin = createBin(BinSize);
+        frameBins(m_frameIndex).push_back(m_lastBin);
+        return copyContent(m_lastBin, data, byteSize, alignment);
     }
 
     void flush()
     {
         // Ensure we unmap last mapped bin
-        if (m_lastBin)
-            m_lastBin->unmap(); // Unmap
-        m_lastBin = nullptr;
+        if (m_lastBin != NoBin)
+            m_bins[m_lastBin].unmap(); // Unmap
+        m_lastBin = NoBin;
     }
 
     void moveToNextFrame()
     {
         // We should have been flushed before calling this
-        assert(m_lastBin == nullptr);
+        assert(m_lastBin == NoBin);
 
         // Early return if we have no bins
         if (m_bins.empty())
             return;
 
-        struct BinCounter {
-            int value = 0;
-        };
-        std::map<int, BinCounter> binToImageIndex;
+        for (auto &binIndices : m_frameBins)
+            binIndices.clear();
 
         // Destroy excess bins
-        // We keep at most MinimumBinCount bins for each frameIndex
-        for (int64_t m = m_bins.size() - 1; m >= 0; --m) {
-            const Bin &bin = m_bins[m];
-            BinCounter &binCounter = binToImageIndex[bin.frameIndex];
-            if (binCounter.value + 1 > MinimumBinCount) {
-                auto it = m_bins.begin() + m;
-                auto &bin = *it;
-                m_deleter->deleteLater(std::move(bin.buffer));
-                m_bins.erase(it);
+        // We keep at most MinimumBinCount bins for each frameIndex, dedicated bins are never kept
+        std::vector<Bin> keptBins;
+        keptBins.reserve(m_bins.size());
+        for (auto &bin : m_bins) {
+            std::vector<size_t> &binIndices = frameBins(bin.frameIndex);
+            if (bin.capacity == BinSize && binIndices.size() < MinimumBinCount) {
+                // Clean bins we keep alive
+                bin.clear();
+                binIndices.push_back(keptBins.size());
+                keptBins.emplace_back(std::move(bin));
             } else {
-                ++(binCounter.value);
+                m_deleter->deleteLater(std::move(bin.buffer));
             }
         }
-
-        // Clean bins we keep alive
-        for (auto &bin : m_bins)
-            bin.clear();
+        m_bins = std::move(keptBins);
     }
 
-    struct Allocation {
-        size_t offset = 0; // in bytes
-        size_t size = 0; // in bytes
-    };
-
     struct Bin {
 
-        bool canAccommodate(size_t s)
+        static size_t alignUp(size_t offset, size_t alignment)
         {
-            assert(s <= BinSize);
-            if (m_allocations.empty())
-                return true;
+            return (offset + alignment - 1) / alignment * alignment;
+        }
 
-            const Allocation &lastAlloc = m_allocations.back();
-            const size_t remainingCapacity = BinSize - (lastAlloc.offset + lastAlloc.size);
-            return remainingCapacity >= s;
+        bool canAccommodate(size_t s, size_t alignment) const
+        {
+            return alignUp(head, alignment) + s <= capacity;
         }
 
-        const Allocation &allocate(size_t s)
+        size_t allocate(size_t s, size_t alignment)
         {
             // Assume we can accommodate
-            Allocation lastAlloc;
-            if (!m_allocations.empty())
-                lastAlloc = m_allocations.back();
-
-            m_allocations.push_back({ lastAlloc.offset + lastAlloc.size, s });
-            return m_allocations.back();
+            const size_t offset = alignUp(head, alignment);
+            head = offset + s;
+            ++allocationCount;
+            return offset;
         }
 
         void clear()
         {
-            m_allocations.clear();
+            head = 0;
+            allocationCount = 0;
         }
 
         void init(KDGpu::Device *device)
         {
             buffer = device->createBuffer(KDGpu::BufferOptions{
-                    .size = BinSize,
+                    .size = capacity,
                     .usage = KDGpu::BufferUsageFlags(KDGpu::BufferUsageFlagBits::TransferSrcBit),
                     .memoryUsage = KDGpu::MemoryUsage::CpuOnly });
         }
@@ -206,17 +205,42 @@ public:
         }
 
         size_t frameIndex;
+        size_t capacity = BinSize; // in bytes, larger than BinSize for dedicated bins
         KDGpu::Buffer buffer;
         bool isMapped = false;
         void *mapped = nullptr;
-        std::vector<Allocation> m_allocations;
+        size_t head = 0; // in bytes, end of the last allocation
+        size_t allocationCount = 0;
     };
 
     const std::vector<Bin> &bins() const noexcept { return m_bins; }
 
 private:
+    static constexpr size_t NoBin = std::numeric_limits<size_t>::max();
+
+    // Creates a mapped bin for the current frame and returns its index
+    size_t createBin(size_t capacity)
+    {
+        m_bins.emplace_back(Bin{ .frameIndex = m_frameIndex, .capacity = capacity });
+        Bin &bin = m_bins.back();
+
+        // Init bin (create VK Buffer) and map it
+        bin.init(m_device);
+        bin.map();
+        return m_bins.size() - 1;
+    }
+
+    // Indices of the regular bins of a frame
+    std::vector<size_t> &frameBins(size_t frameIndex)
+    {
+        if (frameIndex >= m_frameBins.size())
+            m_frameBins.resize(frameIndex + 1);
+        return m_frameBins[frameIndex];
+    }
+
     std::vector<Bin> m_bins;
-    Bin *m_lastBin = nullptr;
+    std::vector<std::vector<size_t>> m_frameBins;
+    size_t m_lastBin = NoBin;
     KDGpu::Device *m_device = nullptr;
     ResourceDeleter *m_deleter = nullptr;
     size_t m_frameIndex = 0;
@@ -0,0 +1,170 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/texture_streamer.h>
+
+#include <KDGpu/adapter.h>
+#include <KDGpu/adapter_queue_type.h>
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/device.h>
+
+#include <KDUtils/logging.h>
+
+namespace KDGpuUtils {
+
+namespace {
+
+bool isTransferOnly(KDGpu::QueueFlags flags)
+{
+    return flags.testFlag(KDGpu::QueueFlagBits::TransferBit) &&
+            !flags.testFlag(KDGpu::QueueFlagBits::GraphicsBit) &&
+            !flags.testFlag(KDGpu::QueueFlagBits::ComputeBit);
+}
+
+} // namespace
+
+TextureStreamer::TextureStreamer(KDGpu::Device *device, KDGpu::Queue *graphicsQueue)
+    : m_device(device)
+    , m_graphicsQueue(graphicsQueue)
+    , m_transferQueue(graphicsQueue)
+{
+    for (KDGpu::Queue &queue : m_device->queues()) {
+        if (isTransferOnly(queue.flags())) {
+            m_transferQueue = &queue;
+            break;
+        }
+    }
+    if (!usesTransferQueue())
+        SPDLOG_WARN("TextureStreamer: no transfer only queue, uploading on the graphics queue");
+
+    m_timelineSemaphore = m_device->createTimelineSemaphore(KDGpu::TimelineSemaphoreOptions{ .initialValue = 0 });
+}
+
+std::optional<uint32_t> TextureStreamer::transferQueueTypeIndex(const KDGpu::Adapter &adapter)
+{
+    const auto queueTypes = adapter.queueTypes();
+    for (uint32_t i = 0, count = static_cast<uint32_t>(queueTypes.size()); i < count; ++i) {
+        if (isTransferOnly(queueTypes[i].flags))
+            return i;
+    }
+    return std::nullopt;
+}
+
+uint64_t TextureStreamer::uploadTextureData(const KDGpu::TextureUploadOptions &options)
+{
+    const KDGpu::BufferOptions stagingBufferOptions{
+        .size = options.byteSize,
+        .usage = KDGpu::BufferUsageFlagBits::TransferSrcBit,
+        .memoryUsage = KDGpu::MemoryUsage::CpuOnly,
+    };
+    KDGpu::Buffer stagingBuffer = m_device->createBuffer(stagingBufferOptions, options.data);
+
+    KDGpu::CommandRecorder commandRecorder = m_device->createCommandRecorder(KDGpu::CommandRecorderOptions{
+            .queue = m_transferQueue->handle(),
+    });
+
+    const KDGpu::TextureSubresourceRange range = KDGpu::textureUploadRange(options.range, options.regions);
+
+    commandRecorder.textureMemoryBarrier(KDGpu::TextureMemoryBarrierOptions{
+            .srcStages = KDGpu::PipelineStageFlagBit::TopOfPipeBit,
+            .dstStages = KDGpu::PipelineStageFlagBit::TransferBit,
+            .dstMask = KDGpu::AccessFlagBit::TransferWriteBit,
+            .oldLayout = options.oldLayout,
+            .newLayout = KDGpu::TextureLayout::TransferDstOptimal,
+            .texture = options.destinationTexture,
+            .range = range,
+    });
+
+    commandRecorder.copyBufferToTexture(KDGpu::BufferToTextureCopy{
+            .srcBuffer = stagingBuffer,
+            .dstTexture = options.destinationTexture,
+            .dstTextureLayout = KDGpu::TextureLayout::TransferDstOptimal,
+            .regions = options.regions,
+    });
+
+    if (usesTransferQueue()) {
+        // Release the texture to the graphics queue family, the layout transition happens
+        // between this barrier and the matching acquire recorded by recordAcquireBarriers()
+        KDGpu::TextureMemoryBarrierOptions ownershipTransfer{
+            .srcStages = KDGpu::PipelineStageFlagBit::TransferBit,
+            .srcMask = KDGpu::AccessFlagBit::TransferWriteBit,
+            .dstStages = KDGpu::PipelineStageFlagBit::BottomOfPipeBit,
+            .oldLayout = KDGpu::TextureLayout::TransferDstOptimal,
+            .newLayout = options.newLayout,
+            .srcQueueTypeIndex = m_transferQueue->queueTypeIndex(),
+            .dstQueueTypeIndex = m_graphicsQueue->queueTypeIndex(),
+            .texture = options.destinationTexture,
+            .range = range,
+        };
+        commandRecorder.textureMemoryBarrier(ownershipTransfer);
+
+        ownershipTransfer.srcStages = KDGpu::PipelineStageFlagBit::TopOfPipeBit;
+        ownershipTransfer.srcMask = KDGpu::AccessFlagBit::None;
+        ownershipTransfer.dstStages = options.dstStages;
+        ownershipTransfer.dstMask = options.dstMask;
+        m_pendingAcquires.push_back(ownershipTransfer);
+    } else {
+        commandRecorder.textureMemoryBarrier(KDGpu::TextureMemoryBarrierOptions{
+                .srcStages = KDGpu::PipelineStageFlagBit::TransferBit,
+                .srcMask = KDGpu::AccessFlagBit::TransferWriteBit,
+                .dstStages = options.dstStages,
+                .dstMask = options.dstMask,
+                .oldLayout = KDGpu::TextureLayout::TransferDstOptimal,
+                .newLayout = options.newLayout,
+                .texture = options.destinationTexture,
+                .range = range,
+        });
+    }
+
+    KDGpu::CommandBuffer commandBuffer = commandRecorder.finish();
+    const uint64_t value = ++m_submittedValue;
+    m_transferQueue->submit(KDGpu::SubmitOptions{
+            .commandBuffers = { commandBuffer },
+            .signalTimelineSemaphores = { { .semaphore = m_timelineSemaphore, .value = value } },
+    });
+
+    m_pendingUploads.push_back(PendingUpload{
+            .value = value,
+            .stagingBuffer = std::move(stagingBuffer),
+            .commandBuffer = std::move(commandBuffer),
+    });
+    return value;
+}
+
+void TextureStreamer::recordAcquireBarriers(KDGpu::CommandRecorder &recorder)
+{
+    if (m_pendingAcquires.empty())
+        return;
+    recorder.textureMemoryBarriers(m_pendingAcquires);
+    m_pendingAcquires.clear();
+}
+
+KDGpu::TimelineSemaphoreSubmitWaitInfo TextureStreamer::waitInfo(KDGpu::PipelineStageFlags waitStages) const
+{
+    return KDGpu::TimelineSemaphoreSubmitWaitInfo{
+        .semaphore = m_timelineSemaphore,
+        .value = m_submittedValue,
+        .waitStages = waitStages,
+    };
+}
+
+void TextureStreamer::releaseCompleted()
+{
+    if (m_pendingUploads.empty())
+        return;
+
+    // Uploads complete in submission order
+    const uint64_t completedValue = m_timelineSemaphore.value();
+    while (!m_pendingUploads.empty() && m_pendingUploads.front().value <= completedValue)
+        m_pendingUploads.pop_front();
+}
+
+} // namespace KDGpuUtils
@@ -0,0 +1,93 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+
+#include <KDGpu/buffer.h>
+#include <KDGpu/command_buffer.h>
+#include <KDGpu/gpu_core.h>
+#include <KDGpu/memory_barrier.h>
+#include <KDGpu/queue.h>
+#include <KDGpu/timeline_semaphore.h>
+
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace KDGpu {
+class Adapter;
+class CommandRecorder;
+class Device;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+/**
+ * @brief Uploads textures on a transfer only queue while the graphics queue keeps rendering
+ *
+ * The Device has to be created with a queue of transferQueueTypeIndex() and with the
+ * timelineSemaphore feature enabled. Without a transfer only queue, uploads are submitted
+ * to the graphics queue instead, which still takes them off the rendering submissions.
+ *
+ * uploadTextureData() records the copy and a queue family ownership release of the
+ * texture, submits it to the transfer queue and signals timelineSemaphore() with the
+ * returned value. Before using the textures, the graphics queue records the matching
+ * acquire barriers with recordAcquireBarriers() and its submission waits on waitInfo().
+ *
+ * Staging buffers are released by releaseCompleted() once their upload completed.
+ */
+class KDGPUUTILS_EXPORT TextureStreamer
+{
+public:
+    TextureStreamer(KDGpu::Device *device, KDGpu::Queue *graphicsQueue);
+
+    TextureStreamer(const TextureStreamer &) = delete;
+    TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+    // Index of a queue type only supporting transfers, to request when creating the Device
+    static std::optional<uint32_t> transferQueueTypeIndex(const KDGpu::Adapter &adapter);
+
+    // Regions have to respect Queue::minImageTransferGranularity() of transferQueue().
+    // Returns the timeline value signalled once the upload completed.
+    uint64_t uploadTextureData(const KDGpu::TextureUploadOptions &options);
+
+    // Records the ownership acquire of the textures uploaded since the previous call,
+    // recorder has to be submitted to the graphics queue waiting on waitInfo()
+    void recordAcquireBarriers(KDGpu::CommandRecorder &recorder);
+
+    KDGpu::TimelineSemaphoreSubmitWaitInfo waitInfo(KDGpu::PipelineStageFlags waitStages = KDGpu::PipelineStageFlagBit::TopOfPipeBit) const;
+
+    void releaseCompleted();
+
+    bool usesTransferQueue() const noexcept { return m_transferQueue != m_graphicsQueue; }
+    KDGpu::Queue *transferQueue() const noexcept { return m_transferQueue; }
+    const KDGpu::TimelineSemaphore &timelineSemaphore() const noexcept { return m_timelineSemaphore; }
+    uint64_t submittedValue() const noexcept { return m_submittedValue; }
+    size_t pendingUploadCount() const noexcept { return m_pendingUploads.size(); }
+
+private:
+    struct PendingUpload {
+        uint64_t value{ 0 };
+        KDGpu::Buffer stagingBuffer;
+        KDGpu::CommandBuffer commandBuffer;
+    };
+
+    KDGpu::Device *m_device{ nullptr };
+    KDGpu::Queue *m_graphicsQueue{ nullptr };
+    KDGpu::Queue *m_transferQueue{ nullptr };
+    KDGpu::TimelineSemaphore m_timelineSemaphore;
+    uint64_t m_submittedValue{ 0 };
+    std::deque<PendingUpload> m_pendingUploads;
+    std::vector<KDGpu::TextureMemoryBarrierOptions> m_pendingAcquires;
+};
+
+} // namespace KDGpuUtils
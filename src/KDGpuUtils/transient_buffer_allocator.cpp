@@ -0,0 +1,196 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/transient_buffer_allocator.h>
+
+#include <KDGpu/adapter.h>
+#include <KDGpu/adapter_properties.h>
+#include <KDGpu/bind_group_options.h>
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/timeline_semaphore.h>
+
+#include <KDUtils/logging.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace KDGpuUtils {
+
+namespace {
+
+KDGpu::DeviceSize alignUp(KDGpu::DeviceSize value, KDGpu::DeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+TransientBufferAllocator::TransientBufferAllocator(KDGpu::Device *device, KDGpu::DeviceSize capacity, KDGpu::BufferUsageFlags usage)
+    : m_device(device)
+    , m_usage(usage)
+{
+    // Dynamic offsets into the ring have to respect the offset alignment of the bindings using it
+    const auto &limits = m_device->adapter()->properties().limits;
+    if (usage.testFlag(KDGpu::BufferUsageFlagBits::UniformBufferBit))
+        m_minAlignment = std::lcm(m_minAlignment, std::max<KDGpu::DeviceSize>(limits.minUniformBufferOffsetAlignment, 1));
+    if (usage.testFlag(KDGpu::BufferUsageFlagBits::StorageBufferBit))
+        m_minAlignment = std::lcm(m_minAlignment, std::max<KDGpu::DeviceSize>(limits.minStorageBufferOffsetAlignment, 1));
+
+    m_buffer = m_device->createBuffer(KDGpu::BufferOptions{
+            .label = "TransientBufferAllocator",
+            .size = capacity,
+            .usage = usage,
+            .memoryUsage = KDGpu::MemoryUsage::CpuToGpu,
+            .persistentlyMapped = true,
+    });
+    m_mapped = static_cast<uint8_t *>(m_buffer.mappedPointer());
+    if (!m_mapped) {
+        SPDLOG_WARN("TransientBufferAllocator: unable to map a buffer of {} bytes", capacity);
+        return;
+    }
+    m_capacity = capacity;
+}
+
+TransientAllocation TransientBufferAllocator::allocate(KDGpu::DeviceSize size, KDGpu::DeviceSize alignment)
+{
+    alignment = std::lcm(std::max<KDGpu::DeviceSize>(alignment, 1), m_minAlignment);
+
+    KDGpu::DeviceSize offset = 0;
+    if (!tryAllocate(size, alignment, offset)) {
+        // Give frames the GPU is done with back before giving up
+        reclaim();
+        if (!tryAllocate(size, alignment, offset)) {
+            SPDLOG_WARN("TransientBufferAllocator: no room left for {} bytes, {} of {} bytes in use", size, m_usedBytes, m_capacity);
+            return {};
+        }
+    }
+
+    return TransientAllocation{
+        .buffer = m_buffer.handle(),
+        .offset = offset,
+        .cpuPtr = m_mapped + offset,
+    };
+}
+
+bool TransientBufferAllocator::tryAllocate(KDGpu::DeviceSize size, KDGpu::DeviceSize alignment, KDGpu::DeviceSize &offset)
+{
+    if (size > m_capacity)
+        return false;
+
+    const KDGpu::DeviceSize alignedHead = alignUp(m_head, alignment);
+    const bool wrapped = m_head < m_tail || (m_head == m_tail && m_usedBytes != 0);
+    if (!wrapped && alignedHead + size <= m_capacity) {
+        // Free space is [m_head, m_capacity) followed by [0, m_tail)
+        offset = alignedHead;
+    } else if (!wrapped && size <= m_tail) {
+        // Skip the end of the ring, the skipped bytes are released with the frame
+        offset = 0;
+    } else if (wrapped && alignedHead + size <= m_tail) {
+        // Free space is [m_head, m_tail)
+        offset = alignedHead;
+    } else {
+        return false;
+    }
+
+    const KDGpu::DeviceSize end = offset + size;
+    const KDGpu::DeviceSize consumed = offset >= m_head ? end - m_head : m_capacity - m_head + end;
+    m_head = end == m_capacity ? 0 : end;
+    m_usedBytes += consumed;
+    m_frameBytes += consumed;
+    m_unflushedBytes += consumed;
+    return true;
+}
+
+void TransientBufferAllocator::endFrame(const KDGpu::Fence &fence)
+{
+    pushFrame(Frame{ .bytes = m_frameBytes, .fence = &fence, .fenceSubmissionCount = fence.submissionCount() });
+}
+
+void TransientBufferAllocator::endFrame(const KDGpu::TimelineSemaphore &timelineSemaphore, uint64_t value)
+{
+    pushFrame(Frame{ .bytes = m_frameBytes, .timelineSemaphore = &timelineSemaphore, .timelineValue = value });
+}
+
+void TransientBufferAllocator::pushFrame(Frame &&frame)
+{
+    m_frames.emplace_back(std::move(frame));
+    m_frameBytes = 0;
+}
+
+bool TransientBufferAllocator::isRetired(const Frame &frame) const
+{
+    // The fence may still be signalled from its previous use until the frame is submitted
+    if (frame.fence)
+        return frame.fence->submissionCount() > frame.fenceSubmissionCount && frame.fence->status() == KDGpu::FenceStatus::Signalled;
+    return frame.timelineSemaphore->value() >= frame.timelineValue;
+}
+
+void TransientBufferAllocator::reclaim()
+{
+    // Frames retire in submission order, stop at the first one still in flight
+    while (!m_frames.empty() && isRetired(m_frames.front())) {
+        const Frame &frame = m_frames.front();
+        m_tail = (m_tail + frame.bytes) % std::max<KDGpu::DeviceSize>(m_capacity, 1);
+        m_usedBytes -= frame.bytes;
+        m_frames.pop_front();
+    }
+
+    // Start over from the beginning of the ring once it is empty
+    if (m_usedBytes == 0)
+        m_head = m_tail = 0;
+    m_unflushedBytes = std::min(m_unflushedBytes, m_usedBytes);
+}
+
+void TransientBufferAllocator::flush()
+{
+    if (m_unflushedBytes == 0)
+        return;
+
+    if (m_unflushedBytes >= m_capacity) {
+        m_buffer.flush();
+    } else {
+        const KDGpu::DeviceSize start = (m_head + m_capacity - m_unflushedBytes) % m_capacity;
+        if (start < m_head) {
+            m_buffer.flush(start, m_head - start);
+        } else {
+            m_buffer.flush(start, m_capacity - start);
+            if (m_head != 0)
+                m_buffer.flush(0, m_head);
+        }
+    }
+    m_unflushedBytes = 0;
+}
+
+KDGpu::BindGroup TransientBufferAllocator::createBindGroup(const KDGpu::Handle<KDGpu::BindGroupLayout_t> &layout, uint32_t binding, uint32_t range) const
+{
+    // Only uniform buffers have a dynamic binding
+    if (!m_usage.testFlag(KDGpu::BufferUsageFlagBits::UniformBufferBit)) {
+        SPDLOG_WARN("TransientBufferAllocator: a dynamic uniform buffer binding needs a ring created with UniformBufferBit");
+        return {};
+    }
+
+    return m_device->createBindGroup(KDGpu::BindGroupOptions{
+            .label = "TransientBufferAllocator",
+            .layout = layout,
+            .resources = {
+                    {
+                            .binding = binding,
+                            .resource = KDGpu::DynamicUniformBufferBinding{
+                                    .buffer = m_buffer,
+                                    .size = range,
+                            },
+                    },
+            },
+    });
+}
+
+} // namespace KDGpuUtils
@@ -0,0 +1,119 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDGpuUtils/kdgpuutils_export.h>
+
+#include <KDGpu/bind_group.h>
+#include <KDGpu/buffer.h>
+#include <KDGpu/gpu_core.h>
+#include <KDGpu/handle.h>
+
+#include <deque>
+
+namespace KDGpu {
+class Device;
+class Fence;
+class TimelineSemaphore;
+struct BindGroupLayout_t;
+} // namespace KDGpu
+
+namespace KDGpuUtils {
+
+struct TransientAllocation {
+    KDGpu::Handle<KDGpu::Buffer_t> buffer;
+    KDGpu::DeviceSize offset{ 0 };
+    void *cpuPtr{ nullptr };
+
+    bool isValid() const noexcept { return cpuPtr != nullptr; }
+    // Offset to hand to setBindGroup() for a bind group from TransientBufferAllocator::createBindGroup()
+    uint32_t dynamicOffset() const noexcept { return static_cast<uint32_t>(offset); }
+};
+
+/**
+ * @brief Streams per frame data through a single persistently mapped Buffer
+ *
+ * allocate() hands out aligned sub-allocations from a ring buffer. Allocations made
+ * since the previous endFrame() belong to the frame ended by the next call and are
+ * reclaimed once its TimelineSemaphore reaches the given value, or once its Fence is
+ * signalled by a submission made after endFrame(). A fence still signalled from an
+ * earlier use does not retire the frame, submit the frame after ending it. reclaim()
+ * polls retired frames, it is called by allocate() when the ring is full.
+ *
+ * Uniform data can be bound through one bind group from createBindGroup() for every
+ * draw, passing TransientAllocation::dynamicOffset() to setBindGroup().
+ */
+class KDGPUUTILS_EXPORT TransientBufferAllocator
+{
+public:
+    TransientBufferAllocator(KDGpu::Device *device, KDGpu::DeviceSize capacity,
+                             KDGpu::BufferUsageFlags usage = KDGpu::BufferUsageFlagBits::UniformBufferBit |
+                                     KDGpu::BufferUsageFlagBits::StorageBufferBit |
+                                     KDGpu::BufferUsageFlagBits::VertexBufferBit |
+                                     KDGpu::BufferUsageFlagBits::IndexBufferBit);
+
+    TransientBufferAllocator(const TransientBufferAllocator &) = delete;
+    TransientBufferAllocator &operator=(const TransientBufferAllocator &) = delete;
+
+    // alignment is raised to the minimum offset alignment of uniform and storage buffers.
+    // Returns an invalid allocation if the ring has no room left for size bytes.
+    TransientAllocation allocate(KDGpu::DeviceSize size, KDGpu::DeviceSize alignment = 1);
+
+    // fence and timelineSemaphore must outlive the frame
+    void endFrame(const KDGpu::Fence &fence);
+    void endFrame(const KDGpu::TimelineSemaphore &timelineSemaphore, uint64_t value);
+
+    void reclaim();
+
+    // Flushes what was written since the previous flush, only needed on non coherent memory
+    void flush();
+
+    // Bind group using a DynamicUniformBufferBinding of range bytes on the ring buffer,
+    // allocations bound through it have to be at least range bytes large. Returns an
+    // invalid bind group if the ring was created without BufferUsageFlagBits::UniformBufferBit
+    KDGpu::BindGroup createBindGroup(const KDGpu::Handle<KDGpu::BindGroupLayout_t> &layout, uint32_t binding, uint32_t range) const;
+
+    const KDGpu::Buffer &buffer() const noexcept { return m_buffer; }
+    KDGpu::DeviceSize capacity() const noexcept { return m_capacity; }
+    KDGpu::DeviceSize usedBytes() const noexcept { return m_usedBytes; }
+    size_t framesInFlight() const noexcept { return m_frames.size(); }
+
+private:
+    struct Frame {
+        KDGpu::DeviceSize bytes{ 0 };
+        const KDGpu::Fence *fence{ nullptr };
+        // Submissions made to signal the fence before the frame ended
+        uint64_t fenceSubmissionCount{ 0 };
+        const KDGpu::TimelineSemaphore *timelineSemaphore{ nullptr };
+        uint64_t timelineValue{ 0 };
+    };
+
+    bool tryAllocate(KDGpu::DeviceSize size, KDGpu::DeviceSize alignment, KDGpu::DeviceSize &offset);
+    bool isRetired(const Frame &frame) const;
+    void pushFrame(Frame &&frame);
+
+    KDGpu::Device *m_device{ nullptr };
+    KDGpu::Buffer m_buffer;
+    KDGpu::BufferUsageFlags m_usage;
+    KDGpu::DeviceSize m_capacity{ 0 };
+    KDGpu::DeviceSize m_minAlignment{ 1 };
+    uint8_t *m_mapped{ nullptr };
+
+    // Live data is the range [m_tail, m_head) of the ring, wrapping at m_capacity
+    KDGpu::DeviceSize m_head{ 0 };
+    KDGpu::DeviceSize m_tail{ 0 };
+    KDGpu::DeviceSize m_usedBytes{ 0 };
+    KDGpu::DeviceSize m_frameBytes{ 0 };
+    KDGpu::DeviceSize m_unflushedBytes{ 0 };
+    std::deque<Frame> m_frames;
+};
+
+} // namespace KDGpuUtils
@@ -0,0 +1,184 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/asset_upload_pipeline.h>
+
+#include <KDGpu/device.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+using namespace KDGpuUtils;
+
+namespace {
+
+AssetUploadPipeline::Decoder solidColorDecoder(uint32_t size, uint32_t mipLevels)
+{
+    return [size, mipLevels](AssetUploadPipeline::DecodeContext &context) {
+        const DeviceSize byteSize = size * size * 4;
+        void *texels = context.allocate(byteSize);
+        if (!texels)
+            return false;
+        std::memset(texels, 0x80, byteSize);
+        context.textureOptions = TextureOptions{
+            .type = TextureType::TextureType2D,
+            .format = Format::R8G8B8A8_UNORM,
+            .extent = { size, size, 1 },
+            .mipLevels = mipLevels,
+            .usage = TextureUsageFlagBits::SampledBit,
+            .memoryUsage = MemoryUsage::GpuOnly,
+        };
+        return true;
+    };
+}
+
+} // namespace
+
+TEST_SUITE("AssetUploadPipeline")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "AssetUploadPipeline",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *discreteGPUAdapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = discreteGPUAdapter->createDevice();
+
+    TEST_CASE("Loading")
+    {
+        // GIVEN
+        AssetUploadPipeline pipeline(&device, &device.queues()[0], AssetUploadPipelineOptions{ .workerThreadCount = 2, .stagingChunkSize = 64 * 1024 });
+
+        SUBCASE("Decoded textures are uploaded")
+        {
+            // WHEN
+            std::future<Texture> single = pipeline.loadTexture(solidColorDecoder(32, 1));
+            std::future<Texture> mipmapped = pipeline.loadTexture(solidColorDecoder(64, 7));
+
+            // THEN
+            CHECK(single.get().isValid());
+            CHECK(mipmapped.get().isValid());
+            CHECK(pipeline.pendingCount() == 0);
+        }
+
+        SUBCASE("Failed decodes produce invalid textures")
+        {
+            // WHEN
+            std::future<Texture> failed = pipeline.loadTexture([](AssetUploadPipeline::DecodeContext &context) {
+                context.allocate(1024);
+                return false;
+            });
+
+            // THEN
+            CHECK(!failed.get().isValid());
+        }
+
+        SUBCASE("Decoders throwing produce invalid textures")
+        {
+            // WHEN
+            std::future<Texture> failed = pipeline.loadTexture([](AssetUploadPipeline::DecodeContext &context) -> bool {
+                context.allocate(1024);
+                throw std::runtime_error("Corrupted image");
+            });
+            pipeline.waitForIdle();
+
+            // THEN
+            CHECK(!failed.get().isValid());
+            CHECK(pipeline.pendingCount() == 0);
+        }
+
+        SUBCASE("Completion is reported per asset")
+        {
+            // GIVEN
+            constexpr uint32_t assetCount = 32;
+            std::atomic<uint32_t> completed = 0;
+            std::atomic<uint32_t> valid = 0;
+
+            // WHEN
+            for (uint32_t i = 0; i < assetCount; ++i) {
+                pipeline.loadTexture(solidColorDecoder(64, 1), [&](Texture &&texture) {
+                    ++completed;
+                    if (texture.isValid())
+                        ++valid;
+                });
+            }
+            pipeline.waitForIdle();
+
+            // THEN
+            CHECK(completed == assetCount);
+            CHECK(valid == assetCount);
+        }
+
+        SUBCASE("Staging memory is reused once uploaded")
+        {
+            // WHEN
+            for (uint32_t i = 0; i < 16; ++i)
+                CHECK(pipeline.loadTexture(solidColorDecoder(64, 1)).get().isValid());
+
+            // THEN -> One 16kB texture at a time fits in a single chunk
+            CHECK(pipeline.stagingChunkCount() == 1);
+        }
+
+        SUBCASE("Staging chunks beyond the first are freed once drained")
+        {
+            // WHEN -> Sixteen 16kB textures in flight do not fit in a single 64kB chunk
+            std::vector<std::future<Texture>> textures;
+            for (uint32_t i = 0; i < 16; ++i)
+                textures.push_back(pipeline.loadTexture(solidColorDecoder(64, 1)));
+            pipeline.waitForIdle();
+
+            // THEN
+            for (std::future<Texture> &texture : textures)
+                CHECK(texture.get().isValid());
+            CHECK(pipeline.stagingChunkCount() == 1);
+        }
+
+        SUBCASE("Assets larger than a chunk get a chunk of their own")
+        {
+            // WHEN
+            CHECK(pipeline.loadTexture(solidColorDecoder(64, 1)).get().isValid());
+            CHECK(pipeline.loadTexture(solidColorDecoder(256, 1)).get().isValid());
+
+            // THEN -> It is freed once uploaded
+            CHECK(pipeline.stagingChunkCount() == 1);
+        }
+    }
+
+    TEST_CASE("Batches in flight")
+    {
+        // GIVEN -> Single asset batches, so that several are submitted before the first retires
+        AssetUploadPipeline pipeline(&device, &device.queues()[0],
+                                     AssetUploadPipelineOptions{
+                                             .workerThreadCount = 2,
+                                             .stagingChunkSize = 64 * 1024,
+                                             .maxBatchSize = 1,
+                                             .maxBatchesInFlight = 3,
+                                     });
+
+        // WHEN
+        std::vector<std::future<Texture>> textures;
+        for (uint32_t i = 0; i < 24; ++i)
+            textures.push_back(pipeline.loadTexture(solidColorDecoder(64, 7)));
+        pipeline.waitForIdle();
+
+        // THEN
+        for (std::future<Texture> &texture : textures)
+            CHECK(texture.get().isValid());
+        CHECK(pipeline.pendingCount() == 0);
+        CHECK(pipeline.stagingChunkCount() == 1);
+    }
+}
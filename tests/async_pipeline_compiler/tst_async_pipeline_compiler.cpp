@@ -0,0 +1,89 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/async_pipeline_compiler.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+TEST_CASE("AsyncPipelineCompiler")
+{
+    SUBCASE("Has at least one worker thread")
+    {
+        // WHEN
+        AsyncPipelineCompiler compiler(0);
+
+        // THEN
+        CHECK(compiler.threadCount() == 1);
+        CHECK(AsyncPipelineCompiler::defaultThreadCount() >= 1);
+    }
+
+    SUBCASE("Jobs run off the calling thread and deliver their result")
+    {
+        // GIVEN
+        AsyncPipelineCompiler compiler(2);
+
+        // WHEN
+        auto future = compiler.enqueue([] { return std::this_thread::get_id(); });
+
+        // THEN
+        CHECK(future.get() != std::this_thread::get_id());
+    }
+
+    SUBCASE("Move only results are supported")
+    {
+        // GIVEN
+        AsyncPipelineCompiler compiler(1);
+
+        // WHEN
+        auto future = compiler.enqueue([] { return std::make_unique<int>(42); });
+
+        // THEN
+        CHECK(*future.get() == 42);
+    }
+
+    SUBCASE("Exceptions are forwarded to the future")
+    {
+        // GIVEN
+        AsyncPipelineCompiler compiler(1);
+
+        // WHEN
+        auto future = compiler.enqueue([]() -> int { throw std::runtime_error("Failed"); });
+
+        // THEN
+        CHECK_THROWS_AS(future.get(), std::runtime_error);
+    }
+
+    SUBCASE("Destruction completes queued jobs")
+    {
+        // GIVEN
+        std::atomic<uint32_t> completed{ 0 };
+        std::vector<std::future<void>> futures;
+
+        {
+            AsyncPipelineCompiler compiler(2);
+
+            // WHEN
+            for (uint32_t i = 0; i < 64; ++i)
+                futures.emplace_back(compiler.enqueue([&completed] { completed.fetch_add(1); }));
+        }
+
+        // THEN
+        CHECK(completed.load() == 64);
+    }
+}
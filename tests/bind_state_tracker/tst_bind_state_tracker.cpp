@@ -0,0 +1,144 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/bind_state_tracker.h>
+#include <KDGpu/pool.h>
+
+#include <array>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+namespace KDGpu {
+struct GraphicsPipeline_t;
+}
+
+TEST_CASE("BindStateTracker")
+{
+    // GIVEN
+    // The pools only serve as a source of valid handles here
+    Pool<int, GraphicsPipeline_t> pipelines{ 4 };
+    Pool<int, PipelineLayout_t> pipelineLayouts{ 4 };
+    Pool<int, BindGroup_t> bindGroups{ 4 };
+    Pool<int, Buffer_t> buffers{ 4 };
+
+    const Handle<GraphicsPipeline_t> pipelineA = pipelines.emplace(0);
+    const Handle<GraphicsPipeline_t> pipelineB = pipelines.emplace(1);
+    const Handle<PipelineLayout_t> layoutA = pipelineLayouts.emplace(0);
+    const Handle<PipelineLayout_t> layoutB = pipelineLayouts.emplace(1);
+    const Handle<BindGroup_t> bindGroupA = bindGroups.emplace(0);
+    const Handle<BindGroup_t> bindGroupB = bindGroups.emplace(1);
+    const Handle<Buffer_t> bufferA = buffers.emplace(0);
+    const Handle<Buffer_t> bufferB = buffers.emplace(1);
+
+    BindStateTracker<GraphicsPipeline_t> tracker;
+
+    SUBCASE("Skips binding the bound pipeline")
+    {
+        // WHEN
+        const bool first = tracker.bindPipeline(pipelineA);
+        const bool again = tracker.bindPipeline(pipelineA);
+        const bool other = tracker.bindPipeline(pipelineB);
+
+        // THEN
+        CHECK(first);
+        CHECK(!again);
+        CHECK(other);
+        CHECK(tracker.stats().issuedBinds == 2);
+        CHECK(tracker.stats().skippedBinds == 1);
+    }
+
+    SUBCASE("Skips bind groups bound with the same layout and offsets")
+    {
+        // GIVEN
+        const std::array<uint32_t, 1> offsets{ 256 };
+        const std::array<uint32_t, 1> otherOffsets{ 512 };
+        REQUIRE(tracker.bindBindGroup(0, bindGroupA, layoutA, offsets));
+
+        // THEN
+        CHECK(!tracker.bindBindGroup(0, bindGroupA, layoutA, offsets));
+        CHECK(tracker.bindBindGroup(0, bindGroupA, layoutA, otherOffsets));
+        CHECK(tracker.bindBindGroup(0, bindGroupB, layoutA, otherOffsets));
+        CHECK(tracker.bindBindGroup(1, bindGroupB, layoutA, otherOffsets));
+    }
+
+    SUBCASE("Binding with another layout forgets the other bind groups")
+    {
+        // GIVEN
+        REQUIRE(tracker.bindBindGroup(0, bindGroupA, layoutA, {}));
+        REQUIRE(tracker.bindBindGroup(1, bindGroupB, layoutA, {}));
+
+        // WHEN
+        REQUIRE(tracker.bindBindGroup(1, bindGroupB, layoutB, {}));
+
+        // THEN
+        CHECK(tracker.bindBindGroup(0, bindGroupA, layoutA, {}));
+    }
+
+    SUBCASE("Bind groups without a layout are never skipped")
+    {
+        // WHEN
+        REQUIRE(tracker.bindBindGroup(0, bindGroupA, tracker.pipelineLayout(), {}));
+
+        // THEN
+        CHECK(tracker.bindBindGroup(0, bindGroupA, tracker.pipelineLayout(), {}));
+    }
+
+    SUBCASE("Bind groups fall back to the layout of the bound pipeline")
+    {
+        // GIVEN
+        tracker.bindPipeline(pipelineA);
+        tracker.setPipelineLayout(layoutA);
+        REQUIRE(tracker.bindBindGroup(0, bindGroupA, tracker.pipelineLayout(), {}));
+
+        // THEN
+        CHECK(!tracker.bindBindGroup(0, bindGroupA, tracker.pipelineLayout(), {}));
+        CHECK(!tracker.bindBindGroup(0, bindGroupA, layoutA, {}));
+    }
+
+    SUBCASE("Pushing a bind group forgets the bound ones")
+    {
+        // GIVEN
+        REQUIRE(tracker.bindBindGroup(0, bindGroupA, layoutA, {}));
+
+        // WHEN
+        tracker.forgetBindGroups();
+
+        // THEN
+        CHECK(tracker.bindBindGroup(0, bindGroupA, layoutA, {}));
+    }
+
+    SUBCASE("Skips vertex buffers bound at the same binding and offset")
+    {
+        // GIVEN
+        REQUIRE(tracker.bindVertexBuffer(0, bufferA, 0));
+
+        // THEN
+        CHECK(!tracker.bindVertexBuffer(0, bufferA, 0));
+        CHECK(tracker.bindVertexBuffer(1, bufferA, 0));
+        CHECK(tracker.bindVertexBuffer(0, bufferA, 64));
+        CHECK(tracker.bindVertexBuffer(0, bufferB, 64));
+    }
+
+    SUBCASE("Skips index buffers bound with the same offset and type")
+    {
+        // GIVEN
+        REQUIRE(tracker.bindIndexBuffer(bufferA, 0, IndexType::Uint32));
+
+        // THEN
+        CHECK(!tracker.bindIndexBuffer(bufferA, 0, IndexType::Uint32));
+        CHECK(tracker.bindIndexBuffer(bufferA, 0, IndexType::Uint16));
+        CHECK(tracker.bindIndexBuffer(bufferB, 0, IndexType::Uint16));
+        CHECK(tracker.stats().issuedBinds == 3);
+        CHECK(tracker.stats().skippedBinds == 1);
+    }
+}
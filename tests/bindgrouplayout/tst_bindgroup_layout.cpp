@@ -299,6 +299,8 @@ TEST_SUITE("BindGroupLayout")
                                 .shaderStages = ShaderStageFlags(ShaderStageFlagBits::VertexBit) } }
             };
 
+            const uint64_t hitsBefore = device.bindGroupLayoutDeduplicationStats().hits;
+
             // WHEN
             BindGroupLayout a = device.createBindGroupLayout(bindGroupLayoutOptions);
             BindGroupLayout b = device.createBindGroupLayout(bindGroupLayoutOptions);
@@ -306,6 +308,8 @@ TEST_SUITE("BindGroupLayout")
             // THEN
             CHECK(a.isCompatibleWith(b.handle()));
             CHECK(a == b);
+            CHECK(a.handle() == b.handle());
+            CHECK(device.bindGroupLayoutDeduplicationStats().hits == hitsBefore + 1);
         }
 
         SUBCASE("Compare incompatible BindGroupLayouts")
@@ -290,6 +290,48 @@ TEST_SUITE("Buffer")
 
             b.unmap();
         }
+
+        SUBCASE("Persistently mapped Buffer")
+        {
+            // GIVEN
+            const BufferOptions bufferOptions = {
+                .size = 4 * sizeof(float),
+                .usage = BufferUsageFlagBits::UniformBufferBit,
+                .memoryUsage = MemoryUsage::CpuToGpu,
+                .persistentlyMapped = true,
+            };
+            const std::vector<float> vertexData = {
+                1.0f, -1.0f, 0.0f, 1.0f
+            };
+
+            // WHEN
+            Buffer b = device.createBuffer(bufferOptions, vertexData.data());
+
+            // THEN
+            REQUIRE(b.isValid());
+            void *mapped = b.mappedPointer();
+            REQUIRE(mapped != nullptr);
+            CHECK(std::memcmp(mapped, vertexData.data(), vertexData.size() * sizeof(float)) == 0);
+            CHECK(api->resourceManager()->getBuffer(b)->mapped == mapped);
+
+            // WHEN
+            const float value = 2.0f;
+            std::memcpy(static_cast<float *>(mapped) + 1, &value, sizeof(float));
+            b.flush(sizeof(float), sizeof(float));
+            b.unmap();
+
+            // THEN -> Still mapped at the same address
+            CHECK(b.mappedPointer() == mapped);
+            CHECK(b.map() == mapped);
+            CHECK(static_cast<const float *>(mapped)[1] == value);
+
+            // WHEN
+            Buffer moved = std::move(b);
+
+            // THEN
+            CHECK(moved.mappedPointer() == mapped);
+            CHECK(b.mappedPointer() == nullptr);
+        }
     }
 
     TEST_CASE("Comparison")
@@ -0,0 +1,221 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/bind_group.h>
+#include <KDGpu/bind_group_layout.h>
+#include <KDGpu/bind_group_layout_options.h>
+#include <KDGpu/bind_group_options.h>
+#include <KDGpu/buffer.h>
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/queue.h>
+#include <KDGpu/texture.h>
+#include <KDGpu/texture_options.h>
+#include <KDGpu/texture_view.h>
+#include <KDGpu/vulkan/vulkan_device.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+TEST_SUITE("ConcurrentResourceManager")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "concurrent_resource_manager",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *adapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = adapter->createDevice(DeviceOptions{ .requestedFeatures = adapter->features() });
+
+    constexpr uint32_t threadCount = 8;
+    constexpr uint32_t iterationCount = 200;
+
+    TEST_CASE("Create and delete resources from several threads")
+    {
+        REQUIRE(device.isValid());
+
+        // GIVEN
+        const BindGroupLayout bindGroupLayout = device.createBindGroupLayout(BindGroupLayoutOptions{
+                .bindings = { { .binding = 0,
+                                .count = 1,
+                                .resourceType = ResourceBindingType::UniformBuffer,
+                                .shaderStages = ShaderStageFlags(ShaderStageFlagBits::VertexBit) } } });
+        REQUIRE(bindGroupLayout.isValid());
+
+        std::atomic<uint32_t> invalidResources{ 0 };
+        std::atomic<uint32_t> lookupFailures{ 0 };
+        std::atomic<uint32_t> staleLookups{ 0 };
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+
+        // WHEN
+        for (uint32_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                std::vector<Handle<Buffer_t>> deletedBuffers;
+                for (uint32_t i = 0; i < iterationCount; ++i) {
+                    const float value = static_cast<float>(t * iterationCount + i);
+                    Buffer buffer = device.createBuffer(BufferOptions{
+                                                                .size = sizeof(float),
+                                                                .usage = BufferUsageFlagBits::UniformBufferBit,
+                                                                .memoryUsage = MemoryUsage::CpuToGpu,
+                                                        },
+                                                        &value);
+                    Texture texture = device.createTexture(TextureOptions{
+                            .type = TextureType::TextureType2D,
+                            .format = Format::R8G8B8A8_UNORM,
+                            .extent = { 4, 4, 1 },
+                            .mipLevels = 1,
+                            .usage = TextureUsageFlagBits::SampledBit,
+                            .memoryUsage = MemoryUsage::GpuOnly,
+                    });
+                    BindGroup bindGroup = device.createBindGroup(BindGroupOptions{
+                            .layout = bindGroupLayout,
+                            .resources = { { .binding = 0, .resource = UniformBufferBinding{ .buffer = buffer } } },
+                    });
+
+                    if (!buffer.isValid() || !texture.isValid() || !bindGroup.isValid()) {
+                        ++invalidResources;
+                        continue;
+                    }
+
+                    // Check we read back what this thread wrote and not another thread's resource
+                    const auto *data = static_cast<const float *>(buffer.map());
+                    if (data == nullptr || *data != value)
+                        ++lookupFailures;
+                    buffer.unmap();
+
+                    if (api->resourceManager()->getTexture(texture.handle()) == nullptr)
+                        ++lookupFailures;
+
+                    deletedBuffers.push_back(buffer.handle());
+                }
+
+                // Handles of deleted resources must never resolve, even though their slots got reused
+                for (const auto &handle : deletedBuffers) {
+                    if (api->resourceManager()->getBuffer(handle) != nullptr)
+                        ++staleLookups;
+                }
+            });
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        // THEN
+        CHECK(invalidResources == 0);
+        CHECK(lookupFailures == 0);
+        CHECK(staleLookups == 0);
+    }
+
+#if VK_KHR_dynamic_rendering
+    TEST_CASE("Record a render pass from several threads" * doctest::skip(!adapter->features().dynamicRendering))
+    {
+        REQUIRE(device.isValid());
+
+        // GIVEN
+        constexpr uint32_t extent = 64;
+        const Texture colorTexture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { extent, extent * threadCount, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::ColorAttachmentBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        const TextureView colorTextureView = colorTexture.createView();
+        const RenderPassInheritance inheritance{
+            .colorFormats = { Format::R8G8B8A8_UNORM },
+            .framebufferWidth = extent,
+            .framebufferHeight = extent * threadCount,
+        };
+
+        std::vector<CommandBuffer> secondaryCommandBuffers(threadCount);
+        std::vector<std::thread::id> threadIds(threadCount);
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+
+        // WHEN -> Each thread records the draws of its own band of the render target
+        for (uint32_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                threadIds[t] = std::this_thread::get_id();
+                CommandRecorder commandRecorder = device.createCommandRecorder(CommandRecorderOptions{
+                        .level = CommandBufferLevel::Secondary,
+                        .renderPassInheritance = inheritance,
+                });
+                RenderPassCommandRecorder renderPass = commandRecorder.continueRenderPass();
+                const float y = static_cast<float>(t * extent);
+                renderPass.setViewport(Viewport{ .y = y, .width = static_cast<float>(extent), .height = static_cast<float>(extent) });
+                renderPass.setScissor(Rect2D{ .offset = { 0, static_cast<int32_t>(t * extent) }, .extent = { extent, extent } });
+                renderPass.end();
+                secondaryCommandBuffers[t] = commandRecorder.finish();
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        CommandRecorder commandRecorder = device.createCommandRecorder();
+        RenderPassCommandRecorder renderPass = commandRecorder.beginRenderPass(RenderPassCommandRecorderWithDynamicRenderingOptions{
+                .colorAttachments = { { .view = colorTextureView } },
+                .secondaryCommandBuffers = true,
+        });
+        for (const CommandBuffer &secondaryCommandBuffer : secondaryCommandBuffers)
+            commandRecorder.executeSecondaryCommandBuffer(secondaryCommandBuffer);
+        renderPass.end();
+        CommandBuffer commandBuffer = commandRecorder.finish();
+
+        Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+        device.queues()[0].submit(SubmitOptions{ .commandBuffers = { commandBuffer }, .signalFence = fence });
+        fence.wait();
+
+        // THEN -> Every thread allocated from a command pool of its own
+        std::vector<VkCommandPool> commandPools;
+        for (const CommandBuffer &secondaryCommandBuffer : secondaryCommandBuffers) {
+            REQUIRE(secondaryCommandBuffer.isValid());
+            commandPools.push_back(api->resourceManager()->getCommandBuffer(secondaryCommandBuffer)->commandPool);
+        }
+        commandPools.push_back(api->resourceManager()->getCommandBuffer(commandBuffer)->commandPool);
+        std::sort(commandPools.begin(), commandPools.end());
+        CHECK(std::unique(commandPools.begin(), commandPools.end()) == commandPools.end());
+
+        // WHEN -> The secondary command buffers are destroyed from this thread
+        const VulkanThreadCommandPool *workerCommandPool = api->resourceManager()->getCommandBuffer(secondaryCommandBuffers[0])->threadCommandPool;
+        secondaryCommandBuffers.clear();
+
+        // THEN -> They were the last ones of their exited thread, so they are not left pending
+        CHECK(workerCommandPool->thread == threadIds[0]);
+        CHECK(workerCommandPool->liveCommandBuffers == 0);
+        CHECK(workerCommandPool->pendingFrees.empty());
+
+        // WHEN -> The command pools of idle threads are released
+        const auto commandPoolCount = [&] {
+            size_t count = 0;
+            for (const auto &threadCommandPools : api->resourceManager()->getDevice(device)->commandPools)
+                count += threadCommandPools.size();
+            return count;
+        };
+        CHECK(commandPoolCount() >= threadCount + 1);
+        device.releaseThreadCommandPools();
+
+        // THEN -> Only the pool of this thread remains, its command buffer is still alive
+        CHECK(commandPoolCount() == 1);
+        CHECK(commandBuffer.isValid());
+    }
+#endif
+}
@@ -0,0 +1,268 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/command_buffer.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/frame_command_allocator.h>
+#include <KDGpu/frame_command_allocator_options.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/queue.h>
+#include <KDGpu/render_pass_command_recorder.h>
+#include <KDGpu/texture.h>
+#include <KDGpu/texture_options.h>
+#include <KDGpu/texture_view.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <array>
+#include <chrono>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+TEST_SUITE("FrameCommandAllocator")
+{
+    // GIVEN
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "FrameCommandAllocator",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *adapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = adapter->createDevice();
+
+    TEST_CASE("Construction")
+    {
+        SUBCASE("A default constructed FrameCommandAllocator is invalid")
+        {
+            // GIVEN
+            FrameCommandAllocator allocator;
+
+            // THEN
+            CHECK(!allocator.isValid());
+        }
+
+        SUBCASE("A constructed FrameCommandAllocator has one command pool per frame")
+        {
+            // GIVEN
+            FrameCommandAllocator allocator = device.createFrameCommandAllocator(FrameCommandAllocatorOptions{
+                    .frameCount = 3,
+            });
+
+            // THEN
+            REQUIRE(allocator.isValid());
+            CHECK(allocator.currentFrame() == 0);
+            const VulkanFrameCommandAllocator *vulkanAllocator = api->resourceManager()->getFrameCommandAllocator(allocator);
+            REQUIRE(vulkanAllocator != nullptr);
+            CHECK(vulkanAllocator->frames.size() == 3);
+        }
+
+        SUBCASE("An allocator without frames is invalid")
+        {
+            // GIVEN
+            FrameCommandAllocator allocator = device.createFrameCommandAllocator(FrameCommandAllocatorOptions{
+                    .frameCount = 0,
+            });
+
+            // THEN
+            CHECK(!allocator.isValid());
+        }
+    }
+
+    TEST_CASE("Recycling")
+    {
+        // GIVEN
+        FrameCommandAllocator allocator = device.createFrameCommandAllocator(FrameCommandAllocatorOptions{
+                .frameCount = 2,
+        });
+        Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+
+        auto recordAndSubmit = [&] {
+            CommandRecorder commandRecorder = device.createCommandRecorder(CommandRecorderOptions{
+                    .frameCommandAllocator = allocator,
+            });
+            CommandBuffer commandBuffer = commandRecorder.finish();
+            device.queues()[0].submit(SubmitOptions{
+                    .commandBuffers = { commandBuffer },
+                    .signalFence = fence,
+            });
+            const VkCommandBuffer vkCommandBuffer = api->resourceManager()->getCommandBuffer(commandBuffer)->commandBuffer;
+            fence.wait();
+            fence.reset();
+            return vkCommandBuffer;
+        };
+
+        SUBCASE("Command buffers are reused once their frame begins again")
+        {
+            // WHEN
+            allocator.beginFrame(0);
+            const VkCommandBuffer first = recordAndSubmit();
+            allocator.beginFrame(0);
+            const VkCommandBuffer second = recordAndSubmit();
+
+            // THEN
+            CHECK(first != VK_NULL_HANDLE);
+            CHECK(first == second);
+        }
+
+        SUBCASE("Each frame has its own command buffers")
+        {
+            // WHEN
+            allocator.beginFrame(0);
+            const VkCommandBuffer frame0 = recordAndSubmit();
+            allocator.beginFrame(1);
+            const VkCommandBuffer frame1 = recordAndSubmit();
+
+            // THEN
+            CHECK(allocator.currentFrame() == 1);
+            CHECK(frame0 != frame1);
+        }
+
+        SUBCASE("Command buffers are not shared within a frame")
+        {
+            // WHEN
+            allocator.beginFrame(0);
+            const VkCommandBuffer first = recordAndSubmit();
+            const VkCommandBuffer second = recordAndSubmit();
+
+            // THEN
+            CHECK(first != second);
+            CHECK(api->resourceManager()->getFrameCommandAllocator(allocator)->frames[0].commandBuffers[VK_COMMAND_BUFFER_LEVEL_PRIMARY].size() == 2);
+        }
+
+        SUBCASE("Out of range frames are ignored")
+        {
+            // WHEN
+            allocator.beginFrame(1);
+            allocator.beginFrame(2);
+
+            // THEN
+            CHECK(allocator.currentFrame() == 1);
+        }
+    }
+
+    TEST_CASE("Resources recorded into a frame")
+    {
+        // GIVEN
+        Device cachingDevice = adapter->createDevice(DeviceOptions{
+                .renderTargetCache = { .maxFramebuffers = 1 },
+        });
+        FrameCommandAllocator allocator = cachingDevice.createFrameCommandAllocator(FrameCommandAllocatorOptions{
+                .frameCount = 2,
+        });
+        Fence fence = cachingDevice.createFence(FenceOptions{ .createSignalled = false });
+
+        const Texture colorTexture = cachingDevice.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 64, 64, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::ColorAttachmentBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        const TextureView firstView = colorTexture.createView();
+        const TextureView secondView = colorTexture.createView();
+
+        auto recordAndSubmit = [&](const TextureView &colorTextureView) {
+            CommandRecorder commandRecorder = cachingDevice.createCommandRecorder(CommandRecorderOptions{
+                    .frameCommandAllocator = allocator,
+            });
+            RenderPassCommandRecorder renderPass = commandRecorder.beginRenderPass(RenderPassCommandRecorderOptions{
+                    .colorAttachments = { { .view = colorTextureView } },
+            });
+            renderPass.end();
+            CommandBuffer commandBuffer = commandRecorder.finish();
+            cachingDevice.queues()[0].submit(SubmitOptions{
+                    .commandBuffers = { commandBuffer },
+                    .signalFence = fence,
+            });
+            // The command buffer is destroyed while it may still be executing
+        };
+
+        SUBCASE("Evicted framebuffers live until their frame begins again")
+        {
+            // WHEN
+            allocator.beginFrame(0);
+            recordAndSubmit(firstView);
+            fence.wait();
+            fence.reset();
+            allocator.beginFrame(1);
+            recordAndSubmit(secondView);
+
+            // THEN -> The framebuffer of the first frame was evicted but is kept alive
+            CHECK(cachingDevice.framebufferCacheStats().evictions == 1);
+            CHECK(cachingDevice.framebufferCacheStats().liveObjects == 2);
+
+            // WHEN
+            allocator.beginFrame(0, fence);
+
+            // THEN
+            CHECK(cachingDevice.framebufferCacheStats().liveObjects == 1);
+        }
+    }
+
+    // Compares allocating and freeing a command buffer per recorder with recycling them per frame.
+    // Run with --no-skip to get the numbers.
+    TEST_CASE("Benchmark" * doctest::skip())
+    {
+        using Clock = std::chrono::steady_clock;
+        using ms = std::chrono::duration<double, std::milli>;
+        constexpr uint32_t frameCount = 500;
+        constexpr uint32_t recordersPerFrame = 32;
+        constexpr uint32_t framesInFlight = 2;
+
+        std::array<Fence, framesInFlight> fences;
+        for (Fence &fence : fences)
+            fence = device.createFence(FenceOptions{ .createSignalled = true });
+
+        auto run = [&](FrameCommandAllocator &allocator) {
+            const auto start = Clock::now();
+            std::array<std::vector<CommandBuffer>, framesInFlight> inFlight;
+            for (uint32_t frame = 0; frame < frameCount; ++frame) {
+                const uint32_t inFlightIndex = frame % framesInFlight;
+                fences[inFlightIndex].wait();
+                fences[inFlightIndex].reset();
+                inFlight[inFlightIndex].clear();
+                if (allocator.isValid())
+                    allocator.beginFrame(inFlightIndex);
+
+                for (uint32_t i = 0; i < recordersPerFrame; ++i) {
+                    CommandRecorder commandRecorder = device.createCommandRecorder(CommandRecorderOptions{
+                            .frameCommandAllocator = allocator.handle(),
+                    });
+                    inFlight[inFlightIndex].push_back(commandRecorder.finish());
+                }
+
+                std::vector<RequiredHandle<CommandBuffer_t>> commandBuffers;
+                for (const CommandBuffer &commandBuffer : inFlight[inFlightIndex])
+                    commandBuffers.emplace_back(commandBuffer.handle());
+                device.queues()[0].submit(SubmitOptions{
+                        .commandBuffers = std::move(commandBuffers),
+                        .signalFence = fences[inFlightIndex],
+                });
+            }
+            device.waitUntilIdle();
+            return Clock::now() - start;
+        };
+
+        FrameCommandAllocator noAllocator;
+        const auto perRecorder = run(noAllocator);
+        FrameCommandAllocator allocator = device.createFrameCommandAllocator(FrameCommandAllocatorOptions{
+                .frameCount = framesInFlight,
+        });
+        const auto perFrame = run(allocator);
+
+        MESSAGE("Recorded " << frameCount * recordersPerFrame << " command buffers over " << frameCount << " frames:"
+                            << " allocate and free " << ms(perRecorder).count() << "ms,"
+                            << " per frame pools " << ms(perFrame).count() << "ms");
+    }
+}
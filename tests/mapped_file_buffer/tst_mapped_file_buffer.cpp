@@ -0,0 +1,227 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/mapped_file_buffer.h>
+
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/device.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/queue.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+using namespace KDGpuUtils;
+
+namespace {
+
+std::vector<uint8_t> makeFileData(size_t size)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = uint8_t((i * 7) ^ (i >> 8));
+    return data;
+}
+
+void writeFile(const std::filesystem::path &path, const std::vector<uint8_t> &data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), std::streamsize(data.size()));
+}
+
+// Copies the region of the MappedFileBuffer to a buffer the host can read
+std::vector<uint8_t> readBack(Device &device, const MappedFileBuffer &mappedFile)
+{
+    Buffer readback = device.createBuffer(BufferOptions{
+            .size = mappedFile.size(),
+            .usage = BufferUsageFlagBits::TransferDstBit,
+            .memoryUsage = MemoryUsage::GpuToCpu,
+    });
+    CommandRecorder recorder = device.createCommandRecorder();
+    recorder.copyBuffer(BufferCopy{
+            .src = mappedFile.buffer(),
+            .srcOffset = mappedFile.offset(),
+            .dst = readback,
+            .byteSize = mappedFile.size(),
+    });
+    CommandBuffer commandBuffer = recorder.finish();
+    device.queues()[0].submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+    device.queues()[0].waitUntilIdle();
+
+    std::vector<uint8_t> data(mappedFile.size());
+    std::memcpy(data.data(), readback.map(), data.size());
+    readback.unmap();
+    return data;
+}
+
+} // namespace
+
+TEST_SUITE("MappedFileBuffer")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "MappedFileBuffer",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *discreteGPUAdapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = discreteGPUAdapter->createDevice();
+
+    const std::filesystem::path filePath = std::filesystem::temp_directory_path() / "kdgpu_mapped_file_buffer.bin";
+
+    TEST_CASE("Regions")
+    {
+        // GIVEN
+        const std::vector<uint8_t> fileData = makeFileData(3 * 65536 + 123);
+        writeFile(filePath, fileData);
+
+        SUBCASE("Whole file")
+        {
+            for (const bool allowImport : { true, false }) {
+                // WHEN
+                MappedFileBuffer mappedFile(&device, { .path = filePath, .allowImport = allowImport });
+
+                // THEN
+                REQUIRE(mappedFile.isValid());
+                CHECK(mappedFile.size() == fileData.size());
+                if (!allowImport)
+                    CHECK(!mappedFile.isImported());
+                CHECK(readBack(device, mappedFile) == fileData);
+            }
+        }
+
+        SUBCASE("Unaligned region")
+        {
+            // GIVEN
+            const DeviceSize offset = 65536 + 17;
+            const DeviceSize size = 70000;
+            const std::vector<uint8_t> expected(fileData.begin() + offset, fileData.begin() + offset + size);
+
+            for (const bool allowImport : { true, false }) {
+                // WHEN
+                MappedFileBuffer mappedFile(&device, { .path = filePath, .offset = offset, .size = size, .allowImport = allowImport });
+
+                // THEN
+                REQUIRE(mappedFile.isValid());
+                CHECK(mappedFile.size() == size);
+                if (mappedFile.isImported())
+                    CHECK(mappedFile.offset() != 0);
+                else
+                    CHECK(mappedFile.offset() == 0);
+                CHECK(readBack(device, mappedFile) == expected);
+            }
+        }
+
+        SUBCASE("Moving keeps the mapping alive")
+        {
+            // GIVEN
+            MappedFileBuffer mappedFile(&device, { .path = filePath });
+
+            // WHEN
+            MappedFileBuffer moved = std::move(mappedFile);
+
+            // THEN
+            CHECK(!mappedFile.isValid());
+            REQUIRE(moved.isValid());
+            CHECK(readBack(device, moved) == fileData);
+        }
+
+        SUBCASE("Writable usages are not imported")
+        {
+            // WHEN
+            MappedFileBuffer mappedFile(&device, { .path = filePath,
+                                                   .usage = BufferUsageFlagBits::TransferSrcBit | BufferUsageFlagBits::StorageBufferBit });
+
+            // THEN
+            REQUIRE(mappedFile.isValid());
+            CHECK(!mappedFile.isImported());
+            CHECK(mappedFile.offset() == 0);
+            CHECK(readBack(device, mappedFile) == fileData);
+        }
+
+        SUBCASE("Regions outside of the file are rejected")
+        {
+            // WHEN
+            MappedFileBuffer pastEnd(&device, { .path = filePath, .offset = fileData.size() - 10, .size = 20 });
+            MappedFileBuffer missing(&device, { .path = filePath.string() + ".missing" });
+
+            // THEN
+            CHECK(!pastEnd.isValid());
+            CHECK(!missing.isValid());
+        }
+
+        std::filesystem::remove(filePath);
+    }
+
+    // Run with --no-skip to get the numbers. Reading a file into memory and copying it into
+    // a staging buffer against reading it straight into one and against importing it.
+    TEST_CASE("Upload benchmark" * doctest::skip())
+    {
+        constexpr DeviceSize fileSize = 256 * 1024 * 1024;
+        writeFile(filePath, makeFileData(fileSize));
+
+        Buffer deviceBuffer = device.createBuffer(BufferOptions{
+                .size = fileSize,
+                .usage = BufferUsageFlagBits::TransferDstBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        Queue &queue = device.queues()[0];
+        const auto upload = [&](const Handle<Buffer_t> &src, DeviceSize srcOffset) {
+            CommandRecorder recorder = device.createCommandRecorder();
+            recorder.copyBuffer(BufferCopy{ .src = src, .srcOffset = srcOffset, .dst = deviceBuffer, .byteSize = fileSize });
+            CommandBuffer commandBuffer = recorder.finish();
+            queue.submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+            queue.waitUntilIdle();
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<uint8_t> data(fileSize);
+            std::ifstream file(filePath, std::ios::binary);
+            file.read(reinterpret_cast<char *>(data.data()), std::streamsize(fileSize));
+            Buffer staging = device.createBuffer(BufferOptions{
+                                                         .size = fileSize,
+                                                         .usage = BufferUsageFlagBits::TransferSrcBit,
+                                                         .memoryUsage = MemoryUsage::CpuToGpu,
+                                                 },
+                                                 data.data());
+            upload(staging, 0);
+        }
+        const double copiedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        {
+            MappedFileBuffer mappedFile(&device, { .path = filePath, .allowImport = false });
+            upload(mappedFile.buffer(), mappedFile.offset());
+        }
+        const double stagedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        bool imported = false;
+        {
+            MappedFileBuffer mappedFile(&device, { .path = filePath });
+            imported = mappedFile.isImported();
+            upload(mappedFile.buffer(), mappedFile.offset());
+        }
+        const double importedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        MESSAGE("Uploading " << fileSize / (1024 * 1024) << " MiB: read and copied " << copiedMs << " ms, read into staging "
+                             << stagedMs << " ms, " << (imported ? "imported " : "import unsupported ") << importedMs << " ms");
+
+        std::filesystem::remove(filePath);
+    }
+}
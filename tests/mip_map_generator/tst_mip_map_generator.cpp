@@ -0,0 +1,290 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/mip_map_generator.h>
+
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/device.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/memory_barrier.h>
+#include <KDGpu/queue.h>
+#include <KDGpu/texture.h>
+#include <KDGpu/texture_options.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+using namespace KDGpuUtils;
+
+namespace {
+
+constexpr uint32_t SolidColor = 0xff20a040;
+
+uint32_t mipLevelCount(const Extent3D &extent)
+{
+    uint32_t levels = 1;
+    for (uint32_t size = std::max(extent.width, extent.height); size > 1; size >>= 1)
+        ++levels;
+    return levels;
+}
+
+Texture createSolidTexture(Device &device, const Extent3D &extent, TextureUsageFlags usage)
+{
+    Texture texture = device.createTexture(TextureOptions{
+            .type = TextureType::TextureType2D,
+            .format = Format::R8G8B8A8_UNORM,
+            .extent = extent,
+            .mipLevels = mipLevelCount(extent),
+            .usage = usage,
+            .memoryUsage = MemoryUsage::GpuOnly,
+    });
+
+    const std::vector<uint32_t> texels(extent.width * extent.height, SolidColor);
+    device.queues()[0].waitForUploadTextureData(WaitForTextureUploadOptions{
+            .destinationTexture = texture,
+            .data = texels.data(),
+            .byteSize = texels.size() * sizeof(uint32_t),
+            .oldLayout = TextureLayout::Undefined,
+            .newLayout = TextureLayout::TransferDstOptimal,
+            .regions = { { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit }, .textureExtent = extent } },
+    });
+    return texture;
+}
+
+// Reads the texel of the last mip level, which has to be in TransferSrcOptimal
+uint32_t readLastTexel(Device &device, const Texture &texture, const Extent3D &extent)
+{
+    Buffer buffer = device.createBuffer(BufferOptions{
+            .size = sizeof(uint32_t),
+            .usage = BufferUsageFlagBits::TransferDstBit,
+            .memoryUsage = MemoryUsage::GpuToCpu,
+    });
+    CommandRecorder recorder = device.createCommandRecorder();
+    recorder.copyTextureToBuffer(TextureToBufferCopy{
+            .srcTexture = texture,
+            .srcTextureLayout = TextureLayout::TransferSrcOptimal,
+            .dstBuffer = buffer,
+            .regions = { { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit, .mipLevel = mipLevelCount(extent) - 1 }, .textureExtent = { 1, 1, 1 } } },
+    });
+    CommandBuffer commandBuffer = recorder.finish();
+    device.queues()[0].submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+    device.queues()[0].waitUntilIdle();
+
+    uint32_t texel = 0;
+    std::memcpy(&texel, buffer.map(), sizeof(uint32_t));
+    buffer.unmap();
+    return texel;
+}
+
+MipMapGenerationTarget targetFor(const Texture &texture, const Extent3D &extent, MipMapMethod method = MipMapMethod::Automatic)
+{
+    return MipMapGenerationTarget{
+        .texture = &texture,
+        .format = Format::R8G8B8A8_UNORM,
+        .extent = extent,
+        .mipLevels = mipLevelCount(extent),
+        .newLayout = TextureLayout::TransferSrcOptimal,
+        .method = method,
+    };
+}
+
+} // namespace
+
+TEST_SUITE("MipMapGenerator")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "MipMapGenerator",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *discreteGPUAdapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = discreteGPUAdapter->createDevice(DeviceOptions{
+            .requestedFeatures = {
+                    .shaderStorageImageWriteWithoutFormat = discreteGPUAdapter->features().shaderStorageImageWriteWithoutFormat,
+            },
+    });
+
+    TEST_CASE("Method")
+    {
+        // GIVEN
+        MipMapGenerator generator(&device);
+
+        // THEN
+        CHECK(generator.method(Format::R8G8B8A8_UNORM) == MipMapMethod::Blit);
+        CHECK(!generator.supports(MipMapMethod::Compute, Format::R32_UINT));
+
+        // WHEN -> The device was created without shaderStorageImageWriteWithoutFormat
+        Device deviceWithoutFeatures = discreteGPUAdapter->createDevice();
+        MipMapGenerator generatorWithoutFeatures(&deviceWithoutFeatures);
+
+        // THEN -> The compute path is not available, whatever the adapter supports
+        CHECK(!generatorWithoutFeatures.supports(MipMapMethod::Compute, Format::R8G8B8A8_UNORM));
+    }
+
+    TEST_CASE("Generation")
+    {
+        // GIVEN
+        MipMapGenerator generator(&device);
+        const TextureUsageFlags blitUsage = TextureUsageFlagBits::SampledBit | TextureUsageFlagBits::TransferSrcBit | TextureUsageFlagBits::TransferDstBit;
+
+        SUBCASE("Textures are blitted in a single recording")
+        {
+            // GIVEN
+            const std::vector<Extent3D> extents = { { 64, 64, 1 }, { 32, 16, 1 }, { 5, 3, 1 } };
+            std::vector<Texture> textures;
+            std::vector<MipMapGenerationTarget> targets;
+            for (const Extent3D &extent : extents)
+                textures.push_back(createSolidTexture(device, extent, blitUsage));
+            for (size_t i = 0; i < extents.size(); ++i)
+                targets.push_back(targetFor(textures[i], extents[i]));
+
+            // WHEN
+            CommandRecorder recorder = device.createCommandRecorder();
+            MipMapGenerationResources resources = generator.record(recorder, targets);
+            CommandBuffer commandBuffer = recorder.finish();
+            device.queues()[0].submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+            device.queues()[0].waitUntilIdle();
+
+            // THEN
+            CHECK(resources.skippedCount == 0);
+            CHECK(resources.bindGroups.empty());
+            for (size_t i = 0; i < extents.size(); ++i)
+                CHECK(readLastTexel(device, textures[i], extents[i]) == SolidColor);
+        }
+
+        SUBCASE("Textures are downsampled by the compute shader")
+        {
+            if (!generator.supports(MipMapMethod::Compute, Format::R8G8B8A8_UNORM))
+                return;
+
+            // GIVEN
+            const Extent3D extent = { 48, 20, 1 };
+            Texture texture = createSolidTexture(device, extent, blitUsage | TextureUsageFlagBits::StorageBit);
+            const std::vector<MipMapGenerationTarget> targets = { targetFor(texture, extent, MipMapMethod::Compute) };
+
+            // WHEN
+            CommandRecorder recorder = device.createCommandRecorder();
+            MipMapGenerationResources resources = generator.record(recorder, targets);
+            CommandBuffer commandBuffer = recorder.finish();
+            device.queues()[0].submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+            device.queues()[0].waitUntilIdle();
+
+            // THEN
+            CHECK(resources.skippedCount == 0);
+            CHECK(resources.textureViews.size() == mipLevelCount(extent));
+            CHECK(resources.bindGroups.size() == mipLevelCount(extent) - 1);
+            CHECK(readLastTexel(device, texture, extent) == SolidColor);
+        }
+
+        SUBCASE("Unsupported targets are skipped but still transitioned")
+        {
+            // GIVEN
+            Texture texture = device.createTexture(TextureOptions{
+                    .type = TextureType::TextureType2D,
+                    .format = Format::R32_UINT,
+                    .extent = { 16, 16, 1 },
+                    .mipLevels = 5,
+                    .usage = TextureUsageFlagBits::StorageBit | TextureUsageFlagBits::TransferDstBit,
+                    .memoryUsage = MemoryUsage::GpuOnly,
+            });
+            const std::vector<MipMapGenerationTarget> targets = {
+                MipMapGenerationTarget{
+                        .texture = &texture,
+                        .format = Format::R32_UINT,
+                        .extent = { 16, 16, 1 },
+                        .mipLevels = 5,
+                        .oldLayout = TextureLayout::Undefined,
+                        .newLayout = TextureLayout::General,
+                        .method = MipMapMethod::Compute,
+                },
+            };
+
+            // WHEN
+            CommandRecorder recorder = device.createCommandRecorder();
+            MipMapGenerationResources resources = generator.record(recorder, targets);
+            CommandBuffer commandBuffer = recorder.finish();
+            device.queues()[0].submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+            device.queues()[0].waitUntilIdle();
+
+            // THEN -> And no validation errors about the layout of the texture
+            CHECK(resources.skippedCount == 1);
+            CHECK(resources.textureViews.empty());
+        }
+    }
+
+    // Run with --no-skip to get the numbers. Generating the mip levels of many textures
+    // with one submission each against a single batched recording.
+    TEST_CASE("Batch benchmark" * doctest::skip())
+    {
+        constexpr uint32_t textureCount = 500;
+        const Extent3D extent = { 128, 128, 1 };
+        const TextureOptions textureOptions{
+            .type = TextureType::TextureType2D,
+            .format = Format::R8G8B8A8_UNORM,
+            .extent = extent,
+            .mipLevels = mipLevelCount(extent),
+            .usage = TextureUsageFlagBits::SampledBit | TextureUsageFlagBits::TransferSrcBit | TextureUsageFlagBits::TransferDstBit,
+            .memoryUsage = MemoryUsage::GpuOnly,
+        };
+        Queue &queue = device.queues()[0];
+
+        // The content of the first level does not matter, only its layout
+        const auto createTextures = [&] {
+            std::vector<Texture> textures;
+            std::vector<TextureMemoryBarrierOptions> barriers;
+            for (uint32_t i = 0; i < textureCount; ++i) {
+                textures.push_back(device.createTexture(textureOptions));
+                barriers.push_back(TextureMemoryBarrierOptions{
+                        .srcStages = PipelineStageFlagBit::TopOfPipeBit,
+                        .dstStages = PipelineStageFlagBit::TransferBit,
+                        .dstMask = AccessFlagBit::TransferWriteBit,
+                        .oldLayout = TextureLayout::Undefined,
+                        .newLayout = TextureLayout::TransferDstOptimal,
+                        .texture = textures.back(),
+                        .range = { .aspectMask = TextureAspectFlagBits::ColorBit, .levelCount = 1 },
+                });
+            }
+            CommandRecorder recorder = device.createCommandRecorder();
+            recorder.textureMemoryBarriers(barriers);
+            CommandBuffer commandBuffer = recorder.finish();
+            queue.submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+            queue.waitUntilIdle();
+            return textures;
+        };
+
+        std::vector<Texture> textures = createTextures();
+        auto start = std::chrono::steady_clock::now();
+        for (Texture &texture : textures)
+            texture.generateMipMaps(device, queue, textureOptions, TextureLayout::TransferDstOptimal, TextureLayout::ShaderReadOnlyOptimal);
+        const double perTextureMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        textures = createTextures();
+        MipMapGenerator generator(&device);
+        std::vector<MipMapGenerationTarget> targets;
+        for (const Texture &texture : textures)
+            targets.push_back(MipMapGenerationTarget{ .texture = &texture, .format = textureOptions.format, .extent = extent, .mipLevels = textureOptions.mipLevels });
+        start = std::chrono::steady_clock::now();
+        CommandRecorder recorder = device.createCommandRecorder();
+        MipMapGenerationResources resources = generator.record(recorder, targets);
+        CommandBuffer commandBuffer = recorder.finish();
+        queue.submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+        queue.waitUntilIdle();
+        const double batchedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        MESSAGE("Mip levels of " << textureCount << " textures: one submission per texture " << perTextureMs
+                                 << " ms, batched " << batchedMs << " ms");
+    }
+}
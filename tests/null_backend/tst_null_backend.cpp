@@ -0,0 +1,633 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/buffer.h>
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/compute_pipeline_options.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/frame_command_allocator.h>
+#include <KDGpu/graphics_pipeline.h>
+#include <KDGpu/graphics_pipeline_options.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/pipeline_layout.h>
+#include <KDGpu/queue.h>
+#include <KDGpu/render_pass_command_recorder.h>
+#include <KDGpu/shader_module.h>
+#include <KDGpu/texture.h>
+#include <KDGpu/texture_options.h>
+#include <KDGpu/texture_view.h>
+#include <KDGpu/upload_batch.h>
+#include <KDGpu/null/null_graphics_api.h>
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <string>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+TEST_SUITE("NullBackend")
+{
+    TEST_CASE("Instance and Device")
+    {
+        // GIVEN
+        NullGraphicsApi api;
+
+        // WHEN
+        Instance instance = api.createInstance(InstanceOptions{ .applicationName = "NullBackend" });
+        Adapter *adapter = instance.selectAdapter(AdapterDeviceType::Default);
+
+        // THEN
+        CHECK(api.api() == ApiType::Null);
+        REQUIRE(instance.isValid());
+        REQUIRE(adapter != nullptr);
+        CHECK(adapter->properties().deviceType == AdapterDeviceType::DiscreteGpu);
+
+        // WHEN
+        Device device = adapter->createDevice();
+
+        // THEN
+        REQUIRE(device.isValid());
+        CHECK(!device.queues().empty());
+        CHECK(api.callCounters().count(NullCall::QueryAdapters) == 1);
+        CHECK(!device.enabledFeatures().hostImageCopy);
+
+        // WHEN
+        Device deviceWithFeatures = adapter->createDevice(DeviceOptions{ .requestedFeatures = { .hostImageCopy = true } });
+
+        // THEN -> It reports the features it was created with rather than those of the adapter
+        CHECK(deviceWithFeatures.enabledFeatures().hostImageCopy);
+        CHECK(!deviceWithFeatures.enabledFeatures().geometryShader);
+    }
+
+    TEST_CASE("Resources")
+    {
+        // GIVEN
+        NullGraphicsApi api;
+        Instance instance = api.createInstance(InstanceOptions{ .applicationName = "NullBackend" });
+        Device device = instance.selectAdapter(AdapterDeviceType::Default)->createDevice();
+        const uint64_t createdBefore = api.callCounters().count(NullCall::CreateResource);
+        const uint64_t deletedBefore = api.callCounters().count(NullCall::DeleteResource);
+
+        SUBCASE("Buffers are backed by host memory")
+        {
+            // GIVEN
+            const std::vector<uint32_t> data{ 1, 2, 3, 4 };
+
+            {
+                // WHEN
+                Buffer buffer = device.createBuffer(BufferOptions{
+                                                            .size = data.size() * sizeof(uint32_t),
+                                                            .usage = BufferUsageFlagBits::StorageBufferBit,
+                                                            .memoryUsage = MemoryUsage::CpuToGpu,
+                                                    },
+                                                    data.data());
+
+                // THEN
+                REQUIRE(buffer.isValid());
+                CHECK(api.callCounters().count(NullCall::CreateResource) == createdBefore + 1);
+
+                const auto *mapped = static_cast<const uint32_t *>(buffer.map());
+                REQUIRE(mapped != nullptr);
+                CHECK(std::memcmp(mapped, data.data(), data.size() * sizeof(uint32_t)) == 0);
+                buffer.unmap();
+
+                CHECK(api.callCounters().count(NullCall::BufferMap) == 1);
+                CHECK(api.callCounters().count(NullCall::BufferUnmap) == 1);
+            }
+
+            // THEN
+            CHECK(api.callCounters().count(NullCall::DeleteResource) == deletedBefore + 1);
+        }
+
+        SUBCASE("Persistently mapped buffers are not mapped per use")
+        {
+            // GIVEN
+            Buffer buffer = device.createBuffer(BufferOptions{
+                    .size = 4 * sizeof(uint32_t),
+                    .usage = BufferUsageFlagBits::UniformBufferBit,
+                    .memoryUsage = MemoryUsage::CpuToGpu,
+                    .persistentlyMapped = true,
+            });
+            REQUIRE(buffer.mappedPointer() != nullptr);
+
+            // WHEN
+            for (uint32_t frame = 0; frame < 3; ++frame) {
+                auto *mapped = static_cast<uint32_t *>(buffer.map());
+                mapped[frame] = frame;
+                buffer.unmap();
+                buffer.flush(frame * sizeof(uint32_t), sizeof(uint32_t));
+            }
+
+            // THEN
+            CHECK(api.callCounters().count(NullCall::BufferMap) == 0);
+            CHECK(api.callCounters().count(NullCall::BufferUnmap) == 0);
+            CHECK(api.callCounters().count(NullCall::BufferFlush) == 3);
+        }
+
+        SUBCASE("Identical shader code shares a shader module")
+        {
+            // GIVEN
+            const std::vector<uint32_t> code{ 0x07230203, 0x00010000, 0, 8, 0 };
+
+            {
+                // WHEN
+                const ShaderModule shaderModule1 = device.createShaderModule(code);
+                const ShaderModule shaderModule2 = device.createShaderModule(code);
+
+                // THEN
+                CHECK(shaderModule1.handle() == shaderModule2.handle());
+                CHECK(api.callCounters().count(NullCall::CreateResource) == createdBefore + 1);
+                CHECK(device.shaderModuleDeduplicationStats().hits == 1);
+                CHECK(device.shaderModuleDeduplicationStats().cachedShaderModules == 1);
+            }
+
+            // THEN
+            CHECK(api.callCounters().count(NullCall::DeleteResource) == deletedBefore + 1);
+            CHECK(device.shaderModuleDeduplicationStats().cachedShaderModules == 0);
+        }
+
+        SUBCASE("Frame command allocators reset a pool per frame")
+        {
+            // GIVEN
+            Fence fence = device.createFence();
+            FrameCommandAllocator allocator = device.createFrameCommandAllocator(FrameCommandAllocatorOptions{ .frameCount = 2 });
+            REQUIRE(allocator.isValid());
+
+            // WHEN
+            allocator.beginFrame(1, fence);
+            CommandRecorder commandRecorder = device.createCommandRecorder(CommandRecorderOptions{ .frameCommandAllocator = allocator });
+
+            // THEN
+            CHECK(commandRecorder.finish().isValid());
+            CHECK(allocator.currentFrame() == 1);
+            CHECK(api.callCounters().count(NullCall::FenceWait) == 1);
+            CHECK(api.callCounters().count(NullCall::CommandPoolReset) == 1);
+
+            // WHEN
+            allocator.beginFrame(2);
+
+            // THEN
+            CHECK(allocator.currentFrame() == 1);
+            CHECK(api.callCounters().count(NullCall::CommandPoolReset) == 1);
+        }
+
+        SUBCASE("Submitting signals the fence")
+        {
+            // GIVEN
+            Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+            CommandRecorder commandRecorder = device.createCommandRecorder();
+            CommandBuffer commandBuffer = commandRecorder.finish();
+
+            // THEN
+            CHECK(fence.status() == FenceStatus::Unsignalled);
+            CHECK(fence.submissionCount() == 0);
+
+            // WHEN
+            device.queues()[0].submit(SubmitOptions{
+                    .commandBuffers = { commandBuffer },
+                    .signalFence = fence,
+            });
+
+            // THEN
+            CHECK(fence.status() == FenceStatus::Signalled);
+            CHECK(fence.submissionCount() == 1);
+            CHECK(api.callCounters().count(NullCall::QueueSubmit) == 1);
+        }
+
+        SUBCASE("Upload batches are submitted at once")
+        {
+            // GIVEN
+            const std::vector<uint32_t> data(64, 42);
+            std::vector<Buffer> buffers;
+            std::vector<Texture> textures;
+            UploadBatch batch;
+            for (uint32_t i = 0; i < 8; ++i) {
+                buffers.push_back(device.createBuffer(BufferOptions{
+                        .size = data.size() * sizeof(uint32_t),
+                        .usage = BufferUsageFlagBits::VertexBufferBit | BufferUsageFlagBits::TransferDstBit,
+                        .memoryUsage = MemoryUsage::GpuOnly,
+                }));
+                batch.addBufferUpload(BufferUploadOptions{
+                        .destinationBuffer = buffers.back(),
+                        .dstStages = PipelineStageFlagBit::VertexAttributeInputBit,
+                        .dstMask = AccessFlagBit::VertexAttributeReadBit,
+                        .data = data.data(),
+                        .byteSize = data.size() * sizeof(uint32_t),
+                });
+            }
+            for (uint32_t i = 0; i < 2; ++i) {
+                textures.push_back(device.createTexture(TextureOptions{
+                        .type = TextureType::TextureType2D,
+                        .format = Format::R8G8B8A8_UNORM,
+                        .extent = { 8, 8, 1 },
+                        .mipLevels = 1,
+                        .usage = TextureUsageFlagBits::SampledBit | TextureUsageFlagBits::TransferDstBit,
+                        .memoryUsage = MemoryUsage::GpuOnly,
+                }));
+                batch.addTextureUpload(TextureUploadOptions{
+                        .destinationTexture = textures.back(),
+                        .dstStages = PipelineStageFlagBit::FragmentShaderBit,
+                        .dstMask = AccessFlagBit::ShaderReadBit,
+                        .data = data.data(),
+                        .byteSize = data.size() * sizeof(uint32_t),
+                        .oldLayout = TextureLayout::Undefined,
+                        .newLayout = TextureLayout::ShaderReadOnlyOptimal,
+                        .regions = { { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit }, .textureExtent = { 8, 8, 1 } } },
+                });
+            }
+
+            // WHEN
+            UploadStagingBuffer upload = device.queues()[0].upload(batch);
+
+            // THEN
+            REQUIRE(upload.buffer.isValid());
+            CHECK(upload.fence.status() == FenceStatus::Signalled);
+            CHECK(api.callCounters().count(NullCall::QueueSubmit) == 1);
+            CHECK(api.callCounters().count(NullCall::CopyBuffer) == 8);
+            CHECK(api.callCounters().count(NullCall::CopyBufferToTexture) == 2);
+            CHECK(api.callCounters().count(NullCall::MemoryBarrier) == 1);
+            CHECK(api.callCounters().count(NullCall::TextureMemoryBarrier) == 2);
+            CHECK(api.callCounters().count(NullCall::BufferMemoryBarrier) == 0);
+            const auto *staging = static_cast<const uint32_t *>(upload.buffer.mappedPointer());
+            REQUIRE(staging != nullptr);
+            CHECK(staging[0] == 42);
+        }
+    }
+
+    TEST_CASE("Host image copy uploads")
+    {
+        // GIVEN
+        NullGraphicsApi api;
+        Instance instance = api.createInstance(InstanceOptions{ .applicationName = "NullBackend" });
+        Device device = instance.selectAdapter(AdapterDeviceType::Default)->createDevice(DeviceOptions{
+                .requestedFeatures = { .hostImageCopy = true },
+        });
+        const std::vector<uint32_t> data(64, 42);
+        const auto uploadTo = [&](const Texture &texture, TextureLayout newLayout, TextureLayout oldLayout = TextureLayout::Undefined) {
+            return device.queues()[0].uploadTextureData(TextureUploadOptions{
+                    .destinationTexture = texture,
+                    .dstStages = PipelineStageFlagBit::FragmentShaderBit,
+                    .dstMask = AccessFlagBit::ShaderReadBit,
+                    .data = data.data(),
+                    .byteSize = data.size() * sizeof(uint32_t),
+                    .oldLayout = oldLayout,
+                    .newLayout = newLayout,
+                    .regions = { { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit }, .textureExtent = { 8, 8, 1 } } },
+            });
+        };
+        TextureOptions textureOptions{
+            .type = TextureType::TextureType2D,
+            .format = Format::R8G8B8A8_UNORM,
+            .extent = { 8, 8, 1 },
+            .mipLevels = 1,
+            .usage = TextureUsageFlagBits::SampledBit | TextureUsageFlagBits::HostTransferBit,
+            .memoryUsage = MemoryUsage::GpuOnly,
+        };
+
+        SUBCASE("Host transfer textures are written without a submission")
+        {
+            // GIVEN
+            Texture texture = device.createTexture(textureOptions);
+
+            // WHEN
+            UploadStagingBuffer upload = uploadTo(texture, TextureLayout::ShaderReadOnlyOptimal);
+
+            // THEN
+            CHECK(!upload.buffer.isValid());
+            CHECK(upload.fence.status() == FenceStatus::Signalled);
+            CHECK(api.callCounters().count(NullCall::QueueSubmit) == 0);
+            CHECK(api.callCounters().count(NullCall::HostLayoutTransition) == 1);
+            CHECK(api.callCounters().count(NullCall::CopyHostMemoryToTexture) == 1);
+        }
+
+        SUBCASE("Other textures fall back to a staging buffer")
+        {
+            // GIVEN
+            textureOptions.usage = TextureUsageFlagBits::SampledBit | TextureUsageFlagBits::TransferDstBit;
+            Texture texture = device.createTexture(textureOptions);
+
+            // WHEN
+            UploadStagingBuffer upload = uploadTo(texture, TextureLayout::ShaderReadOnlyOptimal);
+
+            // THEN
+            CHECK(upload.buffer.isValid());
+            CHECK(api.callCounters().count(NullCall::QueueSubmit) == 1);
+            CHECK(api.callCounters().count(NullCall::CopyHostMemoryToTexture) == 0);
+        }
+
+        SUBCASE("Layouts the host cannot write to fall back to a staging buffer")
+        {
+            // GIVEN
+            textureOptions.usage |= TextureUsageFlagBits::TransferDstBit;
+            Texture texture = device.createTexture(textureOptions);
+
+            // WHEN
+            UploadStagingBuffer upload = uploadTo(texture, TextureLayout::ColorAttachmentOptimal);
+
+            // THEN
+            CHECK(upload.buffer.isValid());
+            CHECK(api.callCounters().count(NullCall::QueueSubmit) == 1);
+            CHECK(api.callCounters().count(NullCall::CopyHostMemoryToTexture) == 0);
+        }
+
+        SUBCASE("Uploads over existing content fall back to a staging buffer")
+        {
+            // GIVEN
+            textureOptions.usage |= TextureUsageFlagBits::TransferDstBit;
+            Texture texture = device.createTexture(textureOptions);
+
+            // WHEN -> The GPU might still be reading the texture in its old layout
+            UploadStagingBuffer upload = uploadTo(texture, TextureLayout::ShaderReadOnlyOptimal, TextureLayout::ShaderReadOnlyOptimal);
+
+            // THEN
+            CHECK(upload.buffer.isValid());
+            CHECK(api.callCounters().count(NullCall::QueueSubmit) == 1);
+            CHECK(api.callCounters().count(NullCall::HostLayoutTransition) == 0);
+            CHECK(api.callCounters().count(NullCall::CopyHostMemoryToTexture) == 0);
+        }
+    }
+
+    TEST_CASE("Host memory import")
+    {
+        // GIVEN
+        NullGraphicsApi api;
+        Instance instance = api.createInstance(InstanceOptions{ .applicationName = "NullBackend" });
+        Adapter *adapter = instance.selectAdapter(AdapterDeviceType::Default);
+        Device device = adapter->createDevice();
+        const DeviceSize alignment = adapter->properties().externalMemoryHostProperties.minImportedHostPointerAlignment;
+        REQUIRE(alignment != 0);
+        std::vector<uint8_t> memory(3 * alignment, 0x2a);
+        // First aligned byte of memory
+        uint8_t *aligned = memory.data() + (alignment - reinterpret_cast<uintptr_t>(memory.data()) % alignment) % alignment;
+
+        SUBCASE("Aligned memory is used as the buffer memory")
+        {
+            // WHEN
+            Buffer buffer = device.createBuffer(BufferOptions{
+                    .size = alignment,
+                    .usage = BufferUsageFlagBits::TransferSrcBit,
+                    .memoryUsage = MemoryUsage::CpuToGpu,
+                    .hostPointer = aligned,
+            });
+
+            // THEN
+            REQUIRE(buffer.isValid());
+            CHECK(buffer.mappedPointer() == aligned);
+            CHECK(buffer.map() == aligned);
+        }
+
+        SUBCASE("Unaligned memory is refused")
+        {
+            // WHEN
+            Buffer unalignedPointer = device.createBuffer(BufferOptions{
+                    .size = alignment,
+                    .usage = BufferUsageFlagBits::TransferSrcBit,
+                    .memoryUsage = MemoryUsage::CpuToGpu,
+                    .hostPointer = aligned + 1,
+            });
+            Buffer unalignedSize = device.createBuffer(BufferOptions{
+                    .size = alignment - 1,
+                    .usage = BufferUsageFlagBits::TransferSrcBit,
+                    .memoryUsage = MemoryUsage::CpuToGpu,
+                    .hostPointer = aligned,
+            });
+
+            // THEN
+            CHECK(!unalignedPointer.isValid());
+            CHECK(!unalignedSize.isValid());
+        }
+    }
+
+    TEST_CASE("Mip maps are recorded without submitting")
+    {
+        // GIVEN
+        NullGraphicsApi api;
+        Instance instance = api.createInstance(InstanceOptions{ .applicationName = "NullBackend" });
+        Device device = instance.selectAdapter(AdapterDeviceType::Default)->createDevice();
+        const TextureOptions textureOptions{
+            .type = TextureType::TextureType2D,
+            .format = Format::R8G8B8A8_UNORM,
+            .extent = { 64, 64, 1 },
+            .mipLevels = 7,
+            .usage = TextureUsageFlagBits::SampledBit | TextureUsageFlagBits::TransferSrcBit | TextureUsageFlagBits::TransferDstBit,
+            .memoryUsage = MemoryUsage::GpuOnly,
+        };
+        std::vector<Texture> textures;
+        for (uint32_t i = 0; i < 4; ++i)
+            textures.push_back(device.createTexture(textureOptions));
+        CommandRecorder commandRecorder = device.createCommandRecorder();
+
+        // WHEN
+        for (Texture &texture : textures)
+            CHECK(texture.generateMipMaps(device, commandRecorder, textureOptions, TextureLayout::TransferDstOptimal, TextureLayout::ShaderReadOnlyOptimal));
+
+        // THEN
+        CHECK(api.callCounters().count(NullCall::BlitTexture) == 4 * 6);
+        CHECK(api.callCounters().count(NullCall::QueueSubmit) == 0);
+
+        // WHEN
+        CommandBuffer commandBuffer = commandRecorder.finish();
+        device.queues()[0].submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+
+        // THEN
+        CHECK(api.callCounters().count(NullCall::QueueSubmit) == 1);
+    }
+
+    TEST_CASE("Recording")
+    {
+        // GIVEN
+        NullGraphicsApi api;
+        Instance instance = api.createInstance(InstanceOptions{ .applicationName = "NullBackend" });
+        Device device = instance.selectAdapter(AdapterDeviceType::Default)->createDevice();
+
+        const Texture colorTexture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 256, 256, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::ColorAttachmentBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        const TextureView colorTextureView = colorTexture.createView();
+        const PipelineLayout pipelineLayout = device.createPipelineLayout();
+        const GraphicsPipeline pipeline = device.createGraphicsPipeline(GraphicsPipelineOptions{
+                .layout = pipelineLayout.handle(),
+                .renderTargets = { { .format = Format::R8G8B8A8_UNORM } },
+        });
+
+        api.callCounters().reset();
+
+        // WHEN
+        CommandRecorder commandRecorder = device.createCommandRecorder();
+        RenderPassCommandRecorder renderPass = commandRecorder.beginRenderPass(RenderPassCommandRecorderOptions{
+                .colorAttachments = { { .view = colorTextureView } },
+        });
+        renderPass.setPipeline(pipeline);
+        renderPass.draw(DrawCommand{ .vertexCount = 3 });
+
+        const std::vector<DrawCommand> draws(4, DrawCommand{ .vertexCount = 3 });
+        renderPass.draw(draws);
+        renderPass.end();
+        CommandBuffer commandBuffer = commandRecorder.finish();
+
+        // THEN
+        CHECK(api.callCounters().count(NullCall::SetPipeline) == 1);
+        CHECK(api.callCounters().count(NullCall::Draw) == 5);
+        CHECK(api.callCounters().count(NullCall::EndPass) == 1);
+        CHECK(api.callCounters().count(NullCall::Finish) == 1);
+        CHECK(commandBuffer.isValid());
+    }
+
+    TEST_CASE("Redundant binds are skipped")
+    {
+        // GIVEN
+        NullGraphicsApi api;
+        Instance instance = api.createInstance(InstanceOptions{ .applicationName = "NullBackend" });
+        Device device = instance.selectAdapter(AdapterDeviceType::Default)->createDevice();
+
+        const Texture colorTexture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 256, 256, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::ColorAttachmentBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        const TextureView colorTextureView = colorTexture.createView();
+        const PipelineLayout pipelineLayout = device.createPipelineLayout();
+        const GraphicsPipeline pipeline = device.createGraphicsPipeline(GraphicsPipelineOptions{
+                .layout = pipelineLayout.handle(),
+                .renderTargets = { { .format = Format::R8G8B8A8_UNORM } },
+        });
+        const Buffer vertexBuffer = device.createBuffer(BufferOptions{
+                .size = 1024,
+                .usage = BufferUsageFlagBits::VertexBufferBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+
+        api.callCounters().reset();
+
+        // WHEN
+        CommandRecorder commandRecorder = device.createCommandRecorder();
+        RenderPassCommandRecorder renderPass = commandRecorder.beginRenderPass(RenderPassCommandRecorderOptions{
+                .colorAttachments = { { .view = colorTextureView } },
+        });
+        for (uint32_t i = 0; i < 10; ++i) {
+            renderPass.setPipeline(pipeline);
+            renderPass.setVertexBuffer(0, vertexBuffer);
+            renderPass.draw(DrawCommand{ .vertexCount = 3 });
+        }
+        const BindStateStats stats = renderPass.bindStateStats();
+        renderPass.end();
+
+        // THEN
+        CHECK(api.callCounters().count(NullCall::SetPipeline) == 1);
+        CHECK(api.callCounters().count(NullCall::SetVertexBuffer) == 1);
+        CHECK(api.callCounters().count(NullCall::Draw) == 10);
+        CHECK(stats.issuedBinds == 2);
+        CHECK(stats.skippedBinds == 18);
+    }
+
+    TEST_CASE("Asynchronous pipeline creation")
+    {
+        // GIVEN
+        NullGraphicsApi api;
+        Instance instance = api.createInstance(InstanceOptions{ .applicationName = "NullBackend" });
+        Device device = instance.selectAdapter(AdapterDeviceType::Default)->createDevice();
+        const PipelineLayout pipelineLayout = device.createPipelineLayout();
+        std::string label = "Async";
+
+        // WHEN
+        std::future<GraphicsPipeline> future = device.createGraphicsPipelineAsync(GraphicsPipelineOptions{
+                .label = label,
+                .layout = pipelineLayout.handle(),
+                .renderTargets = { { .format = Format::R8G8B8A8_UNORM } },
+        });
+        label.clear();
+        const GraphicsPipeline pipeline = future.get();
+
+        // THEN
+        CHECK(pipeline.isValid());
+
+        // WHEN -> The device was moved from
+        Device movedTo = std::move(device);
+        std::future<ComputePipeline> movedFromFuture = device.createComputePipelineAsync(ComputePipelineOptions{});
+
+        // THEN -> The pipeline is invalid rather than the device dereferencing its moved state
+        CHECK(!movedFromFuture.get().isValid());
+    }
+
+    // Measures what the front end costs per recorded command, without a driver underneath.
+    // Run with --no-skip to get the numbers.
+    TEST_CASE("Benchmark" * doctest::skip())
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr uint32_t frameCount = 100;
+        constexpr uint32_t drawsPerFrame = 10000;
+
+        NullGraphicsApi api;
+        Instance instance = api.createInstance(InstanceOptions{ .applicationName = "NullBackend" });
+        Device device = instance.selectAdapter(AdapterDeviceType::Default)->createDevice();
+
+        const Texture colorTexture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 256, 256, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::ColorAttachmentBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        const TextureView colorTextureView = colorTexture.createView();
+        const PipelineLayout pipelineLayout = device.createPipelineLayout();
+        const GraphicsPipeline pipeline = device.createGraphicsPipeline(GraphicsPipelineOptions{
+                .layout = pipelineLayout.handle(),
+                .renderTargets = { { .format = Format::R8G8B8A8_UNORM } },
+        });
+        const Buffer vertexBuffer = device.createBuffer(BufferOptions{
+                .size = 1024,
+                .usage = BufferUsageFlagBits::VertexBufferBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+
+        api.callCounters().reset();
+
+        const auto start = Clock::now();
+        for (uint32_t frame = 0; frame < frameCount; ++frame) {
+            CommandRecorder commandRecorder = device.createCommandRecorder();
+            RenderPassCommandRecorder renderPass = commandRecorder.beginRenderPass(RenderPassCommandRecorderOptions{
+                    .colorAttachments = { { .view = colorTextureView } },
+            });
+            for (uint32_t i = 0; i < drawsPerFrame; ++i) {
+                renderPass.setPipeline(pipeline);
+                renderPass.setVertexBuffer(0, vertexBuffer);
+                renderPass.draw(DrawCommand{ .vertexCount = 3, .firstInstance = i });
+            }
+            renderPass.end();
+            CommandBuffer commandBuffer = commandRecorder.finish();
+            device.queues()[0].submit(SubmitOptions{ .commandBuffers = { commandBuffer } });
+        }
+        const auto elapsed = Clock::now() - start;
+
+        const uint64_t calls = api.callCounters().totalCount();
+        using ms = std::chrono::duration<double, std::milli>;
+        using ns = std::chrono::duration<double, std::nano>;
+        MESSAGE("Recorded " << calls << " backend calls over " << frameCount << " frames in "
+                            << ms(elapsed).count() << "ms"
+                            << " (" << ns(elapsed).count() / double(calls) << "ns per call)");
+        REQUIRE(api.callCounters().count(NullCall::Draw) == uint64_t(frameCount) * drawsPerFrame);
+    }
+}
@@ -0,0 +1,195 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/persistent_pipeline_cache.h>
+
+#include <KDGpu/adapter_properties.h>
+#include <KDGpu/device.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+namespace {
+
+void appendUint32(std::vector<uint8_t> &data, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        data.push_back(uint8_t(value >> (8 * i)));
+}
+
+std::vector<uint8_t> makeCacheData(const KDGpu::AdapterProperties &properties)
+{
+    std::vector<uint8_t> data;
+    appendUint32(data, 32);
+    appendUint32(data, 1);
+    appendUint32(data, properties.vendorID);
+    appendUint32(data, properties.deviceID);
+    data.insert(data.end(), properties.pipelineCacheUUID.begin(), properties.pipelineCacheUUID.end());
+    data.resize(data.size() + 64, 0xab);
+    return data;
+}
+
+void writeFile(const std::filesystem::path &path, const std::vector<uint8_t> &data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), std::streamsize(data.size()));
+}
+
+} // namespace
+
+TEST_CASE("Header validation")
+{
+    // GIVEN
+    KDGpu::AdapterProperties properties;
+    properties.vendorID = 0x10de;
+    properties.deviceID = 0x2204;
+    for (size_t i = 0; i < properties.pipelineCacheUUID.size(); ++i)
+        properties.pipelineCacheUUID[i] = uint8_t(i);
+    std::vector<uint8_t> data = makeCacheData(properties);
+
+    SUBCASE("accepts a matching header")
+    {
+        CHECK(KDGpuUtils::PersistentPipelineCache::isCompatible(data, properties));
+    }
+
+    SUBCASE("rejects a different vendor or device")
+    {
+        KDGpu::AdapterProperties otherProperties = properties;
+
+        // WHEN
+        otherProperties.vendorID = 0x1002;
+
+        // THEN
+        CHECK(!KDGpuUtils::PersistentPipelineCache::isCompatible(data, otherProperties));
+
+        // WHEN
+        otherProperties = properties;
+        otherProperties.deviceID = 0x2206;
+
+        // THEN
+        CHECK(!KDGpuUtils::PersistentPipelineCache::isCompatible(data, otherProperties));
+    }
+
+    SUBCASE("rejects a different pipeline cache UUID")
+    {
+        // WHEN
+        data[20] ^= 0xff;
+
+        // THEN
+        CHECK(!KDGpuUtils::PersistentPipelineCache::isCompatible(data, properties));
+    }
+
+    SUBCASE("rejects an unknown header version")
+    {
+        // WHEN
+        data[4] = 2;
+
+        // THEN
+        CHECK(!KDGpuUtils::PersistentPipelineCache::isCompatible(data, properties));
+    }
+
+    SUBCASE("rejects truncated data")
+    {
+        // WHEN
+        data.resize(31);
+
+        // THEN
+        CHECK(!KDGpuUtils::PersistentPipelineCache::isCompatible(data, properties));
+        CHECK(!KDGpuUtils::PersistentPipelineCache::isCompatible({}, properties));
+    }
+}
+
+TEST_SUITE("PersistentPipelineCache")
+{
+    std::unique_ptr<KDGpu::GraphicsApi> api = std::make_unique<KDGpu::VulkanGraphicsApi>();
+    KDGpu::Instance instance = api->createInstance(KDGpu::InstanceOptions{
+            .applicationName = "PersistentPipelineCache",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    KDGpu::Adapter *discreteGPUAdapter = instance.selectAdapter(KDGpu::AdapterDeviceType::Default);
+    KDGpu::Device device = discreteGPUAdapter->createDevice();
+
+    const std::filesystem::path cachePath = std::filesystem::temp_directory_path() / "kdgpu_persistent_pipeline_cache.bin";
+
+    TEST_CASE("Loading")
+    {
+        std::filesystem::remove(cachePath);
+
+        SUBCASE("starts empty without a file")
+        {
+            // WHEN
+            KDGpuUtils::PersistentPipelineCache cache(&device, { .path = cachePath });
+
+            // THEN
+            CHECK(cache.loadResult() == KDGpuUtils::PersistentPipelineCache::LoadResult::NotFound);
+            CHECK(cache.pipelineCache().isValid());
+        }
+
+        SUBCASE("discards a file from a different device")
+        {
+            // GIVEN
+            KDGpu::AdapterProperties otherProperties = discreteGPUAdapter->properties();
+            otherProperties.deviceID += 1;
+            writeFile(cachePath, makeCacheData(otherProperties));
+
+            // WHEN
+            KDGpuUtils::PersistentPipelineCache cache(&device, { .path = cachePath });
+
+            // THEN
+            CHECK(cache.loadResult() == KDGpuUtils::PersistentPipelineCache::LoadResult::Incompatible);
+            CHECK(cache.pipelineCache().isValid());
+        }
+
+        std::filesystem::remove(cachePath);
+    }
+
+    TEST_CASE("Saving")
+    {
+        std::filesystem::remove(cachePath);
+
+        SUBCASE("writes a cache that loads on the next run")
+        {
+            // GIVEN
+            {
+                KDGpuUtils::PersistentPipelineCache cache(&device, { .path = cachePath });
+                REQUIRE(cache.threadCache().isValid());
+
+                // WHEN
+                REQUIRE(cache.save());
+            }
+
+            // THEN
+            REQUIRE(std::filesystem::exists(cachePath));
+            CHECK(!std::filesystem::exists(std::filesystem::path(cachePath).concat(".tmp")));
+
+            // WHEN
+            KDGpuUtils::PersistentPipelineCache cache(&device, { .path = cachePath });
+
+            // THEN
+            CHECK(cache.loadResult() == KDGpuUtils::PersistentPipelineCache::LoadResult::Loaded);
+        }
+
+        SUBCASE("only saves periodically when an interval is set")
+        {
+            // GIVEN
+            KDGpuUtils::PersistentPipelineCache cache(&device, { .path = cachePath });
+
+            // THEN
+            CHECK(!cache.saveIfDue());
+        }
+
+        std::filesystem::remove(cachePath);
+    }
+}
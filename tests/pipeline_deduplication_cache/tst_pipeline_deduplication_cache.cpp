@@ -0,0 +1,207 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/compute_pipeline.h>
+#include <KDGpu/compute_pipeline_options.h>
+#include <KDGpu/pipeline_deduplication_cache.h>
+#include <KDGpu/pool.h>
+
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+namespace {
+
+struct Pipeline {
+    int id;
+};
+
+// Pools only serve as a source of valid handles here
+struct Handles {
+    Pool<int, ShaderModule_t> shaderModules{ 4 };
+    Pool<int, PipelineLayout_t> pipelineLayouts{ 4 };
+    Pool<Pipeline, ComputePipeline_t> pipelines{ 4 };
+};
+
+} // namespace
+
+TEST_CASE("PipelineDeduplicationCache")
+{
+    // GIVEN
+    Handles handles;
+    const Handle<ShaderModule_t> shaderModule = handles.shaderModules.emplace(0);
+    const Handle<PipelineLayout_t> pipelineLayout = handles.pipelineLayouts.emplace(0);
+    const ComputePipelineOptions options{
+        .label = "Compute",
+        .layout = pipelineLayout,
+        .shaderStage = { .shaderModule = shaderModule },
+    };
+
+    PipelineDeduplicationCache<ComputePipelineOptions, ComputePipeline_t> cache;
+    uint32_t createCount = 0;
+    auto create = [&] {
+        ++createCount;
+        return handles.pipelines.emplace(Pipeline{ int(createCount) });
+    };
+
+    SUBCASE("Identical options share a pipeline")
+    {
+        // WHEN
+        const auto handle1 = cache.getOrCreate(options, create);
+        const auto handle2 = cache.getOrCreate(options, create);
+
+        // THEN
+        CHECK(handle1.isValid());
+        CHECK(handle1 == handle2);
+        CHECK(createCount == 1);
+        CHECK(cache.stats().hits == 1);
+        CHECK(cache.stats().misses == 1);
+        CHECK(cache.stats().cachedPipelines == 1);
+    }
+
+    SUBCASE("Different options create different pipelines")
+    {
+        // GIVEN
+        ComputePipelineOptions otherOptions = options;
+        otherOptions.shaderStage.entryPoint = "other";
+
+        // WHEN
+        const auto handle1 = cache.getOrCreate(options, create);
+        const auto handle2 = cache.getOrCreate(otherOptions, create);
+
+        // THEN
+        CHECK(handle1 != handle2);
+        CHECK(createCount == 2);
+        CHECK(cache.stats().hits == 0);
+        CHECK(cache.stats().misses == 2);
+        CHECK(cache.stats().cachedPipelines == 2);
+    }
+
+    SUBCASE("Pipelines are released with the last reference")
+    {
+        // GIVEN
+        const auto handle = cache.getOrCreate(options, create);
+        REQUIRE(cache.getOrCreate(options, create) == handle);
+
+        // THEN
+        CHECK(!cache.release(handle));
+        CHECK(cache.stats().cachedPipelines == 1);
+        CHECK(cache.release(handle));
+        CHECK(cache.stats().cachedPipelines == 0);
+
+        // WHEN
+        cache.getOrCreate(options, create);
+
+        // THEN
+        CHECK(createCount == 2);
+    }
+
+    SUBCASE("Pipelines that were never cached can be released")
+    {
+        // WHEN
+        const auto handle = create();
+
+        // THEN
+        CHECK(cache.release(handle));
+    }
+
+    SUBCASE("The cache owns a copy of the label")
+    {
+        // GIVEN
+        std::string label = "Label";
+        ComputePipelineOptions labelledOptions = options;
+        labelledOptions.label = label;
+        const auto handle = cache.getOrCreate(labelledOptions, create);
+
+        // WHEN
+        label = "Other";
+        ComputePipelineOptions sameOptions = options;
+        sameOptions.label = "Label";
+
+        // THEN
+        CHECK(cache.getOrCreate(sameOptions, create) == handle);
+        CHECK(createCount == 1);
+    }
+
+    SUBCASE("Failed creations are not cached")
+    {
+        // WHEN
+        const auto handle = cache.getOrCreate(options, [] { return Handle<ComputePipeline_t>(); });
+
+        // THEN
+        CHECK(!handle.isValid());
+        CHECK(cache.stats().cachedPipelines == 0);
+    }
+
+    SUBCASE("Pipelines are created with the cache unlocked")
+    {
+        // GIVEN
+        std::mutex mutex;
+        std::unique_lock lock(mutex);
+
+        // WHEN
+        bool lockedDuringCreation = true;
+        const auto handle = cache.getOrCreate(lock, options, [&] {
+            lockedDuringCreation = lock.owns_lock();
+            return create();
+        });
+
+        // THEN
+        CHECK(handle.isValid());
+        CHECK(!lockedDuringCreation);
+        CHECK(lock.owns_lock());
+        CHECK(cache.stats().misses == 1);
+    }
+
+    SUBCASE("Concurrent requests wait for the pipeline being created")
+    {
+        // GIVEN
+        std::mutex mutex;
+        std::promise<void> creationStarted;
+        std::promise<void> finishCreation;
+        Handle<ComputePipeline_t> firstHandle;
+
+        std::thread first([&] {
+            std::unique_lock lock(mutex);
+            firstHandle = cache.getOrCreate(lock, options, [&] {
+                creationStarted.set_value();
+                finishCreation.get_future().wait();
+                return create();
+            });
+        });
+        creationStarted.get_future().wait();
+
+        // WHEN
+        std::thread second([&] {
+            std::unique_lock lock(mutex);
+            const auto handle = cache.getOrCreate(lock, options, create);
+            CHECK(handle == firstHandle);
+        });
+        // Let the second thread find the pipeline in flight
+        for (bool waiting = true; waiting; std::this_thread::yield()) {
+            std::lock_guard lock(mutex);
+            waiting = cache.stats().hits == 0;
+        }
+        finishCreation.set_value();
+        first.join();
+        second.join();
+
+        // THEN -> Both hold a reference on a single pipeline
+        CHECK(createCount == 1);
+        CHECK(!cache.release(firstHandle));
+        CHECK(cache.release(firstHandle));
+    }
+}
@@ -0,0 +1,223 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/pipeline_state_recorder.h>
+#include <KDGpuUtils/pipeline_state_replayer.h>
+
+#include <KDGpu/compute_pipeline.h>
+#include <KDGpu/compute_pipeline_options.h>
+#include <KDGpu/device.h>
+#include <KDGpu/graphics_pipeline.h>
+#include <KDGpu/graphics_pipeline_options.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/pipeline_cache.h>
+#include <KDGpu/pipeline_cache_options.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <KDUtils/file.h>
+#include <KDUtils/dir.h>
+
+#include <cstring>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+namespace {
+
+inline std::string assetPath()
+{
+#if defined(KDGPU_ASSET_PATH)
+    return KDGPU_ASSET_PATH;
+#else
+    return "";
+#endif
+}
+
+std::vector<uint32_t> readShaderFile(const std::string &filename)
+{
+    using namespace KDUtils;
+
+    File file(File::exists(filename) ? filename : Dir::applicationDir().absoluteFilePath(filename));
+
+    if (!file.open(std::ios::in | std::ios::binary)) {
+        SPDLOG_CRITICAL("Failed to open file {}", filename);
+        throw std::runtime_error("Failed to open file");
+    }
+
+    const ByteArray fileContent = file.readAll();
+    std::vector<uint32_t> buffer(fileContent.size() / 4);
+    std::memcpy(buffer.data(), fileContent.data(), fileContent.size());
+
+    return buffer;
+}
+
+struct Pipelines {
+    ShaderModule vertexShader;
+    ShaderModule fragmentShader;
+    ShaderModule computeShader;
+    PipelineLayout pipelineLayout;
+    GraphicsPipeline graphicsPipeline;
+    ComputePipeline computePipeline;
+};
+
+Pipelines createPipelines(Device &device)
+{
+    Pipelines pipelines;
+    pipelines.vertexShader = device.createShaderModule(readShaderFile(assetPath() + "/shaders/tests/graphics_pipeline/triangle.vert.spv"));
+    pipelines.fragmentShader = device.createShaderModule(readShaderFile(assetPath() + "/shaders/tests/graphics_pipeline/triangle.frag.spv"));
+    pipelines.computeShader = device.createShaderModule(readShaderFile(assetPath() + "/shaders/tests/compute_pipeline/empty_compute.comp.spv"));
+    pipelines.pipelineLayout = device.createPipelineLayout();
+
+    pipelines.graphicsPipeline = device.createGraphicsPipeline(GraphicsPipelineOptions{
+            .shaderStages = {
+                    { .shaderModule = pipelines.vertexShader.handle(), .stage = ShaderStageFlagBits::VertexBit },
+                    { .shaderModule = pipelines.fragmentShader.handle(), .stage = ShaderStageFlagBits::FragmentBit },
+            },
+            .layout = pipelines.pipelineLayout.handle(),
+            .vertex = {
+                    .buffers = { { .binding = 0, .stride = 8 * sizeof(float) } },
+                    .attributes = {
+                            { .location = 0, .binding = 0, .format = Format::R32G32B32A32_SFLOAT },
+                            { .location = 1, .binding = 0, .format = Format::R32G32B32A32_SFLOAT, .offset = 4 * sizeof(float) },
+                    },
+            },
+            .renderTargets = { { .format = Format::R8G8B8A8_UNORM } },
+            .depthStencil = { .depthTestEnabled = false },
+    });
+    pipelines.computePipeline = device.createComputePipeline(ComputePipelineOptions{
+            .layout = pipelines.pipelineLayout.handle(),
+            .shaderStage = { .shaderModule = pipelines.computeShader.handle() },
+    });
+    return pipelines;
+}
+
+} // namespace
+
+TEST_SUITE("PipelineStateRecorder")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "PipelineStateRecorder",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *discreteGPUAdapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = discreteGPUAdapter->createDevice();
+
+    TEST_CASE("Recording")
+    {
+        SUBCASE("captures pipelines created while installed")
+        {
+            // GIVEN
+            KDGpuUtils::PipelineStateRecorder recorder(&device);
+            REQUIRE(device.pipelineStateObserver() == &recorder);
+
+            // WHEN
+            const Pipelines pipelines = createPipelines(device);
+            REQUIRE(pipelines.graphicsPipeline.isValid());
+            REQUIRE(pipelines.computePipeline.isValid());
+
+            // THEN
+            CHECK(recorder.graphicsPipelineCount() == 1);
+            CHECK(recorder.computePipelineCount() == 1);
+            CHECK(recorder.skippedPipelineCount() == 0);
+        }
+
+        SUBCASE("only stores identical pipelines once")
+        {
+            // GIVEN
+            KDGpuUtils::PipelineStateRecorder recorder(&device);
+
+            // WHEN
+            const Pipelines pipelines1 = createPipelines(device);
+            const Pipelines pipelines2 = createPipelines(device);
+
+            // THEN
+            CHECK(recorder.graphicsPipelineCount() == 1);
+            CHECK(recorder.computePipelineCount() == 1);
+        }
+
+        SUBCASE("skips pipelines whose dependencies were not captured")
+        {
+            // GIVEN
+            const PipelineLayout pipelineLayout = device.createPipelineLayout();
+            KDGpuUtils::PipelineStateRecorder recorder(&device);
+            const ShaderModule computeShader = device.createShaderModule(readShaderFile(assetPath() + "/shaders/tests/compute_pipeline/empty_compute.comp.spv"));
+
+            // WHEN
+            const ComputePipeline computePipeline = device.createComputePipeline(ComputePipelineOptions{
+                    .layout = pipelineLayout.handle(),
+                    .shaderStage = { .shaderModule = computeShader.handle() },
+            });
+
+            // THEN
+            CHECK(computePipeline.isValid());
+            CHECK(recorder.computePipelineCount() == 0);
+            CHECK(recorder.skippedPipelineCount() == 1);
+        }
+
+        SUBCASE("uninstalls itself on destruction")
+        {
+            {
+                KDGpuUtils::PipelineStateRecorder recorder(&device);
+            }
+            CHECK(device.pipelineStateObserver() == nullptr);
+        }
+    }
+
+    TEST_CASE("Replaying")
+    {
+        // GIVEN
+        std::vector<uint8_t> manifest;
+        {
+            KDGpuUtils::PipelineStateRecorder recorder(&device);
+            const Pipelines pipelines = createPipelines(device);
+            manifest = recorder.manifest();
+        }
+        PipelineCache pipelineCache = device.createPipelineCache();
+        KDGpuUtils::PipelineStateReplayer replayer(&device);
+
+        SUBCASE("recreates all recorded pipelines")
+        {
+            // WHEN
+            const KDGpuUtils::PipelineReplayResult result = replayer.replay(manifest, pipelineCache);
+
+            // THEN
+            CHECK(result.manifestValid);
+            CHECK(result.graphicsPipelines == 1);
+            CHECK(result.computePipelines == 1);
+            CHECK(result.failedPipelines == 0);
+        }
+
+        SUBCASE("rejects data that is not a manifest")
+        {
+            // WHEN
+            const std::vector<uint8_t> garbage(64, 0xab);
+            const KDGpuUtils::PipelineReplayResult result = replayer.replay(garbage, pipelineCache);
+
+            // THEN
+            CHECK(!result.manifestValid);
+            CHECK(result.graphicsPipelines == 0);
+            CHECK(result.computePipelines == 0);
+        }
+
+        SUBCASE("replays what it can of a truncated manifest")
+        {
+            // WHEN
+            manifest.resize(manifest.size() - 1);
+            const KDGpuUtils::PipelineReplayResult result = replayer.replay(manifest, pipelineCache);
+
+            // THEN
+            CHECK(!result.manifestValid);
+            CHECK(result.graphicsPipelines == 1);
+            CHECK(result.computePipelines == 0);
+        }
+    }
+}
@@ -0,0 +1,407 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/pool.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <set>
+#include <string>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+struct int_tag;
+using IntPool = KDGpu::ChunkedPool<int, int_tag, 4>;
+
+static_assert(std::is_nothrow_destructible<IntPool>{});
+static_assert(std::is_nothrow_default_constructible<IntPool>{});
+static_assert(!std::is_copy_constructible<IntPool>{});
+static_assert(!std::is_copy_assignable<IntPool>{});
+static_assert(std::is_nothrow_move_constructible<IntPool>{});
+static_assert(std::is_nothrow_move_assignable<IntPool>{});
+
+TEST_CASE("Construction")
+{
+    SUBCASE("A default constructed ChunkedPool is empty")
+    {
+        IntPool pool;
+        REQUIRE(pool.capacity() == 0);
+        REQUIRE(pool.chunkCount() == 0);
+        REQUIRE(pool.size() == 0);
+    }
+
+    SUBCASE("A constructed ChunkedPool with a size is empty but has capacity rounded up to whole chunks")
+    {
+        IntPool pool(10);
+        REQUIRE(pool.capacity() == 12);
+        REQUIRE(pool.chunkCount() == 3);
+        REQUIRE(pool.size() == 0);
+    }
+
+    SUBCASE("A move constructed pool maintains the elements and resets the original")
+    {
+        IntPool pool;
+        auto handle = pool.insert(1);
+        auto handle2 = pool.insert(2);
+        auto handle3 = pool.insert(3);
+        int *value2Ptr = pool.get(handle2);
+
+        auto secondPool = std::move(pool);
+        REQUIRE(pool.capacity() == 0);
+        REQUIRE(pool.size() == 0);
+        REQUIRE(pool.get(handle) == nullptr);
+        REQUIRE(pool.get(handle2) == nullptr);
+        REQUIRE(pool.get(handle3) == nullptr);
+
+        REQUIRE(secondPool.size() == 3);
+        REQUIRE(*secondPool.get(handle) == 1);
+        REQUIRE(*secondPool.get(handle2) == 2);
+        REQUIRE(*secondPool.get(handle3) == 3);
+        REQUIRE_MESSAGE(secondPool.get(handle2) == value2Ptr, "moving the pool does not move the chunks");
+    }
+}
+
+TEST_CASE("Insertion and removal")
+{
+    SUBCASE("Values can be inserted and retrieved")
+    {
+        IntPool pool;
+        auto handle = pool.insert(5);
+        REQUIRE(handle.index() == 0);
+        REQUIRE(handle.generation() == 1);
+        REQUIRE(handle.isValid() == true);
+
+        auto handle2 = pool.insert(7);
+        REQUIRE(handle2.index() == 1);
+        REQUIRE(handle2.generation() == 1);
+        REQUIRE(handle2.isValid() == true);
+
+        REQUIRE(pool.capacity() == 4);
+        REQUIRE(pool.size() == 2);
+        REQUIRE(*pool.get(handle) == 5);
+        REQUIRE(*pool.get(handle2) == 7);
+    }
+
+    SUBCASE("Deletion removes the value")
+    {
+        IntPool pool;
+
+        auto handle = pool.insert(5);
+        REQUIRE(pool.size() == 1);
+
+        pool.remove(handle);
+        REQUIRE(pool.get(handle) == nullptr);
+        REQUIRE_MESSAGE(pool.capacity() == 4, "capacity does not get smaller during deletion");
+        REQUIRE_MESSAGE(pool.size() == 0, "size does get smaller during deletion");
+    }
+
+    SUBCASE("Inserting after a removal reuses the empty index")
+    {
+        IntPool pool;
+
+        pool.insert(5);
+        auto handle2 = pool.insert(7);
+        pool.insert(9);
+
+        pool.remove(handle2);
+        auto replacementHandle2 = pool.insert(123);
+
+        REQUIRE(handle2.index() == replacementHandle2.index());
+        REQUIRE(handle2.generation() < replacementHandle2.generation());
+        REQUIRE(pool.get(handle2) == nullptr);
+        REQUIRE(*pool.get(replacementHandle2) == 123);
+    }
+
+    SUBCASE("Clear invalidates all indices, but leaves capacity unchanged")
+    {
+        IntPool pool;
+
+        auto handle = pool.insert(5);
+        auto handle2 = pool.insert(7);
+        auto handle3 = pool.insert(9);
+        auto capacity = pool.capacity();
+
+        pool.clear();
+        REQUIRE(pool.size() == 0);
+        REQUIRE(pool.capacity() == capacity);
+        REQUIRE(pool.get(handle) == nullptr);
+        REQUIRE(pool.get(handle2) == nullptr);
+        REQUIRE(pool.get(handle3) == nullptr);
+    }
+
+    SUBCASE("After clearing, spots in the pool are reused with different generations")
+    {
+        IntPool pool;
+        std::set<uint32_t> indices;
+        std::set<uint32_t> generations;
+
+        for (int i = 0; i < 6; ++i) {
+            const auto handle = pool.insert(i);
+            indices.emplace(handle.index());
+            generations.emplace(handle.generation());
+        }
+
+        pool.clear();
+
+        std::set<uint32_t> newIndices;
+        std::set<uint32_t> newGenerations;
+        for (int i = 0; i < 6; ++i) {
+            const auto handle = pool.insert(i);
+            newIndices.emplace(handle.index());
+            newGenerations.emplace(handle.generation());
+        }
+
+        REQUIRE(pool.chunkCount() == 2);
+        REQUIRE(indices == newIndices);
+        for (const auto &generation : generations) {
+            REQUIRE(newGenerations.find(generation) == newGenerations.end());
+        }
+    }
+}
+
+TEST_CASE("Pointer stability")
+{
+    SUBCASE("Growing the pool never moves existing entries")
+    {
+        // GIVEN
+        IntPool pool;
+        std::vector<KDGpu::Handle<int_tag>> handles;
+        std::vector<int *> pointers;
+        for (int i = 0; i < 3; ++i) {
+            handles.emplace_back(pool.insert(i));
+            pointers.emplace_back(pool.get(handles.back()));
+        }
+
+        // WHEN
+        for (int i = 0; i < 1000; ++i)
+            pool.insert(i);
+
+        // THEN
+        REQUIRE(pool.chunkCount() == 251);
+        for (size_t i = 0; i < handles.size(); ++i) {
+            REQUIRE(pool.get(handles[i]) == pointers[i]);
+            REQUIRE(*pointers[i] == static_cast<int>(i));
+        }
+    }
+
+    SUBCASE("Removing other entries does not move remaining entries")
+    {
+        // GIVEN
+        IntPool pool;
+        std::vector<KDGpu::Handle<int_tag>> handles;
+        for (int i = 0; i < 16; ++i)
+            handles.emplace_back(pool.insert(i));
+        int *lastPtr = pool.get(handles.back());
+
+        // WHEN
+        for (size_t i = 0; i < handles.size() - 1; ++i)
+            pool.remove(handles[i]);
+
+        // THEN
+        REQUIRE(pool.size() == 1);
+        REQUIRE(pool.get(handles.back()) == lastPtr);
+        REQUIRE(*lastPtr == 15);
+    }
+}
+
+TEST_CASE("handleForIndex")
+{
+    SUBCASE("An empty pool never returns a valid handle")
+    {
+        IntPool pool;
+
+        for (uint32_t i = 0; i < 10; ++i) {
+            REQUIRE_FALSE(pool.handleForIndex(i).isValid());
+        }
+    }
+
+    SUBCASE("A full pool returns a valid handle for every index, but not more")
+    {
+        IntPool pool;
+
+        for (auto i = 0; i < 10; ++i) {
+            pool.emplace(std::move(i));
+        }
+
+        for (uint32_t i = 0; i < pool.size(); ++i) {
+            REQUIRE(pool.handleForIndex(i).isValid());
+            REQUIRE_FALSE(pool.handleForIndex(i + pool.size()).isValid());
+        }
+    }
+}
+
+class MyType
+{
+public:
+    explicit MyType(uint32_t a, uint32_t b) noexcept
+        : m_a(a)
+        , m_b(b)
+    {
+        ++ms_liveCount;
+    }
+
+    MyType(const MyType &) = delete;
+    MyType &operator=(const MyType &) = delete;
+
+    ~MyType()
+    {
+        m_a = 0;
+        m_b = 0;
+        --ms_liveCount;
+    }
+
+    uint32_t a() const noexcept { return m_a; }
+    uint32_t b() const noexcept { return m_b; }
+
+    static int ms_liveCount;
+
+private:
+    uint32_t m_a;
+    uint32_t m_b;
+};
+
+int MyType::ms_liveCount = 0;
+
+struct MyType_tag;
+using MyTypePool = KDGpu::ChunkedPool<MyType, MyType_tag, 4>;
+
+TEST_CASE("Non-trivial types")
+{
+    SUBCASE("Non-copyable, non-default constructible types can be used")
+    {
+        std::unique_ptr<MyTypePool> pool = std::make_unique<MyTypePool>();
+
+        auto handle = pool->emplace(123, 69);
+        REQUIRE(pool->get(handle)->a() == 123);
+        REQUIRE(pool->get(handle)->b() == 69);
+        REQUIRE(MyType::ms_liveCount == 1);
+    }
+
+    SUBCASE("Dtor is called on removal")
+    {
+        MyTypePool pool;
+
+        auto handle = pool.emplace(1, 2);
+        pool.emplace(3, 4);
+        REQUIRE(MyType::ms_liveCount == 2);
+
+        pool.remove(handle);
+        REQUIRE(MyType::ms_liveCount == 1);
+
+        pool.remove(handle);
+        REQUIRE_MESSAGE(MyType::ms_liveCount == 1, "removing a stale handle is a no-op");
+    }
+
+    SUBCASE("Remaining entries are destroyed with the pool")
+    {
+        {
+            MyTypePool pool;
+            for (uint32_t i = 0; i < 10; ++i)
+                pool.emplace(i, i);
+            pool.remove(pool.handleForIndex(3));
+            REQUIRE(MyType::ms_liveCount == 9);
+        }
+        REQUIRE(MyType::ms_liveCount == 0);
+    }
+
+    SUBCASE("Move assignment destroys the previous content")
+    {
+        MyTypePool pool;
+        pool.emplace(1, 1);
+        pool.emplace(2, 2);
+
+        MyTypePool otherPool;
+        auto handle = otherPool.emplace(3, 3);
+        REQUIRE(MyType::ms_liveCount == 3);
+
+        pool = std::move(otherPool);
+        REQUIRE(MyType::ms_liveCount == 1);
+        REQUIRE(pool.get(handle)->a() == 3);
+    }
+
+    REQUIRE(MyType::ms_liveCount == 0);
+}
+
+namespace {
+
+// Roughly the footprint of a VulkanBuffer / VulkanTexture
+struct Resource {
+    explicit Resource(uint64_t v)
+        : payload{ v }
+        , name(std::to_string(v))
+    {
+    }
+
+    std::array<uint64_t, 12> payload;
+    std::string name;
+};
+struct Resource_tag;
+
+template<typename P>
+void runBenchmark(const char *label, uint32_t initialCapacity, uint32_t count)
+{
+    using Clock = std::chrono::steady_clock;
+    std::vector<KDGpu::Handle<Resource_tag>> handles;
+    handles.reserve(count);
+
+    P pool(initialCapacity);
+
+    // Track the slowest single emplace, this is where regrowing the storage shows up as a spike
+    Clock::duration worstEmplace{ 0 };
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto before = Clock::now();
+        handles.emplace_back(pool.emplace(i));
+        worstEmplace = std::max(worstEmplace, Clock::now() - before);
+    }
+    const auto inserted = Clock::now();
+
+    uint64_t sum = 0;
+    for (int pass = 0; pass < 8; ++pass) {
+        for (const auto &handle : handles)
+            sum += pool.get(handle)->payload[0];
+    }
+    const auto looked = Clock::now();
+
+    // Churn: remove every other entry and refill
+    for (uint32_t i = 0; i < count; i += 2)
+        pool.remove(handles[i]);
+    for (uint32_t i = 0; i < count; i += 2)
+        handles[i] = pool.emplace(i);
+    const auto churned = Clock::now();
+
+    using ms = std::chrono::duration<double, std::milli>;
+    MESSAGE(label << ": emplace " << ms(inserted - start).count() << "ms"
+                  << " (worst " << ms(worstEmplace).count() << "ms)"
+                  << ", lookup " << ms(looked - inserted).count() << "ms"
+                  << ", churn " << ms(churned - looked).count() << "ms"
+                  << " (checksum " << sum << ")");
+    REQUIRE(pool.size() == count);
+}
+
+} // namespace
+
+// Not run by default, use --no-skip to get the numbers
+TEST_CASE("Benchmark" * doctest::skip())
+{
+    constexpr uint32_t count = 200000;
+
+    SUBCASE("Vector storage")
+    {
+        runBenchmark<KDGpu::Pool<Resource, Resource_tag>>("Pool", 128, count);
+    }
+
+    SUBCASE("Chunked storage")
+    {
+        runBenchmark<KDGpu::ChunkedPool<Resource, Resource_tag>>("ChunkedPool", 128, count);
+    }
+}
@@ -0,0 +1,199 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/concurrent_pool.h>
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+struct int_tag;
+using IntPool = KDGpu::ConcurrentPool<int, int_tag, 4>;
+
+static_assert(std::is_nothrow_destructible<IntPool>{});
+static_assert(!std::is_copy_constructible<IntPool>{});
+static_assert(!std::is_move_constructible<IntPool>{});
+
+TEST_CASE("Construction")
+{
+    SUBCASE("A default constructed ConcurrentPool is empty")
+    {
+        IntPool pool;
+        REQUIRE(pool.capacity() == 0);
+        REQUIRE(pool.size() == 0);
+    }
+
+    SUBCASE("A constructed ConcurrentPool with a size is empty but has capacity rounded up to whole chunks")
+    {
+        IntPool pool(10);
+        REQUIRE(pool.capacity() == 12);
+        REQUIRE(pool.size() == 0);
+    }
+}
+
+TEST_CASE("Insertion and removal")
+{
+    SUBCASE("Values can be inserted and retrieved")
+    {
+        IntPool pool;
+        auto handle = pool.insert(5);
+        auto handle2 = pool.insert(7);
+
+        REQUIRE(handle.isValid());
+        REQUIRE(handle.generation() == 1);
+        REQUIRE(handle2.isValid());
+        REQUIRE(pool.size() == 2);
+        REQUIRE(*pool.get(handle) == 5);
+        REQUIRE(*pool.get(handle2) == 7);
+    }
+
+    SUBCASE("Inserting after a removal reuses the empty index with a new generation")
+    {
+        IntPool pool;
+
+        pool.insert(5);
+        auto handle2 = pool.insert(7);
+        int *value2Ptr = pool.get(handle2);
+
+        pool.remove(handle2);
+        REQUIRE(pool.get(handle2) == nullptr);
+        REQUIRE(pool.size() == 1);
+
+        auto replacementHandle2 = pool.insert(123);
+        REQUIRE(handle2.index() == replacementHandle2.index());
+        REQUIRE(handle2.generation() < replacementHandle2.generation());
+        REQUIRE(pool.get(handle2) == nullptr);
+        REQUIRE(pool.get(replacementHandle2) == value2Ptr);
+        REQUIRE(*pool.get(replacementHandle2) == 123);
+    }
+
+    SUBCASE("Removing a handle twice is a no-op")
+    {
+        IntPool pool;
+
+        auto handle = pool.insert(5);
+        pool.remove(handle);
+        auto handle2 = pool.insert(7);
+        pool.remove(handle);
+
+        REQUIRE(pool.size() == 1);
+        REQUIRE(*pool.get(handle2) == 7);
+    }
+
+    SUBCASE("Clear invalidates all indices, but leaves capacity unchanged")
+    {
+        IntPool pool;
+
+        auto handle = pool.insert(5);
+        auto handle2 = pool.insert(7);
+        auto handle3 = pool.insert(9);
+        auto capacity = pool.capacity();
+
+        pool.clear();
+        REQUIRE(pool.size() == 0);
+        REQUIRE(pool.capacity() == capacity);
+        REQUIRE(pool.get(handle) == nullptr);
+        REQUIRE(pool.get(handle2) == nullptr);
+        REQUIRE(pool.get(handle3) == nullptr);
+        REQUIRE_FALSE(pool.handleForIndex(0).isValid());
+    }
+
+    SUBCASE("Inserting into a full pool fails with an invalid handle")
+    {
+        KDGpu::ConcurrentPool<int, int_tag, 4, 2> pool;
+        for (int i = 0; i < 8; ++i)
+            REQUIRE(pool.insert(i).isValid());
+
+        auto overflow = pool.insert(8);
+        REQUIRE_FALSE(overflow.isValid());
+        REQUIRE(pool.size() == 8);
+        REQUIRE(pool.capacity() == 8);
+
+        // Removing an object makes room again
+        pool.remove(pool.handleForIndex(3));
+        auto handle = pool.insert(9);
+        REQUIRE(handle.isValid());
+        REQUIRE(*pool.get(handle) == 9);
+    }
+}
+
+TEST_CASE("Concurrent access")
+{
+    SUBCASE("Several threads can emplace, look up and remove at the same time")
+    {
+        // GIVEN
+        using StringPool = KDGpu::ConcurrentPool<std::string, int_tag, 16>;
+        StringPool pool;
+        constexpr int threadCount = 8;
+        constexpr int iterationCount = 5000;
+        std::atomic<int> failures{ 0 };
+        std::vector<std::thread> threads;
+
+        // WHEN
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                std::vector<KDGpu::Handle<int_tag>> handles;
+                for (int i = 0; i < iterationCount; ++i) {
+                    const std::string value = std::to_string(t * iterationCount + i);
+                    const auto handle = pool.emplace(value);
+                    handles.push_back(handle);
+                    if (pool.get(handle) == nullptr || *pool.get(handle) != value)
+                        ++failures;
+
+                    if (handles.size() == 32) {
+                        for (const auto &h : handles) {
+                            pool.remove(h);
+                            if (pool.get(h) != nullptr)
+                                ++failures;
+                        }
+                        handles.clear();
+                    }
+                }
+                for (const auto &h : handles)
+                    pool.remove(h);
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        // THEN
+        REQUIRE(failures == 0);
+        REQUIRE(pool.size() == 0);
+        REQUIRE_MESSAGE(pool.capacity() < threadCount * iterationCount, "released slots get reused");
+    }
+
+    SUBCASE("Pointers remain stable while other threads grow the pool")
+    {
+        // GIVEN
+        IntPool pool;
+        const auto handle = pool.insert(42);
+        int *valuePtr = pool.get(handle);
+
+        // WHEN
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&pool] {
+                for (int i = 0; i < 1000; ++i)
+                    pool.insert(i);
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        // THEN
+        REQUIRE(pool.size() == 4001);
+        REQUIRE(pool.get(handle) == valuePtr);
+        REQUIRE(*valuePtr == 42);
+    }
+}
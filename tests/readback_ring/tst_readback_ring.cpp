@@ -0,0 +1,178 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/readback_ring.h>
+
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/texture_options.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <algorithm>
+#include <cstring>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+using namespace KDGpuUtils;
+
+TEST_SUITE("ReadbackRing")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "ReadbackRing",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *discreteGPUAdapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = discreteGPUAdapter->createDevice();
+    Queue queue = device.queues()[0];
+
+    TEST_CASE("Buffer readback")
+    {
+        // GIVEN
+        const std::vector<uint32_t> data = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        const DeviceSize byteSize = data.size() * sizeof(uint32_t);
+        const BufferOptions sourceOptions{
+            .size = byteSize,
+            .usage = BufferUsageFlagBits::TransferSrcBit,
+            .memoryUsage = MemoryUsage::CpuToGpu,
+        };
+        Buffer source = device.createBuffer(sourceOptions, data.data());
+        ReadbackRing ring(&device, 2, 256);
+
+        SUBCASE("Data is delivered once the submission completed")
+        {
+            // GIVEN
+            std::vector<uint32_t> readBack;
+            Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+            CommandRecorder recorder = device.createCommandRecorder();
+
+            // WHEN
+            const std::optional<uint64_t> id = ring.readBuffer(recorder, source, 0, byteSize, [&](uint64_t, std::span<const uint8_t> bytes) {
+                readBack.resize(bytes.size() / sizeof(uint32_t));
+                std::memcpy(readBack.data(), bytes.data(), bytes.size());
+            });
+            CommandBuffer commandBuffer = recorder.finish();
+            queue.submit(SubmitOptions{ .commandBuffers = { commandBuffer }, .signalFence = fence });
+            ring.submitted(fence);
+
+            // THEN
+            REQUIRE(id.has_value());
+            CHECK(ring.inFlightCount() == 1);
+
+            // WHEN
+            fence.wait();
+            const size_t delivered = ring.poll();
+
+            // THEN
+            CHECK(delivered == 1);
+            CHECK(readBack == data);
+            CHECK(ring.inFlightCount() == 0);
+        }
+
+        SUBCASE("Readbacks fail while every slot is in flight")
+        {
+            // GIVEN
+            Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+            CommandRecorder recorder = device.createCommandRecorder();
+
+            // WHEN
+            const std::optional<uint64_t> first = ring.readBuffer(recorder, source, 0, byteSize);
+            const std::optional<uint64_t> second = ring.readBuffer(recorder, source, 4, 4);
+            const std::optional<uint64_t> third = ring.readBuffer(recorder, source, 0, byteSize);
+
+            // THEN
+            CHECK(first.has_value());
+            CHECK(second.has_value());
+            CHECK(!third.has_value());
+            CHECK(!ring.readBuffer(recorder, source, 0, 512).has_value());
+
+            // WHEN
+            CommandBuffer commandBuffer = recorder.finish();
+            queue.submit(SubmitOptions{ .commandBuffers = { commandBuffer }, .signalFence = fence });
+            ring.submitted(fence);
+            fence.wait();
+
+            std::vector<uint64_t> ids;
+            ring.poll([&](uint64_t id, std::span<const uint8_t> bytes) {
+                ids.push_back(id);
+                if (id == *second)
+                    CHECK(*reinterpret_cast<const uint32_t *>(bytes.data()) == 2);
+            });
+
+            // THEN -> Delivered in order and recycled
+            CHECK(ids == std::vector<uint64_t>{ *first, *second });
+            CHECK(ring.inFlightCount() == 0);
+            CommandRecorder nextRecorder = device.createCommandRecorder();
+            CHECK(ring.readBuffer(nextRecorder, source, 0, byteSize).has_value());
+        }
+
+        SUBCASE("Nothing is delivered before submission")
+        {
+            // GIVEN
+            CommandRecorder recorder = device.createCommandRecorder();
+            REQUIRE(ring.readBuffer(recorder, source, 0, byteSize).has_value());
+
+            // WHEN
+            const size_t delivered = ring.poll();
+
+            // THEN
+            CHECK(delivered == 0);
+            CHECK(ring.inFlightCount() == 1);
+        }
+    }
+
+    TEST_CASE("Texture readback")
+    {
+        // GIVEN
+        const std::vector<uint32_t> texels(8 * 8, 0xff00ff00);
+        Texture texture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 8, 8, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::TransferSrcBit | TextureUsageFlagBits::TransferDstBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        queue.waitForUploadTextureData(WaitForTextureUploadOptions{
+                .destinationTexture = texture,
+                .data = texels.data(),
+                .byteSize = texels.size() * sizeof(uint32_t),
+                .oldLayout = TextureLayout::Undefined,
+                .newLayout = TextureLayout::TransferSrcOptimal,
+                .regions = { { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit }, .textureExtent = { 8, 8, 1 } } },
+        });
+        ReadbackRing ring(&device, 3, 1024);
+        Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+        CommandRecorder recorder = device.createCommandRecorder();
+        bool matches = false;
+
+        // WHEN
+        const TextureReadbackOptions readbackOptions{
+            .texture = texture,
+            .region = { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit }, .textureExtent = { 8, 8, 1 } },
+            .byteSize = texels.size() * sizeof(uint32_t),
+        };
+        const std::optional<uint64_t> id = ring.readTexture(recorder, readbackOptions, [&](uint64_t, std::span<const uint8_t> bytes) {
+            matches = std::equal(bytes.begin(), bytes.end(), reinterpret_cast<const uint8_t *>(texels.data()));
+        });
+        CommandBuffer commandBuffer = recorder.finish();
+        queue.submit(SubmitOptions{ .commandBuffers = { commandBuffer }, .signalFence = fence });
+        ring.submitted(fence);
+        fence.wait();
+
+        // THEN
+        REQUIRE(id.has_value());
+        CHECK(ring.poll() == 1);
+        CHECK(matches);
+    }
+}
@@ -21,6 +21,7 @@
 #include <KDGpu/texture_options.h>
 #include <KDGpu/texture_view.h>
 #include <KDGpu/device_options.h>
+#include <KDGpu/vulkan/vulkan_device.h>
 #include <KDGpu/vulkan/vulkan_graphics_api.h>
 #include <KDGpu/buffer.h>
 #include <KDGpu/buffer_options.h>
@@ -34,6 +35,8 @@
 #include <KDUtils/file.h>
 #include <KDUtils/dir.h>
 
+#include <chrono>
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
 
@@ -1175,4 +1178,254 @@ TEST_SUITE("RenderPassCommandRecorder")
         CHECK(commandBuffer.isValid());
     }
 #endif
+
+    TEST_CASE("RenderPassCommandRecorder - Framebuffer invalidation")
+    {
+        // GIVEN
+        Device device = discreteGPUAdapter->createDevice();
+        const VulkanDevice *vulkanDevice = api->resourceManager()->getDevice(device.handle());
+
+        const Texture colorTexture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 64, 64, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::ColorAttachmentBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        const Texture depthTexture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+#if defined(KD_PLATFORM_MACOS)
+                .format = Format::D32_SFLOAT_S8_UINT,
+#else
+                .format = Format::D24_UNORM_S8_UINT,
+#endif
+                .extent = { 64, 64, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::DepthStencilAttachmentBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        TextureView depthTextureView = depthTexture.createView();
+
+        // Every view of the color texture gets its own framebuffer, all of them share the depth view
+        std::vector<TextureView> colorTextureViews;
+        for (uint32_t i = 0; i < 3; ++i)
+            colorTextureViews.push_back(colorTexture.createView());
+
+        {
+            CommandRecorder commandRecorder = device.createCommandRecorder();
+            for (const TextureView &colorTextureView : colorTextureViews) {
+                RenderPassCommandRecorder renderPass = commandRecorder.beginRenderPass(RenderPassCommandRecorderOptions{
+                        .colorAttachments = { { .view = colorTextureView } },
+                        .depthStencilAttachment = { .view = depthTextureView },
+                });
+                renderPass.end();
+            }
+            commandRecorder.finish();
+        }
+
+        // THEN
+        REQUIRE(vulkanDevice->framebuffers.size() == 3);
+        CHECK(vulkanDevice->framebufferKeysByAttachment.size() == 6);
+
+        // WHEN
+        colorTextureViews[1] = {};
+
+        // THEN
+        CHECK(vulkanDevice->framebuffers.size() == 2);
+        CHECK(vulkanDevice->framebufferKeysByAttachment.size() == 4);
+        CHECK(vulkanDevice->framebufferKeysByAttachment.count(depthTextureView.handle()) == 2);
+
+        // WHEN
+        depthTextureView = {};
+
+        // THEN
+        CHECK(vulkanDevice->framebuffers.empty());
+        CHECK(vulkanDevice->framebufferKeysByAttachment.empty());
+    }
+
+    TEST_CASE("RenderPassCommandRecorder - Framebuffer cache eviction")
+    {
+        // GIVEN
+        Device device = discreteGPUAdapter->createDevice(DeviceOptions{
+                .renderTargetCache = { .maxRenderPasses = 1, .maxFramebuffers = 2 },
+        });
+        const VulkanDevice *vulkanDevice = api->resourceManager()->getDevice(device.handle());
+
+        const Texture colorTexture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 64, 64, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::ColorAttachmentBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        std::vector<TextureView> colorTextureViews;
+        for (uint32_t i = 0; i < 3; ++i)
+            colorTextureViews.push_back(colorTexture.createView());
+
+        auto record = [&](const TextureView &colorTextureView) {
+            CommandRecorder commandRecorder = device.createCommandRecorder();
+            RenderPassCommandRecorder renderPass = commandRecorder.beginRenderPass(RenderPassCommandRecorderOptions{
+                    .colorAttachments = { { .view = colorTextureView } },
+            });
+            renderPass.end();
+            return commandRecorder.finish();
+        };
+
+        SUBCASE("Least recently used framebuffers are evicted")
+        {
+            // WHEN
+            for (const TextureView &colorTextureView : colorTextureViews)
+                record(colorTextureView);
+            record(colorTextureViews[2]);
+
+            // THEN
+            CHECK(vulkanDevice->framebuffers.size() == 2);
+            CHECK(vulkanDevice->framebufferKeysByAttachment.size() == 2);
+            CHECK(vulkanDevice->framebufferKeysByAttachment.count(colorTextureViews[0].handle()) == 0);
+
+            const RenderTargetCacheStats framebufferStats = device.framebufferCacheStats();
+            CHECK(framebufferStats.hits == 1);
+            CHECK(framebufferStats.misses == 3);
+            CHECK(framebufferStats.evictions == 1);
+            CHECK(framebufferStats.liveObjects == 2);
+
+            const RenderTargetCacheStats renderPassStats = device.renderPassCacheStats();
+            CHECK(renderPassStats.hits == 3);
+            CHECK(renderPassStats.misses == 1);
+            CHECK(renderPassStats.evictions == 0);
+            CHECK(renderPassStats.liveObjects == 1);
+        }
+
+        SUBCASE("Evicted framebuffers live as long as command buffers using them")
+        {
+            // WHEN
+            CommandBuffer inFlight = record(colorTextureViews[0]);
+            record(colorTextureViews[1]);
+            record(colorTextureViews[2]);
+
+            // THEN
+            CHECK(vulkanDevice->framebuffers.size() == 2);
+            CHECK(device.framebufferCacheStats().evictions == 1);
+            CHECK(device.framebufferCacheStats().liveObjects == 3);
+
+            // WHEN
+            inFlight = {};
+
+            // THEN
+            CHECK(device.framebufferCacheStats().liveObjects == 2);
+        }
+    }
+
+    TEST_CASE("RenderPassCommandRecorder - Render pass cache eviction")
+    {
+        // GIVEN
+        Device device = discreteGPUAdapter->createDevice(DeviceOptions{
+                .renderTargetCache = { .maxRenderPasses = 1 },
+        });
+        const VulkanDevice *vulkanDevice = api->resourceManager()->getDevice(device.handle());
+
+        // Each format needs a render pass of its own
+        std::vector<Texture> colorTextures;
+        std::vector<TextureView> colorTextureViews;
+        for (const Format format : { Format::R8G8B8A8_UNORM, Format::B8G8R8A8_UNORM }) {
+            colorTextures.push_back(device.createTexture(TextureOptions{
+                    .type = TextureType::TextureType2D,
+                    .format = format,
+                    .extent = { 64, 64, 1 },
+                    .mipLevels = 1,
+                    .usage = TextureUsageFlagBits::ColorAttachmentBit,
+                    .memoryUsage = MemoryUsage::GpuOnly,
+            }));
+            colorTextureViews.push_back(colorTextures.back().createView());
+        }
+
+        auto record = [&](const TextureView &colorTextureView) {
+            CommandRecorder commandRecorder = device.createCommandRecorder();
+            RenderPassCommandRecorder renderPass = commandRecorder.beginRenderPass(RenderPassCommandRecorderOptions{
+                    .colorAttachments = { { .view = colorTextureView } },
+            });
+            renderPass.end();
+            return commandRecorder.finish();
+        };
+
+        SUBCASE("Framebuffers of evicted render passes are evicted with them")
+        {
+            // WHEN
+            for (uint32_t i = 0; i < 4; ++i)
+                record(colorTextureViews[i % 2]);
+
+            // THEN
+            CHECK(device.renderPassCacheStats().evictions == 3);
+            CHECK(device.renderPassCacheStats().liveObjects == 1);
+            CHECK(device.framebufferCacheStats().evictions == 3);
+            CHECK(device.framebufferCacheStats().liveObjects == 1);
+            CHECK(vulkanDevice->framebufferKeysByRenderPass.size() == 1);
+            CHECK(vulkanDevice->framebufferKeysByAttachment.size() == 1);
+        }
+
+        SUBCASE("Framebuffers in use outlive the eviction of their render pass")
+        {
+            // WHEN
+            CommandBuffer inFlight = record(colorTextureViews[0]);
+            record(colorTextureViews[1]);
+
+            // THEN
+            CHECK(vulkanDevice->framebuffers.size() == 1);
+            CHECK(device.framebufferCacheStats().liveObjects == 2);
+
+            // WHEN
+            inFlight = {};
+
+            // THEN
+            CHECK(device.framebufferCacheStats().liveObjects == 1);
+        }
+    }
+
+    // Deleting a texture view only visits the framebuffers it is attached to.
+    // Run with --no-skip to get the numbers.
+    TEST_CASE("RenderPassCommandRecorder - Framebuffer invalidation benchmark" * doctest::skip())
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr uint32_t viewCount = 4000;
+
+        // GIVEN
+        Device device = discreteGPUAdapter->createDevice();
+        const Texture colorTexture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 64, 64, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::ColorAttachmentBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+
+        std::vector<TextureView> colorTextureViews;
+        colorTextureViews.reserve(viewCount);
+        for (uint32_t i = 0; i < viewCount; ++i)
+            colorTextureViews.push_back(colorTexture.createView());
+
+        {
+            CommandRecorder commandRecorder = device.createCommandRecorder();
+            for (const TextureView &colorTextureView : colorTextureViews) {
+                RenderPassCommandRecorder renderPass = commandRecorder.beginRenderPass(RenderPassCommandRecorderOptions{
+                        .colorAttachments = { { .view = colorTextureView } },
+                });
+                renderPass.end();
+            }
+            commandRecorder.finish();
+        }
+        REQUIRE(api->resourceManager()->getDevice(device.handle())->framebuffers.size() == viewCount);
+
+        // WHEN
+        const auto start = Clock::now();
+        colorTextureViews.clear();
+        const auto deleted = Clock::now();
+
+        // THEN
+        using ms = std::chrono::duration<double, std::milli>;
+        MESSAGE("Deleted " << viewCount << " views and their framebuffers in " << ms(deleted - start).count() << "ms");
+        CHECK(api->resourceManager()->getDevice(device.handle())->framebuffers.empty());
+    }
 }
@@ -14,6 +14,8 @@
 #include <KDGpu/instance.h>
 #include <KDGpu/vulkan/vulkan_graphics_api.h>
 
+#include <vector>
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
 
@@ -145,11 +147,75 @@ TEST_SUITE("Sampler")
             Sampler a = device.createSampler(samplerOptions);
             Sampler b = device.createSampler(samplerOptions);
 
+            // THEN
+            CHECK(a == b);
+        }
+
+        SUBCASE("Compare device created Samplers with different options")
+        {
+            // WHEN
+            Sampler a = device.createSampler(SamplerOptions{});
+            Sampler b = device.createSampler(SamplerOptions{ .magFilter = FilterMode::Linear });
+
             // THEN
             CHECK(a != b);
         }
     }
 
+    TEST_CASE("Deduplication")
+    {
+        Device device = discreteGPUAdapter->createDevice();
+
+        // GIVEN
+        const SamplerOptions linearOptions{
+            .magFilter = FilterMode::Linear,
+            .minFilter = FilterMode::Linear,
+        };
+        const SamplerOptions nearestOptions{};
+
+        SUBCASE("Identical options share a single Vulkan sampler")
+        {
+            {
+                // WHEN
+                std::vector<Sampler> samplers;
+                for (uint32_t i = 0; i < 8; ++i)
+                    samplers.push_back(device.createSampler(i % 2 ? linearOptions : nearestOptions));
+
+                // THEN
+                // Every VkSampler created by the device goes through the cache
+                CHECK(device.samplerDeduplicationStats().cachedObjects == 2);
+                CHECK(device.samplerDeduplicationStats().misses == 2);
+                CHECK(device.samplerDeduplicationStats().hits == 6);
+                CHECK(samplers[0] == samplers[2]);
+                CHECK(samplers[1] == samplers[3]);
+                CHECK(samplers[0] != samplers[1]);
+
+                // WHEN
+                const Handle<Sampler_t> linearHandle = samplers[1].handle();
+                samplers.erase(samplers.begin() + 1);
+
+                // THEN
+                CHECK(api->resourceManager()->getSampler(linearHandle) != nullptr);
+                CHECK(device.samplerDeduplicationStats().cachedObjects == 2);
+            }
+
+            // THEN
+            CHECK(device.samplerDeduplicationStats().cachedObjects == 0);
+        }
+
+        SUBCASE("Labels are not part of the description")
+        {
+            // WHEN
+            Sampler a = device.createSampler(SamplerOptions{ .label = "A" });
+            Sampler b = device.createSampler(SamplerOptions{ .label = "B" });
+
+            // THEN
+            CHECK(a == b);
+            CHECK(device.samplerDeduplicationStats().cachedObjects == 1);
+            CHECK(device.samplerDeduplicationStats().hits == 1);
+        }
+    }
+
 #if VK_KHR_sampler_ycbcr_conversion
     TEST_CASE("YUV Sampling" * doctest::skip(!discreteGPUAdapter->features().samplerYCbCrConversion))
     {
@@ -0,0 +1,106 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/pool.h>
+#include <KDGpu/shader_module_deduplication_cache.h>
+
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+TEST_CASE("ShaderModuleDeduplicationCache")
+{
+    // GIVEN
+    // The pool only serves as a source of valid handles here
+    Pool<int, ShaderModule_t> shaderModules{ 4 };
+    const std::vector<uint32_t> code{ 0x07230203, 0x00010000, 0, 8, 0 };
+
+    ShaderModuleDeduplicationCache cache;
+    uint32_t createCount = 0;
+    auto create = [&] {
+        ++createCount;
+        return shaderModules.emplace(int(createCount));
+    };
+
+    SUBCASE("Identical code shares a shader module")
+    {
+        // WHEN
+        const auto handle1 = cache.getOrCreate(code, create);
+        const auto handle2 = cache.getOrCreate(std::vector<uint32_t>(code), create);
+
+        // THEN
+        CHECK(handle1.isValid());
+        CHECK(handle1 == handle2);
+        CHECK(createCount == 1);
+        CHECK(cache.stats().hits == 1);
+        CHECK(cache.stats().misses == 1);
+        CHECK(cache.stats().cachedShaderModules == 1);
+    }
+
+    SUBCASE("Different code creates different shader modules")
+    {
+        // GIVEN
+        std::vector<uint32_t> otherCode = code;
+        otherCode.back() = 1;
+
+        // WHEN
+        const auto handle1 = cache.getOrCreate(code, create);
+        const auto handle2 = cache.getOrCreate(otherCode, create);
+
+        // THEN
+        CHECK(ShaderModuleDeduplicationCache::hashCode(code) != ShaderModuleDeduplicationCache::hashCode(otherCode));
+        CHECK(handle1 != handle2);
+        CHECK(createCount == 2);
+        CHECK(cache.stats().hits == 0);
+        CHECK(cache.stats().misses == 2);
+        CHECK(cache.stats().cachedShaderModules == 2);
+    }
+
+    SUBCASE("Shader modules are released with the last reference")
+    {
+        // GIVEN
+        const auto handle = cache.getOrCreate(code, create);
+        REQUIRE(cache.getOrCreate(code, create) == handle);
+
+        // THEN
+        CHECK(!cache.release(handle));
+        CHECK(cache.stats().cachedShaderModules == 1);
+        CHECK(cache.release(handle));
+        CHECK(cache.stats().cachedShaderModules == 0);
+
+        // WHEN
+        cache.getOrCreate(code, create);
+
+        // THEN
+        CHECK(createCount == 2);
+    }
+
+    SUBCASE("Shader modules that were never cached can be released")
+    {
+        // WHEN
+        const auto handle = create();
+
+        // THEN
+        CHECK(cache.release(handle));
+    }
+
+    SUBCASE("Failed creations are not cached")
+    {
+        // WHEN
+        const auto handle = cache.getOrCreate(code, [] { return Handle<ShaderModule_t>(); });
+
+        // THEN
+        CHECK(!handle.isValid());
+        CHECK(cache.stats().cachedShaderModules == 0);
+    }
+}
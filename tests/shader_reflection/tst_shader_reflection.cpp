@@ -0,0 +1,427 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/pipeline_layout_builder.h>
+#include <KDGpuUtils/shader_reflection.h>
+
+#include <KDGpu/bind_group_layout_options.h>
+#include <KDGpu/device.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <KDUtils/file.h>
+#include <KDUtils/dir.h>
+
+#include <cstring>
+#include <initializer_list>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+using namespace KDGpuUtils;
+
+namespace {
+
+inline std::string assetPath()
+{
+#if defined(KDGPU_ASSET_PATH)
+    return KDGPU_ASSET_PATH;
+#else
+    return "";
+#endif
+}
+
+std::vector<uint32_t> readShaderFile(const std::string &filename)
+{
+    using namespace KDUtils;
+
+    File file(File::exists(filename) ? filename : Dir::applicationDir().absoluteFilePath(filename));
+
+    if (!file.open(std::ios::in | std::ios::binary)) {
+        SPDLOG_CRITICAL("Failed to open file {}", filename);
+        throw std::runtime_error("Failed to open file");
+    }
+
+    const ByteArray fileContent = file.readAll();
+    std::vector<uint32_t> buffer(fileContent.size() / 4);
+    std::memcpy(buffer.data(), fileContent.data(), fileContent.size());
+
+    return buffer;
+}
+
+ShaderReflection reflectAsset(const std::string &path)
+{
+    const auto reflection = reflectShader(readShaderFile(assetPath() + path));
+    REQUIRE(reflection.has_value());
+    return *reflection;
+}
+
+// Just enough of an assembler to write the modules below by hand
+class SpirvModule
+{
+public:
+    enum Op : uint32_t {
+        OpEntryPoint = 15,
+        OpTypeInt = 21,
+        OpTypeFloat = 22,
+        OpTypeVector = 23,
+        OpTypeMatrix = 24,
+        OpTypeImage = 25,
+        OpTypeSampledImage = 27,
+        OpTypeArray = 28,
+        OpTypeRuntimeArray = 29,
+        OpTypeStruct = 30,
+        OpTypePointer = 32,
+        OpConstant = 43,
+        OpVariable = 59,
+        OpDecorate = 71,
+        OpMemberDecorate = 72,
+    };
+
+    enum StorageClass : uint32_t {
+        UniformConstant = 0,
+        Input = 1,
+        Uniform = 2,
+        PushConstant = 9,
+        StorageBuffer = 12,
+    };
+
+    explicit SpirvModule(uint32_t executionModel)
+    {
+        op(OpEntryPoint, { executionModel, newId(), 0x6e69616d, 0 }); // "main"
+    }
+
+    uint32_t newId() { return m_nextId++; }
+
+    void op(uint32_t opcode, std::initializer_list<uint32_t> operands)
+    {
+        m_words.push_back(uint32_t((operands.size() + 1) << 16) | opcode);
+        m_words.insert(m_words.end(), operands);
+    }
+
+    uint32_t type(uint32_t opcode, std::initializer_list<uint32_t> operands = {})
+    {
+        const uint32_t id = newId();
+        std::vector<uint32_t> words{ id };
+        words.insert(words.end(), operands);
+        m_words.push_back(uint32_t((words.size() + 1) << 16) | opcode);
+        m_words.insert(m_words.end(), words.begin(), words.end());
+        return id;
+    }
+
+    uint32_t variable(uint32_t typeId, uint32_t storageClass)
+    {
+        const uint32_t pointer = type(OpTypePointer, { storageClass, typeId });
+        const uint32_t id = newId();
+        op(OpVariable, { pointer, id, storageClass });
+        return id;
+    }
+
+    uint32_t resource(uint32_t typeId, uint32_t storageClass, uint32_t set, uint32_t binding)
+    {
+        const uint32_t id = variable(typeId, storageClass);
+        op(OpDecorate, { id, 34, set });
+        op(OpDecorate, { id, 33, binding });
+        return id;
+    }
+
+    std::vector<uint32_t> code() const
+    {
+        std::vector<uint32_t> code{ 0x07230203, 0x00010000, 0, m_nextId, 0 };
+        code.insert(code.end(), m_words.begin(), m_words.end());
+        return code;
+    }
+
+private:
+    uint32_t m_nextId{ 1 };
+    std::vector<uint32_t> m_words;
+};
+
+constexpr uint32_t ExecutionModelVertex = 0;
+constexpr uint32_t ExecutionModelFragment = 4;
+
+// layout(location = 0) in vec3 position;
+// layout(set = 0, binding = 0) uniform Block { mat4 mvp; };
+// layout(push_constant) uniform PushConstants { layout(offset = 64) vec2 size; uint flags; };
+std::vector<uint32_t> vertexModule()
+{
+    SpirvModule module(ExecutionModelVertex);
+    const uint32_t floatType = module.type(SpirvModule::OpTypeFloat, { 32 });
+    const uint32_t uintType = module.type(SpirvModule::OpTypeInt, { 32, 0 });
+    const uint32_t vec2Type = module.type(SpirvModule::OpTypeVector, { floatType, 2 });
+    const uint32_t vec3Type = module.type(SpirvModule::OpTypeVector, { floatType, 3 });
+    const uint32_t vec4Type = module.type(SpirvModule::OpTypeVector, { floatType, 4 });
+    const uint32_t mat4Type = module.type(SpirvModule::OpTypeMatrix, { vec4Type, 4 });
+
+    const uint32_t position = module.variable(vec3Type, SpirvModule::Input);
+    module.op(SpirvModule::OpDecorate, { position, 30, 0 });
+    const uint32_t vertexIndex = module.variable(uintType, SpirvModule::Input);
+    module.op(SpirvModule::OpDecorate, { vertexIndex, 11, 42 });
+
+    const uint32_t blockType = module.type(SpirvModule::OpTypeStruct, { mat4Type });
+    module.op(SpirvModule::OpDecorate, { blockType, 2 });
+    module.op(SpirvModule::OpMemberDecorate, { blockType, 0, 35, 0 });
+    module.op(SpirvModule::OpMemberDecorate, { blockType, 0, 7, 16 });
+    module.resource(blockType, SpirvModule::Uniform, 0, 0);
+
+    const uint32_t pushConstantType = module.type(SpirvModule::OpTypeStruct, { vec2Type, uintType });
+    module.op(SpirvModule::OpDecorate, { pushConstantType, 2 });
+    module.op(SpirvModule::OpMemberDecorate, { pushConstantType, 0, 35, 64 });
+    module.op(SpirvModule::OpMemberDecorate, { pushConstantType, 1, 35, 72 });
+    module.variable(pushConstantType, SpirvModule::PushConstant);
+
+    return module.code();
+}
+
+// layout(set = 0, binding = 1) uniform subpassInput input;
+// layout(set = 1, binding = 0) buffer Data { float values[]; };
+// layout(set = 1, binding = 2) uniform sampler2D textures[4];
+// layout(set = 0, binding = 0) uniform Block or buffer Block, depending on conflicting
+std::vector<uint32_t> fragmentModule(bool conflicting = false)
+{
+    SpirvModule module(ExecutionModelFragment);
+    const uint32_t floatType = module.type(SpirvModule::OpTypeFloat, { 32 });
+    const uint32_t uintType = module.type(SpirvModule::OpTypeInt, { 32, 0 });
+    const uint32_t vec4Type = module.type(SpirvModule::OpTypeVector, { floatType, 4 });
+    const uint32_t mat4Type = module.type(SpirvModule::OpTypeMatrix, { vec4Type, 4 });
+
+    const uint32_t subpassType = module.type(SpirvModule::OpTypeImage, { floatType, 6, 0, 0, 0, 2, 0 });
+    module.resource(subpassType, SpirvModule::UniformConstant, 0, 1);
+
+    const uint32_t runtimeArrayType = module.type(SpirvModule::OpTypeRuntimeArray, { floatType });
+    const uint32_t dataType = module.type(SpirvModule::OpTypeStruct, { runtimeArrayType });
+    module.op(SpirvModule::OpDecorate, { dataType, 2 });
+    module.resource(dataType, SpirvModule::StorageBuffer, 1, 0);
+
+    const uint32_t imageType = module.type(SpirvModule::OpTypeImage, { floatType, 1, 0, 0, 0, 1, 0 });
+    const uint32_t sampledImageType = module.type(SpirvModule::OpTypeSampledImage, { imageType });
+    const uint32_t four = module.newId();
+    module.op(SpirvModule::OpConstant, { uintType, four, 4 });
+    const uint32_t textureArrayType = module.type(SpirvModule::OpTypeArray, { sampledImageType, four });
+    module.resource(textureArrayType, SpirvModule::UniformConstant, 1, 2);
+
+    const uint32_t blockType = module.type(SpirvModule::OpTypeStruct, { mat4Type });
+    module.op(SpirvModule::OpDecorate, { blockType, 2 });
+    module.op(SpirvModule::OpMemberDecorate, { blockType, 0, 35, 0 });
+    module.resource(blockType, conflicting ? SpirvModule::StorageBuffer : SpirvModule::Uniform, 0, 0);
+
+    return module.code();
+}
+
+} // namespace
+
+TEST_CASE("Reflection")
+{
+    SUBCASE("finds the interface of a vertex shader")
+    {
+        // WHEN
+        const auto reflection = reflectShader(vertexModule());
+
+        // THEN
+        REQUIRE(reflection.has_value());
+        CHECK(reflection->shaderStages == ShaderStageFlags(ShaderStageFlagBits::VertexBit));
+        REQUIRE(reflection->bindings.size() == 1);
+        CHECK(reflection->bindings[0] == ReflectedBinding{ .set = 0, .binding = 0, .count = 1, .resourceType = ResourceBindingType::UniformBuffer, .shaderStages = ShaderStageFlagBits::VertexBit });
+        REQUIRE(reflection->pushConstantRanges.size() == 1);
+        CHECK(reflection->pushConstantRanges[0] == PushConstantRange{ .offset = 64, .size = 12, .shaderStages = ShaderStageFlagBits::VertexBit });
+        REQUIRE(reflection->vertexInputs.size() == 1);
+        CHECK(reflection->vertexInputs[0] == ReflectedVertexInput{ .location = 0, .format = Format::R32G32B32_SFLOAT });
+    }
+
+    SUBCASE("finds the interface of a fragment shader")
+    {
+        // WHEN
+        const auto reflection = reflectShader(fragmentModule());
+
+        // THEN
+        REQUIRE(reflection.has_value());
+        CHECK(reflection->vertexInputs.empty());
+        REQUIRE(reflection->bindings.size() == 4);
+        CHECK(reflection->bindings[0].resourceType == ResourceBindingType::UniformBuffer);
+        CHECK(reflection->bindings[1].resourceType == ResourceBindingType::InputAttachment);
+        CHECK(reflection->bindings[2].resourceType == ResourceBindingType::StorageBuffer);
+        CHECK(reflection->bindings[2].count == 1);
+        CHECK(reflection->bindings[3].resourceType == ResourceBindingType::CombinedImageSampler);
+        CHECK(reflection->bindings[3].count == 4);
+    }
+
+    SUBCASE("merges stages")
+    {
+        // GIVEN
+        auto reflection = reflectShader(vertexModule());
+        REQUIRE(reflection.has_value());
+
+        // WHEN
+        const bool compatible = reflection->merge(*reflectShader(fragmentModule()));
+
+        // THEN
+        CHECK(compatible);
+        CHECK(reflection->shaderStages == (ShaderStageFlagBits::VertexBit | ShaderStageFlagBits::FragmentBit));
+        REQUIRE(reflection->bindings.size() == 4);
+        CHECK(reflection->bindings[0].shaderStages == (ShaderStageFlagBits::VertexBit | ShaderStageFlagBits::FragmentBit));
+        CHECK(reflection->bindings[1].shaderStages == ShaderStageFlags(ShaderStageFlagBits::FragmentBit));
+        CHECK(reflection->vertexInputs.size() == 1);
+
+        const std::vector<BindGroupLayoutOptions> options = reflection->bindGroupLayoutOptions(64);
+        REQUIRE(options.size() == 2);
+        CHECK(options[0].bindings.size() == 2);
+        REQUIRE(options[1].bindings.size() == 2);
+        CHECK(options[1].bindings[0].binding == 0);
+        CHECK(options[1].bindings[1].binding == 2);
+        CHECK(options[1].bindings[1].count == 4);
+    }
+
+    SUBCASE("reports stages that disagree on a binding")
+    {
+        // GIVEN
+        auto reflection = reflectShader(vertexModule());
+
+        // WHEN
+        const bool compatible = reflection->merge(*reflectShader(fragmentModule(true)));
+
+        // THEN
+        CHECK(!compatible);
+        CHECK(reflection->bindings[0].resourceType == ResourceBindingType::UniformBuffer);
+    }
+
+    SUBCASE("rejects data that is not SPIR-V")
+    {
+        // GIVEN
+        std::vector<uint32_t> truncated = vertexModule();
+        truncated.pop_back();
+
+        // THEN
+        CHECK(!reflectShader(std::vector<uint32_t>{ 1, 2, 3, 4, 5, 6 }).has_value());
+        CHECK(!reflectShader(truncated).has_value());
+        CHECK(!reflectShader({}).has_value());
+    }
+}
+
+TEST_SUITE("ShaderReflection")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "ShaderReflection",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *discreteGPUAdapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = discreteGPUAdapter->createDevice();
+
+    TEST_CASE("Shipped shaders")
+    {
+        SUBCASE("vertex inputs")
+        {
+            const ShaderReflection reflection = reflectAsset("/shaders/tests/graphics_pipeline/triangle.vert.spv");
+
+            CHECK(reflection.shaderStages == ShaderStageFlags(ShaderStageFlagBits::VertexBit));
+            CHECK(reflection.bindings.empty());
+            REQUIRE(reflection.vertexInputs.size() == 2);
+            CHECK(reflection.vertexInputs[0] == ReflectedVertexInput{ .location = 0, .format = Format::R32G32B32_SFLOAT });
+            CHECK(reflection.vertexInputs[1] == ReflectedVertexInput{ .location = 1, .format = Format::R32G32B32_SFLOAT });
+        }
+
+        SUBCASE("uniform buffer")
+        {
+            const ShaderReflection reflection = reflectAsset("/shaders/examples/dynamic_ubo/dynamic_ubo.vert.spv");
+
+            REQUIRE(reflection.bindings.size() == 1);
+            CHECK(reflection.bindings[0] == ReflectedBinding{ .set = 0, .binding = 0, .count = 1, .resourceType = ResourceBindingType::UniformBuffer, .shaderStages = ShaderStageFlagBits::VertexBit });
+        }
+
+        SUBCASE("storage buffer")
+        {
+            const ShaderReflection reflection = reflectAsset("/shaders/tests/compute_pipeline/empty_compute_with_bindgroup.comp.spv");
+
+            CHECK(reflection.shaderStages == ShaderStageFlags(ShaderStageFlagBits::ComputeBit));
+            REQUIRE(reflection.bindings.size() == 1);
+            CHECK(reflection.bindings[0].resourceType == ResourceBindingType::StorageBuffer);
+        }
+
+        SUBCASE("input attachment")
+        {
+            const ShaderReflection reflection = reflectAsset("/shaders/tests/render_pass_command_recorder/read-image.frag.spv");
+
+            REQUIRE(reflection.bindings.size() == 1);
+            CHECK(reflection.bindings[0].resourceType == ResourceBindingType::InputAttachment);
+        }
+
+        SUBCASE("combined image sampler and push constants")
+        {
+            const ShaderReflection reflection = reflectAsset("/shaders/examples/bindgroup_partially_bound/bindgroup_partially_bound.frag.spv");
+
+            REQUIRE(reflection.bindings.size() == 1);
+            CHECK(reflection.bindings[0].resourceType == ResourceBindingType::CombinedImageSampler);
+            REQUIRE(reflection.pushConstantRanges.size() == 1);
+            CHECK(reflection.pushConstantRanges[0] == PushConstantRange{ .offset = 64, .size = 12, .shaderStages = ShaderStageFlagBits::FragmentBit });
+        }
+    }
+
+    TEST_CASE("Building layouts")
+    {
+        // GIVEN
+        ShaderReflection texturedQuad = reflectAsset("/shaders/examples/textured_quad/textured_quad.vert.spv");
+        REQUIRE(texturedQuad.merge(reflectAsset("/shaders/examples/textured_quad/textured_quad.frag.spv")));
+        PipelineLayoutBuilder builder(&device);
+
+        SUBCASE("creates a usable pipeline layout")
+        {
+            // WHEN
+            const ReflectedPipelineLayout layout = builder.build(texturedQuad);
+
+            // THEN
+            CHECK(layout.pipelineLayout.isValid());
+            REQUIRE(layout.bindGroupLayouts.size() == 1);
+            CHECK(layout.bindGroupLayouts[0].isValid());
+        }
+
+        SUBCASE("shares layouts between identical interfaces")
+        {
+            // WHEN
+            const ReflectedPipelineLayout layout1 = builder.build(texturedQuad);
+            const ReflectedPipelineLayout layout2 = builder.build(texturedQuad);
+
+            // THEN
+            CHECK(layout1.pipelineLayout == layout2.pipelineLayout);
+            CHECK(builder.pipelineLayoutCount() == 1);
+            CHECK(builder.bindGroupLayoutCount() == 1);
+        }
+
+        SUBCASE("shares bind group layouts between different pipeline layouts")
+        {
+            // GIVEN
+            ShaderReflection withPushConstants = texturedQuad;
+            withPushConstants.pushConstantRanges.push_back(PushConstantRange{ .offset = 0, .size = 16, .shaderStages = ShaderStageFlagBits::VertexBit });
+
+            // WHEN
+            const ReflectedPipelineLayout layout1 = builder.build(texturedQuad);
+            const ReflectedPipelineLayout layout2 = builder.build(withPushConstants);
+
+            // THEN
+            CHECK(layout1.pipelineLayout != layout2.pipelineLayout);
+            CHECK(layout1.bindGroupLayouts == layout2.bindGroupLayouts);
+            CHECK(builder.bindGroupLayoutCount() == 1);
+        }
+
+        SUBCASE("reuses compatible layouts created by the application")
+        {
+            // GIVEN
+            const BindGroupLayout existing = device.createBindGroupLayout(texturedQuad.bindGroupLayoutOptions()[0]);
+            builder.addBindGroupLayout(existing);
+
+            // WHEN
+            const ReflectedPipelineLayout layout = builder.build(texturedQuad);
+
+            // THEN
+            REQUIRE(layout.bindGroupLayouts.size() == 1);
+            CHECK(layout.bindGroupLayouts[0] == existing.handle());
+            CHECK(builder.bindGroupLayoutCount() == 0);
+        }
+    }
+}
@@ -16,6 +16,7 @@
 #include <KDGpu/vulkan/vulkan_graphics_api.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
@@ -81,10 +82,9 @@ TEST_SUITE("StagingBufferPool")
             CHECK(bin.buffer.isValid());
             CHECK(bin.buffer.handle() == result.second);
             CHECK(bin.isMapped == true);
-            CHECK(bin.m_allocations.size() == 1);
-            CHECK(bin.m_allocations[0].offset == 0);
-            CHECK(bin.m_allocations[0].offset == result.first);
-            CHECK(bin.m_allocations[0].size == 512);
+            CHECK(bin.allocationCount == 1);
+            CHECK(result.first == 0);
+            CHECK(bin.head == 512);
             CHECK(std::memcmp(bin.mapped, testData.data(), 512) == 0);
         }
 
@@ -106,13 +106,10 @@ TEST_SUITE("StagingBufferPool")
             CHECK(bin.buffer.handle() == r1.second);
             CHECK(bin.buffer.handle() == r2.second);
             CHECK(bin.isMapped == true);
-            CHECK(bin.m_allocations.size() == 2);
-            CHECK(bin.m_allocations[0].offset == 0);
-            CHECK(bin.m_allocations[0].offset == r1.first);
-            CHECK(bin.m_allocations[0].size == 512);
-            CHECK(bin.m_allocations[1].offset == 512);
-            CHECK(bin.m_allocations[1].offset == r2.first);
-            CHECK(bin.m_allocations[1].size == 512);
+            CHECK(bin.allocationCount == 2);
+            CHECK(r1.first == 0);
+            CHECK(r2.first == 512);
+            CHECK(bin.head == 1024);
             CHECK(std::memcmp(bin.mapped, testData.data(), 512) == 0);
             CHECK(std::memcmp(reinterpret_cast<uint8_t *>(bin.mapped) + 512, testData.data(), 512) == 0);
         }
@@ -140,14 +137,12 @@ TEST_SUITE("StagingBufferPool")
             CHECK(bin2.buffer.handle() == r2.second);
             CHECK(bin1.isMapped == false);
             CHECK(bin2.isMapped == true);
-            CHECK(bin1.m_allocations.size() == 1);
-            CHECK(bin2.m_allocations.size() == 1);
-            CHECK(bin1.m_allocations[0].offset == 0);
-            CHECK(bin1.m_allocations[0].offset == r1.first);
-            CHECK(bin1.m_allocations[0].size == 512);
-            CHECK(bin2.m_allocations[0].offset == 0);
-            CHECK(bin2.m_allocations[0].offset == r2.first);
-            CHECK(bin2.m_allocations[0].size == 768);
+            CHECK(bin1.allocationCount == 1);
+            CHECK(bin2.allocationCount == 1);
+            CHECK(r1.first == 0);
+            CHECK(bin1.head == 512);
+            CHECK(r2.first == 0);
+            CHECK(bin2.head == 768);
 
             // If we could map bin1
             // CHECK(std::memcmp(bin1.mapped, smallTestData.data(), 512) == 0);
@@ -179,17 +174,13 @@ TEST_SUITE("StagingBufferPool")
             CHECK(bin2.buffer.handle() == r2.second);
             CHECK(bin1.isMapped == true);
             CHECK(bin2.isMapped == false);
-            CHECK(bin1.m_allocations.size() == 2);
-            CHECK(bin2.m_allocations.size() == 1);
-            CHECK(bin1.m_allocations[0].offset == 0);
-            CHECK(bin1.m_allocations[0].offset == r1.first);
-            CHECK(bin1.m_allocations[0].size == 512);
-            CHECK(bin1.m_allocations[1].offset == 512);
-            CHECK(bin1.m_allocations[1].offset == r3.first);
-            CHECK(bin1.m_allocations[1].size == 512);
-            CHECK(bin2.m_allocations[0].offset == 0);
-            CHECK(bin2.m_allocations[0].offset == r2.first);
-            CHECK(bin2.m_allocations[0].size == 768);
+            CHECK(bin1.allocationCount == 2);
+            CHECK(bin2.allocationCount == 1);
+            CHECK(r1.first == 0);
+            CHECK(r3.first == 512);
+            CHECK(bin1.head == 1024);
+            CHECK(r2.first == 0);
+            CHECK(bin2.head == 768);
 
             CHECK(std::memcmp(bin1.mapped, smallTestData.data(), 512) == 0);
             CHECK(std::memcmp(reinterpret_cast<uint8_t *>(bin1.mapped) + 512, smallTestData.data(), 512) == 0);
@@ -233,6 +224,75 @@ TEST_SUITE("StagingBufferPool")
             CHECK(bin2.frameIndex == 1);
             CHECK(bin2.isMapped == true);
         }
+
+        SUBCASE("Aligns allocations")
+        {
+            // GIVEN
+            KDGpuUtils::ResourceDeleter deleter(&device, MAX_FRAMES_IN_FLIGHT);
+            KDGpuUtils::StagingBufferPoolImpl<1, 1024> stagingBufferPool(&device, &deleter);
+            const std::vector<uint8_t> testData = std::vector<uint8_t>(100, 0xaa);
+
+            // WHEN
+            const std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> r1 = stagingBufferPool.stage(testData);
+            const std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> r2 = stagingBufferPool.stage(testData, 256);
+            const std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> r3 = stagingBufferPool.stage(testData, 12);
+
+            // THEN
+            REQUIRE(stagingBufferPool.bins().size() == 1);
+            const auto &bin = stagingBufferPool.bins()[0];
+            CHECK(r1.first == 0);
+            CHECK(r2.first == 256);
+            CHECK(r3.first == 360);
+            CHECK(bin.head == 460);
+            CHECK(std::memcmp(reinterpret_cast<uint8_t *>(bin.mapped) + 256, testData.data(), 100) == 0);
+
+            // WHEN -> Fits without alignment, not with it
+            const std::vector<uint8_t> bigTestData = std::vector<uint8_t>(540, 0xee);
+            const std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> r4 = stagingBufferPool.stage(bigTestData, 512);
+
+            // THEN
+            REQUIRE(stagingBufferPool.bins().size() == 2);
+            CHECK(r4.first == 0);
+            CHECK(r4.second == stagingBufferPool.bins()[1].buffer.handle());
+        }
+
+        SUBCASE("Stages data larger than a bin into a dedicated bin")
+        {
+            // GIVEN
+            KDGpuUtils::ResourceDeleter deleter(&device, MAX_FRAMES_IN_FLIGHT);
+            KDGpuUtils::StagingBufferPoolImpl<1, 1024> stagingBufferPool(&device, &deleter);
+            const std::vector<uint8_t> smallTestData = std::vector<uint8_t>(512, 0xaa);
+            const std::vector<uint8_t> hugeTestData = std::vector<uint8_t>(4096, 0xee);
+
+            // WHEN
+            const std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> r1 = stagingBufferPool.stage(smallTestData);
+            const std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> r2 = stagingBufferPool.stage(hugeTestData);
+            const std::pair<size_t, KDGpu::Handle<KDGpu::Buffer_t>> r3 = stagingBufferPool.stage(smallTestData);
+
+            // THEN -> Regular bins keep being used around the dedicated one
+            REQUIRE(stagingBufferPool.bins().size() == 2);
+            const auto &bin1 = stagingBufferPool.bins()[0];
+            const auto &bin2 = stagingBufferPool.bins()[1];
+            CHECK(bin1.buffer.handle() == r1.second);
+            CHECK(bin1.buffer.handle() == r3.second);
+            CHECK(bin1.isMapped == true);
+            CHECK(r3.first == 512);
+            CHECK(bin2.buffer.handle() == r2.second);
+            CHECK(bin2.capacity == 4096);
+            CHECK(bin2.isMapped == false);
+            CHECK(r2.first == 0);
+
+            // WHEN
+            stagingBufferPool.flush();
+            stagingBufferPool.moveToNextFrame();
+
+            // THEN
+            REQUIRE(stagingBufferPool.bins().size() == 1);
+            CHECK(stagingBufferPool.bins()[0].buffer.handle() == r1.second);
+            auto &bins = deleter.frameBins();
+            CHECK(bins.size() == 1);
+            CHECK(bins[0].resources.get<KDGpu::Buffer>().size() == 1);
+        }
     }
 
     TEST_CASE("Trims when moving to next frame")
@@ -277,16 +337,18 @@ TEST_SUITE("StagingBufferPool")
             // THEN
             REQUIRE(stagingBufferPool.bins().size() == 1);
             const auto &bin = stagingBufferPool.bins()[0];
-            CHECK(bin.m_allocations.size() == 5);
+            CHECK(bin.allocationCount == 5);
 
             // WHEN
             stagingBufferPool.flush();
             stagingBufferPool.moveToNextFrame();
 
             // THEN
-            CHECK(stagingBufferPool.bins().size() == 1);
-            CHECK(bin.isMapped == false);
-            CHECK(bin.m_allocations.empty());
+            REQUIRE(stagingBufferPool.bins().size() == 1);
+            const auto &keptBin = stagingBufferPool.bins()[0];
+            CHECK(keptBin.isMapped == false);
+            CHECK(keptBin.allocationCount == 0);
+            CHECK(keptBin.head == 0);
         }
 
         SUBCASE("Destroys excess bins")
@@ -371,4 +433,35 @@ TEST_SUITE("StagingBufferPool")
             CHECK(bins[0].resources.get<KDGpu::Buffer>().size() == 9);
         }
     }
+
+    // Stages small uploads over many bins and frames in flight.
+    // Run with --no-skip to get the numbers.
+    TEST_CASE("Staging benchmark" * doctest::skip())
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr size_t frameCount = 300;
+        constexpr size_t stagesPerFrame = 2000;
+
+        // GIVEN
+        KDGpuUtils::ResourceDeleter deleter(&device, MAX_FRAMES_IN_FLIGHT);
+        KDGpuUtils::StagingBufferPoolImpl<4, 64 * 1024> stagingBufferPool(&device, &deleter);
+        const std::vector<uint8_t> testData = std::vector<uint8_t>(200, 0xaa);
+
+        // WHEN
+        const auto start = Clock::now();
+        for (size_t frame = 0; frame < frameCount; ++frame) {
+            stagingBufferPool.derefFrameIndex(frame % MAX_FRAMES_IN_FLIGHT);
+            for (size_t i = 0; i < stagesPerFrame; ++i)
+                stagingBufferPool.stage(testData, 16);
+            stagingBufferPool.flush();
+            stagingBufferPool.moveToNextFrame();
+            deleter.moveToNextFrame();
+        }
+        const auto end = Clock::now();
+
+        // THEN
+        using ms = std::chrono::duration<double, std::milli>;
+        MESSAGE("Staged " << frameCount * stagesPerFrame << " uploads over " << frameCount << " frames in " << ms(end - start).count() << "ms");
+        CHECK(stagingBufferPool.bins().size() <= 4 * MAX_FRAMES_IN_FLIGHT);
+    }
 }
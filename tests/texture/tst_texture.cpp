@@ -13,8 +13,10 @@
 #include <KDGpu/texture_options.h>
 #include <KDGpu/device.h>
 #include <KDGpu/instance.h>
+#include <KDGpu/queue.h>
 #include <KDGpu/vulkan/vulkan_graphics_api.h>
 
+#include <chrono>
 #include <set>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
@@ -488,6 +490,110 @@ TEST_SUITE("Texture")
                 return rgba == 0xff0000ff;
             }));
         }
+
+        SUBCASE("Queue uploads to host transfer textures are host copies")
+        {
+            // GIVEN
+            Texture t = device.createTexture(TextureOptions{
+                    .type = TextureType::TextureType2D,
+                    .format = Format::R8G8B8A8_UNORM,
+                    .extent = { 512, 512, 1 },
+                    .mipLevels = 1,
+                    .usage = TextureUsageFlagBits::SampledBit | TextureUsageFlagBits::HostTransferBit,
+                    .memoryUsage = MemoryUsage::GpuOnly,
+                    .initialLayout = TextureLayout::Undefined,
+            });
+            const std::vector<uint32_t> texels(512 * 512, 0xff00ff00);
+
+            // WHEN
+            UploadStagingBuffer upload = graphicsQueue.uploadTextureData(TextureUploadOptions{
+                    .destinationTexture = t,
+                    .dstStages = PipelineStageFlagBit::FragmentShaderBit,
+                    .dstMask = AccessFlagBit::ShaderReadBit,
+                    .data = texels.data(),
+                    .byteSize = texels.size() * sizeof(uint32_t),
+                    .oldLayout = TextureLayout::Undefined,
+                    .newLayout = TextureLayout::General,
+                    .regions = { { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit }, .textureExtent = { 512, 512, 1 } } },
+            });
+
+            // THEN
+            CHECK(!upload.buffer.isValid());
+            CHECK(!upload.commandBuffer.isValid());
+            CHECK(upload.fence.status() == FenceStatus::Signalled);
+
+            std::vector<uint32_t> rawImageData(512 * 512);
+            t.copyTextureToHostMemory(TextureToHostMemoryCopy{
+                    .textureLayout = TextureLayout::General,
+                    .regions = {
+                            TextureToHostMemoryCopyRegion{
+                                    .srcSubresource = { .aspectMask = TextureAspectFlagBits::ColorBit },
+                                    .srcExtent = { 512, 512, 1 },
+                                    .dstHostMemoryPointer = rawImageData.data(),
+                            },
+                    },
+            });
+            CHECK(rawImageData == texels);
+        }
+    }
+
+    // Run with --no-skip to get the numbers. Compares uploads writing the texture from the
+    // host with uploads going through a staging buffer and a queue submission.
+    TEST_CASE("Host copy upload benchmark" * doctest::skip())
+    {
+        if (!discreteGPUAdapter->features().hostImageCopy)
+            return;
+
+        Device device = discreteGPUAdapter->createDevice(DeviceOptions{
+                .requestedFeatures = {
+                        .hostImageCopy = true,
+                },
+        });
+        Queue &queue = device.queues()[0];
+
+        constexpr uint32_t textureCount = 64;
+        constexpr uint32_t size = 1024;
+        const std::vector<uint32_t> texels(size * size, 0xff0000ff);
+
+        const auto uploadAll = [&](TextureUsageFlagBits usage) {
+            std::vector<Texture> textures;
+            textures.reserve(textureCount);
+            for (uint32_t i = 0; i < textureCount; ++i) {
+                textures.push_back(device.createTexture(TextureOptions{
+                        .type = TextureType::TextureType2D,
+                        .format = Format::R8G8B8A8_UNORM,
+                        .extent = { size, size, 1 },
+                        .mipLevels = 1,
+                        .usage = TextureUsageFlagBits::SampledBit | usage,
+                        .memoryUsage = MemoryUsage::GpuOnly,
+                }));
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<UploadStagingBuffer> uploads;
+            uploads.reserve(textureCount);
+            for (const Texture &texture : textures) {
+                uploads.push_back(queue.uploadTextureData(TextureUploadOptions{
+                        .destinationTexture = texture,
+                        .dstStages = PipelineStageFlagBit::FragmentShaderBit,
+                        .dstMask = AccessFlagBit::ShaderReadBit,
+                        .data = texels.data(),
+                        .byteSize = texels.size() * sizeof(uint32_t),
+                        .oldLayout = TextureLayout::Undefined,
+                        .newLayout = TextureLayout::General,
+                        .regions = { { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit }, .textureExtent = { size, size, 1 } } },
+                }));
+            }
+            for (UploadStagingBuffer &upload : uploads)
+                upload.fence.wait();
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        const double hostCopyMs = uploadAll(TextureUsageFlagBits::HostTransferBit);
+        const double stagingMs = uploadAll(TextureUsageFlagBits::TransferDstBit);
+
+        MESSAGE("Uploading " << textureCount << " " << size << "x" << size << " textures: host copies "
+                             << hostCopyMs << " ms, staging buffers " << stagingMs << " ms");
     }
 #endif
 }
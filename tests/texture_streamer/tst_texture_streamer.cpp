@@ -0,0 +1,109 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/texture_streamer.h>
+
+#include <KDGpu/adapter.h>
+#include <KDGpu/command_recorder.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/texture_options.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+using namespace KDGpuUtils;
+
+namespace {
+
+DeviceOptions streamingDeviceOptions(Adapter *adapter)
+{
+    DeviceOptions options{
+        .queues = { { .queueTypeIndex = 0, .count = 1, .priorities = { 1.0f } } },
+        .requestedFeatures = adapter->features(),
+    };
+    if (const auto transferQueueTypeIndex = TextureStreamer::transferQueueTypeIndex(*adapter))
+        options.queues.push_back({ .queueTypeIndex = *transferQueueTypeIndex, .count = 1, .priorities = { 1.0f } });
+    return options;
+}
+
+} // namespace
+
+TEST_SUITE("TextureStreamer")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "TextureStreamer",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *discreteGPUAdapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = discreteGPUAdapter->createDevice(streamingDeviceOptions(discreteGPUAdapter));
+    const bool supportsTimelineSemaphores = discreteGPUAdapter->features().timelineSemaphore;
+
+    TEST_CASE("Streaming" * doctest::skip(!supportsTimelineSemaphores))
+    {
+        // GIVEN
+        Queue &graphicsQueue = device.queues()[0];
+        TextureStreamer streamer(&device, &graphicsQueue);
+        const std::vector<uint8_t> pixels(16 * 16 * 4, 0xff);
+        Texture texture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 16, 16, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::SampledBit | TextureUsageFlagBits::TransferDstBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+
+        // THEN
+        CHECK(streamer.usesTransferQueue() == TextureStreamer::transferQueueTypeIndex(*discreteGPUAdapter).has_value());
+        CHECK(streamer.transferQueue()->flags().testFlag(QueueFlagBits::TransferBit));
+
+        // WHEN
+        const uint64_t value = streamer.uploadTextureData(TextureUploadOptions{
+                .destinationTexture = texture,
+                .dstStages = PipelineStageFlagBit::FragmentShaderBit,
+                .dstMask = AccessFlagBit::ShaderReadBit,
+                .data = pixels.data(),
+                .byteSize = pixels.size(),
+                .oldLayout = TextureLayout::Undefined,
+                .newLayout = TextureLayout::ShaderReadOnlyOptimal,
+                .regions = { { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit }, .textureExtent = { 16, 16, 1 } } },
+        });
+
+        // THEN
+        CHECK(value == 1);
+        CHECK(streamer.submittedValue() == 1);
+        CHECK(streamer.pendingUploadCount() == 1);
+
+        // WHEN -> The graphics queue acquires the texture after the upload completed
+        CommandRecorder commandRecorder = device.createCommandRecorder(CommandRecorderOptions{ .queue = graphicsQueue });
+        streamer.recordAcquireBarriers(commandRecorder);
+        CommandBuffer commandBuffer = commandRecorder.finish();
+        Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+        graphicsQueue.submit(SubmitOptions{
+                .commandBuffers = { commandBuffer },
+                .waitTimelineSemaphores = { streamer.waitInfo(PipelineStageFlagBit::FragmentShaderBit) },
+                .signalFence = fence,
+        });
+        fence.wait();
+
+        // THEN
+        CHECK(streamer.timelineSemaphore().value() >= value);
+
+        // WHEN
+        streamer.releaseCompleted();
+
+        // THEN
+        CHECK(streamer.pendingUploadCount() == 0);
+    }
+}
@@ -0,0 +1,241 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpuUtils/transient_buffer_allocator.h>
+
+#include <KDGpu/adapter.h>
+#include <KDGpu/adapter_properties.h>
+#include <KDGpu/bind_group_layout_options.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/queue.h>
+#include <KDGpu/timeline_semaphore.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <algorithm>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+using namespace KDGpuUtils;
+
+TEST_SUITE("TransientBufferAllocator")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "TransientBufferAllocator",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *discreteGPUAdapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = discreteGPUAdapter->createDevice(DeviceOptions{
+            .requestedFeatures = discreteGPUAdapter->features(),
+    });
+    const bool supportsTimelineSemaphores = discreteGPUAdapter->features().timelineSemaphore;
+    const DeviceSize minUniformAlignment = discreteGPUAdapter->properties().limits.minUniformBufferOffsetAlignment;
+    const DeviceSize minStorageAlignment = discreteGPUAdapter->properties().limits.minStorageBufferOffsetAlignment;
+    // Both limits are powers of two of at most 256, so offsets in multiples of alignment stay aligned
+    const DeviceSize alignment = std::max<DeviceSize>({ minUniformAlignment, minStorageAlignment, 256 });
+
+    TEST_CASE("Allocation")
+    {
+        // GIVEN
+        TransientBufferAllocator allocator(&device, 4 * alignment);
+
+        SUBCASE("Allocations are aligned and mapped")
+        {
+            // WHEN
+            const TransientAllocation first = allocator.allocate(16);
+            const TransientAllocation second = allocator.allocate(16);
+
+            // THEN
+            REQUIRE(first.isValid());
+            REQUIRE(second.isValid());
+            CHECK(first.buffer == allocator.buffer().handle());
+            CHECK(first.offset == 0);
+            CHECK(second.offset % std::max<DeviceSize>(minUniformAlignment, 1) == 0);
+            CHECK(second.offset % std::max<DeviceSize>(minStorageAlignment, 1) == 0);
+            CHECK(second.offset >= 16);
+            CHECK(static_cast<uint8_t *>(second.cpuPtr) - static_cast<uint8_t *>(first.cpuPtr) == second.offset);
+            CHECK(allocator.buffer().mappedPointer() == first.cpuPtr);
+        }
+
+        SUBCASE("Allocations larger than the ring fail")
+        {
+            // WHEN
+            const TransientAllocation allocation = allocator.allocate(5 * alignment);
+
+            // THEN
+            CHECK(!allocation.isValid());
+            CHECK(allocator.usedBytes() == 0);
+        }
+
+        SUBCASE("Allocations fail while all frames are in flight")
+        {
+            // GIVEN
+            Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+            REQUIRE(allocator.allocate(4 * alignment).isValid());
+            allocator.endFrame(fence);
+
+            // WHEN
+            const TransientAllocation allocation = allocator.allocate(alignment);
+
+            // THEN
+            CHECK(!allocation.isValid());
+            CHECK(allocator.usedBytes() == 4 * alignment);
+            CHECK(allocator.framesInFlight() == 1);
+        }
+
+        SUBCASE("Fences signalled by the frame submission release their frame")
+        {
+            // GIVEN
+            Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+            REQUIRE(allocator.allocate(4 * alignment).isValid());
+            allocator.endFrame(fence);
+            device.queues()[0].submit(SubmitOptions{ .signalFence = fence });
+            fence.wait();
+
+            // WHEN
+            const TransientAllocation allocation = allocator.allocate(alignment);
+
+            // THEN
+            CHECK(allocation.isValid());
+            CHECK(allocation.offset == 0);
+            CHECK(allocator.usedBytes() == alignment);
+            CHECK(allocator.framesInFlight() == 0);
+        }
+
+        SUBCASE("Fences still signalled from an earlier use do not release the frame")
+        {
+            // GIVEN
+            Fence fence = device.createFence(FenceOptions{ .createSignalled = true });
+            REQUIRE(allocator.allocate(4 * alignment).isValid());
+            allocator.endFrame(fence);
+
+            // WHEN
+            const TransientAllocation allocation = allocator.allocate(alignment);
+
+            // THEN
+            CHECK(!allocation.isValid());
+            CHECK(allocator.framesInFlight() == 1);
+        }
+
+        SUBCASE("Allocations not fitting at the end of the ring wrap around")
+        {
+            // GIVEN
+            Fence signalledFence = device.createFence(FenceOptions{ .createSignalled = false });
+            Fence fence = device.createFence(FenceOptions{ .createSignalled = false });
+            REQUIRE(allocator.allocate(2 * alignment).isValid());
+            allocator.endFrame(signalledFence);
+            device.queues()[0].submit(SubmitOptions{ .signalFence = signalledFence });
+            signalledFence.wait();
+            REQUIRE(allocator.allocate(alignment).isValid());
+            allocator.endFrame(fence);
+
+            // WHEN
+            const TransientAllocation allocation = allocator.allocate(2 * alignment);
+
+            // THEN -> The skipped end of the ring is in use until the frame retires
+            REQUIRE(allocation.isValid());
+            CHECK(allocation.offset == 0);
+            CHECK(allocator.usedBytes() == 4 * alignment);
+            CHECK(allocator.framesInFlight() == 1);
+        }
+    }
+
+    TEST_CASE("Reclaim" * doctest::skip(!supportsTimelineSemaphores))
+    {
+        // GIVEN
+        TransientBufferAllocator allocator(&device, 4 * alignment);
+        TimelineSemaphore timeline = device.createTimelineSemaphore(TimelineSemaphoreOptions{ .initialValue = 0 });
+
+        REQUIRE(allocator.allocate(2 * alignment).isValid());
+        allocator.endFrame(timeline, 1);
+        REQUIRE(allocator.allocate(2 * alignment).isValid());
+        allocator.endFrame(timeline, 2);
+
+        SUBCASE("Frames are released in order as their timeline value is reached")
+        {
+            // THEN
+            CHECK(!allocator.allocate(alignment).isValid());
+
+            // WHEN
+            timeline.signal(1);
+            const TransientAllocation allocation = allocator.allocate(alignment);
+
+            // THEN
+            REQUIRE(allocation.isValid());
+            CHECK(allocation.offset == 0);
+            CHECK(allocator.usedBytes() == 3 * alignment);
+            CHECK(allocator.framesInFlight() == 1);
+
+            // WHEN
+            timeline.signal(2);
+            allocator.reclaim();
+
+            // THEN
+            CHECK(allocator.usedBytes() == alignment);
+            CHECK(allocator.framesInFlight() == 0);
+        }
+
+        SUBCASE("Allocations wait for the frame using their range")
+        {
+            // GIVEN
+            timeline.signal(1);
+            allocator.reclaim();
+            REQUIRE(allocator.allocate(alignment).isValid());
+            REQUIRE(allocator.usedBytes() == 3 * alignment);
+
+            // WHEN
+            const TransientAllocation allocation = allocator.allocate(2 * alignment);
+
+            // THEN
+            CHECK(!allocation.isValid());
+
+            // WHEN
+            timeline.signal(2);
+            const TransientAllocation retried = allocator.allocate(2 * alignment);
+
+            // THEN
+            REQUIRE(retried.isValid());
+            CHECK(retried.offset == alignment);
+            CHECK(allocator.usedBytes() == 3 * alignment);
+        }
+    }
+
+    TEST_CASE("Dynamic bind group")
+    {
+        // GIVEN
+        TransientBufferAllocator allocator(&device, 4 * alignment);
+        const BindGroupLayout bindGroupLayout = device.createBindGroupLayout(BindGroupLayoutOptions{
+                .bindings = {
+                        {
+                                .binding = 0,
+                                .resourceType = ResourceBindingType::DynamicUniformBuffer,
+                                .shaderStages = ShaderStageFlags(ShaderStageFlagBits::VertexBit),
+                        },
+                },
+        });
+
+        // WHEN
+        const BindGroup bindGroup = allocator.createBindGroup(bindGroupLayout, 0, 64);
+        const TransientAllocation allocation = allocator.allocate(64);
+
+        // THEN
+        CHECK(bindGroup.isValid());
+        CHECK(allocation.dynamicOffset() == allocation.offset);
+
+        // WHEN -> The ring cannot back uniform buffers
+        TransientBufferAllocator vertexAllocator(&device, 4 * alignment, BufferUsageFlagBits::VertexBufferBit);
+
+        // THEN
+        CHECK(!vertexAllocator.createBindGroup(bindGroupLayout, 0, 64).isValid());
+    }
+}
@@ -0,0 +1,151 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/buffer_options.h>
+#include <KDGpu/device.h>
+#include <KDGpu/fence.h>
+#include <KDGpu/instance.h>
+#include <KDGpu/queue.h>
+#include <KDGpu/texture_options.h>
+#include <KDGpu/upload_batch.h>
+#include <KDGpu/vulkan/vulkan_graphics_api.h>
+
+#include <cstring>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+TEST_SUITE("UploadBatch")
+{
+    std::unique_ptr<GraphicsApi> api = std::make_unique<VulkanGraphicsApi>();
+    Instance instance = api->createInstance(InstanceOptions{
+            .applicationName = "UploadBatch",
+            .applicationVersion = KDGPU_MAKE_API_VERSION(0, 1, 0, 0) });
+    Adapter *discreteGPUAdapter = instance.selectAdapter(AdapterDeviceType::Default);
+    Device device = discreteGPUAdapter->createDevice();
+
+    TEST_CASE("Staging layout")
+    {
+        // GIVEN
+        const std::vector<uint8_t> data(100, 0xaa);
+        UploadBatch batch;
+
+        SUBCASE("An empty batch needs no staging memory")
+        {
+            // THEN
+            CHECK(batch.isEmpty());
+            CHECK(batch.uploadCount() == 0);
+            CHECK(batch.stagingSize() == 0);
+        }
+
+        SUBCASE("Uploads are packed into the staging memory")
+        {
+            // WHEN
+            batch.addBufferUpload(BufferUploadOptions{ .data = data.data(), .byteSize = 10 });
+            batch.addTextureUpload(TextureUploadOptions{ .data = data.data(), .byteSize = 100 });
+
+            // THEN -> Texture data starts at a multiple of every texel block size
+            CHECK(!batch.isEmpty());
+            CHECK(batch.uploadCount() == 2);
+            CHECK(batch.stagingSize() == 96 + 100);
+
+            // WHEN
+            batch.addBufferUpload(BufferUploadOptions{ .data = data.data(), .byteSize = 4 });
+
+            // THEN
+            CHECK(batch.uploadCount() == 3);
+            CHECK(batch.stagingSize() == 208 + 4);
+        }
+
+        SUBCASE("Clearing releases every upload")
+        {
+            // GIVEN
+            batch.addBufferUpload(BufferUploadOptions{ .data = data.data(), .byteSize = 10 });
+
+            // WHEN
+            batch.clear();
+
+            // THEN
+            CHECK(batch.isEmpty());
+            CHECK(batch.stagingSize() == 0);
+        }
+    }
+
+    TEST_CASE("Upload")
+    {
+        // GIVEN
+        const std::vector<uint32_t> data(256, 0xdeadbeef);
+        const DeviceSize byteSize = data.size() * sizeof(uint32_t);
+        Buffer first = device.createBuffer(BufferOptions{
+                .size = byteSize,
+                .usage = BufferUsageFlagBits::VertexBufferBit | BufferUsageFlagBits::TransferDstBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+        Buffer second = device.createBuffer(BufferOptions{
+                .size = byteSize,
+                .usage = BufferUsageFlagBits::TransferDstBit,
+                .memoryUsage = MemoryUsage::GpuToCpu,
+        });
+        Texture texture = device.createTexture(TextureOptions{
+                .type = TextureType::TextureType2D,
+                .format = Format::R8G8B8A8_UNORM,
+                .extent = { 16, 16, 1 },
+                .mipLevels = 1,
+                .usage = TextureUsageFlagBits::SampledBit | TextureUsageFlagBits::TransferDstBit,
+                .memoryUsage = MemoryUsage::GpuOnly,
+        });
+
+        UploadBatch batch;
+        batch.addBufferUpload(BufferUploadOptions{
+                .destinationBuffer = first,
+                .dstStages = PipelineStageFlagBit::VertexAttributeInputBit,
+                .dstMask = AccessFlagBit::VertexAttributeReadBit,
+                .data = data.data(),
+                .byteSize = byteSize,
+        });
+        batch.addTextureUpload(TextureUploadOptions{
+                .destinationTexture = texture,
+                .dstStages = PipelineStageFlagBit::FragmentShaderBit,
+                .dstMask = AccessFlagBit::ShaderReadBit,
+                .data = data.data(),
+                .byteSize = byteSize,
+                .oldLayout = TextureLayout::Undefined,
+                .newLayout = TextureLayout::ShaderReadOnlyOptimal,
+                .regions = { { .textureSubResource = { .aspectMask = TextureAspectFlagBits::ColorBit }, .textureExtent = { 16, 16, 1 } } },
+        });
+        batch.addBufferUpload(BufferUploadOptions{
+                .destinationBuffer = second,
+                .dstStages = PipelineStageFlagBit::HostBit,
+                .dstMask = AccessFlagBit::HostReadBit,
+                .data = data.data(),
+                .byteSize = byteSize,
+        });
+
+        // WHEN
+        UploadStagingBuffer upload = device.queues()[0].upload(batch);
+
+        // THEN
+        REQUIRE(upload.buffer.isValid());
+        REQUIRE(upload.fence.isValid());
+
+        // WHEN
+        upload.fence.wait();
+
+        // THEN
+        CHECK(upload.fence.status() == FenceStatus::Signalled);
+        second.invalidate();
+        const void *readBack = second.map();
+        REQUIRE(readBack != nullptr);
+        CHECK(std::memcmp(readBack, data.data(), byteSize) == 0);
+        second.unmap();
+    }
+}
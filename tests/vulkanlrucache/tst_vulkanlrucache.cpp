@@ -0,0 +1,202 @@
+/*
+  This file is part of KDGpu.
+
+  SPDX-FileCopyrightText: 2023 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDGpu/pool.h>
+#include <KDGpu/vulkan/vulkan_lru_cache.h>
+
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDGpu;
+
+namespace KDGpu {
+struct RenderPass_t;
+}
+
+TEST_CASE("VulkanLruCache")
+{
+    // GIVEN
+    // The pool only serves as a source of valid handles here
+    Pool<int, RenderPass_t> renderPasses{ 4 };
+    VulkanLruCache<int, RenderPass_t> cache;
+    std::vector<int> evictedKeys;
+    std::vector<int> destroyedKeys;
+
+    auto insert = [&](int key) {
+        const Handle<RenderPass_t> handle = renderPasses.emplace(key);
+        cache.insert(
+                key, handle,
+                [&](const Handle<RenderPass_t> &, int evictedKey) { evictedKeys.push_back(evictedKey); },
+                [&](const Handle<RenderPass_t> &, int destroyedKey) { destroyedKeys.push_back(destroyedKey); });
+        return handle;
+    };
+    auto destroy = [&](const Handle<RenderPass_t> &, int destroyedKey) {
+        destroyedKeys.push_back(destroyedKey);
+    };
+
+    SUBCASE("Unbounded by default")
+    {
+        // WHEN
+        for (int key = 0; key < 100; ++key)
+            insert(key);
+
+        // THEN
+        CHECK(cache.capacity() == 0);
+        CHECK(cache.size() == 100);
+        CHECK(cache.stats().evictions == 0);
+        CHECK(destroyedKeys.empty());
+    }
+
+    SUBCASE("Counts hits and misses")
+    {
+        // GIVEN
+        const Handle<RenderPass_t> handle = insert(1);
+
+        // WHEN
+        const Handle<RenderPass_t> found = cache.find(1);
+        const Handle<RenderPass_t> notFound = cache.find(2);
+
+        // THEN
+        CHECK(found == handle);
+        CHECK(!notFound.isValid());
+        CHECK(cache.stats().hits == 1);
+        CHECK(cache.stats().misses == 1);
+        CHECK(cache.stats().liveObjects == 1);
+    }
+
+    SUBCASE("Evicts the least recently used entries over capacity")
+    {
+        // GIVEN
+        cache.setCapacity(2);
+        insert(1);
+        insert(2);
+
+        // WHEN
+        cache.find(1);
+        insert(3);
+
+        // THEN
+        CHECK(cache.size() == 2);
+        CHECK(!cache.find(2).isValid());
+        CHECK(cache.find(1).isValid());
+        CHECK(cache.find(3).isValid());
+        CHECK(evictedKeys == std::vector<int>{ 2 });
+        CHECK(destroyedKeys == std::vector<int>{ 2 });
+        CHECK(cache.stats().evictions == 1);
+        CHECK(cache.stats().liveObjects == 2);
+    }
+
+    SUBCASE("Evicted entries in use are destroyed with their last use")
+    {
+        // GIVEN
+        cache.setCapacity(1);
+        const Handle<RenderPass_t> handle = insert(1);
+        cache.use(handle);
+        cache.use(handle);
+
+        // WHEN
+        insert(2);
+
+        // THEN
+        CHECK(evictedKeys == std::vector<int>{ 1 });
+        CHECK(destroyedKeys.empty());
+        CHECK(!cache.find(1).isValid());
+        CHECK(cache.stats().liveObjects == 2);
+
+        // WHEN
+        cache.release(handle, destroy);
+
+        // THEN
+        CHECK(destroyedKeys.empty());
+
+        // WHEN
+        cache.release(handle, destroy);
+
+        // THEN
+        CHECK(destroyedKeys == std::vector<int>{ 1 });
+        CHECK(cache.stats().liveObjects == 1);
+    }
+
+    SUBCASE("Releasing entries that were not evicted keeps them")
+    {
+        // GIVEN
+        const Handle<RenderPass_t> handle = insert(1);
+        cache.use(handle);
+
+        // WHEN
+        cache.release(handle, destroy);
+
+        // THEN
+        CHECK(destroyedKeys.empty());
+        CHECK(cache.find(1) == handle);
+    }
+
+    SUBCASE("Entries evicted explicitly are destroyed with their last use")
+    {
+        // GIVEN
+        const Handle<RenderPass_t> inUse = insert(1);
+        insert(2);
+        cache.use(inUse);
+
+        // WHEN
+        cache.evict(1, destroy);
+        cache.evict(2, destroy);
+        cache.evict(3, destroy);
+
+        // THEN
+        CHECK(cache.empty());
+        CHECK(!cache.find(1).isValid());
+        CHECK(destroyedKeys == std::vector<int>{ 2 });
+        CHECK(cache.stats().evictions == 2);
+        CHECK(cache.stats().liveObjects == 1);
+
+        // WHEN
+        cache.release(inUse, destroy);
+
+        // THEN
+        CHECK(destroyedKeys == std::vector<int>{ 2, 1 });
+        CHECK(cache.stats().liveObjects == 0);
+    }
+
+    SUBCASE("Taken entries are no longer tracked")
+    {
+        // GIVEN
+        const Handle<RenderPass_t> handle = insert(1);
+        cache.use(handle);
+
+        // WHEN
+        const Handle<RenderPass_t> taken = cache.take(1);
+        cache.release(handle, destroy);
+
+        // THEN
+        CHECK(taken == handle);
+        CHECK(!cache.take(1).isValid());
+        CHECK(cache.empty());
+        CHECK(destroyedKeys.empty());
+        CHECK(cache.stats().liveObjects == 0);
+    }
+
+    SUBCASE("Clearing destroys evicted entries still in use")
+    {
+        // GIVEN
+        cache.setCapacity(1);
+        cache.use(insert(1));
+        insert(2);
+
+        // WHEN
+        cache.clear(destroy);
+
+        // THEN
+        CHECK(destroyedKeys.size() == 2);
+        CHECK(cache.stats().liveObjects == 0);
+    }
+}